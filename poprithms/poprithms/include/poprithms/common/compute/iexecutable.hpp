@@ -3,6 +3,7 @@
 #define POPRITHMS_COMMON_COMPUTE_IEXECUTABLE_HPP
 
 #include <poprithms/common/compute/graph.hpp>
+#include <poprithms/common/compute/profiler.hpp>
 
 namespace poprithms {
 namespace common {
@@ -117,6 +118,49 @@ public:
    * */
   HostTensor getRemoteValue(const TensorId &rId, uint64_t r) const;
 
+  /**
+   * Start recording the time spent running each op, in all subsequent calls
+   * to #run. Profiling is disabled by default, as it adds a small overhead
+   * to every op run.
+   * */
+  void enableProfiling() { profiling_ = true; }
+
+  /**
+   * Stop recording. The events already recorded are kept.
+   * */
+  void disableProfiling() { profiling_ = false; }
+
+  bool isProfiling() const { return profiling_; }
+
+  /**
+   * All of the events recorded while profiling was enabled.
+   * */
+  const OpProfiler &profiler() const { return profiler_; }
+
+  void clearProfile() { profiler_.clear(); }
+
+  /**
+   * A text summary of the recorded events. \sa OpProfiler::summary.
+   * */
+  std::string profileSummary(uint64_t maxRows = 20) const {
+    return profiler_.summary(graph(), maxRows);
+  }
+
+  /**
+   * Write the recorded events in the Chrome trace event format.
+   * \sa OpProfiler::appendChromeTrace.
+   * */
+  void appendProfileChromeTrace(std::ostream &ost) const {
+    profiler_.appendChromeTrace(ost, graph());
+  }
+
+protected:
+  /**
+   * The profiler with which executables record the ops which they run, or
+   * nullptr if profiling is not enabled.
+   * */
+  OpProfiler *activeProfiler() { return profiling_ ? &profiler_ : nullptr; }
+
 private:
   // Get the host tensor (shared pointer) of #hId.
   virtual HostTensor
@@ -138,6 +182,9 @@ private:
   // that it is not be modified -- all optimizations on the Graph must be run
   // before constructing an executable.
   const Graph graph_;
+
+  bool profiling_{false};
+  OpProfiler profiler_;
 };
 } // namespace compute
 } // namespace common
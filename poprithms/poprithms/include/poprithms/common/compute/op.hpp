@@ -80,6 +80,12 @@ public:
   virtual const Graph &graph() const              = 0;
   virtual const OpIds &schedule(SubGraphId) const = 0;
 
+  /**
+   * Run all of the ops in the sub-graph #sgId. The default implementation
+   * runs them one after another, in the order of #schedule.
+   * */
+  virtual void runSubGraph(SubGraphId sgId);
+
 private:
   virtual void noWeakVTables();
 };
@@ -0,0 +1,161 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMMON_COMPUTE_PROFILER_HPP
+#define POPRITHMS_COMMON_COMPUTE_PROFILER_HPP
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poprithms/common/multiout/opid.hpp>
+#include <poprithms/common/schedulable/subgraphid.hpp>
+
+namespace poprithms {
+namespace common {
+namespace compute {
+
+class Graph;
+
+using poprithms::common::multiout::OpId;
+using poprithms::common::multiout::OpIds;
+using poprithms::common::schedulable::SubGraphId;
+
+/**
+ * Records when the ops of a Graph are run by an executable, and summarizes
+ * where the time is spent. \sa IExecutable::enableProfiling.
+ *
+ * The methods which record events can be called concurrently, from multiple
+ * threads.
+ * */
+class OpProfiler {
+
+public:
+  /**
+   * A single run of an op.
+   * */
+  struct OpEvent {
+    OpId opId;
+
+    /// The ops with callees through which the op was run, outermost first.
+    /// This is empty for the ops of the sub-graph passed to
+    /// IExecutable::run.
+    OpIds callStack;
+
+    /// The start time and duration, in nanoseconds. Times are relative to
+    /// the construction (or most recent #clear) of the profiler.
+    uint64_t startNs;
+    uint64_t durationNs;
+
+    /// A small integer which identifies the thread which ran the op.
+    uint64_t thread;
+  };
+
+  /**
+   * A single call to IExecutable::run.
+   * */
+  struct RunEvent {
+    SubGraphId subGraphId;
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint64_t thread;
+  };
+
+  /**
+   * The accumulated statistics of a set of op runs.
+   * */
+  struct Stats {
+    uint64_t nInvocations{0};
+
+    /// The total time, including the time spent in the ops of callees.
+    double seconds{0};
+
+    /// The total time, excluding the time spent in the ops of callees. For
+    /// ops without callees this is the same as #seconds.
+    double selfSeconds{0};
+
+    /// The total number of bytes of the input and output tensors, over all
+    /// invocations and replicas.
+    uint64_t bytesRead{0};
+    uint64_t bytesWritten{0};
+  };
+
+  OpProfiler();
+  OpProfiler(const OpProfiler &);
+  OpProfiler &operator=(const OpProfiler &);
+
+  /**
+   * The time since this profiler was constructed or cleared, in nanoseconds.
+   * */
+  uint64_t now() const;
+
+  void recordOp(OpId,
+                const OpIds &callStack,
+                uint64_t startNs,
+                uint64_t endNs);
+
+  void recordRun(SubGraphId, uint64_t startNs, uint64_t endNs);
+
+  /**
+   * Remove all recorded events, and restart the clock.
+   * */
+  void clear();
+
+  std::vector<OpEvent> opEvents() const;
+  std::vector<RunEvent> runEvents() const;
+
+  /**
+   * The number of bytes of the inputs (outputs) of op #opId, summed over
+   * replicas.
+   * */
+  static uint64_t bytesRead(const Graph &, OpId opId);
+  static uint64_t bytesWritten(const Graph &, OpId opId);
+
+  /**
+   * Statistics aggregated by op, by op type (the op's type string without
+   * its attributes, such as "Repeat"), and by call stack. The call stack of
+   * an op is a string such as "main/Repeat(op=7)/body", where "main" is the
+   * name of the sub-graph which was run, "Repeat(op=7)" is an op with a
+   * callee, and "body" is the name of the callee sub-graph which contains
+   * the op.
+   * */
+  std::map<OpId, Stats> statsByOp(const Graph &) const;
+  std::map<std::string, Stats> statsByOpType(const Graph &) const;
+  std::map<std::string, Stats> statsByCallStack(const Graph &) const;
+
+  /**
+   * Write all events in the Chrome trace event format. The output can be
+   * loaded in chrome://tracing or https://ui.perfetto.dev.
+   * */
+  void appendChromeTrace(std::ostream &, const Graph &) const;
+
+  /**
+   * A summary of the statistics by op type, by call stack, and by op, each
+   * sorted by decreasing self time and truncated to #maxRows rows.
+   * */
+  std::string summary(const Graph &, uint64_t maxRows = 20) const;
+
+private:
+  uint64_t threadIndex();
+
+  std::string callStackString(const Graph &, const OpEvent &) const;
+
+  // Sum the stats of the ops in #opEvents_, with #key mapping each event to
+  // the key which it is aggregated by.
+  template <typename Key, typename F>
+  std::map<Key, Stats> aggregate(const Graph &, F &&key) const;
+
+  std::chrono::steady_clock::time_point start_;
+  std::vector<OpEvent> opEvents_;
+  std::vector<RunEvent> runEvents_;
+  std::map<std::thread::id, uint64_t> threads_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace compute
+} // namespace common
+} // namespace poprithms
+
+#endif
@@ -0,0 +1,102 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMMON_COMPUTE_PRUNE_INCREMENTALPRUNER_HPP
+#define POPRITHMS_COMMON_COMPUTE_PRUNE_INCREMENTALPRUNER_HPP
+
+#include <set>
+#include <vector>
+
+#include <poprithms/common/compute/graph.hpp>
+
+namespace poprithms {
+namespace common {
+namespace compute {
+
+/**
+ * Prune a compute::Graph repeatedly, as it is transformed.
+ *
+ * After a graph is pruned, every op in it is on a path to a retained
+ * tensor. A transformation can only make an op pruneable by removing some
+ * of its consumers, and so only the ops whose consumers have changed (and
+ * the ops which have been inserted) since the previous prune need to be
+ * examined. An examined op is pruneable if it has no consumers and no
+ * retained outputs, in which case it is removed and its input producers are
+ * examined in turn. As the graph is a DAG, this is equivalent to pruning the
+ * complete graph with Pruner::prune.
+ *
+ * This is only valid for ops in a sub-graph which is runnable and which is
+ * not the callee of any op, and for ops without callees. Pruning ops with
+ * callees requires the call stacks of the callees to be analysed, so when
+ * any op which is examined has callees or is in a callee sub-graph, or when
+ * the graph has tensors with references in other sub-graphs, or when the
+ * runnable sub-graphs have changed, the complete graph is pruned with
+ * Pruner::prune instead.
+ *
+ * All changes to the graph must be made with the methods of the graph, as
+ * they are detected with multiout::Graph::takeConsumerChanges.
+ * */
+class IncrementalPruner {
+public:
+  /**
+   * Prune #g with Pruner::prune, retaining the tensors #retain. The graph
+   * #g must outlive this object.
+   * */
+  IncrementalPruner(Graph &g, const TensorIds &retain);
+
+  /**
+   * Prune all ops in the graph which are not on a path to a retained
+   * tensor. The result is the same as Pruner::prune with the retained
+   * tensors of this object.
+   * */
+  void prune();
+
+  /**
+   * The number of times that the complete graph has been pruned, including
+   * the prune at construction.
+   * */
+  uint64_t nFullPrunes() const { return nFullPrunes_; }
+
+  /**
+   * The number of times that the graph has been pruned by only examining
+   * the ops which have changed.
+   * */
+  uint64_t nIncrementalPrunes() const { return nIncrementalPrunes_; }
+
+  /**
+   * The number of ops examined in the most recent call to #prune, if it was
+   * incremental.
+   * */
+  uint64_t nExamined() const { return nExamined_; }
+
+private:
+  Graph &graph() { return *graph_; }
+
+  void fullPrune();
+
+  // If the op #opId can be examined without analysing call stacks.
+  bool canExamine(OpId opId) const;
+
+  // If no output of #opId is retained or consumed.
+  bool isPruneable(OpId opId) const;
+
+  Graph *graph_;
+  TensorIds retain_;
+  std::set<TensorId> retainSet_;
+
+  // The state of the graph at the previous prune: the runnable sub-graphs,
+  // the sub-graphs which are runnable and not callees, and the first OpId
+  // which had not been created.
+  SubGraphIds runnable_;
+  std::set<SubGraphId> examinable_;
+  bool hasRefs_{false};
+  OpId nxtOpId_{0};
+
+  uint64_t nFullPrunes_{0};
+  uint64_t nIncrementalPrunes_{0};
+  uint64_t nExamined_{0};
+};
+
+} // namespace compute
+} // namespace common
+} // namespace poprithms
+
+#endif
@@ -2,15 +2,96 @@
 #ifndef POPRITHMS_COMMON_COMPUTE_SIMEXECUTABLE_HPP
 #define POPRITHMS_COMMON_COMPUTE_SIMEXECUTABLE_HPP
 
+#include <functional>
+#include <map>
+#include <vector>
+
 #include <poprithms/common/compute/iexecutable.hpp>
+#include <poprithms/compute/host/bufferpool.hpp>
+#include <poprithms/schedule/vanilla/csredges.hpp>
+#include <poprithms/util/copybyclone.hpp>
 
 namespace poprithms {
 namespace common {
 namespace compute {
 
+namespace dataflow {
+class Executor;
+}
+
 using poprithms::common::compute::IExecutable;
 using poprithms::common::compute::SimTensorMap;
 
+/**
+ * How a SimExecutable runs the ops of a sub-graph.
+ * */
+enum class SimExecutionMode {
+  /// One op at a time, in the order of the schedule.
+  Serial = 0,
+
+  /// Ops are run on multiple threads as soon as all of the ops which they
+  /// depend on have completed. The dependencies are the data and control
+  /// dependencies, the constraints which ensure that ops which modify a
+  /// tensor run after all other consumers of its aliases, and additional
+  /// constraints which keep ops which share callees, and ops which use
+  /// tensors which are referenced from other sub-graphs, in the order of the
+  /// schedule. The values computed are therefore the same as with Serial.
+  Dataflow
+};
+
+/**
+ * How a SimExecutable allocates the host tensors which store the values of
+ * the tensors of its graph.
+ * */
+enum class SimMemoryMode {
+  /// Every tensor which is not an alias of another tensor has its own
+  /// allocation, which exists for the lifetime of the SimExecutable.
+  Unplanned = 0,
+
+  /// Intermediate tensors in a sub-graph whose lifetimes (in the schedule of
+  /// the sub-graph) do not overlap share allocations. Tensors which are
+  /// host, remote, variables or constants, or which are referenced from
+  /// other sub-graphs or copied to and from by ops with callees, have their
+  /// own allocations, as with Unplanned. This is only supported with
+  /// SimExecutionMode::Serial.
+  Planned
+};
+
+/**
+ * The host memory used by a SimExecutable to store the values of the tensors
+ * of its graph, and the temporary tensors created while its ops are run.
+ *
+ * The stored values are allocated when the SimExecutable is constructed,
+ * and exist for its lifetime. Temporary tensors are only tracked if the
+ * SimExecutable has a buffer pool (see SimExecutable::enableBufferPool),
+ * in which case the peak simulated host memory is at most
+ * peakBytes + poolPeakBytes.
+ * */
+struct SimMemoryStats {
+  /// The number of bytes allocated for the stored values.
+  uint64_t peakBytes{0};
+
+  /// The number of bytes which would be allocated with
+  /// SimMemoryMode::Unplanned.
+  uint64_t peakBytesUnplanned{0};
+
+  /// The number of tensors which share buffers.
+  uint64_t nPlannedTensors{0};
+
+  /// The number of buffers shared by the planned tensors.
+  uint64_t nBuffers{0};
+
+  /// The peak number of bytes of the buffers of the buffer pool, both those
+  /// in use by temporary tensors and those retained for reuse. This is the
+  /// capacity of the buffers, which is rounded up from the sizes of the
+  /// tensors. It is 0 if there is no buffer pool.
+  uint64_t poolPeakBytes{0};
+
+  /// The number of bytes of the buffers currently retained by the buffer
+  /// pool, which are not in use.
+  uint64_t poolBytesHeld{0};
+};
+
 /**
  * A 'simulator' executable. All tensors, including those which are not
  * DeviceType::Host, are stored only on host, and all code is run on host.
@@ -20,9 +101,43 @@ class SimExecutable : public IExecutable {
 public:
   SimExecutable() = delete;
 
+  /**
+   * The ops of the graph of an executable must not point to any other graph
+   * (see multiout::Graph::bindOps), and so constructing a SimExecutable from
+   * a const Graph clones all of its ops. Constructing it from a Graph which
+   * does not share ops with other graphs does not clone any ops.
+   * */
   SimExecutable(Graph &&m);
   SimExecutable(const Graph &m) : SimExecutable(Graph(m)) {}
 
+  /**
+   * \param mode How the ops of each sub-graph are run.
+   *
+   * \param nThreads The number of threads used to run ops, if #mode is
+   *                 SimExecutionMode::Dataflow. This includes the thread
+   *                 which calls #run. It must be at least 1. The other
+   *                 threads are created here, and are used by all runs.
+   *                 The replica threads (see #setNReplicaThreads) are
+   *                 separate from these.
+   * */
+  SimExecutable(Graph &&m, SimExecutionMode mode, uint64_t nThreads);
+  SimExecutable(const Graph &m, SimExecutionMode mode, uint64_t nThreads)
+      : SimExecutable(Graph(m), mode, nThreads) {}
+
+  /**
+   * \param memoryMode How the host tensors which store the values of the
+   *                   graph's tensors are allocated.
+   * */
+  SimExecutable(Graph &&m,
+                SimExecutionMode mode,
+                uint64_t nThreads,
+                SimMemoryMode memoryMode);
+  SimExecutable(const Graph &m,
+                SimExecutionMode mode,
+                uint64_t nThreads,
+                SimMemoryMode memoryMode)
+      : SimExecutable(Graph(m), mode, nThreads, memoryMode) {}
+
   SimExecutable(SimExecutable &&);
   SimExecutable(const SimExecutable &);
 
@@ -33,7 +148,138 @@ public:
    * */
   const OpIds &schedule(SubGraphId sgId) const { return schedules.at(sgId); }
 
+  /**
+   * Run the replicas of each op concurrently, on up to #n threads. Ops are
+   * still run one after another in the order of the schedule, and all
+   * replicas of an op complete before the next op starts, so that ops which
+   * communicate across replicas (such as ReduceAcrossReplicas) see the
+   * values of all replicas. The default is 1 thread, in which case the
+   * replicas are run one after another. The results do not depend on #n.
+   * */
+  void setNReplicaThreads(uint64_t n) { vals().setNReplicaThreads(n); }
+
+  uint64_t nReplicaThreads() const { return vals().nReplicaThreads(); }
+
+  SimExecutionMode mode() const { return mode_; }
+
+  uint64_t nThreads() const { return nThreads_; }
+
+  SimMemoryMode memoryMode() const { return memoryMode_; }
+
+  /**
+   * Use a host::BufferPool, owned by this executable, for the host tensors
+   * created while ops are run. The buffers of temporary tensors are then
+   * reused across calls to #run, so that repeatedly running a sub-graph
+   * reaches a steady state in which no tensor buffers are allocated. The
+   * pool retains at most #maxBytesHeld bytes of buffers which are not in
+   * use. The pool is not used by default.
+   *
+   * \sa poprithms::compute::host::BufferPool.
+   * */
+  void enableBufferPool(uint64_t maxBytesHeld =
+                            poprithms::compute::host::BufferPool::
+                                defaultMaxBytesHeld());
+
+  /**
+   * Stop using, and destroy, the buffer pool of this executable.
+   * */
+  void disableBufferPool() { bufferPool_.uptr.reset(); }
+
+  /**
+   * The buffer pool of this executable, or nullptr if it does not use one.
+   * */
+  const poprithms::compute::host::BufferPool *bufferPool() const {
+    return bufferPool_.uptr.get();
+  }
+
+  /**
+   * The memory used by this executable. The statistics of the buffer pool
+   * are those at the time of the call.
+   * */
+  SimMemoryStats memoryStats() const;
+
+  /**
+   * The ops of a sub-graph, and the dependencies between them, used when
+   * the mode is SimExecutionMode::Dataflow. The ops include the
+   * initializing ops, which do not run code, as dependencies can be
+   * transferred through them.
+   * */
+  struct DataflowGraph {
+    OpIds ops;
+    poprithms::schedule::vanilla::CsrEdges<uint64_t> edges;
+    std::vector<uint64_t> nIns;
+  };
+
+  const DataflowGraph &dataflowGraph(SubGraphId sgId) const {
+    return dataflowGraphs.at(sgId);
+  }
+
+  /**
+   * A user-provided callback which writes the value of a host or remote
+   * tensor for the iteration #iteration of #runStreaming into #buffers.
+   * There is one buffer for each replica of a remote tensor, and a single
+   * buffer for a host tensor. The buffers have the shape of the tensor.
+   * */
+  using StreamSource =
+      std::function<void(uint64_t iteration, const HostTensors &buffers)>;
+
+  /**
+   * A user-provided callback which receives the value of a host or remote
+   * tensor after the iteration #iteration of #runStreaming. The values
+   * (one for each replica of a remote tensor) are only valid for the
+   * duration of the call.
+   * */
+  using StreamSink =
+      std::function<void(uint64_t iteration, const HostTensors &values)>;
+
+  /**
+   * Register #source as the source of the host or remote tensor #tId, in
+   * all subsequent calls to #runStreaming. This replaces any source already
+   * registered for #tId.
+   * */
+  void setStreamSource(const TensorId &tId, StreamSource source);
+
+  /**
+   * Register #sink as the sink of the host or remote tensor #tId, in all
+   * subsequent calls to #runStreaming. This replaces any sink already
+   * registered for #tId. A tensor can have both a source and a sink.
+   * */
+  void setStreamSink(const TensorId &tId, StreamSink sink);
+
+  /**
+   * Remove all registered stream sources and sinks.
+   * */
+  void clearStreams();
+
+  /**
+   * Run the sub-graph #sgId #nIterations times, streaming the values of the
+   * tensors with registered sources and sinks.
+   *
+   * The streams are double-buffered: while iteration i runs, the sources
+   * write the values of iteration i+1 into staging buffers, and the sinks
+   * receive the values of iteration i-1 from staging buffers, on a
+   * background thread. Between iterations, the staged values are copied
+   * into (and out of) the tensors. The callbacks are therefore never run
+   * concurrently with each other, and are called in the order of the
+   * iterations, but are run concurrently with the ops of the sub-graph.
+   *
+   * The values of the sinks are copied out before the values of the
+   * sources are copied in, so a tensor with both a source and a sink has
+   * the value of its source at the start of each iteration, and its sink
+   * receives the value at the end of each iteration.
+   *
+   * An exception thrown by a callback is rethrown by this method, after all
+   * background work has completed.
+   * */
+  void runStreaming(SubGraphId sgId, uint64_t nIterations);
+
 private:
+  // Verify that #tId is a host or remote tensor, for a stream named #what.
+  void verifyStreamable(const TensorId &tId, const std::string &what) const;
+
+  // Buffers with the shape and type of the stored value of #tId.
+  HostTensors streamBuffers(const TensorId &tId) const;
+
   void executableSpecificRun(SubGraphId) final;
   HostTensor executableSpecificGetHostValue(const TensorId &) const final;
 
@@ -54,6 +300,28 @@ private:
 
   // All of the schedules, one for each sub-graph of the graph.
   std::map<SubGraphId, OpIds> schedules;
+
+  SimExecutionMode mode_;
+  uint64_t nThreads_;
+  SimMemoryMode memoryMode_;
+  SimMemoryStats memoryStats_;
+
+  // One for each sub-graph of the graph, if the mode is Dataflow.
+  std::map<SubGraphId, DataflowGraph> dataflowGraphs;
+
+  // The threads which run the dataflow graphs, if the mode is Dataflow.
+  // They are created with this executable, and used by every run. A copy of
+  // this executable has its own threads.
+  poprithms::util::CopyByClone<dataflow::Executor> executor_;
+
+  // The registered stream sources and sinks, see #runStreaming.
+  std::map<TensorId, StreamSource> streamSources_;
+  std::map<TensorId, StreamSink> streamSinks_;
+
+  // The pool of the host tensors created when ops are run, if enabled. A
+  // copy of this executable has a new, empty, pool.
+  poprithms::util::CopyByClone<poprithms::compute::host::BufferPool>
+      bufferPool_;
 };
 } // namespace compute
 } // namespace common
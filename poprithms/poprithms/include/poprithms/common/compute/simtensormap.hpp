@@ -2,14 +2,17 @@
 #ifndef POPRITHMS_COMMON_COMPUTE_SIMTENSORMAP_HPP
 #define POPRITHMS_COMMON_COMPUTE_SIMTENSORMAP_HPP
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <poprithms/common/multiout/tensormap.hpp>
 #include <poprithms/common/schedulable/subgraphid.hpp>
 #include <poprithms/compute/host/tensor.hpp>
 #include <poprithms/util/circularcounter.hpp>
 #include <poprithms/util/copybyclone.hpp>
+#include <poprithms/util/threadpool.hpp>
 
 namespace poprithms {
 namespace common {
@@ -78,9 +81,89 @@ public:
 
   void incrementCounter(OpId opId) { counters.increment(opId); }
 
+  /**
+   * Set the maximum number of threads used to run the replicas of an op
+   * concurrently. The default is 1, in which case the replicas are run one
+   * after another. #n must be at least 1. The #n - 1 threads which are used
+   * in addition to the calling thread are created here, and are reused by
+   * all ops.
+   * */
+  void setNReplicaThreads(uint64_t n);
+
+  uint64_t nReplicaThreads() const { return nReplicaThreads_; }
+
+  /**
+   * Call f(r) for all r in [0, n), where #n is typically the replication
+   * factor. If nReplicaThreads() is greater than 1, [0, n) is partitioned
+   * into contiguous ranges which are processed on different threads, so the
+   * calls must not modify data which is shared between values of r. If the
+   * threads are already in use, by an op which is run concurrently with
+   * this one, the calls are made on the calling thread.
+   *
+   * This method only returns once f has been called for all r, and so it is
+   * a barrier between consecutive ops. If any of the calls throws, one of
+   * the exceptions is rethrown.
+   * */
+  void replicaParallelFor(uint64_t n,
+                          const std::function<void(uint64_t)> &f) const;
+
+  /**
+   * The host tensors of the inputs and outputs of an op, resolved for each
+   * replica: ins[r][i] is replica r of input i, and outs[r][o] is replica r
+   * of output o.
+   * */
+  struct ReplicatedSlots {
+    std::vector<HostTensors> ins;
+    std::vector<HostTensors> outs;
+  };
+
+  /**
+   * Allocate storage for the resolved slots of #nOps ops. This must be
+   * called before ops are run concurrently, so that #setReplicatedSlots
+   * does not resize the storage. Calling it again clears all slots.
+   * */
+  void initReplicatedSlots(uint64_t nOps);
+
+  /**
+   * The resolved slots of op #opId, or nullptr if they have not been set.
+   *
+   * The host tensors of a SimTensorMap are updated in place once they have
+   * been initialized (see for example HostTensor::update_), so that the
+   * slots of an op remain valid across runs, and can be used instead of
+   * looking up each tensor every time the op is run.
+   * */
+  ReplicatedSlots *replicatedSlots(OpId opId) {
+    const auto i = static_cast<uint64_t>(opId.get());
+    return i < slots_.size() ? slots_[i].get() : nullptr;
+  }
+
+  /**
+   * If storage for the slots of op #opId has been allocated (see
+   * #initReplicatedSlots).
+   * */
+  bool canStoreReplicatedSlots(OpId opId) const {
+    return static_cast<uint64_t>(opId.get()) < slots_.size();
+  }
+
+  /**
+   * Set the resolved slots of op #opId. Ops with different OpIds can set
+   * their slots concurrently.
+   * */
+  void setReplicatedSlots(OpId opId, ReplicatedSlots &&slots);
+
 private:
   poprithms::util::CircularCounters<OpId> counters;
 
+  uint64_t nReplicaThreads_{1};
+
+  // The threads used by #replicaParallelFor, if nReplicaThreads_ > 1. They
+  // are created once, by #setNReplicaThreads, and not for every op. A copy
+  // of this SimTensorMap has its own threads.
+  poprithms::util::CopyByClone<poprithms::util::ThreadPool> replicaPool_;
+
+  // The slots are shared by clones, as the host tensors are.
+  std::vector<std::shared_ptr<ReplicatedSlots>> slots_;
+
   virtual void noWeakVTables();
 };
 
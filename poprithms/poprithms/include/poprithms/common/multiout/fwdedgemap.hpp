@@ -6,6 +6,7 @@
 #include <unordered_map>
 
 #include <poprithms/common/multiout/opid.hpp>
+#include <poprithms/schedule/vanilla/csredges.hpp>
 
 namespace poprithms {
 namespace common {
@@ -63,6 +64,26 @@ public:
    * */
   std::vector<std::vector<uint64_t>> createBwdEdgesCompact() const;
 
+  /**
+   * The forward edges of the compact representation, in compressed sparse
+   * row format. The edges are stored with one vector per op (so that they
+   * can be grown incrementally with #insertEdge), so this is a copy. It
+   * requires 2 allocations, and can be passed to the schedule algorithms
+   * which have overloads for schedule::vanilla::CsrEdges.
+   * */
+  schedule::vanilla::CsrEdges<uint64_t> fwdEdgesCsr() const {
+    return schedule::vanilla::CsrEdges<uint64_t>(fwdEdgesCompact_);
+  }
+
+  /**
+   * The reverse edges of the forward edge map, in compressed sparse row
+   * format. This requires 2 allocations, whereas #createBwdEdgesCompact
+   * requires one per op.
+   * */
+  schedule::vanilla::CsrEdges<uint64_t> createBwdEdgesCsr() const {
+    return schedule::vanilla::CsrEdges<uint64_t>::reversed(fwdEdgesCompact_);
+  }
+
   OpIds outs(OpId opId) const {
     return unpacked(fwdEdgesCompact().at(compactId(opId)));
   }
@@ -3,7 +3,6 @@
 #define POPRITHMS_COMMON_MULTIOUT_GRAPH_HPP
 
 #include <memory>
-#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -16,7 +15,6 @@
 #include <poprithms/common/multiout/removalevent.hpp>
 #include <poprithms/common/multiout/tensorid.hpp>
 #include <poprithms/ndarray/shape.hpp>
-#include <poprithms/util/copybyclone.hpp>
 #include <poprithms/util/stringutil.hpp>
 
 namespace poprithms {
@@ -39,14 +37,27 @@ using ndarray::Shapes;
 class Graph {
 
 public:
-  Graph()          = default;
-  virtual ~Graph() = default;
+  Graph();
+  virtual ~Graph();
 
   /**
    * Graph constructors and assignment operators. The reason these are not
    * 'default' is that Ops contain (const) pointers to their containing
-   * Graphs. When a Graph #a is copied to Graph #b, all of the Ops of #a are
-   * cloned into #b, and then the clones have their pointers updated to #b.
+   * Graphs. When a Graph #a is copied to Graph #b, #b shares all of the Ops
+   * of #a, and so copying a Graph does not clone any Ops. An Op which is
+   * shared is cloned (and the clone has its pointer updated to #b) when it
+   * is modified through #b, and similarly for #a. See #op.
+   *
+   * An Op which is shared points to one of the Graphs which share it, and
+   * reading it reads that Graph. If a Graph stops sharing an Op which points
+   * to it (because the Graph is modified or destroyed), the Op is pointed to
+   * another of the Graphs which share it.
+   *
+   * Graphs which share Ops can be read concurrently, but they cannot be
+   * modified (or destroyed) concurrently with each other, or while another
+   * of them is read from a different thread. To use Graphs which share Ops
+   * from different threads, call #bindOps on each of them from a single
+   * thread first.
    * */
   Graph(Graph &&);
   Graph(const Graph &);
@@ -115,19 +126,57 @@ public:
   uint64_t nOutTensors(const OpIds &) const;
 
   /** The total number of Ops in this Graph. */
-  uint64_t nOps() const { return atts.live_.size(); }
+  uint64_t nOps() const { return atts.live_.size() - atts.nRemovedInLive_; }
+
+  /**
+   * The number of Ops in this Graph which are shared with other Graphs,
+   * because they have not been modified since this Graph was copied (or
+   * since this Graph was copied from).
+   * */
+  uint64_t nSharedOps() const;
+
+  /**
+   * Clone all of the Ops in this Graph which are shared with, or which
+   * point to, other Graphs. After this, this Graph shares no Ops, and so it
+   * can be read and modified concurrently with the Graphs it was copied from
+   * (or to). This modifies the Ops which this Graph shared, and so it must
+   * not be called concurrently with reading or modifying those Graphs.
+   * */
+  void bindOps();
+
+  /**
+   * Start (or stop) recording the Ops whose consumers change. While this is
+   * enabled, every Op which gains or loses a consumer (because an Op is
+   * inserted or removed, or because an input of an Op is replaced) is
+   * recorded. This makes it possible to incrementally update an analysis
+   * of this Graph, see for example compute::IncrementalPruner.
+   * */
+  void setTrackConsumerChanges(bool);
+
+  bool tracksConsumerChanges() const { return atts.trackConsumerChanges_; }
+
+  /**
+   * The Ops whose consumers have changed since the previous call to this
+   * method (or since recording was enabled). An Op can appear more than
+   * once, and might have been removed since its consumers changed.
+   * */
+  OpIds takeConsumerChanges();
 
   /**
    * If an Op #opId was created and not yet removed, return true. Otherwise,
    * return false.
    * */
-  bool isLive(OpId opId) const { return atts.live_.count(opId) != 0; }
+  bool isLive(OpId opId) const {
+    return opId.get() >= 0 &&
+           static_cast<uint64_t>(opId.get()) < atts.ops_.size() &&
+           atts.ops_[static_cast<uint64_t>(opId.get())] != nullptr;
+  }
 
   /** The total number of Ops in this Graph which have 0 outputs. */
   uint64_t nOpsWithZeroOutputs() const;
   uint64_t nWithZeroOutputs(const OpIds &) const;
 
-  int64_t nOps_i64() const { return static_cast<int64_t>(atts.live_.size()); }
+  int64_t nOps_i64() const { return static_cast<int64_t>(nOps()); }
 
   /** \return The number of inputs of the Op #id.*/
   uint64_t nInTensors(OpId id) const;
@@ -207,10 +256,8 @@ public:
   /** The TensorIds of all (live) Tensors in this Graph */
   TensorIds tensorIds() const;
 
-  /** The OpIds of all (live) Ops in this Graph */
-  OpIds opIds() const {
-    return OpIds(atts.live_.cbegin(), atts.live_.cend());
-  }
+  /** The OpIds of all (live) Ops in this Graph, in increasing order. */
+  OpIds opIds() const;
 
   /**
    * Consider a table summarising the Graph, where for each Tensor, and for
@@ -311,7 +358,8 @@ public:
 
   /**
    * Ops in this Graph contain a pointer to Graph. They should all point to
-   * this Graph. Verify that this is the case.
+   * this Graph, or to another Graph which they are shared with. Verify that
+   * this is the case.
    * */
   void verifyOpsConnectedToThisGraph() const;
 
@@ -508,6 +556,13 @@ private:
   /**
    * Return the  id'th Op in the member variable \a ops, performing checks
    * that 0 <= id < nOps().
+   *
+   * The const version does not modify this Graph, and returns the Op even if
+   * it is shared with another Graph. The non-const version replaces an Op
+   * which is shared with another Graph by a clone which points to this
+   * Graph, so that modifying the returned Op does not modify any other
+   * Graph. A reference returned by the const version is therefore not valid
+   * after the non-const version is called with the same OpId.
    * */
   Op &op(OpId id);
   const Op &op(OpId) const;
@@ -518,17 +573,32 @@ private:
   public:
     bool operator==(const Attributes &) const;
 
-    /** All of the Ops in this Graph. The Ops are stored as unique_ptrs
-     * wrapped in the CopyByClone class, which makes them, and thus the class,
-     * copyable. When this Graph is copied, the resulting copy has a clone of
-     * all of the Ops in this Graph.
+    /** All of the Ops in this Graph. The Ops are stored as shared_ptrs,
+     * which makes them, and thus the class, copyable. When this Graph is
+     * copied, the resulting copy shares all of the Ops in this Graph, and
+     * Ops are only cloned when they are modified (see Graph::op).
      */
-    std::vector<poprithms::util::CopyByClone<Op>> ops_;
+    std::vector<std::shared_ptr<Op>> ops_;
 
     /**
-     * The Ops which have not been deleted.
+     * The Ops which have not been deleted, in increasing order. An Op is
+     * live if and only if its entry in #ops_ is not nullptr, so this is not
+     * needed to check if an Op is live, only to iterate over the live Ops.
+     *
+     * So that removing an Op has constant amortized cost, removed Ops are
+     * not erased from this vector immediately. The first #nRemovedInLive_
+     * removals since the last compaction are left in place, and when more
+     * than half of the vector is removed Ops, it is compacted.
      * */
-    std::set<OpId> live_;
+    OpIds live_;
+    uint64_t nRemovedInLive_{0};
+
+    /**
+     * The Ops whose consumers have changed, if #trackConsumerChanges_.
+     * These are not compared in Graph::operator==.
+     * */
+    bool trackConsumerChanges_{false};
+    OpIds consumerChanges_;
 
     /**
      * Every OpId in [0, ops_.size()) corresponds to either a 'live' Op, or to
@@ -542,17 +612,50 @@ private:
     std::string name_;
   } atts;
 
-  const std::vector<poprithms::util::CopyByClone<Op>> &ops() const {
-    return atts.ops_;
-  }
+  const std::vector<std::shared_ptr<Op>> &ops() const { return atts.ops_; }
+
+  std::vector<std::shared_ptr<Op>> &ops() { return atts.ops_; }
+
+  /** Record that the consumers of #opId have changed, if enabled. */
+  void registerConsumersChanged(OpId opId);
+
+  /**
+   * Set the Graph pointed to by the Ops in this Graph which point to
+   * #previous, to this Graph. This is used when a Graph is moved.
+   * */
+  void resetGraphOfOps(const Graph &previous);
+
+  /**
+   * Replace the Op at #opPtr by a clone which points to this Graph, unless
+   * it is not shared with any other Graph, in which case only its pointer
+   * is updated.
+   * */
+  void bindOp(std::shared_ptr<Op> &opPtr);
 
-  std::vector<poprithms::util::CopyByClone<Op>> &ops() { return atts.ops_; }
+  /**
+   * Called before this Graph stops sharing the Op #opPtr. If the Op points
+   * to this Graph, it is pointed to another Graph which shares it.
+   * */
+  void releaseOp(const std::shared_ptr<Op> &opPtr);
 
-  /** Set the Graph pointed to by all Ops in this Graph, to this Graph. */
-  void resetGraphOfOps();
+  /** Call #releaseOp for all of the Ops of this Graph. */
+  void releaseOps();
 
 private:
   virtual void noWeakVTables();
+
+  /**
+   * The Graphs which this Graph was copied from or to (directly, or through
+   * other copies), and so which might share Ops with this Graph.
+   * */
+  class Family;
+  std::shared_ptr<Family> family_;
+
+  void joinFamily(const Graph &);
+  void leaveFamily();
+
+  // Take the place of #g in its family. #g gets a new family.
+  void replaceInFamily(Graph &g);
 };
 
 } // namespace multiout
@@ -480,7 +480,7 @@ private:
     // disabled.
     SubGraphState(const std::string &name)
         : name_(name), eager_(Eager::Disabled), hasLast_(false), last_(-1),
-          ops_({}) {}
+          ops_({}), nRemoved_(0) {}
 
     const std::string &name() const { return name_; }
     bool eagerEnabled() const { return eager_ == Eager::Enabled; }
@@ -491,8 +491,11 @@ private:
 
     bool hasKnownLast() const { return hasLast_; }
 
-    // All the Ops which are in this SubGraph.
-    OpIds ops() const { return OpIds(ops_.cbegin(), ops_.cend()); }
+    // All the Ops which are in this SubGraph, in increasing order. This
+    // includes up to #nRemoved Ops which have been removed, see #removeOp.
+    const OpIds &ops() const { return ops_; }
+
+    uint64_t nRemoved() const { return nRemoved_; }
 
     // Change eager mode.
     void toggleEager(bool);
@@ -506,9 +509,14 @@ private:
       last_    = opId;
     }
 
-    void insertBack(OpId opId) { ops_.insert(/* hint = */ ops_.end(), opId); }
+    // OpIds are increasing, so #ops_ remains sorted.
+    void insertBack(OpId opId) { ops_.push_back(opId); }
 
-    void removeOp(OpId opId);
+    // Remove the op #opId from this SubGraph. So that this has constant
+    // amortized cost, #opId is not erased from #ops_ immediately. When more
+    // than half of #ops_ are removed ops, all ops which are not live in #g
+    // (and #opId) are erased.
+    void removeOp(OpId opId, const Graph &g);
 
   private:
     std::tuple<std::string, Eager, bool, OpId> t() const {
@@ -518,8 +526,8 @@ private:
     Eager eager_;
     bool hasLast_;
     OpId last_;
-    // using a set, to make removing easier, when eventually we get to it.
-    std::set<OpId> ops_;
+    OpIds ops_;
+    uint64_t nRemoved_;
   };
   std::vector<SubGraphState> subGraphStates;
 };
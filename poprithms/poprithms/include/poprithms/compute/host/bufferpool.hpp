@@ -0,0 +1,171 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMPUTE_HOST_BUFFERPOOL_HPP
+#define POPRITHMS_COMPUTE_HOST_BUFFERPOOL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+/**
+ * A pool of the buffers which store the elements of host Tensors.
+ *
+ * Without a pool, every out-of-place operation on a Tensor (add, mul, abs,
+ * reduceSum, etc.) makes a new heap allocation for its result, which is
+ * freed when the result is destroyed. While a BufferPool::Scope of a pool
+ * exists on a thread, the buffers of the Tensors created on that thread
+ * belong to the pool: when such a buffer is freed it is retained by the
+ * pool, and handed out again to a later result of a similar size. A program
+ * which repeatedly performs the same sequence of operations (such as a
+ * SimExecutable which is run multiple times) therefore reaches a steady
+ * state in which no buffers are allocated.
+ *
+ * Buffers are bucketed by size class. There are 4 size classes between
+ * consecutive powers of 2, so a buffer is at most 25% larger than the number
+ * of elements requested. Boolean tensors, which do not store their elements
+ * in a std::vector, are not pooled.
+ *
+ * Pools are independent of each other, and each has its own lock. Buffers
+ * which are freed after their pool has been destroyed are not retained. All
+ * methods are thread-safe.
+ * */
+class BufferPool {
+
+public:
+  /**
+   * Statistics of the use of a pool, accumulated since the pool was
+   * created, or since #resetStats was last called.
+   * */
+  class Stats {
+  public:
+    // The number of buffers requested.
+    uint64_t nAcquisitions{0};
+
+    // The number of requested buffers which were retained buffers, and so
+    // did not require an allocation.
+    uint64_t nHits{0};
+
+    // The number of buffers returned to, and retained by, the pool.
+    uint64_t nReleases{0};
+
+    // The number of buffers returned to the pool which were freed, because
+    // retaining them would take the pool over #maxBytesHeld.
+    uint64_t nRejections{0};
+
+    // The number of bytes of the buffers of the pool which are in use by
+    // Tensors. This is the capacity of the buffers, which might be more
+    // than the number of bytes of the Tensors.
+    uint64_t nBytesInUse{0};
+
+    // The number of bytes retained by the pool, which are not in use.
+    uint64_t nBytesHeld{0};
+
+    // The maximum value of nBytesInUse.
+    uint64_t peakBytesInUse{0};
+
+    // The maximum value of nBytesHeld.
+    uint64_t peakBytesHeld{0};
+
+    // The maximum value of nBytesInUse + nBytesHeld. This is the peak host
+    // memory of the buffers which belong to the pool.
+    uint64_t peakBytes{0};
+
+    uint64_t nMisses() const { return nAcquisitions - nHits; }
+
+    // The fraction of acquisitions which are hits (1 if there have been no
+    // acquisitions).
+    double hitRate() const;
+
+    void append(std::ostream &) const;
+  };
+
+  /**
+   * \param maxBytesHeld The maximum number of bytes which the pool retains.
+   *                     Buffers which are returned to the pool when it is
+   *                     full are freed.
+   * */
+  explicit BufferPool(uint64_t maxBytesHeld = defaultMaxBytesHeld());
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  /**
+   * All retained buffers are freed. Buffers which are in use are freed when
+   * their Tensors are destroyed.
+   * */
+  ~BufferPool();
+
+  /**
+   * A new, empty pool with the same maximum number of bytes held as this
+   * pool.
+   * */
+  std::unique_ptr<BufferPool> clone() const;
+
+  // The state of a pool, shared with the buffers which belong to it.
+  class Impl;
+
+  /**
+   * While an object of this class exists, Tensors created on the thread
+   * which created it take their buffers from, and return their buffers to,
+   * #pool. Scopes can be nested, the innermost Scope of a thread is the one
+   * which is active.
+   * */
+  class Scope {
+  public:
+    explicit Scope(const BufferPool &pool) : Scope(pool.impl) {}
+
+    /**
+     * Use the pool #pool, obtained from #current on another thread. If
+     * #pool is nullptr, Tensors created on this thread do not use a pool.
+     * */
+    explicit Scope(std::shared_ptr<Impl> pool);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    std::shared_ptr<Impl> previous;
+  };
+
+  /**
+   * The pool of the innermost Scope of the calling thread, or nullptr if the
+   * thread has no Scope. It can be passed to a Scope on another thread, so
+   * that the Tensors created on that thread use the same pool.
+   * */
+  static std::shared_ptr<Impl> current();
+
+  Stats stats() const;
+
+  /**
+   * Reset all of the counters to zero, and the peak numbers of bytes to the
+   * current numbers of bytes.
+   * */
+  void resetStats();
+
+  /**
+   * Free all of the buffers retained by the pool.
+   * */
+  void clear();
+
+  uint64_t maxBytesHeld() const;
+  void setMaxBytesHeld(uint64_t);
+
+  /**
+   * The default maximum number of bytes held, 64MB.
+   * */
+  static uint64_t defaultMaxBytesHeld() { return uint64_t(64) << 20; }
+
+private:
+  std::shared_ptr<Impl> impl;
+};
+
+std::ostream &operator<<(std::ostream &, const BufferPool::Stats &);
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
+
+#endif
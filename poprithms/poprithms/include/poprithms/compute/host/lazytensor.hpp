@@ -0,0 +1,151 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMPUTE_HOST_LAZYTENSOR_HPP
+#define POPRITHMS_COMPUTE_HOST_LAZYTENSOR_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <poprithms/compute/host/tensor.hpp>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+/**
+ * A lazily evaluated chain of elementwise operations on host Tensors.
+ *
+ * Every out-of-place operation on a Tensor allocates a new buffer for its
+ * result. For a chain of elementwise operations such as
+ *
+ * <code>
+ *    auto d = a.mul(b).add(c).relu();
+ * </code>
+ *
+ * the intermediate results a*b and a*b+c are each allocated, written, and
+ * then read once. With this class, the operations are recorded and only
+ * performed when the value is required, in a single pass over memory which
+ * allocates just the final result:
+ *
+ * <code>
+ *    auto d = a.lazy().mul(b).add(c).relu().eval();
+ * </code>
+ *
+ * The elements of the output are computed in blocks which fit in cache, so
+ * that every intermediate value of an element is consumed soon after it is
+ * produced.
+ *
+ * Only elementwise operations are recorded. To apply any other operation
+ * (a reduction, a view change, a matmul, etc.) the LazyTensor must first be
+ * evaluated with #eval. The rules for broadcasting and for types are the
+ * same as for the corresponding (eager) Tensor methods: shapes are numpy
+ * broadcast, and no implicit type casting is performed.
+ *
+ * Tensors are referenced, not copied, when they are recorded. If a Tensor
+ * which is an input to a LazyTensor is modified (inplace) before the
+ * LazyTensor is evaluated, the evaluation uses the modified values.
+ * */
+class LazyTensor {
+
+public:
+  /** A LazyTensor whose value is the Tensor #t. */
+  explicit LazyTensor(const Tensor &t);
+
+  const Shape &shape() const;
+  DType dtype() const;
+  uint64_t nelms_u64() const { return shape().nelms_u64(); }
+
+  /**
+   * Elementwise binary operations, with numpy-style broadcasting.
+   * \sa the corresponding Tensor methods.
+   * */
+  LazyTensor add(const LazyTensor &rhs) const;
+  LazyTensor mul(const LazyTensor &rhs) const;
+  LazyTensor subtract(const LazyTensor &rhs) const;
+  LazyTensor divide(const LazyTensor &rhs) const;
+  LazyTensor max(const LazyTensor &rhs) const;
+  LazyTensor min(const LazyTensor &rhs) const;
+  LazyTensor pow(const LazyTensor &rhs) const;
+  LazyTensor mod(const LazyTensor &rhs) const;
+
+  LazyTensor add(const Tensor &rhs) const { return add(LazyTensor(rhs)); }
+  LazyTensor mul(const Tensor &rhs) const { return mul(LazyTensor(rhs)); }
+  LazyTensor subtract(const Tensor &rhs) const {
+    return subtract(LazyTensor(rhs));
+  }
+  LazyTensor divide(const Tensor &rhs) const {
+    return divide(LazyTensor(rhs));
+  }
+  LazyTensor max(const Tensor &rhs) const { return max(LazyTensor(rhs)); }
+  LazyTensor min(const Tensor &rhs) const { return min(LazyTensor(rhs)); }
+  LazyTensor pow(const Tensor &rhs) const { return pow(LazyTensor(rhs)); }
+  LazyTensor mod(const Tensor &rhs) const { return mod(LazyTensor(rhs)); }
+
+  /**
+   * Elementwise binary operations with a scalar, which must be exactly
+   * representable in this LazyTensor's type. \sa Tensor::safeScalar.
+   * */
+  LazyTensor add(double v) const { return add(safeScalar(v)); }
+  LazyTensor mul(double v) const { return mul(safeScalar(v)); }
+  LazyTensor subtract(double v) const { return subtract(safeScalar(v)); }
+  LazyTensor divide(double v) const { return divide(safeScalar(v)); }
+  LazyTensor max(double v) const { return max(safeScalar(v)); }
+  LazyTensor min(double v) const { return min(safeScalar(v)); }
+  LazyTensor pow(double v) const { return pow(safeScalar(v)); }
+
+  /**
+   * Elementwise unary operations. \sa the corresponding Tensor methods.
+   * */
+  LazyTensor abs() const;
+  LazyTensor exp() const;
+  LazyTensor log() const;
+  LazyTensor sqrt() const;
+  LazyTensor sin() const;
+  LazyTensor cos() const;
+  LazyTensor ceil() const;
+  LazyTensor floor() const;
+  LazyTensor reciprocal() const;
+  LazyTensor neg() const;
+  LazyTensor relu() const;
+
+  /**
+   * Perform all of the recorded operations in a single pass, and return the
+   * result in a new allocation.
+   * */
+  Tensor eval() const;
+
+  /** Evaluate, and return the values of the result. \sa Tensor::values. */
+  std::string values() const { return eval().values(); }
+
+  /**
+   * The number of elementwise operations which will be performed per
+   * element when this LazyTensor is evaluated. Operations which appear
+   * multiple times in the expression (for example 'x' in x.mul(x)) are only
+   * counted, and performed, once.
+   * */
+  uint64_t nOps() const;
+
+  void append(std::ostream &) const;
+
+private:
+  enum class OpType;
+  class Node;
+  class Evaluator;
+
+  LazyTensor(std::shared_ptr<const Node> n) : node_(std::move(n)) {}
+  LazyTensor binary(OpType, const LazyTensor &rhs) const;
+  LazyTensor unary(OpType) const;
+  LazyTensor safeScalar(double v) const {
+    return LazyTensor(Tensor::safeScalar(dtype(), v));
+  }
+
+  std::shared_ptr<const Node> node_;
+};
+
+std::ostream &operator<<(std::ostream &, const LazyTensor &);
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
+
+#endif
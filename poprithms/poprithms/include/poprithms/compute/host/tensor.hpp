@@ -33,6 +33,7 @@ using Upper                 = Shape::Upper;
 class Tensor;
 using Tensors = std::vector<Tensor>;
 class BaseData;
+class LazyTensor;
 
 enum class CommutativeOp { Sum, Min, Max, Product };
 std::ostream &operator<<(std::ostream &, CommutativeOp);
@@ -551,6 +552,14 @@ public:
    * */
   bool containsAliases() const;
 
+  /**
+   * \return true iff any element of this Tensor is in memory which must not
+   *         be written to. This is the case for Tensors created with #mapRaw
+   *         and #mapNpy in MapMode::ReadOnly, and for all of their aliases.
+   *         Inplace methods on such a Tensor throw an error.
+   * */
+  bool isReadOnly() const;
+
   /** Append information about this Tensor to \p outputStream */
   void append(std::ostream &outputStream) const;
 
@@ -1386,11 +1395,123 @@ public:
    * */
   static Tensor uninitializedRef(const Shape &s, const DType t);
 
+  /**
+   * How a file is mapped into memory by #mapRaw and #mapNpy.
+   *
+   * ReadOnly: The pages of the file are shared with all other processes
+   *           which map the file. The tensor must not be modified: inplace
+   *           methods on it, and on all of its aliases, throw an error.
+   *           \sa isReadOnly.
+   *
+   * CopyOnWrite: The tensor may be modified. A page of the file is privately
+   *              copied when it is first written to, so the file (and other
+   *              processes which map it) never see the modifications.
+   * */
+  enum class MapMode { ReadOnly = 0, CopyOnWrite };
+
+  /**
+   * Create a tensor of type #t and shape #s, whose elements are the raw,
+   * row-major, little-endian values in the file #filename, starting at byte
+   * #byteOffset.
+   *
+   * The file is memory mapped, and no copy of it is made. Elements are read
+   * from the file lazily, as they are accessed. The mapping is kept alive
+   * until this tensor and all tensors which alias it are destroyed. In this
+   * sense the returned tensor is like a tensor created with #refFloat64,
+   * except that it manages the lifetime of the memory it references.
+   *
+   * \param byteOffset The offset in bytes into the file of the first element
+   *                   of the tensor. It must be a multiple of the size of
+   *                   #t. The file must contain at least s.nelms() elements
+   *                   after this offset.
+   * */
+  static Tensor mapRaw(DType t,
+                       const Shape &s,
+                       const std::string &filename,
+                       MapMode mode,
+                       uint64_t byteOffset = 0);
+
+  /**
+   * Create a tensor from the memory mapped .npy file #filename. The type and
+   * shape of the tensor are read from the header of the file. Only
+   * little-endian C-ordered (row-major) arrays are supported.
+   *
+   * \sa mapRaw.
+   * */
+  static Tensor mapNpy(const std::string &filename, MapMode mode);
+
+  /**
+   * Start recording a chain of elementwise operations on this Tensor, which
+   * are only performed when the result is required. \sa LazyTensor.
+   * */
+  LazyTensor lazy() const;
+
+  /**
+   * Destination passing versions of outplace methods. The result of the
+   * outplace method is written into #out, which must have the Shape and
+   * DType of the result. For example,
+   *
+   * <code>
+   *    a.addInto(b, out);
+   * </code>
+   *
+   * has the same effect as out.update_(a.add(b)). If #out has contiguous
+   * (origin) data, the result is written directly into it and no tensor is
+   * allocated for the result. Otherwise the result is computed and then
+   * copied into #out.
+   *
+   * #out must not partially alias this Tensor or #rhs. For the elementwise
+   * methods, #out may be exactly the same as an input.
+   * */
+  void addInto(const Tensor &rhs, const Tensor &out) const;
+  void subtractInto(const Tensor &rhs, const Tensor &out) const;
+  void mulInto(const Tensor &rhs, const Tensor &out) const;
+  void divideInto(const Tensor &rhs, const Tensor &out) const;
+  void powInto(const Tensor &rhs, const Tensor &out) const;
+  void modInto(const Tensor &rhs, const Tensor &out) const;
+  void minInto(const Tensor &rhs, const Tensor &out) const;
+  void maxInto(const Tensor &rhs, const Tensor &out) const;
+
+  /**
+   * Comparisons, where #out is of type Boolean.
+   * */
+  void greaterThanInto(const Tensor &rhs, const Tensor &out) const;
+  void equalToInto(const Tensor &rhs, const Tensor &out) const;
+
+  void absInto(const Tensor &out) const;
+  void expInto(const Tensor &out) const;
+  void logInto(const Tensor &out) const;
+  void sqrtInto(const Tensor &out) const;
+  void sinInto(const Tensor &out) const;
+  void cosInto(const Tensor &out) const;
+  void negInto(const Tensor &out) const;
+  void reciprocalInto(const Tensor &out) const;
+
+  /**
+   * Cast this Tensor to the DType of #out, writing the result into #out.
+   * */
+  void toInto(const Tensor &out) const;
+
+  /**
+   * Matrix multiplication, where #out may be of a different DType to this
+   * Tensor and #rhs. In this case the result is cast to the DType of #out.
+   * */
+  void matmulInto(const Tensor &rhs, const Tensor &out) const;
+
+  /**
+   * Reduce this Tensor to the Shape of #out.
+   * */
+  void reduceInto(const Tensor &out, CommutativeOp) const;
+
 private:
   // get the BaseData for each Tensor in tIns.
   static std::vector<const BaseData *> getBaseDataPtrs(const Tensors &tIns);
 
   const BaseData &tData() const { return *tData_; }
+
+  // The BaseData of this Tensor, which #method is about to modify. An error
+  // is thrown if this Tensor is read-only.
+  const BaseData &mutableTData(const char *method) const;
   Tensor(const Shape &shape__,
          DType dtype__,
          std::shared_ptr<BaseData> tData__)
@@ -1420,6 +1541,9 @@ private:
   // shared_ptrs, polymorphic base pointers, etc.
   friend class Serializer;
 
+  // LazyTensor creates Tensors directly from the buffers it evaluates into.
+  friend class LazyTensor;
+
   void assertValidReshape(const Shape &) const;
 
   /** Verify that the values in this Tensor can be scattered into a Tensor of
@@ -1436,6 +1560,7 @@ private:
   class Zeros;
   class Ones;
   class UninitializedPointer;
+  class FileMapper;
 
   void assertContainsAliases(bool) const;
 
@@ -65,11 +65,14 @@ private:
 class Graph {
 
 public:
-  Graph()                         = default;
-  Graph(const Graph &)            = default;
-  Graph(Graph &&)                 = default;
-  Graph &operator=(const Graph &) = default;
-  Graph &operator=(Graph &&)      = default;
+  Graph() = default;
+
+  // The Nodes of a Graph point to the Graph which they belong to, so these
+  // methods reset the Graph of all Nodes.
+  Graph(const Graph &);
+  Graph(Graph &&);
+  Graph &operator=(const Graph &);
+  Graph &operator=(Graph &&);
 
   // defined in source file to support members which are pointers to forward
   // declared Classes (Node).
@@ -445,8 +448,8 @@ public:
    * The regions of the allocation tensor #alloc which the tensor #query
    * aliases.
    * */
-  const std::vector<DisjointRegions> &allocRegions(TensorId query,
-                                                   TensorId alloc) const;
+  std::vector<DisjointRegions> allocRegions(TensorId query,
+                                            TensorId alloc) const;
 
 private:
   Node &node(TensorId);
@@ -466,6 +469,25 @@ private:
   using UpNode = util::CopyByClone<Node>;
   std::vector<UpNode> nodes;
 
+  /** Set the Graph pointed to by all Nodes in this Graph, to this Graph. */
+  void resetGraphOfNodes();
+
+  // An inverted index of the Origins of the Tensors: the i'th element is the
+  // set of all Tensors which have an Origin in the allocation with AllocId
+  // i. Two Tensors can only be aliased if they share an allocation, so
+  // alias queries need only visit the Tensors in these sets. It is updated
+  // whenever the Origins of a Tensor are set.
+  std::vector<std::set<TensorId>> allocUsers;
+
+  // add (remove) the Tensor #id to (from) the sets in allocUsers of each of
+  // its allocations.
+  void indexOrigins(TensorId id);
+  void unindexOrigins(TensorId id);
+
+  // All Tensors which share at least one allocation with #id, in ascending
+  // order.
+  TensorIds sharedAllocationTensors(TensorId id) const;
+
   // a mutable workspace used for depth-first searches.
   class Workspace {
   public:
@@ -507,7 +529,7 @@ private:
   // traverse back collecting all Tensors
   TensorIds depthFirstBwdAll(TensorId id) const;
 
-  // set the Origins of Tensor with id `id'
+  // set the Origins of Tensor with id `id', and update allocUsers.
   void setOrigins(TensorId id);
 
   std::vector<Shape> getShapes(const TensorIds &) const;
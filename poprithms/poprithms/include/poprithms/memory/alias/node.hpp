@@ -141,6 +141,9 @@ public:
 
   const Origins &origins() const { return origins_; }
 
+  /** Set the Graph which this Node belongs to. */
+  void setGraph(const Graph &g) { pGraph_ = &g; }
+
 private:
   const Graph &graph() const { return *pGraph_; }
   std::vector<TensorId> ins_;
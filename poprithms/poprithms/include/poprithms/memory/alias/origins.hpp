@@ -2,7 +2,10 @@
 #ifndef POPRITHMS_MEMORY_ALIAS_ORIGINS_HPP
 #define POPRITHMS_MEMORY_ALIAS_ORIGINS_HPP
 
-#include <map>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
 
 #include <poprithms/memory/alias/usings.hpp>
 #include <poprithms/memory/nest/region.hpp>
@@ -25,10 +28,16 @@ using nest::Region;
  *   so that C is a shape=(3,2) Tensor.
  *
  * The Origins for C will represent the regions in the origin allocations
- * A and B which C used. In particular, the member oMap stores:
+ * A and B which C used. In particular, the allocations stored are:
  *
  *   {"A" : {"the full (2,2) Region"}, "B" : {"a (1, 2) slice"} }.
  *
+ * Most Tensors are composed of exactly 1 allocation, through exactly 1
+ * DisjointRegions, so the allocation with the smallest AllocId is stored
+ * inline, as is the first DisjointRegions of each allocation. Any other
+ * allocations are stored in a vector sorted by AllocId, and any other
+ * DisjointRegions of an allocation in a vector.
+ *
  */
 class Origins {
 public:
@@ -60,9 +69,8 @@ public:
 
   std::unique_ptr<Origins> clone() const;
 
-  const std::vector<DisjointRegions> &at(AllocId id) const {
-    return oMap.at(id);
-  }
+  /** The Regions of allocation #id. This Origins must contain #id. */
+  std::vector<DisjointRegions> at(AllocId id) const;
 
   /** \return true iff there are any duplicated allocation addresses */
   bool containsAliases() const;
@@ -80,7 +88,7 @@ public:
    * which poplar's isContiguous return true.
    *
    * \return true if
-   *          1) oMap has more than 1 key,
+   *          1) there is at most 1 allocation with a non-empty Region,
    *          2) containsAliases() is false,
    *          3) the elements form a row-major contiguous set
    *
@@ -90,27 +98,103 @@ public:
   void append(std::ostream &) const;
 
   void clear() {
-    oMap.clear();
+    first    = Entry();
+    hasFirst = false;
+    rest.clear();
     sumTotalRegionSizes = 0;
+    nRepeatedAllocs     = 0;
   }
 
-  /** map all keys `k' in oMap, to crt[k]. */
+  /** map all allocations `k', to crt[k]. */
   Origins remap(const std::vector<uint64_t> &crt) const;
 
 private:
-  // A map from AllocId to DisjointRegions. Design decision: We could have
-  // std::map<AllocId, DisjointRegions>, that is, a single DisjointRegions
-  // instead of a vector of them. Using this non-vector approach would require
-  // subtracting DisjointRegions and only inserting the novel elements. For
-  // many uses of Origins, this is unnecessary and the required information
-  // can be obtained without doing the subtraction. Thus taking this lazy/jit
-  // approach of keeping a vector of DisjointRegions, the union of which
-  // represents all the addresses of the allocation (the key) aliased.
-  std::map<AllocId, std::vector<DisjointRegions>> oMap;
+  // An allocation, and the DisjointRegions of it which are aliased. Design
+  // decision: We could have a single DisjointRegions instead of a list of
+  // them. Using this non-list approach would require subtracting
+  // DisjointRegions and only inserting the novel elements. For many uses of
+  // Origins, this is unnecessary and the required information can be
+  // obtained without doing the subtraction. Thus taking this lazy/jit
+  // approach of keeping a list of DisjointRegions, the union of which
+  // represents all the addresses of the allocation aliased.
+  //
+  // The first DisjointRegions is stored inline, so that the list does not
+  // allocate unless it has more than 1 element.
+  class Entry {
+  public:
+    Entry(AllocId id_, const DisjointRegions &regs) : id(id_), head(regs) {}
+
+    // A placeholder, which does not allocate.
+    Entry()
+        : id(0),
+          head(DisjointRegions::createEmpty(Shape(std::vector<int64_t>{}))) {}
+
+    AllocId id;
+
+    uint64_t size() const { return 1 + tail.size(); }
+    const DisjointRegions &operator[](uint64_t i) const {
+      return i == 0 ? head : tail[i - 1];
+    }
+    void push_back(const DisjointRegions &regs) { tail.push_back(regs); }
+
+    // The union of all of the DisjointRegions.
+    DisjointRegions createUnion() const;
+
+    std::vector<DisjointRegions> toVector() const;
+
+    class const_iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = DisjointRegions;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = const DisjointRegions *;
+      using reference         = const DisjointRegions &;
+
+      const_iterator(const Entry &e, uint64_t i) : e_(&e), i_(i) {}
+      const DisjointRegions &operator*() const { return (*e_)[i_]; }
+      const DisjointRegions *operator->() const { return &(*e_)[i_]; }
+      const_iterator &operator++() {
+        ++i_;
+        return *this;
+      }
+      bool operator==(const const_iterator &r) const { return i_ == r.i_; }
+      bool operator!=(const const_iterator &r) const { return i_ != r.i_; }
+
+    private:
+      const Entry *e_;
+      uint64_t i_;
+    };
+
+    const_iterator begin() const { return {*this, 0}; }
+    const_iterator end() const { return {*this, size()}; }
+
+  private:
+    DisjointRegions head;
+    std::vector<DisjointRegions> tail;
+  };
+
+  // The allocation with the smallest AllocId, if #hasFirst is true (if there
+  // are any allocations).
+  Entry first;
+  bool hasFirst{false};
+
+  // All other allocations, in increasing order of AllocId.
+  std::vector<Entry> rest;
+
+  uint64_t nEntries() const { return hasFirst ? 1 + rest.size() : 0; }
+  const Entry &entry(uint64_t i) const { return i == 0 ? first : rest[i - 1]; }
+
+  // The Entry of allocation #id, or nullptr if there is none.
+  const Entry *find(AllocId id) const;
 
   Shape shape;
   uint64_t sumTotalRegionSizes{0};
   void incrementSumTotalRegionSizes(uint64_t);
+
+  // The number of times a DisjointRegions has been inserted for an
+  // allocation which already had one. If this is 0, no element is
+  // registered twice, as the Regions of a DisjointRegions are disjoint.
+  uint64_t nRepeatedAllocs{0};
 };
 
 std::ostream &operator<<(std::ostream &, const Origins &);
@@ -234,6 +234,48 @@ public:
   bool operator==(const Chain &rhs) const;
   bool operator!=(const Chain &rhs) const { return !operator==(rhs); }
 
+  /**
+   * A randomized test of functional equivalence. Both Chains are applied to
+   * #nTrials host::Tensors of random integers, generated from #seed. If any
+   * of the outputs differ, false is returned, and the Chains are certainly
+   * not equivalent.
+   *
+   * Every element of a Chain's output is a sum of elements of its input (or
+   * 0), and so if the Chains are not equivalent, the difference between
+   * their outputs is a non-zero linear function of the input. The
+   * probability that such a function is 0 for uniformly random integers in
+   * [-2^20, 2^20] is less than 2^-20, so the probability that this method
+   * returns true for Chains which are not equivalent is less than
+   * 2^(-20*nTrials).
+   * */
+  bool randomlyEquivalent(const Chain &rhs,
+                          uint64_t nTrials = 2,
+                          uint32_t seed    = 1011) const;
+
+  /**
+   * Check for functional equivalence. That is, whether this Chain and #rhs
+   * map every input to the same output, even if their Ops differ.
+   *
+   * Chains which are equal (see operator==) are equivalent. Otherwise, the
+   * Chains are compared with #randomlyEquivalent, which is fast and rejects
+   * most Chains which are not equivalent. If they pass, their canonicalized
+   * Chains are compared, and if these differ, each element of the input is
+   * mapped through both Chains as a single element Region. If the Chains
+   * contain no Reduce, the final comparison is exact. With Reduce, it
+   * compares which output elements each input element contributes to, but
+   * not how many times, and so relies on the randomized test for this.
+   *
+   * Cost: the randomized test allocates and maps a host::Tensor of the
+   * input Shape, and so is O(nelms). The final, element-wise comparison
+   * maps nelms single element Regions through both Chains, and so is
+   * O(nelms) times the cost of applying a Chain to a Region. It is only
+   * reached for Chains which pass the randomized test but have different
+   * canonicalized Chains. For large Shapes, where this is too slow, compare
+   * canonicalized Chains with operator== instead, which is symbolic but can
+   * return false for Chains which are equivalent.
+   * */
+  bool equivalent(const Chain &rhs) const;
+
   /** Confirm that #rhs is equal to this Chain. If it is not, a descriptive
    * error is thrown. */
   void confirmEqual(const Chain &, const std::string &ctx = {}) const;
@@ -0,0 +1,26 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_MEMORY_INPLACE_ALIAS_CACHE_DEBUG_HPP
+#define POPRITHMS_MEMORY_INPLACE_ALIAS_CACHE_DEBUG_HPP
+
+#include <ostream>
+
+namespace poprithms {
+namespace memory {
+namespace inplace {
+
+/// The aliases of Tensors are cached by a Graph while it is processing
+/// Proposals to open AliasGates. This enum class defines whether every
+/// cached answer is verified against the answer computed without the cache.
+/// Verification is slow, it is intended for debugging.
+enum class AliasCacheDebug {
+  Off = 0, ///< Trust the cache.
+  On       ///< Compare every cached answer to the uncached answer, and throw
+           ///< an error if they differ.
+};
+std::ostream &operator<<(std::ostream &, AliasCacheDebug);
+
+} // namespace inplace
+} // namespace memory
+} // namespace poprithms
+
+#endif
@@ -5,12 +5,16 @@
 #include <array>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <poprithms/common/multiout/consumptionid.hpp>
 #include <poprithms/common/multiout/graph.hpp>
 #include <poprithms/common/multiout/tensorid.hpp>
 #include <poprithms/memory/alias/graph.hpp>
+#include <poprithms/memory/inplace/aliascachedebug.hpp>
 #include <poprithms/memory/inplace/allowmultigatealias.hpp>
 #include <poprithms/memory/inplace/checkparallelwriteable.hpp>
 #include <poprithms/memory/inplace/constantpadding.hpp>
@@ -18,6 +22,8 @@
 #include <poprithms/memory/inplace/padding.hpp>
 #include <poprithms/memory/inplace/proposal.hpp>
 #include <poprithms/memory/inplace/result.hpp>
+#include <poprithms/memory/inplace/scheduleupdate.hpp>
+#include <poprithms/memory/inplace/scheduleupdatestats.hpp>
 #include <poprithms/memory/inplace/tensormap.hpp>
 #include <poprithms/memory/nest/region.hpp>
 #include <poprithms/util/copybyclone.hpp>
@@ -315,11 +321,68 @@ public:
   /** Revert the changes made in tryOpeningPartial, if there were any */
   void backoutOpening(const Proposal &);
 
+  /**
+   * Set whether the aliases cached while processing Proposals are verified
+   * against the aliases computed without the cache. \sa AliasCacheDebug.
+   * */
+  void setAliasCacheDebug(AliasCacheDebug d) { aliasCacheDebug_ = d; }
+  AliasCacheDebug aliasCacheDebug() const { return aliasCacheDebug_; }
+
+  /**
+   * Set how the schedule is changed when a Proposal requires it to change.
+   * The default, ScheduleUpdate::Full, computes the schedule from scratch.
+   * \sa ScheduleUpdate.
+   * */
+  void setScheduleUpdate(ScheduleUpdate u) { scheduleUpdate_ = u; }
+  ScheduleUpdate scheduleUpdate() const { return scheduleUpdate_; }
+
+  /**
+   * Counters of how the schedule has been updated while processing
+   * Proposals. \sa ScheduleUpdateStats.
+   * */
+  const ScheduleUpdateStats &scheduleUpdateStats() const {
+    return scheduleUpdateStats_;
+  }
+  void resetScheduleUpdateStats() { scheduleUpdateStats_ = {}; }
+
   /** Attempt Proposals in order, returning OpeningResults for each */
   OpeningStatuses tryOpenings(const Proposals &,
                               CheckParallelWriteable,
                               AllowMultiGateAlias = AllowMultiGateAlias::Yes);
 
+  /**
+   * Attempt Proposals in order, returning the same OpeningStatuses as
+   * #tryOpenings, but processing independent Proposals concurrently on
+   * #nThreads threads.
+   *
+   * Proposals are independent if their AliasGates are in different weakly
+   * connected components of this Graph (where Constraints are edges too).
+   * Tensors in different components are never aliased, and the relative
+   * schedule of the Ops in one component is not changed by opening an
+   * AliasGate in another, so the Proposals of one component can be
+   * processed without knowing the outcomes of the Proposals of any other.
+   *
+   * The Proposals are grouped by component, preserving their order, and
+   * each thread processes groups on its own copy of this Graph. The
+   * openings, Constraints and schedule changes are then copied back to this
+   * Graph. If there is only one group, this is equivalent to #tryOpenings.
+   *
+   * The copies of this Graph are made by the first batch, and kept for the
+   * next batch if this Graph is not changed in between, so they cost the
+   * memory of #nThreads Graphs until this Graph is destroyed.
+   *
+   * A schedule computed from scratch is not a function of each component
+   * alone, so the Proposals are only processed concurrently if this Graph's
+   * ScheduleUpdate is Incremental (or IncrementalDebug). With the default
+   * ScheduleUpdate::Full, this method is exactly #tryOpenings, and runs on
+   * the calling thread only. See #setScheduleUpdate.
+   * */
+  OpeningStatuses
+  tryOpeningsBatched(const Proposals &,
+                     CheckParallelWriteable,
+                     AllowMultiGateAlias,
+                     uint64_t nThreads);
+
   OpeningStatuses
   tryOpenings0(const TensorIds &,
                CheckParallelWriteable,
@@ -514,6 +577,34 @@ private:
   std::vector<OpId> sched;
   std::vector<uint64_t> invSched;
   bool scheduleIsValid{false};
+  ScheduleUpdate scheduleUpdate_{ScheduleUpdate::Full};
+  ScheduleUpdateStats scheduleUpdateStats_;
+
+  // The schedule changes made by the last call to tryOpeningPartial, which
+  // updated the schedule incrementally, in place. Each entry is a schedule
+  // index and the Op which was at that index. These are reverted, in
+  // reverse order, if the opening is backed out.
+  std::vector<std::pair<uint64_t, OpId>> pendingScheduleChanges;
+  void revertPendingScheduleChanges();
+
+  // Compute the schedule from scratch. #ctxt is used in the error message if
+  // there is a cycle.
+  void computeSchedule(const std::string &ctxt);
+
+  // Update the schedule in place, so that it satisfies the Constraints #cs
+  // as well as all of the edges of this Graph. This is the online
+  // topological ordering algorithm of Pearce and Kelly: for each violated
+  // Constraint a->b, the Ops which must move are found by searching forwards
+  // from b and backwards from a, visiting only Ops scheduled between b and
+  // a, and these Ops are reordered among their current schedule indices.
+  // The changes are appended to #pendingScheduleChanges. Returns false if
+  // the Constraints create a cycle, in which case the schedule is valid for
+  // a subset of #cs.
+  bool reorder(const Constraints &cs);
+
+  // Compare the result #isAcyclic of #reorder, and the updated schedule, to
+  // the vanilla scheduler on all edges of this Graph and #cs.
+  void verifyReorder(const Constraints &cs, bool isAcyclic) const;
 
   // An Op in this Graph maps to 1 or more Nodes in an alias::Graph.
   alias::Graph aGraph_;
@@ -525,6 +616,50 @@ private:
   AliasGate &asAliasGate(OpId);
   const AliasGate &asAliasGate(OpId) const;
 
+  // The aliases of Tensors, cached between calls to tryOpeningPartial, in
+  // which the same alias queries are repeated for many Proposals (T29079).
+  // An entry is erased when the aliases of its Tensor might change. All
+  // entries are erased when an Op is inserted, and the entries of the
+  // aliases of an AliasGate's output are erased when it is opened or closed.
+  //
+  // The cache is only read and written by non-const methods, so const
+  // methods of a Graph can be called concurrently. Proposals which are
+  // processed concurrently (see #tryOpeningsBatched) are processed on
+  // separate copies of the Graph, each with its own cache.
+  std::unordered_map<TensorId, TensorIds> aliasCache_;
+  AliasCacheDebug aliasCacheDebug_{AliasCacheDebug::Off};
+  TensorIds cachedAliases(const TensorId &);
+  void eraseCachedAliases(const TensorId &aliasGateOut);
+  void openAliasGate(AliasGate &, InIndex);
+  void closeAliasGate(AliasGate &);
+
+  // The number of changes to this Graph which can change the result of an
+  // opening: inserted Ops, Constraints, opened and closed AliasGates, and
+  // schedule changes.
+  uint64_t nMutations_{0};
+
+  // The copies of this Graph on which #tryOpeningsBatched processes
+  // Proposals. They are kept between calls, so that this Graph is not
+  // copied for every batch, and are brought up to date with this Graph at
+  // the end of each batch. They are only reused if this Graph has not been
+  // changed since, that is if #nMutations_ is #syncedAt.
+  //
+  // Copying (or copy assigning) a Graph does not copy its workers.
+  class Workers {
+  public:
+    Workers()                      = default;
+    Workers(Workers &&)            = default;
+    Workers &operator=(Workers &&) = default;
+    Workers(const Workers &) {}
+    Workers &operator=(const Workers &) {
+      graphs.clear();
+      return *this;
+    }
+
+    std::vector<std::unique_ptr<Graph>> graphs;
+    uint64_t syncedAt{0};
+  } workers_;
+
   void
   multiOutTypeSpecificRemoveInputs(OpId,
                                    const ContiguousInIndexSubset &) final {
@@ -27,11 +27,16 @@ enum OpeningStatus {
  * 1) OpeningStatus (see above), and
  * 2) The constraints required if (1) is OpeningStatus::Valid, and
  * 3) The new schedule if one is required by the constraints in (2).
+ *
+ * If the Graph's schedule is updated incrementally, the new schedule is not
+ * stored in this object: the Graph's schedule is changed in place, and
+ * restored if the opening is backed out.
  * */
 class OpeningResult {
 public:
   static OpeningResult validWithUnchangedSchedule(Constraints &&);
   static OpeningResult validWithChangedSchedule(Constraints &&, OpIds &&);
+  static OpeningResult validWithScheduleChangedInGraph(Constraints &&);
   static OpeningResult cycle();
   static OpeningResult alreadyOpen();
   static OpeningResult notParallelWriteable();
@@ -46,6 +51,10 @@ public:
 
   bool scheduleChange() const { return scheduleChange_; }
 
+  /** true if the schedule changed, and the new schedule is stored in this
+   * object (as opposed to in the Graph). */
+  bool scheduleStored() const { return scheduleChange_ && scheduleStored_; }
+
   void append(std::ostream &ost) const;
 
 private:
@@ -53,6 +62,7 @@ private:
   Constraints constraints_;
   OpIds schedule_;
   bool scheduleChange_;
+  bool scheduleStored_{true};
 
   /** Constructor for a successful opening. */
   OpeningResult(OpeningStatus st, Constraints &&cs, OpIds &&sc, bool hs)
@@ -0,0 +1,38 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_MEMORY_INPLACE_SCHEDULE_UPDATE_HPP
+#define POPRITHMS_MEMORY_INPLACE_SCHEDULE_UPDATE_HPP
+
+#include <ostream>
+
+namespace poprithms {
+namespace memory {
+namespace inplace {
+
+/// When a Proposal to open an AliasGate introduces Constraints which the
+/// current schedule of a Graph does not satisfy, the schedule must change.
+/// This enum class defines how the new schedule is obtained.
+///
+/// The Constraints which a Proposal introduces depend on the schedule, and
+/// the two options do not in general maintain the same schedule, so the
+/// statuses of later Proposals can differ between them.
+enum class ScheduleUpdate {
+  Full = 0,   ///< Compute the schedule from scratch, with the vanilla
+              ///< scheduler on all edges and Constraints of the Graph.
+  Incremental, ///< Move only the Ops scheduled between the endpoints of the
+               ///< violated Constraints. This is faster for large Graphs,
+               ///< but the schedule depends on the order in which Proposals
+               ///< were processed, not only on the edges of the Graph.
+  IncrementalDebug ///< As Incremental, but every update is compared to
+                   ///< the vanilla scheduler on all edges and Constraints:
+                   ///< an error is thrown if they disagree on whether there
+                   ///< is a cycle, or if the updated schedule does not
+                   ///< satisfy all edges. This is slow, it is intended for
+                   ///< debugging.
+};
+std::ostream &operator<<(std::ostream &, ScheduleUpdate);
+
+} // namespace inplace
+} // namespace memory
+} // namespace poprithms
+
+#endif
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_MEMORY_INPLACE_SCHEDULE_UPDATE_STATS_HPP
+#define POPRITHMS_MEMORY_INPLACE_SCHEDULE_UPDATE_STATS_HPP
+
+#include <cstdint>
+#include <ostream>
+
+namespace poprithms {
+namespace memory {
+namespace inplace {
+
+/**
+ * Counters of how a Graph keeps its schedule (a topological order of its
+ * Ops) up to date while it processes Proposals.
+ *
+ * The schedule is computed from scratch the first time a Proposal is
+ * processed after Ops are inserted. After that, the Constraints which a
+ * Proposal introduces are either already satisfied by the schedule, or the
+ * schedule is updated as defined by the Graph's ScheduleUpdate: computed
+ * from scratch again, or updated incrementally, by moving only the Ops
+ * which are scheduled between the endpoints of the violated Constraints.
+ * */
+class ScheduleUpdateStats {
+public:
+  // The number of times the schedule was computed from scratch, either
+  // after Ops were inserted or (with ScheduleUpdate::Full) for a Proposal.
+  uint64_t nFull{0};
+
+  // The number of valid Proposals whose Constraints were all satisfied by
+  // the current schedule.
+  uint64_t nUnchanged{0};
+
+  // The number of valid Proposals whose Constraints required the schedule
+  // to be updated incrementally.
+  uint64_t nIncremental{0};
+
+  // The number of Proposals which were rejected because their Constraints
+  // would have created a cycle.
+  uint64_t nCycles{0};
+
+  // The total number of Ops visited, and moved, by incremental updates
+  // (including those of Proposals which were rejected, or backed out).
+  uint64_t nOpsVisited{0};
+  uint64_t nOpsMoved{0};
+
+  // The fraction of schedule updates which did not compute the schedule
+  // from scratch (1 if there have been no updates).
+  double fastPathRate() const;
+
+  void append(std::ostream &) const;
+
+  // Add all of the counters of #rhs to the counters of this object.
+  ScheduleUpdateStats &operator+=(const ScheduleUpdateStats &rhs);
+};
+
+std::ostream &operator<<(std::ostream &, const ScheduleUpdateStats &);
+
+} // namespace inplace
+} // namespace memory
+} // namespace poprithms
+
+#endif
@@ -0,0 +1,70 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_MEMORY_NEST_MEMO_HPP
+#define POPRITHMS_MEMORY_NEST_MEMO_HPP
+
+#include <cstdint>
+#include <ostream>
+
+namespace poprithms {
+namespace memory {
+namespace nest {
+
+/** The operations whose results can be memoized. */
+enum class MemoizedOp {
+  Intersect = 0, ///< Sett::intersect
+  Subtract,      ///< Sett::subtract
+  Complement,    ///< Sett::getComplement
+  Merge,         ///< Sett::merge
+  Reshape,       ///< Region::reshape
+  N              ///< The number of memoized operations
+};
+
+std::ostream &operator<<(std::ostream &, MemoizedOp);
+
+/**
+ * A cache of the results of some of the Sett and Region operations. These
+ * operations are pure functions of small values, and classes such as
+ * unwind::Solution, chain::Chain and alias::Origins repeatedly evaluate them
+ * with the same arguments.
+ *
+ * The cache is disabled by default. When it is enabled, the arguments of
+ * the operations are hashed by their Stripes (and Shapes, for Regions), and
+ * the results are stored in tables which are shared by all threads.
+ * Enabling the cache does not change the results of any operation.
+ * */
+class Memo {
+public:
+  /** Enable or disable the cache. Disabling it does not clear it. */
+  static void enable();
+  static void disable();
+  static bool enabled();
+
+  /** Erase all cached results, and reset the statistics. */
+  static void clear();
+
+  /**
+   * Set the maximum number of results cached for each operation (default
+   * 1<<20). When this is exceeded, the results of the operation are erased.
+   * */
+  static void setCapacity(uint64_t);
+  static uint64_t capacity();
+
+  /** The number of times a result of #op was, and was not, cached. */
+  static uint64_t hits(MemoizedOp op);
+  static uint64_t misses(MemoizedOp op);
+
+  /** The fraction of calls to #op which were cached (0 if none). */
+  static double hitRate(MemoizedOp op);
+
+  /** Append the hits and misses of all operations. */
+  static void appendStats(std::ostream &);
+
+  /** Log the statistics with the memory::nest logger, at info level. */
+  static void logStats();
+};
+
+} // namespace nest
+} // namespace memory
+} // namespace poprithms
+
+#endif
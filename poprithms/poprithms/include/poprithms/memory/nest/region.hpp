@@ -525,6 +525,11 @@ public:
   /**
    * \return The intersection of this DisjointRegions and #rhs.
    *
+   * If there are many pairs of Regions, the bounding boxes of the Regions
+   * in #rhs are indexed, so that only pairs of Regions whose bounding boxes
+   * intersect are intersected. The Regions of the returned DisjointRegions
+   * are the same, and in the same order, as if all pairs were intersected.
+   *
    * \sa Region::intersect
    * */
   DisjointRegions intersect(const DisjointRegions &rhs) const;
@@ -2,9 +2,18 @@
 #ifndef POPRITHMS_MEMORY_UNWIND_LOWER_HPP
 #define POPRITHMS_MEMORY_UNWIND_LOWER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include <poprithms/error/error.hpp>
 #include <poprithms/memory/unwind/scheduledsolution.hpp>
 #include <poprithms/memory/unwind/solution.hpp>
+#include <poprithms/util/parallelfor.hpp>
 
 namespace poprithms {
 namespace memory {
@@ -43,8 +52,34 @@ public:
     x.lower();
   };
 
-  void lower() {
+  /**
+   * Lower the ops and unwind paths defined in #h to the backend, as #lower
+   * does, but unwind paths to different sinks concurrently on #nThreads
+   * threads.
+   *
+   * The consecutive paths between 2 ops in the schedule are grouped by
+   * their destination sinks. The paths of a group are unwound in schedule
+   * order, and the groups are unwound concurrently. Ops are initialized in
+   * schedule order, on the calling thread, once all the paths scheduled
+   * before them have been unwound. The layouts obtained are the same as
+   * those obtained with #lower.
+   *
+   * This places an additional requirement on the Helper class: the methods
+   * used to unwind paths (finalLayout, createEmpty, createUnmapped,
+   * createMappedSrc, shape, getUnwindSink and unwindAndUpdate) may be
+   * called concurrently, for paths to different sinks. The methods
+   * initialize, unwindSinkInitialized and initializeUnwindSink are only
+   * called from the calling thread, and never while paths are being
+   * unwound.
+   * */
+  static void lowerParallel(Helper &h, uint64_t nThreads) {
+    Lowerer<T, Helper> x(h);
+    x.lower(nThreads);
+  };
+
+  void lower(uint64_t nThreads = 1) {
     const ScheduledSolution &ss = helper.scheduledSolution();
+    const auto &schedule        = ss.schedule();
 
     /**
      * ScheduledSolution ss is a sequence of 'nodes' corresponding to either
@@ -52,30 +87,26 @@ public:
      * between tensors. The nodes are ordered in topological order, so that
      * they can be lowered in order without missing any dependencies.
      * */
-    for (auto n : ss.schedule()) {
+    uint64_t i = 0;
+    while (i < schedule.size()) {
 
       // If the node is an op, call 'initialize' on it (similar to popart's
       // grow method).
-      if (ss.isOp(n)) {
-
-        helper.initialize(ss.op(n));
+      if (ss.isOp(schedule[i])) {
+        helper.initialize(ss.op(schedule[i]));
+        ++i;
       }
+
       // If the node is a path, then unwind from the source to the
       // destination. This gives the destination of the path a layout/mapping.
+      // All the paths up to the next op are unwound together.
       else {
-        const auto &p = ss.pathToSink(n);
-
-        const auto tSrc = getPathSrc(p);
-        loweringShapeAssert(
-            helper.shape(tSrc),
-            p.chain().inShape(),
-            "The shape of the input of the path's chain must match the "
-            "shape of the tensor at the start of the chain.");
-        if (!helper.unwindSinkInitialized(p.dst())) {
-          helper.initializeUnwindSink(p.dst());
+        auto end = i;
+        while (end < schedule.size() && ss.isPathToSink(schedule[end])) {
+          ++end;
         }
-        const auto tDst = helper.getUnwindSink(p.dst());
-        helper.unwindAndUpdate(p, tSrc, tDst);
+        unwindPaths(i, end, nThreads);
+        i = end;
       }
     }
   }
@@ -84,6 +115,67 @@ private:
   Helper &helper;
   Lowerer(Helper &h) : helper(h) {}
 
+  void initializeSink(const TensorId &sink) {
+    if (!helper.unwindSinkInitialized(sink)) {
+      helper.initializeUnwindSink(sink);
+    }
+  }
+
+  // Unwind the path #p to its (initialized) destination sink.
+  void unwindToSink(const Path &p) {
+    const auto tSrc = getPathSrc(p);
+    loweringShapeAssert(
+        helper.shape(tSrc),
+        p.chain().inShape(),
+        "The shape of the input of the path's chain must match the "
+        "shape of the tensor at the start of the chain.");
+    const auto tDst = helper.getUnwindSink(p.dst());
+    helper.unwindAndUpdate(p, tSrc, tDst);
+  }
+
+  /**
+   * Unwind the paths at schedule indices [start, end), which are all paths.
+   * */
+  void unwindPaths(uint64_t start, uint64_t end, uint64_t nThreads) {
+
+    const ScheduledSolution &ss = helper.scheduledSolution();
+
+    if (nThreads < 2 || end - start < 2) {
+      for (uint64_t i = start; i < end; ++i) {
+        const auto &p = ss.pathToSink(ss.schedule(i));
+        initializeSink(p.dst());
+        unwindToSink(p);
+      }
+      return;
+    }
+
+    // Group the paths by destination sink, in order of first appearance.
+    std::vector<std::vector<const Path *>> groups;
+    std::map<TensorId, uint64_t> groupOfSink;
+    for (uint64_t i = start; i < end; ++i) {
+      const auto &p    = ss.pathToSink(ss.schedule(i));
+      const auto found = groupOfSink.find(p.dst());
+      if (found == groupOfSink.cend()) {
+        initializeSink(p.dst());
+        groupOfSink.insert({p.dst(), groups.size()});
+        groups.push_back({&p});
+      } else {
+        groups[found->second].push_back(&p);
+      }
+    }
+
+    nThreads = std::min<uint64_t>(nThreads, groups.size());
+    std::atomic<uint64_t> nextGroup{0};
+    poprithms::util::forEachThread(
+        nThreads, [this, &groups, &nextGroup](uint64_t) {
+          for (auto g = nextGroup++; g < groups.size(); g = nextGroup++) {
+            for (const auto *p : groups[g]) {
+              unwindToSink(*p);
+            }
+          }
+        });
+  }
+
   std::pair<bool, T> layout(const TensorId &uwId) {
 
     /**
@@ -102,20 +194,28 @@ private:
     return cachedLayout(uwId);
   }
 
-  void insertCacheSrc(const Path &p, const T &t) {
+  void assertCacheSrcShape(const Path &p, const T &t) {
     loweringShapeAssert(helper.shape(t),
                         p.chain().inShape(),
                         "Cannot make tensor of shape A into the cache for "
                         "the source of the chain of path, if the chain has "
                         "input shape B!=A. Failed to insert cache source.");
-    cache_.insert({p.src(), t});
   }
 
   std::pair<bool, T> cachedLayout(const TensorId &uwId) const {
 
-    auto f1 = cache_.find(uwId);
-    if (f1 != cache_.cend()) {
-      return {true, f1->second};
+    std::shared_future<T> cached;
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex_);
+      auto f1 = cache_.find(uwId);
+      if (f1 != cache_.cend()) {
+        cached = f1->second;
+      }
+    }
+
+    // If another thread is creating the T, this waits for it.
+    if (cached.valid()) {
+      return {true, cached.get()};
     }
 
     return {false, helper.createEmpty()};
@@ -128,17 +228,51 @@ private:
    * */
   T getPathSrc(const poprithms::memory::unwind::Path &p) {
 
-    // The op at the start of the path.
-    const auto barrierOp = p.src().opId();
-
     // If there is a T with a known 'layout' corresponding to the source of
     // the path, then return it. Having this initial check means that caching
     // can reduce the total amount of backend tensor creation required.
-    const auto easyFind0 = layout(p.src());
+    const auto easyFind0 = helper.finalLayout(p.src());
     if (easyFind0.first) {
       return easyFind0.second;
     }
 
+    // Check the cache, and if there is no T for the source of the path,
+    // reserve the cache entry so that no other thread creates one.
+    std::shared_future<T> cached;
+    std::promise<T> created;
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex_);
+      auto f0 = cache_.find(p.src());
+      if (f0 != cache_.cend()) {
+        cached = f0->second;
+      } else {
+        cache_.insert({p.src(), created.get_future().share()});
+      }
+    }
+    if (cached.valid()) {
+      return cached.get();
+    }
+
+    try {
+      auto out = createPathSrc(p);
+      assertCacheSrcShape(p, out);
+      created.set_value(out);
+      return out;
+    } catch (...) {
+      created.set_exception(std::current_exception());
+      throw;
+    }
+  }
+
+  /**
+   * Create the tensor at the start of the Path #p, which is not in the
+   * cache.
+   * */
+  T createPathSrc(const poprithms::memory::unwind::Path &p) {
+
+    // The op at the start of the path.
+    const auto barrierOp = p.src().opId();
+
     const auto &ss  = helper.scheduledSolution();
     const auto &uwg = ss.graph();
 
@@ -177,14 +311,14 @@ private:
       srcIns.push_back(getIn(uwIn));
     }
 
-    auto out = helper.createMappedSrc(p, srcIns);
-    insertCacheSrc(p, out);
-
-    return out;
+    return helper.createMappedSrc(p, srcIns);
   }
 
 private:
-  std::map<TensorId, T> cache_;
+  // The Ts created for the sources of paths. A T which is being created by
+  // one thread can be waited for by other threads.
+  std::map<TensorId, std::shared_future<T>> cache_;
+  mutable std::mutex cacheMutex_;
 };
 
 } // namespace unwind
@@ -2,7 +2,9 @@
 #ifndef POPRITHMS_MEMORY_UNWIND_SOLUTION_HPP
 #define POPRITHMS_MEMORY_UNWIND_SOLUTION_HPP
 
+#include <limits>
 #include <map>
+#include <utility>
 
 #include <poprithms/common/multiout/fwdedgemap.hpp>
 #include <poprithms/memory/chain/chain.hpp>
@@ -35,8 +37,39 @@ using nest::DisjointRegions;
  *    known layout (a path from a Source or a Barrier) in one Tensor, but
  *    not the other. Copy the layout to the Tensor with the unset Region.
  *
+ * Algo::Greedy0Refine
+ * -------------------
+ * Start from the Greedy0 Solution, and then perform a local search over the
+ * order in which Greedy0 processes ValuedPairs:
+ *
+ * 1) Choose a ValuedPair which does not obtain all of its value in the
+ *    current Solution, starting with the one which obtains the least of its
+ *    maximum possible value.
+ *
+ * 2) Rerun Greedy0, with the chosen ValuedPair processed before all other
+ *    ValuedPairs. If the score increases, keep the new Solution.
+ *
+ * This is repeated until no ValuedPair remains to be tried, or until the
+ * RefinementBudget is exhausted. The score is never lower than Greedy0's.
+ *
+ * */
+enum class Algo { Greedy0, Greedy0Refine };
+
+/**
+ * Limits on the local search performed by Algo::Greedy0Refine. Each
+ * iteration of the search runs Greedy0 once. The search stops when either
+ * limit is reached, so the time limit can be exceeded by at most 1
+ * iteration.
+ *
+ * By default there is no time limit, so that the Solution does not depend
+ * on the speed of the machine. A time limit makes the Solution
+ * non-deterministic, and should only be set when bounding the run time is
+ * more important than reproducibility.
  * */
-enum class Algo { Greedy0 };
+struct RefinementBudget {
+  uint64_t maxIterations{32};
+  double maxSeconds{std::numeric_limits<double>::infinity()};
+};
 
 /**
  * A Solution to the unwinding problem for a specific Graph.
@@ -44,11 +77,21 @@ enum class Algo { Greedy0 };
 class Solution {
 
 public:
-  /** Construct a Solution for the Graph \a g, using the algorithm \a a. */
-  Solution(const Graph &g, Algo a = Algo::Greedy0);
+  /**
+   * Construct a Solution for the Graph \a g, using the algorithm \a a. The
+   * budget \a b is only used by algorithms which perform a search.
+   * */
+  Solution(const Graph &g,
+           Algo a                   = Algo::Greedy0,
+           const RefinementBudget &b = RefinementBudget());
 
-  /** Construct a Solution for the Graph \a g, using the algorithm \a a. */
-  Solution(Graph &&g, Algo = Algo::Greedy0);
+  /**
+   * Construct a Solution for the Graph \a g, using the algorithm \a a. The
+   * budget \a b is only used by algorithms which perform a search.
+   * */
+  Solution(Graph &&g,
+           Algo a                   = Algo::Greedy0,
+           const RefinementBudget &b = RefinementBudget());
 
   /**
    * Create a Solution based on a partial solution in the form of a sequence
@@ -167,7 +210,22 @@ private:
   TensorIds processPathStack();
   void processUnwindPath(const Path &unwindPath);
 
-  void setPathsGreedy0();
+  /**
+   * The values used to order ValuedPairs in Greedy0, for ValuedPairs which
+   * are not ordered by their attraction values. The keys are the TensorIds
+   * of the ValuedPairs, smallest first.
+   * */
+  using Priorities = std::map<std::pair<TensorId, TensorId>, double>;
+
+  void setPathsGreedy0(const Priorities & = {});
+
+  void setPathsGreedy0Refine(const RefinementBudget &);
+
+  /**
+   * The score obtained from the ValuedPair \a vp in this Solution. The
+   * score of the Solution is the sum of this over all ValuedPairs.
+   * */
+  double getScore(const ValuedPair &vp) const;
 
   void initPaths();
 
@@ -5,6 +5,7 @@
 #include <tuple>
 #include <vector>
 
+#include <poprithms/schedule/vanilla/csredges.hpp>
 #include <poprithms/util/typedinteger.hpp>
 
 namespace poprithms {
@@ -40,6 +41,7 @@ public:
    * */
   explicit ConnectedComponents(const Edges<int64_t> &edges);
   explicit ConnectedComponents(const Edges<uint64_t> &edges);
+  explicit ConnectedComponents(const vanilla::CsrEdges<uint64_t> &edges);
 
   /**
    * The total number of disjoint subgraphs.
@@ -105,7 +107,8 @@ private:
 
   // The bool argument is a dummy variable to distinguish this constructor
   // from the public ones
-  template <typename T> ConnectedComponents(const Edges<T> &edges, bool);
+  template <typename TEdges>
+  ConnectedComponents(const TEdges &edges, bool);
 };
 
 std::ostream &operator<<(std::ostream &, const ConnectedComponents &);
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <vector>
 
+#include <poprithms/schedule/vanilla/csredges.hpp>
+
 namespace poprithms {
 namespace schedule {
 namespace dfs {
@@ -38,6 +40,12 @@ namespace dfs {
 using Edges = std::vector<std::vector<uint64_t>>;
 std::vector<uint64_t> postOrder(const Edges &edges);
 
+/**
+ * The same as the method above, but with the edges in compressed sparse row
+ * format.
+ * */
+std::vector<uint64_t> postOrder(const vanilla::CsrEdges<uint64_t> &edges);
+
 } // namespace dfs
 } // namespace schedule
 } // namespace poprithms
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include <poprithms/schedule/vanilla/csredges.hpp>
+
 namespace poprithms {
 namespace schedule {
 namespace scc {
@@ -26,6 +28,13 @@ using FwdEdges = std::vector<std::vector<uint64_t>>;
  * */
 SCCs getStronglyConnectedComponents(const FwdEdges &edges);
 
+/**
+ * The same as the method above, but with the edges in compressed sparse row
+ * format.
+ * */
+SCCs getStronglyConnectedComponents(
+    const vanilla::CsrEdges<uint64_t> &edges);
+
 enum class IncludeCyclelessComponents { No = 0, Yes };
 
 /// \deprecated {on 10 March 2022. Please use IncludeCyclelessComponents.}
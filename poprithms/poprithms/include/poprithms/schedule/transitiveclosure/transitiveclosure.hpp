@@ -7,6 +7,8 @@
 #include <tuple>
 #include <vector>
 
+#include <poprithms/schedule/vanilla/csredges.hpp>
+
 namespace poprithms {
 namespace schedule {
 namespace transitiveclosure {
@@ -50,10 +52,17 @@ public:
    */
   explicit TransitiveClosure(const Edges &forwardEdges);
 
+  /**
+   * Construct a transitive closure from the forward edges of a DAG, in
+   * compressed sparse row format.
+   * */
+  explicit TransitiveClosure(const vanilla::CsrEdges<OpId> &forwardEdges);
+
   /**
    * Update the transitive closure by propagating all the edges in #fwd.
    * */
   void bidirectionalPropagate(const Edges &fwd);
+  void bidirectionalPropagate(const vanilla::CsrEdges<OpId> &fwd);
 
   /**
    * Insert additional DAG edges. Note that it is much faster to call the
@@ -349,6 +358,9 @@ private:
 
   void insertConstraint(OpId from, OpId to, BitSets &edgeSet);
 
+  // TEdges is either Edges or vanilla::CsrEdges<OpId>.
+  template <typename TEdges> void tBidirectionalPropagate(const TEdges &);
+
   BitSets bitSetIntersection(const std::vector<BitSets> &) const;
   BitSets bitSetIntersection(const Filters &) const;
 
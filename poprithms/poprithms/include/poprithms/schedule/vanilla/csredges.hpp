@@ -0,0 +1,170 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_SCHEDULE_VANILLA_CSREDGES_HPP
+#define POPRITHMS_SCHEDULE_VANILLA_CSREDGES_HPP
+
+#include <cstdint>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/schedule/vanilla/types.hpp>
+
+namespace poprithms {
+namespace schedule {
+namespace vanilla {
+
+/**
+ * The forward edges of a graph in compressed sparse row (CSR) format. The
+ * edges of node i are
+ *
+ *    targets()[offsets()[i]], ... , targets()[offsets()[i+1] - 1].
+ *
+ * Example: the edges {{1,2}, {}, {0}} are stored as
+ *
+ *    offsets = {0, 2, 2, 3}
+ *    targets = {1, 2, 0}.
+ *
+ * Edges<TNode> stores one vector per node, so that constructing it for a
+ * graph with N nodes requires N allocations, and the edges of different
+ * nodes are not contiguous in memory. This class stores all of the edges in
+ * 2 vectors.
+ *
+ * This class has the subset of the interface of Edges<TNode> which the
+ * schedule algorithms use: size() is the number of nodes, and
+ * operator[](i) is a range of the edges of node i, so that the
+ * algorithms can be templatized by the edge type.
+ * */
+template <typename TNode> class CsrEdges {
+
+public:
+  /**
+   * The forward edges of one node. This is a view into the CSR, which must
+   * outlive it.
+   * */
+  class Targets {
+  public:
+    Targets(const TNode *b, const TNode *e) : b_(b), e_(e) {}
+    const TNode *begin() const { return b_; }
+    const TNode *end() const { return e_; }
+    const TNode *cbegin() const { return b_; }
+    const TNode *cend() const { return e_; }
+    uint64_t size() const { return static_cast<uint64_t>(e_ - b_); }
+    bool empty() const { return b_ == e_; }
+    TNode operator[](uint64_t i) const { return b_[i]; }
+
+  private:
+    const TNode *b_;
+    const TNode *e_;
+  };
+
+  /**
+   * Copy the edges #edges into CSR format.
+   *
+   * This is the only constructor: the schedule algorithms have overloads for
+   * Edges<TNode> and CsrEdges<TNode>, and other (implicit) constructors would
+   * make calls with brace-initialized edges, such as {{1}, {}}, ambiguous.
+   * */
+  explicit CsrEdges(const Edges<TNode> &edges) {
+    offsets_.reserve(edges.size() + 1);
+    offsets_.push_back(0);
+    for (const auto &es : edges) {
+      offsets_.push_back(offsets_.back() + es.size());
+    }
+    targets_.reserve(offsets_.back());
+    for (const auto &es : edges) {
+      targets_.insert(targets_.end(), es.cbegin(), es.cend());
+    }
+  }
+
+  /**
+   * Construct from the offsets and targets, without copying them. #offsets
+   * must be non-decreasing, start at 0, and end at the number of targets.
+   * */
+  static CsrEdges fromOffsets(std::vector<uint64_t> &&offsets,
+                              std::vector<TNode> &&targets) {
+    bool valid = !offsets.empty() && offsets[0] == 0 &&
+                 offsets.back() == targets.size();
+    for (uint64_t i = 1; valid && i < offsets.size(); ++i) {
+      valid = offsets[i - 1] <= offsets[i];
+    }
+    if (!valid) {
+      std::ostringstream oss;
+      oss << "Invalid CsrEdges, with " << offsets.size() << " offsets and "
+          << targets.size() << " targets. The offsets must be "
+          << "non-decreasing, and start at 0 and end at the number of "
+          << "targets.";
+      throw poprithms::error::error("schedule::vanilla", oss.str());
+    }
+    CsrEdges csr{Edges<TNode>{}};
+    csr.offsets_ = std::move(offsets);
+    csr.targets_ = std::move(targets);
+    return csr;
+  }
+
+  /**
+   * The reverse of the edges #edges, which may be Edges<TNode> or
+   * CsrEdges<TNode>. If there is an edge a->b in #edges, then there is an
+   * edge b->a in the returned CsrEdges. The edges of each node are in
+   * increasing order of their source nodes.
+   * */
+  template <typename E> static CsrEdges reversed(const E &edges) {
+    const auto N = edges.size();
+    std::vector<uint64_t> offsets(N + 1, 0);
+    for (uint64_t from = 0; from < N; ++from) {
+      for (auto to : edges[from]) {
+        ++offsets[static_cast<uint64_t>(to) + 1];
+      }
+    }
+    for (uint64_t i = 0; i < N; ++i) {
+      offsets[i + 1] += offsets[i];
+    }
+    std::vector<TNode> targets(offsets.back());
+    std::vector<uint64_t> next(offsets.cbegin(), offsets.cend() - 1);
+    for (uint64_t from = 0; from < N; ++from) {
+      for (auto to : edges[from]) {
+        targets[next[static_cast<uint64_t>(to)]++] = static_cast<TNode>(from);
+      }
+    }
+    return fromOffsets(std::move(offsets), std::move(targets));
+  }
+
+  /** The number of nodes. */
+  uint64_t size() const { return offsets_.size() - 1; }
+
+  /** The total number of edges. */
+  uint64_t nEdges() const { return targets_.size(); }
+
+  /** The forward edges of node #i. */
+  Targets operator[](uint64_t i) const {
+    return {targets_.data() + offsets_[i], targets_.data() + offsets_[i + 1]};
+  }
+
+  const std::vector<uint64_t> &offsets() const { return offsets_; }
+  const std::vector<TNode> &targets() const { return targets_; }
+
+  /** Copy the edges into the format with one vector per node. */
+  Edges<TNode> toNested() const {
+    Edges<TNode> edges(size());
+    for (uint64_t i = 0; i < size(); ++i) {
+      const auto es = operator[](i);
+      edges[i]      = {es.cbegin(), es.cend()};
+    }
+    return edges;
+  }
+
+  bool operator==(const CsrEdges &rhs) const {
+    return offsets_ == rhs.offsets_ && targets_ == rhs.targets_;
+  }
+  bool operator!=(const CsrEdges &rhs) const { return !operator==(rhs); }
+
+private:
+  std::vector<uint64_t> offsets_;
+  std::vector<TNode> targets_;
+};
+
+} // namespace vanilla
+} // namespace schedule
+} // namespace poprithms
+
+#endif
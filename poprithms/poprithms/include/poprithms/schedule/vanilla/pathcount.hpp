@@ -8,6 +8,7 @@
 #include <tuple>
 #include <vector>
 
+#include <poprithms/schedule/vanilla/csredges.hpp>
 #include <poprithms/schedule/vanilla/types.hpp>
 
 namespace poprithms {
@@ -64,6 +65,36 @@ public:
                                      ErrorIfCycle,
                                      VerifyEdges);
 
+  /**
+   * The same as the method above, but with the edges in compressed sparse
+   * row format.
+   * */
+  static std::vector<uint64_t> count(const CsrEdges<uint64_t> &fwdEdges,
+                                     CountType,
+                                     ErrorIfCycle,
+                                     VerifyEdges);
+
+  /**
+   * The same as #count, but computed on #nThreads threads. The nodes are
+   * partitioned into the frontiers of fifo scheduling (see
+   * getParallelFifoSchedule_u64), and the statistics of the nodes in a
+   * frontier, which only depend on the statistics of nodes in later
+   * frontiers, are computed concurrently. The statistics are the same as
+   * those computed by #count.
+   * */
+  static std::vector<uint64_t> countParallel(const Edges<uint64_t> &fwdEdges,
+                                             CountType,
+                                             uint64_t nThreads,
+                                             ErrorIfCycle,
+                                             VerifyEdges);
+
+  static std::vector<uint64_t>
+  countParallel(const CsrEdges<uint64_t> &fwdEdges,
+                CountType,
+                uint64_t nThreads,
+                ErrorIfCycle,
+                VerifyEdges);
+
   static std::vector<uint64_t>
   longestPathsToTerminal(const Edges<uint64_t> &fwdEdges,
                          ErrorIfCycle eic,
@@ -6,6 +6,7 @@
 #include <tuple>
 #include <vector>
 
+#include <poprithms/schedule/vanilla/csredges.hpp>
 #include <poprithms/schedule/vanilla/types.hpp>
 
 namespace poprithms {
@@ -59,6 +60,43 @@ getSchedule_u64(const Edges<uint64_t> &fwdEdges, ErrorIfCycle, VerifyEdges);
 std::vector<int64_t>
 getSchedule_i64(const Edges<int64_t> &fwdEdges, ErrorIfCycle, VerifyEdges);
 
+/**
+ * The same as the methods above, but with the edges in compressed sparse row
+ * format. See CsrEdges.
+ * */
+std::vector<uint64_t> getSchedule_u64(const CsrEdges<uint64_t> &fwdEdges,
+                                      ErrorIfCycle,
+                                      VerifyEdges);
+
+std::vector<int64_t> getSchedule_i64(const CsrEdges<int64_t> &fwdEdges,
+                                     ErrorIfCycle,
+                                     VerifyEdges);
+
+/**
+ * The schedule obtained with fifo tie-breaking and no priorities or links
+ * (see Scheduler::fifo), computed frontier by frontier on #nThreads threads.
+ *
+ * Fifo scheduling schedules all of the nodes with no input edges (frontier
+ * 0), then all of the nodes which become schedulable when frontier 0 is
+ * scheduled (frontier 1), and so on. All of the nodes in a frontier are
+ * processed concurrently. The schedule does not depend on #nThreads.
+ *
+ * This is faster than Scheduler::fifo for very wide graphs, where the
+ * frontiers contain many thousands of nodes. Frontiers with fewer than
+ * about 1000 nodes per thread are processed sequentially.
+ * */
+std::vector<uint64_t>
+getParallelFifoSchedule_u64(const Edges<uint64_t> &fwdEdges,
+                            uint64_t nThreads,
+                            ErrorIfCycle,
+                            VerifyEdges);
+
+std::vector<uint64_t>
+getParallelFifoSchedule_u64(const CsrEdges<uint64_t> &fwdEdges,
+                            uint64_t nThreads,
+                            ErrorIfCycle,
+                            VerifyEdges);
+
 /**
  * Definition of 'schedulable': any node which has had all of its input
  * dependencies satisfied, and so is ready to be scheduled, but has not yet
@@ -115,6 +153,29 @@ public:
                                    uint32_t seed,
                                    ErrorIfCycle,
                                    VerifyEdges);
+
+  /**
+   * The same as the methods above, but with the edges in compressed sparse
+   * row format. See CsrEdges.
+   * */
+  static std::vector<TNode> filo(const CsrEdges<TNode> &fwdEdges,
+                                 const Priorities<TNode, TPriority> &,
+                                 const Links<TNode> &,
+                                 ErrorIfCycle,
+                                 VerifyEdges);
+
+  static std::vector<TNode> fifo(const CsrEdges<TNode> &fwdEdges,
+                                 const Priorities<TNode, TPriority> &,
+                                 const Links<TNode> &,
+                                 ErrorIfCycle,
+                                 VerifyEdges);
+
+  static std::vector<TNode> random(const CsrEdges<TNode> &fwdEdges,
+                                   const Priorities<TNode, TPriority> &,
+                                   const Links<TNode> &,
+                                   uint32_t seed,
+                                   ErrorIfCycle,
+                                   VerifyEdges);
 };
 
 extern template class Scheduler<int64_t, double>;
@@ -160,6 +221,15 @@ public:
    * schedule the graph, then false is returned.
    * */
   static bool hasUniqueSchedule(const Edges<TNode> &fwdEdges, VerifyEdges);
+
+  /**
+   * The same as the methods above, but with the edges in compressed sparse
+   * row format. See CsrEdges.
+   * */
+  static bool isSchedulable(const CsrEdges<TNode> &edges, VerifyEdges);
+
+  static bool hasUniqueSchedule(const CsrEdges<TNode> &fwdEdges,
+                                VerifyEdges);
 };
 
 extern template class Query<int64_t>;
@@ -0,0 +1,73 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_UTIL_PARALLELFOR_HPP
+#define POPRITHMS_UTIL_PARALLELFOR_HPP
+
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace poprithms {
+namespace util {
+
+/**
+ * Call f(t) for t in [0, nThreads). f(0) is called on the calling thread,
+ * and all others on new threads, which are joined before this function
+ * returns. If any of the calls throw, the exception of the call with the
+ * lowest t is rethrown after all threads are joined.
+ *
+ * This is for work which is distributed dynamically between the threads
+ * (by f), for example by an atomic counter.
+ * */
+template <typename F> void forEachThread(uint64_t nThreads, F &&f) {
+
+  if (nThreads <= 1) {
+    f(uint64_t(0));
+    return;
+  }
+
+  std::vector<std::exception_ptr> errors(nThreads);
+  auto process = [&f, &errors](uint64_t t) {
+    try {
+      f(t);
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(nThreads - 1);
+  for (uint64_t t = 1; t < nThreads; ++t) {
+    threads.emplace_back(process, t);
+  }
+  process(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &e : errors) {
+    if (e) {
+      std::rethrow_exception(e);
+    }
+  }
+}
+
+/**
+ * Call f(t, begin, end) for t in [0, nThreads), where the ranges
+ * [begin, end) partition [0, n) into contiguous and ordered chunks of
+ * (almost) equal size. The calls are made as in #forEachThread.
+ * */
+template <typename F>
+void parallelFor(uint64_t nThreads, uint64_t n, F &&f) {
+  if (nThreads <= 1) {
+    f(uint64_t(0), uint64_t(0), n);
+    return;
+  }
+  forEachThread(nThreads, [&f, n, nThreads](uint64_t t) {
+    f(t, n * t / nThreads, n * (t + 1) / nThreads);
+  });
+}
+
+} // namespace util
+} // namespace poprithms
+
+#endif
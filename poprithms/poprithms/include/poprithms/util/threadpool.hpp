@@ -0,0 +1,105 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_UTIL_THREADPOOL_HPP
+#define POPRITHMS_UTIL_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poprithms {
+namespace util {
+
+/**
+ * A fixed set of threads which repeatedly run the same kind of work as
+ * util::forEachThread, without creating and joining threads for every call.
+ *
+ * A pool of size n has n - 1 threads of its own: the thread which calls
+ * #forEachThread is the n'th. Threads which have no work wait on a
+ * condition variable.
+ * */
+class ThreadPool {
+
+public:
+  /**
+   * \param nThreads The number of threads used by each call to
+   *                 #forEachThread, including the calling thread. This must
+   *                 be at least 1.
+   * */
+  explicit ThreadPool(uint64_t nThreads);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &)            = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  uint64_t nThreads() const { return nThreads_; }
+
+  /** A new pool with the same number of threads as this pool. */
+  std::unique_ptr<ThreadPool> clone() const {
+    return std::unique_ptr<ThreadPool>(new ThreadPool(nThreads_));
+  }
+
+  /**
+   * Call f(t) for t in [0, nThreads()). f(0) is called on the calling
+   * thread, and the others on the threads of this pool. If any of the calls
+   * throw, the exception of the call with the lowest t is rethrown after all
+   * of the calls have returned.
+   *
+   * Only one call can use the threads of this pool at a time. If this method
+   * is called while the pool is in use (by another thread, or from within f)
+   * the calls f(t) are instead made on the calling thread, in order of t,
+   * and an exception is propagated as soon as it is thrown.
+   * */
+  void forEachThread(const std::function<void(uint64_t)> &f);
+
+  /**
+   * Call f(t, begin, end) for t in [0, nThreads()), where the ranges
+   * [begin, end) partition [0, n) into contiguous and ordered chunks of
+   * (almost) equal size. The calls are made as in #forEachThread.
+   * */
+  void parallelFor(uint64_t n,
+                   const std::function<void(uint64_t, uint64_t, uint64_t)> &f);
+
+private:
+  void work(uint64_t t);
+
+  uint64_t nThreads_;
+
+  // True for the duration of a call to #forEachThread which uses the
+  // threads of this pool.
+  std::atomic<bool> inUse{false};
+
+  // Protects all of the members below.
+  std::mutex mutex;
+
+  // Notified when there is a new job, or when the pool is destroyed.
+  std::condition_variable jobReady;
+
+  // Notified when the final thread of this pool completes its part of a job.
+  std::condition_variable jobDone;
+
+  const std::function<void(uint64_t)> *job{nullptr};
+
+  // Incremented for each job, so that a thread runs each job exactly once.
+  uint64_t jobIndex{0};
+
+  // The number of threads of this pool which have not completed the current
+  // job.
+  uint64_t nRunning{0};
+
+  bool stopping{false};
+
+  std::vector<std::exception_ptr> errors;
+  std::vector<std::thread> threads;
+};
+
+} // namespace util
+} // namespace poprithms
+
+#endif
@@ -0,0 +1,307 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMMON_COMPUTE_DATAFLOW_HPP
+#define POPRITHMS_COMMON_COMPUTE_DATAFLOW_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <poprithms/schedule/vanilla/csredges.hpp>
+
+namespace poprithms {
+namespace common {
+namespace compute {
+namespace dataflow {
+
+using poprithms::schedule::vanilla::CsrEdges;
+
+/**
+ * A work stealing executor for graphs of tasks with dependencies.
+ *
+ * The constructor starts nThreads - 1 worker threads, and the thread which
+ * calls #run is the final worker. Each worker has a deque of tasks which are
+ * ready to run: a worker takes tasks from the back of its own deque, and
+ * when it is empty it steals tasks from the front of the deques of the other
+ * workers. When a task completes, the tasks which depend on it have their
+ * counts of outstanding dependencies decremented, and those which reach 0
+ * are pushed to the back of the worker's deque.
+ *
+ * #run can be called from within a task (this is how the sub-graphs of ops
+ * with callees are run). The calling worker then runs (and steals) tasks
+ * until all of the tasks of the nested graph have completed, so a nested
+ * run does not need a thread of its own: the executor never uses more than
+ * its nThreads threads. This does not limit the threads used by the tasks
+ * themselves (for example, SimExecutable's replica threads).
+ *
+ * A worker which finds no task to run waits on a condition variable until
+ * a task is pushed (or until the run it is waiting for completes). The
+ * worker threads are kept between runs, so an Executor should be
+ * constructed once and used for many runs.
+ * */
+class Executor {
+
+public:
+  explicit Executor(uint64_t nThreads) {
+    workers.reserve(nThreads);
+    for (uint64_t t = 0; t < nThreads; ++t) {
+      workers.push_back(std::make_unique<Worker>());
+    }
+    threads.reserve(nThreads - 1);
+    for (uint64_t t = 1; t < nThreads; ++t) {
+      threads.emplace_back([this, t]() { work(t); });
+    }
+  }
+
+  ~Executor() {
+    done.store(true, std::memory_order_release);
+    notify();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  uint64_t nThreads() const { return workers.size(); }
+
+  /** A new executor with the same number of threads as this executor. */
+  std::unique_ptr<Executor> clone() const {
+    return std::make_unique<Executor>(nThreads());
+  }
+
+  /**
+   * Call f(i) for all nodes i of the graph with forward edges #edges, where
+   * f(i) is called after f(j) has returned for all edges j->i. #nIns[i] is
+   * the number of edges into node i.
+   *
+   * If any of the calls to f throw, no further calls are started, and one
+   * of the exceptions is rethrown once all started calls have returned.
+   * */
+  void run(const CsrEdges<uint64_t> &edges,
+           const std::vector<uint64_t> &nIns,
+           const std::function<void(uint64_t)> &f) {
+
+    const auto N = edges.size();
+    if (N == 0) {
+      return;
+    }
+
+    Run r(edges, f);
+    r.nOutstanding = std::vector<std::atomic<uint64_t>>(N);
+    r.nRemaining.store(N, std::memory_order_relaxed);
+    for (uint64_t i = 0; i < N; ++i) {
+      r.nOutstanding[i].store(nIns[i], std::memory_order_relaxed);
+    }
+
+    const auto w = currentWorker();
+
+    // Push the nodes without dependencies in reverse, so that the worker
+    // starts with the lowest node.
+    {
+      auto &worker = *workers[w];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      for (uint64_t i = N; i-- > 0;) {
+        if (nIns[i] == 0) {
+          worker.tasks.push_back({&r, i});
+        }
+      }
+    }
+    notify();
+
+    // Run tasks (which need not be tasks of this run) until this run has
+    // completed.
+    const auto previous = current();
+    current()           = {this, w};
+    while (r.nRemaining.load(std::memory_order_acquire) != 0) {
+      const auto seen = epoch.load();
+      Task task{nullptr, 0};
+      if (pop(w, task)) {
+        execute(task, w);
+      } else {
+        waitFor(seen, [&r]() {
+          return r.nRemaining.load(std::memory_order_acquire) == 0;
+        });
+      }
+    }
+    current() = previous;
+
+    if (r.failed.load(std::memory_order_acquire)) {
+      std::rethrow_exception(r.error);
+    }
+  }
+
+private:
+  struct Run {
+    Run(const CsrEdges<uint64_t> &edges_,
+        const std::function<void(uint64_t)> &f_)
+        : edges(edges_), f(f_) {}
+
+    const CsrEdges<uint64_t> &edges;
+    const std::function<void(uint64_t)> &f;
+
+    // The number of dependencies of each node which have not completed.
+    std::vector<std::atomic<uint64_t>> nOutstanding;
+
+    // The number of nodes which have not completed.
+    std::atomic<uint64_t> nRemaining{0};
+
+    std::atomic<bool> failed{false};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+  };
+
+  struct Task {
+    Run *run;
+    uint64_t node;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // The executor and worker index of the calling thread, if it is a worker.
+  struct Current {
+    const Executor *executor;
+    uint64_t worker;
+  };
+
+  static Current &current() {
+    static thread_local Current c{nullptr, 0};
+    return c;
+  }
+
+  // The worker index of the calling thread. A thread which is not one of
+  // the worker threads of this executor is worker 0.
+  uint64_t currentWorker() const {
+    return current().executor == this ? current().worker : 0;
+  }
+
+  void work(uint64_t w) {
+    current() = {this, w};
+    while (!done.load(std::memory_order_acquire)) {
+      const auto seen = epoch.load();
+      Task task{nullptr, 0};
+      if (pop(w, task)) {
+        execute(task, w);
+      } else {
+        waitFor(seen,
+                [this]() { return done.load(std::memory_order_acquire); });
+      }
+    }
+  }
+
+  // Wake the workers which are waiting in #waitFor. This is called after
+  // tasks are pushed, when a run completes, and when this executor is
+  // destroyed.
+  void notify() {
+    epoch.fetch_add(1);
+    if (nWaiting.load() != 0) {
+      std::lock_guard<std::mutex> lock(waitMutex);
+      wake.notify_all();
+    }
+  }
+
+  // Wait until #notify has been called since #epoch was #seen, or until
+  // #stop returns true. As #epoch is incremented before #nWaiting is read
+  // in #notify, and #nWaiting is incremented before #epoch is read here,
+  // either #notify sees this waiter, or this waiter sees the new #epoch.
+  template <typename Stop> void waitFor(uint64_t seen, Stop &&stop) {
+    nWaiting.fetch_add(1);
+    {
+      std::unique_lock<std::mutex> lock(waitMutex);
+      wake.wait(lock, [this, seen, &stop]() {
+        return epoch.load() != seen || stop();
+      });
+    }
+    nWaiting.fetch_sub(1);
+  }
+
+  // Take a task from the back of worker #w's deque, or steal one from the
+  // front of another worker's deque.
+  bool pop(uint64_t w, Task &task) {
+    {
+      auto &worker = *workers[w];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (!worker.tasks.empty()) {
+        task = worker.tasks.back();
+        worker.tasks.pop_back();
+        return true;
+      }
+    }
+    for (uint64_t d = 1; d < workers.size(); ++d) {
+      auto &victim = *workers[(w + d) % workers.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.front();
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void execute(const Task &task, uint64_t w) {
+    auto &r = *task.run;
+    if (!r.failed.load(std::memory_order_acquire)) {
+      try {
+        r.f(task.node);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(r.errorMutex);
+        if (!r.failed.load(std::memory_order_relaxed)) {
+          r.error = std::current_exception();
+          r.failed.store(true, std::memory_order_release);
+        }
+      }
+    }
+
+    // Release the dependent nodes. This is done even if a call failed, so
+    // that the run drains.
+    bool pushed{false};
+    {
+      auto &worker = *workers[w];
+      for (auto to : r.edges[task.node]) {
+        if (r.nOutstanding[to].fetch_sub(1, std::memory_order_acq_rel) ==
+            1) {
+          std::lock_guard<std::mutex> lock(worker.mutex);
+          worker.tasks.push_back({&r, to});
+          pushed = true;
+        }
+      }
+    }
+
+    // The run might be destroyed as soon as #nRemaining is 0, so it is not
+    // accessed after this.
+    const auto completed =
+        r.nRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    if (pushed || completed) {
+      notify();
+    }
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  std::atomic<bool> done{false};
+
+  // Incremented by #notify.
+  std::atomic<uint64_t> epoch{0};
+
+  // The number of threads in #waitFor.
+  std::atomic<uint64_t> nWaiting{0};
+  std::mutex waitMutex;
+  std::condition_variable wake;
+};
+
+} // namespace dataflow
+} // namespace compute
+} // namespace common
+} // namespace poprithms
+
+#endif
@@ -359,10 +359,9 @@ const Op &Graph::computeOp(OpId a) const {
 
 const Op &Graph::op(OpId a) const { return computeOp(a); }
 
-// See Scott Meyers' "Effective C++"
-Op &Graph::op(OpId id) {
-  return const_cast<Op &>(static_cast<const Graph &>(*this).op(id));
-}
+// The non-const multiout::Graph::op ensures that the op is not shared with
+// another graph, and so this cannot be implemented with the const version.
+Op &Graph::op(OpId id) { return static_cast<Op &>(multioutOp(id)); }
 
 DeviceIds Graph::deviceIds(const TensorIds &tIds) const {
   DeviceIds devIds;
@@ -10,7 +10,17 @@ namespace poprithms {
 namespace common {
 namespace compute {
 
-IExecutable::IExecutable(Graph &&m) : graph_(std::move(m)) {}
+namespace {
+// Executables can read their graphs from multiple threads, and so the ops
+// of their graphs must not point to (and read) other graphs, which might be
+// modified concurrently.
+Graph bound(Graph &&m) {
+  m.bindOps();
+  return std::move(m);
+}
+} // namespace
+
+IExecutable::IExecutable(Graph &&m) : graph_(bound(std::move(m))) {}
 
 void IExecutable::run(SubGraphId sgId) {
   if (!graph().isRunnable(sgId)) {
@@ -22,7 +32,13 @@ void IExecutable::run(SubGraphId sgId) {
         << "to specify which SubGraphs can be run. ";
     throw error(oss.str());
   }
+  if (!profiling_) {
+    executableSpecificRun(sgId);
+    return;
+  }
+  const auto t0 = profiler_.now();
   executableSpecificRun(sgId);
+  profiler_.recordRun(sgId, t0, profiler_.now());
 }
 
 using HostTensor = poprithms::compute::host::Tensor;
@@ -11,6 +11,12 @@ namespace poprithms {
 namespace common {
 namespace compute {
 
+void ISimState::runSubGraph(SubGraphId sgId) {
+  for (auto opId : schedule(sgId)) {
+    graph().computeOp(opId).runSim(*this);
+  }
+}
+
 void ISimState::noWeakVTables() {
   throw error(error::error::weakVTableMessage());
 }
@@ -78,11 +78,11 @@ void BinaryElementwiseInplace_::simpleBinaryElementwiseInplaceVerifyValid()
 }
 
 void Add::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0] + ins[1]);
+  ins[0].addInto(ins[1], outs[0]);
 }
 
 void Mul::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].mul(ins[1]));
+  ins[0].mulInto(ins[1], outs[0]);
 }
 
 void BinaryElementwiseInplace_::noInplaceAutodiff() const {
@@ -119,7 +119,7 @@ std::vector<OutIndex> Pow_::autodiffRequiredOuts() const {
  * Div
  * */
 void Div::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].divide(ins[1]));
+  ins[0].divideInto(ins[1], outs[0]);
 }
 
 /**
@@ -133,7 +133,7 @@ void Div_::compute(const HostTensors &ins, const HostTensors &outs) const {
  * Pow
  * */
 void Pow::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].pow(ins[1]));
+  ins[0].powInto(ins[1], outs[0]);
 }
 
 /**
@@ -151,18 +151,18 @@ UpOp Pow_::cloneWithState(const State &s) const {
  * */
 void GreaterThan::compute(const HostTensors &ins,
                           const HostTensors &outs) const {
-  outs[0].update_((ins[0] > ins[1]));
+  ins[0].greaterThanInto(ins[1], outs[0]);
 }
 
 void EqualTo::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_((ins[0] == ins[1]));
+  ins[0].equalToInto(ins[1], outs[0]);
 }
 
 /**
  * Sub
  * */
 void Sub::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0] - ins[1]);
+  ins[0].subtractInto(ins[1], outs[0]);
 }
 
 /**
@@ -220,7 +220,7 @@ BooleanBinaryElementwiseOutplace::autodiffRequiredOuts() const {
 
 void Remainder::compute(const HostTensors &ins,
                         const HostTensors &outs) const {
-  outs[0].update_(ins[0].mod(ins[1]));
+  ins[0].modInto(ins[1], outs[0]);
 }
 
 void Remainder_::compute(const HostTensors &ins, const HostTensors &) const {
@@ -228,7 +228,7 @@ void Remainder_::compute(const HostTensors &ins, const HostTensors &) const {
 }
 
 void Min::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].min(ins[1]));
+  ins[0].minInto(ins[1], outs[0]);
 }
 
 void Min_::compute(const HostTensors &ins, const HostTensors &outs) const {
@@ -236,7 +236,7 @@ void Min_::compute(const HostTensors &ins, const HostTensors &outs) const {
 }
 
 void Max::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].max(ins[1]));
+  ins[0].maxInto(ins[1], outs[0]);
 }
 
 void Max_::compute(const HostTensors &ins, const HostTensors &outs) const {
@@ -24,12 +24,18 @@ void CopyBetweenHostAndIpu_::initializeSimOut(SimTensorMap &htm) const {
 }
 
 void CopyBetweenHostAndIpu_::runSim(ISimState &iss) const {
-  auto &hts = iss.simTensorMap();
-  for (uint64_t r = 0; r < computeGraph().replicationFactor_u64(); ++r) {
-    // call into the virtual method which copies either to or from host.
-    runCopyHostSim(
-        hts[sourceId()], hts[destinationId()], r, hts.getCounterState(id()));
-  }
+  auto &hts          = iss.simTensorMap();
+  const auto &src    = hts[sourceId()];
+  const auto &dst    = hts[destinationId()];
+  const auto cbIndex = hts.getCounterState(id());
+
+  // The replicas copy to/from different slices of the host tensor, and so
+  // can be run concurrently.
+  hts.replicaParallelFor(
+      computeGraph().replicationFactor_u64(), [&](uint64_t r) {
+        // call into the virtual method which copies either to or from host.
+        runCopyHostSim(src, dst, r, cbIndex);
+      });
 
   // increment the index of the circular buffer.
   hts.incrementCounter(id());
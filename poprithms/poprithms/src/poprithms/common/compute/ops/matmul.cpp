@@ -12,7 +12,7 @@ bool MatMul::computeTypeSpecificEqualTo(const Op &rhs) const {
 }
 
 void MatMul::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].matmul(ins[1]).to(outDType(0)));
+  ins[0].matmulInto(ins[1], outs[0]);
 }
 
 HostTensors MatMul::initializeOut(const HostTensors &) const {
@@ -1,6 +1,8 @@
 // Copyright (c) 2022 Graphcore Ltd. All rights reserved.
 
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include <common/compute/error.hpp>
 
@@ -41,7 +43,7 @@ std::string Reduce::typeString() const {
   return oss.str();
 }
 void Reduce::compute(const HostTensors &ins, const HostTensors &outs) const {
-  outs[0].update_(ins[0].reduce(outShape(0), cop()));
+  ins[0].reduceInto(outs[0], cop());
 }
 
 /**
@@ -127,23 +129,28 @@ void ReduceAcrossReplicas::runSim(ISimState &hts) const {
   auto ins  = hts.simTensorMap().getValue(inTensorId(InIndex(0)));
   auto outs = hts.simTensorMap().getValue(outTensorId(OutIndex(0)));
 
-  auto replicasByGroup = grouping().groups();
-  HostTensors reductions;
-  reductions.reserve(grouping().nGroups());
+  const auto replicasByGroup = grouping().groups();
+  std::vector<std::unique_ptr<HostTensor>> reductions(replicasByGroup.size());
 
-  for (auto &&replicas : replicasByGroup) {
+  // Accumulate across replicas, with the groups processed concurrently. The
+  // replicas within a group are always accumulated in the same order, so
+  // that the result does not depend on the number of threads.
+  const auto &stm = hts.simTensorMap();
+  stm.replicaParallelFor(replicasByGroup.size(), [&](uint64_t g) {
     HostTensors ts;
-    for (auto r : replicas) {
+    ts.reserve(replicasByGroup[g].size());
+    for (auto r : replicasByGroup[g]) {
       ts.push_back(ins.at(r));
     }
-    // Accumulate across replicas:
-    reductions.push_back(HostTensor::accumulate(ts, cop()));
-  }
-
-  // Update local tensors:
-  for (uint64_t r = 0; r < outs.size(); ++r) {
-    outs.at(r).update_(reductions.at(grouping().group(r)));
-  }
+    reductions[g] =
+        std::make_unique<HostTensor>(HostTensor::accumulate(ts, cop()));
+  });
+
+  // Update local tensors (this is the barrier between the accumulation and
+  // the broadcast of the reductions back to the replicas):
+  stm.replicaParallelFor(outs.size(), [&](uint64_t r) {
+    outs.at(r).update_(*reductions.at(grouping().group(r)));
+  });
 }
 
 void ReduceAcrossReplicas::computeDerivedVerifyValid() const {
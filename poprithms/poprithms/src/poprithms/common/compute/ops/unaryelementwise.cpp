@@ -76,7 +76,7 @@ std::string Log_::whyNoAutodiff() const {
 }
 
 void Log::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.log());
+  i.logInto(o);
 }
 
 void Log_::unaryCompute(const HostTensor &, const HostTensor &o) const {
@@ -84,7 +84,7 @@ void Log_::unaryCompute(const HostTensor &, const HostTensor &o) const {
 }
 
 void Cast::unaryCompute(const HostTensor &ins, const HostTensor &outs) const {
-  outs.update_(ins.to(outDType(0)));
+  ins.toInto(outs);
 }
 
 bool Cast::gradientPropagates(OutIndex, InIndex) const {
@@ -126,7 +126,7 @@ void Fill_::unaryElementwiseDerivedVerifyValid() const {
 }
 
 void Exp::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.exp());
+  i.expInto(o);
 }
 
 void Exp_::unaryCompute(const HostTensor &i, const HostTensor &) const {
@@ -134,7 +134,7 @@ void Exp_::unaryCompute(const HostTensor &i, const HostTensor &) const {
 }
 
 void Neg::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.neg());
+  i.negInto(o);
 }
 
 void Neg_::unaryCompute(const HostTensor &i, const HostTensor &) const {
@@ -142,7 +142,7 @@ void Neg_::unaryCompute(const HostTensor &i, const HostTensor &) const {
 }
 
 void Inv::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.inverse());
+  i.reciprocalInto(o);
 }
 
 void Inv_::unaryCompute(const HostTensor &i, const HostTensor &) const {
@@ -150,7 +150,7 @@ void Inv_::unaryCompute(const HostTensor &i, const HostTensor &) const {
 }
 
 void Sqrt::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.sqrt());
+  i.sqrtInto(o);
 }
 
 void Sqrt_::unaryCompute(const HostTensor &i, const HostTensor &) const {
@@ -158,7 +158,7 @@ void Sqrt_::unaryCompute(const HostTensor &i, const HostTensor &) const {
 }
 
 void Sin::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.sin());
+  i.sinInto(o);
 }
 
 void Sin_::unaryCompute(const HostTensor &, const HostTensor &o) const {
@@ -166,7 +166,7 @@ void Sin_::unaryCompute(const HostTensor &, const HostTensor &o) const {
 }
 
 void Abs::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.abs());
+  i.absInto(o);
 }
 
 void Abs_::unaryCompute(const HostTensor &, const HostTensor &o) const {
@@ -174,7 +174,7 @@ void Abs_::unaryCompute(const HostTensor &, const HostTensor &o) const {
 }
 
 void Cos::unaryCompute(const HostTensor &i, const HostTensor &o) const {
-  o.update_(i.cos());
+  i.cosInto(o);
 }
 
 void Cos_::unaryCompute(const HostTensor &, const HostTensor &o) const {
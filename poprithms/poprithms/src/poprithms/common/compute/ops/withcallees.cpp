@@ -337,7 +337,7 @@ void WithCallees::extendAutodiffRequiredTensors(
 }
 
 void WithCallees::runSim(ISimState &hts) const {
-  computeDerivedVerifyValid();
+  // The op is validated once, when the SimExecutable is constructed.
   hostRun(SimHostRunner(hts));
 }
 
@@ -532,11 +532,7 @@ void IHostRunner::noWeakVTables() {
 }
 
 void SimHostRunner::run(SubGraphId sgId) const {
-  OpIds schedule = simState.schedule(sgId);
-  using namespace poprithms::schedule;
-  for (auto opId : schedule) {
-    simState.graph().computeOp(opId).runSim(simState);
-  }
+  simState.runSubGraph(sgId);
 }
 
 bool Call::gradientPropagates(OutIndex o, InIndex i) const {
@@ -984,38 +980,68 @@ void Repeat::hostRun(const IHostRunner &fb) const {
 
   fb.copies(inTensorIds(carriedInIndices()), inDsts(carriedInIndices()));
 
+  // The host tensors are updated in place, so they can be looked up once,
+  // before the first iteration, rather than in every iteration.
+  const auto stackedIns = stackedInIndices();
+  std::vector<HostTensors> stackedInSources;
+  std::vector<HostTensors> stackedInDsts;
+  for (auto i : stackedIns) {
+    stackedInSources.push_back(fb.tensor(inTensorId(i)));
+    stackedInDsts.push_back(fb.tensor(dstInCallee(i).tId()));
+    assertSizes(stackedInSources.back(), stackedInDsts.back());
+  }
+
+  const auto stackedOuts = stackedOutIndices();
+  std::vector<HostTensors> stackedOutSources;
+  std::vector<HostTensors> stackedOutDsts;
+  for (auto o : stackedOuts) {
+    stackedOutSources.push_back(
+        fb.tensor(outs().outSource(o, CalleeIndex(0))));
+    stackedOutDsts.push_back(fb.tensor(outTensorId(o)));
+    assertSizes(stackedOutSources.back(), stackedOutDsts.back());
+  }
+
+  const auto carriedFroms = fb.tensors(carriedFroms_);
+  const auto carriedTos   = fb.tensors(carriedTos_);
+  for (uint64_t n = 0; n < nCarriedTensors(); ++n) {
+    if (carriedFroms[n].size() != carriedTos[n].size()) {
+      throw error("Number of replicas for source and destination differ");
+    }
+  }
+
+  const auto calleeId = callee(CalleeIndex(0));
+
   for (uint64_t iter = 0; iter < repeatCount(); ++iter) {
 
     auto stackIndex = stackedCopyOrder() == StackedCopyOrder::Up
                           ? iter
                           : repeatCount() - 1 - iter;
 
-    for (auto i : stackedInIndices()) {
-      auto tSource = fb.tensor(inTensorId(i));
-      auto tDst    = fb.tensor(dstInCallee(i).tId());
-      assertSizes(tSource, tDst);
-      const auto rf = tSource.size();
-      for (uint64_t ri = 0; ri < rf; ++ri) {
+    for (uint64_t i = 0; i < stackedIns.size(); ++i) {
+      const auto &tSource = stackedInSources[i];
+      const auto &tDst    = stackedInDsts[i];
+      for (uint64_t ri = 0; ri < tSource.size(); ++ri) {
         tDst[ri].update_(tSource[ri].at(stackIndex));
       }
     }
 
-    fb.run(callee(CalleeIndex(0)));
+    fb.run(calleeId);
 
     // We must make sure this happens before the roll copies back.
-    for (auto o : stackedOutIndices()) {
-
-      auto tSource = fb.tensor(outs().outSource(o, CalleeIndex(0)));
-      auto tDst    = fb.tensor(outTensorId(o));
-      assertSizes(tSource, tDst);
-      const auto rf = tSource.size();
-      for (uint64_t ri = 0; ri < rf; ++ri) {
+    for (uint64_t o = 0; o < stackedOuts.size(); ++o) {
+      const auto &tSource = stackedOutSources[o];
+      const auto &tDst    = stackedOutDsts[o];
+      for (uint64_t ri = 0; ri < tSource.size(); ++ri) {
         tDst[ri].at_(stackIndex).update_(tSource[ri]);
       }
     }
 
     for (uint64_t n = 0; n < nCarriedTensors(); ++n) {
-      fb.copy(carriedFroms_[n], carriedTos_[n]);
+      const auto &tFrom = carriedFroms[n];
+      const auto &tTo   = carriedTos[n];
+      for (uint64_t ri = 0; ri < tFrom.size(); ++ri) {
+        tTo[ri].update_(tFrom[ri]);
+      }
     }
   }
 
@@ -1186,7 +1212,6 @@ Switch::Switch(const State &s,
 
 void Switch::hostRun(const IHostRunner &fb) const {
 
-  computeDerivedVerifyValid();
   auto condition = fb.tensor(conditionId());
   for (auto x : condition) {
     if (!(x - condition[0]).allZero()) {
@@ -177,11 +177,33 @@ void WithoutCallees::computeWithChecks(const HostTensors &ins,
 }
 
 void WithoutCallees::runReplicatedSim(SimTensorMap &hts) const {
+
+  // The replicas of an op have no shared outputs, so they can be run
+  // concurrently. If the host tensors have already been resolved and
+  // checked in an earlier run, the op's compute is called directly.
+  if (auto slots = hts.replicatedSlots(id())) {
+    hts.replicaParallelFor(slots->ins.size(), [this, slots](uint64_t r) {
+      compute(slots->ins[r], slots->outs[r]);
+    });
+    return;
+  }
+
   const auto rf = hts.getNTensorsByUnanimity(inAndOutTensorIds());
+  SimTensorMap::ReplicatedSlots resolved;
+  resolved.ins.reserve(rf);
+  resolved.outs.reserve(rf);
   for (uint64_t r = 0; r < rf; ++r) {
-    auto inTensors  = hts.getTensors(inTensorIds(), r);
-    auto outTensors = hts.getTensors(outTensorIds(), r);
-    computeWithChecks(inTensors, outTensors);
+    resolved.ins.push_back(hts.getTensors(inTensorIds(), r));
+    resolved.outs.push_back(hts.getTensors(outTensorIds(), r));
+  }
+
+  hts.replicaParallelFor(rf, [this, &resolved](uint64_t r) {
+    computeWithChecks(resolved.ins[r], resolved.outs[r]);
+  });
+
+  // Only store the slots once all of the replicas have passed the checks.
+  if (hts.canStoreReplicatedSlots(id())) {
+    hts.setReplicatedSlots(id(), std::move(resolved));
   }
 }
 
@@ -0,0 +1,339 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <poprithms/common/compute/graph.hpp>
+#include <poprithms/common/compute/profiler.hpp>
+#include <poprithms/util/stringutil.hpp>
+
+namespace poprithms {
+namespace common {
+namespace compute {
+
+namespace {
+
+// The number of host tensors which store the values of #tId.
+uint64_t nReplicas(const Graph &g, const TensorId &tId) {
+  return g.deviceType(tId) == DeviceType::Host ? 1
+                                               : g.replicationFactor_u64();
+}
+
+uint64_t totalBytes(const Graph &g, const TensorIds &tIds) {
+  uint64_t n{0};
+  for (const auto &tId : tIds) {
+    n += g.nbytes(tId) * nReplicas(g, tId);
+  }
+  return n;
+}
+
+std::string subGraphString(const Graph &g, SubGraphId sgId) {
+  const auto name = g.subGraphName(sgId);
+  return name.empty() ? "sg" + std::to_string(sgId.get_u64()) : name;
+}
+
+// The type string of an op, without its attributes. For example "Repeat"
+// for the op with type string "Repeat(id=0,repeatCount=3,...)".
+std::string opType(const Graph &g, OpId opId) {
+  const auto s = g.typeString(opId);
+  return s.substr(0, s.find('('));
+}
+
+std::string opString(const Graph &g, OpId opId) {
+  return opType(g, opId) + "(op=" + std::to_string(opId.get()) + ")";
+}
+
+// Escape the characters which cannot appear in JSON strings.
+std::string jsonString(const std::string &s) {
+  std::ostringstream oss;
+  oss << '"';
+  for (auto c : s) {
+    switch (c) {
+    case '"':
+      oss << "\\\"";
+      break;
+    case '\\':
+      oss << "\\\\";
+      break;
+    case '\n':
+      oss << "\\n";
+      break;
+    case '\t':
+      oss << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << static_cast<int>(c) << std::dec << std::setfill(' ');
+      } else {
+        oss << c;
+      }
+    }
+  }
+  oss << '"';
+  return oss.str();
+}
+
+double microseconds(uint64_t ns) { return static_cast<double>(ns) / 1e3; }
+
+// A table of #stats, sorted by decreasing self time.
+template <typename Key, typename F>
+std::string table(const std::string &title,
+                  const std::map<Key, OpProfiler::Stats> &stats,
+                  uint64_t maxRows,
+                  F &&keyString) {
+
+  std::vector<std::pair<double, Key>> order;
+  double totalSelf{0};
+  for (const auto &[key, s] : stats) {
+    order.push_back({s.selfSeconds, key});
+    totalSelf += s.selfSeconds;
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](const auto &a, const auto &b) {
+        return a.first > b.first;
+      });
+
+  std::vector<std::string> keys;
+  std::vector<std::string> counts;
+  std::vector<std::string> times;
+  std::vector<std::string> selfTimes;
+  std::vector<std::string> percentages;
+  std::vector<std::string> reads;
+  std::vector<std::string> writes;
+  for (uint64_t i = 0; i < std::min<uint64_t>(maxRows, order.size()); ++i) {
+    const auto &s = stats.at(order[i].second);
+    keys.push_back(keyString(order[i].second));
+    counts.push_back(std::to_string(s.nInvocations));
+    times.push_back(std::to_string(s.seconds));
+    selfTimes.push_back(std::to_string(s.selfSeconds));
+    std::ostringstream perc;
+    perc << std::fixed << std::setprecision(1)
+         << (totalSelf > 0 ? 100. * s.selfSeconds / totalSelf : 0.) << " %";
+    percentages.push_back(perc.str());
+    reads.push_back(std::to_string(s.bytesRead));
+    writes.push_back(std::to_string(s.bytesWritten));
+  }
+
+  using Parameters = poprithms::util::StringColumn::Parameters;
+  const auto right = Parameters().alignType(util::StringColumn::Align::Right);
+  return util::alignedColumns({{title, keys, Parameters()},
+                               {"Count", counts, right},
+                               {"Time [s]", times, right},
+                               {"Self [s]", selfTimes, right},
+                               {"Self", percentages, right},
+                               {"Read [B]", reads, right},
+                               {"Written [B]", writes, right}});
+}
+
+} // namespace
+
+OpProfiler::OpProfiler() : start_(std::chrono::steady_clock::now()) {}
+
+OpProfiler::OpProfiler(const OpProfiler &rhs) {
+  std::lock_guard<std::mutex> lock(rhs.mutex_);
+  start_     = rhs.start_;
+  opEvents_  = rhs.opEvents_;
+  runEvents_ = rhs.runEvents_;
+  threads_   = rhs.threads_;
+}
+
+OpProfiler &OpProfiler::operator=(const OpProfiler &rhs) {
+  if (this != &rhs) {
+    std::scoped_lock lock(mutex_, rhs.mutex_);
+    start_     = rhs.start_;
+    opEvents_  = rhs.opEvents_;
+    runEvents_ = rhs.runEvents_;
+    threads_   = rhs.threads_;
+  }
+  return *this;
+}
+
+uint64_t OpProfiler::now() const {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_)
+          .count());
+}
+
+uint64_t OpProfiler::threadIndex() {
+  const auto id = std::this_thread::get_id();
+  auto found    = threads_.find(id);
+  if (found == threads_.cend()) {
+    found = threads_.insert({id, threads_.size()}).first;
+  }
+  return found->second;
+}
+
+void OpProfiler::recordOp(OpId opId,
+                          const OpIds &callStack,
+                          uint64_t startNs,
+                          uint64_t endNs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  opEvents_.push_back(
+      {opId, callStack, startNs, endNs - startNs, threadIndex()});
+}
+
+void OpProfiler::recordRun(SubGraphId sgId,
+                           uint64_t startNs,
+                           uint64_t endNs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  runEvents_.push_back({sgId, startNs, endNs - startNs, threadIndex()});
+}
+
+void OpProfiler::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  opEvents_.clear();
+  runEvents_.clear();
+  start_ = std::chrono::steady_clock::now();
+}
+
+std::vector<OpProfiler::OpEvent> OpProfiler::opEvents() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return opEvents_;
+}
+
+std::vector<OpProfiler::RunEvent> OpProfiler::runEvents() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return runEvents_;
+}
+
+uint64_t OpProfiler::bytesRead(const Graph &g, OpId opId) {
+  return totalBytes(g, g.inTensorIds(opId));
+}
+
+uint64_t OpProfiler::bytesWritten(const Graph &g, OpId opId) {
+  return totalBytes(g, g.outTensorIds(opId));
+}
+
+std::string OpProfiler::callStackString(const Graph &g,
+                                        const OpEvent &e) const {
+  std::ostringstream oss;
+  const auto &cs = e.callStack;
+  oss << subGraphString(g, g.subGraphId(cs.empty() ? e.opId : cs[0]));
+  for (uint64_t i = 0; i < cs.size(); ++i) {
+    const auto next = i + 1 < cs.size() ? cs[i + 1] : e.opId;
+    oss << '/' << opString(g, cs[i]) << '/'
+        << subGraphString(g, g.subGraphId(next));
+  }
+  return oss.str();
+}
+
+template <typename Key, typename F>
+std::map<Key, OpProfiler::Stats> OpProfiler::aggregate(const Graph &g,
+                                                       F &&key) const {
+  const auto events = opEvents();
+
+  std::map<Key, Stats> stats;
+  std::map<OpId, std::pair<uint64_t, uint64_t>> bytes;
+  for (const auto &e : events) {
+    auto found = bytes.find(e.opId);
+    if (found == bytes.cend()) {
+      found = bytes
+                  .insert({e.opId,
+                           {bytesRead(g, e.opId), bytesWritten(g, e.opId)}})
+                  .first;
+    }
+
+    const auto seconds = static_cast<double>(e.durationNs) / 1e9;
+    auto &s            = stats[key(e)];
+    ++s.nInvocations;
+    s.seconds += seconds;
+    s.selfSeconds += seconds;
+    s.bytesRead += found->second.first;
+    s.bytesWritten += found->second.second;
+
+    // The time of this op is not self time of the op which called it.
+    if (!e.callStack.empty()) {
+      const OpEvent caller{
+          e.callStack.back(),
+          OpIds(e.callStack.cbegin(), std::prev(e.callStack.cend())),
+          0,
+          0,
+          0};
+      stats[key(caller)].selfSeconds -= seconds;
+    }
+  }
+
+  // Ops with callees which are run concurrently (in dataflow mode) can have
+  // less time than their callees.
+  for (auto &kv : stats) {
+    kv.second.selfSeconds = std::max(0., kv.second.selfSeconds);
+  }
+  return stats;
+}
+
+std::map<OpId, OpProfiler::Stats>
+OpProfiler::statsByOp(const Graph &g) const {
+  return aggregate<OpId>(g, [](const OpEvent &e) { return e.opId; });
+}
+
+std::map<std::string, OpProfiler::Stats>
+OpProfiler::statsByOpType(const Graph &g) const {
+  return aggregate<std::string>(
+      g, [&g](const OpEvent &e) { return opType(g, e.opId); });
+}
+
+std::map<std::string, OpProfiler::Stats>
+OpProfiler::statsByCallStack(const Graph &g) const {
+  return aggregate<std::string>(
+      g, [this, &g](const OpEvent &e) { return callStackString(g, e); });
+}
+
+void OpProfiler::appendChromeTrace(std::ostream &ost, const Graph &g) const {
+
+  const auto ops  = opEvents();
+  const auto runs = runEvents();
+
+  ost << "{\"traceEvents\":[";
+  bool first{true};
+  auto separate = [&ost, &first]() {
+    ost << (first ? "\n" : ",\n");
+    first = false;
+  };
+
+  for (const auto &e : runs) {
+    separate();
+    ost << "{\"name\":"
+        << jsonString("run(" + subGraphString(g, e.subGraphId) + ")")
+        << ",\"cat\":\"run\",\"ph\":\"X\",\"ts\":" << microseconds(e.startNs)
+        << ",\"dur\":" << microseconds(e.durationNs)
+        << ",\"pid\":0,\"tid\":" << e.thread << '}';
+  }
+
+  for (const auto &e : ops) {
+    separate();
+    ost << "{\"name\":" << jsonString(opType(g, e.opId))
+        << ",\"cat\":\"op\",\"ph\":\"X\",\"ts\":" << microseconds(e.startNs)
+        << ",\"dur\":" << microseconds(e.durationNs)
+        << ",\"pid\":0,\"tid\":" << e.thread
+        << ",\"args\":{\"op\":" << e.opId.get()
+        << ",\"type\":" << jsonString(g.typeString(e.opId))
+        << ",\"callStack\":" << jsonString(callStackString(g, e))
+        << ",\"bytesRead\":" << bytesRead(g, e.opId)
+        << ",\"bytesWritten\":" << bytesWritten(g, e.opId) << "}}";
+  }
+  ost << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+std::string OpProfiler::summary(const Graph &g, uint64_t maxRows) const {
+  std::ostringstream oss;
+  oss << table("Op type",
+               statsByOpType(g),
+               maxRows,
+               [](const std::string &s) { return s; })
+      << '\n'
+      << table("Call stack",
+               statsByCallStack(g),
+               maxRows,
+               [](const std::string &s) { return s; })
+      << '\n'
+      << table("Op", statsByOp(g), maxRows, [&g](OpId opId) {
+           return opString(g, opId);
+         });
+  return oss.str();
+}
+
+} // namespace compute
+} // namespace common
+} // namespace poprithms
@@ -0,0 +1,136 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <set>
+#include <sstream>
+
+#include <common/compute/error.hpp>
+
+#include <poprithms/common/compute/prune/incrementalpruner.hpp>
+#include <poprithms/common/compute/prune/pruner.hpp>
+
+namespace poprithms {
+namespace common {
+namespace compute {
+
+IncrementalPruner::IncrementalPruner(Graph &g, const TensorIds &retain)
+    : graph_(&g), retain_(retain),
+      retainSet_(retain.cbegin(), retain.cend()) {
+  fullPrune();
+}
+
+void IncrementalPruner::fullPrune() {
+
+  Pruner::prune(graph(), retain_);
+
+  // Start recording changes from the pruned graph.
+  graph().setTrackConsumerChanges(true);
+  graph().takeConsumerChanges();
+
+  runnable_ = graph().runnable();
+  examinable_.clear();
+  examinable_.insert(runnable_.cbegin(), runnable_.cend());
+  hasRefs_ = false;
+  for (auto opId : graph().opIds()) {
+    for (auto callee : graph().callees(opId)) {
+      examinable_.erase(callee);
+    }
+    for (OutIndex o = 0; o < graph().nOutTensors(opId); ++o) {
+      hasRefs_ = hasRefs_ || !graph().refsExcludingSelf({opId, o}).empty();
+    }
+  }
+
+  nxtOpId_ = graph().nxtOpId();
+  ++nFullPrunes_;
+}
+
+bool IncrementalPruner::canExamine(OpId opId) const {
+  const auto &g = *graph_;
+  if (g.nCallees(opId) != 0 ||
+      examinable_.count(g.subGraphId(opId)) == 0) {
+    return false;
+  }
+  for (OutIndex o = 0; o < g.nOutTensors(opId); ++o) {
+    if (!g.refsExcludingSelf({opId, o}).empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IncrementalPruner::isPruneable(OpId opId) const {
+  for (OutIndex o = 0; o < graph_->nOutTensors(opId); ++o) {
+    if (retainSet_.count({opId, o}) != 0 ||
+        graph_->hasConsumptionIds({opId, o})) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void IncrementalPruner::prune() {
+
+  nExamined_ = 0;
+
+  // Changes which cannot be pruned without analysing call stacks, or a
+  // retained tensor which has been removed (an error in Pruner::prune).
+  bool full = hasRefs_ || graph().runnable() != runnable_ ||
+              !graph().tracksConsumerChanges();
+  for (const auto &tId : retain_) {
+    full = full || !graph().isLive(tId.opId());
+  }
+
+  // The ops which have been inserted, and the ops whose consumers have
+  // changed, since the previous prune.
+  auto toExamine = graph().takeConsumerChanges();
+  for (OpId opId = nxtOpId_; opId < graph().nxtOpId(); ++opId) {
+    toExamine.push_back(opId);
+  }
+
+  for (auto opId : toExamine) {
+    full = full || (graph().isLive(opId) && !canExamine(opId));
+  }
+
+  if (full) {
+    fullPrune();
+    return;
+  }
+
+  while (!toExamine.empty()) {
+    const auto opId = toExamine.back();
+    toExamine.pop_back();
+    if (!graph().isLive(opId)) {
+      continue;
+    }
+    ++nExamined_;
+
+    if (!isPruneable(opId)) {
+      continue;
+    }
+
+    // The producers of the inputs of #opId are reached while removing ops,
+    // and can have callees.
+    if (!canExamine(opId)) {
+      fullPrune();
+      return;
+    }
+
+    for (const auto &inId : graph().inTensorIds(opId)) {
+      toExamine.push_back(inId.opId());
+    }
+
+    std::ostringstream ctxt;
+    ctxt << "[incremental pruning] " << graph().str(opId)
+         << " is not on a path to an unpruneable back source. ";
+    graph().removeOp(
+        opId, OptionalTensorIds(graph().nOutTensors(opId)), ctxt.str());
+  }
+
+  // The changes made by this method are all examined above.
+  graph().takeConsumerChanges();
+  nxtOpId_ = graph().nxtOpId();
+  ++nIncrementalPrunes_;
+}
+
+} // namespace compute
+} // namespace common
+} // namespace poprithms
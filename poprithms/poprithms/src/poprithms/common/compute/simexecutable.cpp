@@ -2,10 +2,23 @@
 
 #include "error.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <limits>
+#include <map>
 #include <memory>
+#include <optional>
+#include <queue>
+#include <set>
+#include <vector>
 
+#include <common/compute/dataflow.hpp>
+
+#include <poprithms/common/compute/ops/withcallees.hpp>
 #include <poprithms/common/compute/scheduler.hpp>
 #include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/schedule/vanilla/vanilla.hpp>
 #include <poprithms/util/copybyclone_impl.hpp>
 
 namespace poprithms {
@@ -13,12 +26,243 @@ namespace common {
 namespace compute {
 
 using poprithms::common::compute::Graph;
+using poprithms::compute::host::BufferPool;
 
 SimExecutable::SimExecutable(SimExecutable &&)         = default;
 SimExecutable::SimExecutable(const SimExecutable &rhs) = default;
 
 namespace {
-SimTensorMap initHostSimTensors(const Graph &m) {
+
+// The tensors of the ops #opIds, partitioned into the components of the
+// graph whose edges are between the inputs and outputs of ops which alias
+// each other. Each tensor is mapped to a tensor of its component, which is
+// the same for all of the tensors in the component.
+std::map<TensorId, TensorId> getAliasRoots(const Graph &graph,
+                                           const OpIds &opIds) {
+
+  // Union-find of the tensors which are aliased by an op.
+  std::map<TensorId, TensorId> parents;
+  auto root = [&parents](TensorId tId) {
+    auto found = parents.find(tId);
+    while (found != parents.cend() && found->second != tId) {
+      tId   = found->second;
+      found = parents.find(tId);
+    }
+    return tId;
+  };
+
+  for (auto opId : opIds) {
+    for (InIndex i = 0; i < graph.nInTensors(opId); ++i) {
+      for (OutIndex o = 0; o < graph.nOutTensors(opId); ++o) {
+        if (graph.aliases(opId, i, o)) {
+          const auto a = root(graph.inTensorId(opId, i));
+          const auto b = root(graph.outTensorId(opId, o));
+          if (a != b) {
+            parents[b] = a;
+          }
+        }
+      }
+    }
+  }
+
+  std::map<TensorId, TensorId> roots;
+  for (auto opId : opIds) {
+    for (const auto &tId : graph.inAndOutTensorIds(opId)) {
+      roots.insert({tId, root(tId)});
+    }
+  }
+  return roots;
+}
+
+bool isRefRelated(const Graph &graph, const TensorId &tId) {
+  return !graph.isRootRef(tId) || graph.hasDerivedRefs(tId);
+}
+
+// If the output #o of op #opId is a new allocation, and not an alias of one
+// of the op's inputs or a reference to a tensor in another sub-graph.
+bool isAllocation(const Graph &graph, OpId opId, OutIndex o) {
+  if (!graph.isRootRef({opId, o})) {
+    return false;
+  }
+  for (InIndex i = 0; i < graph.nInTensors(opId); ++i) {
+    if (graph.aliases(opId, i, o)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * The assignment of intermediate tensors to shared buffers, for
+ * SimMemoryMode::Planned.
+ * */
+struct MemoryPlan {
+  struct Buffer {
+    poprithms::ndarray::DType dtype;
+    uint64_t nelms;
+  };
+  std::vector<Buffer> buffers;
+
+  // The index in #buffers of each planned tensor.
+  std::map<TensorId, uint64_t> bufferIndices;
+};
+
+/**
+ * Plan the buffers of the tensors of the graph #graph, whose sub-graphs
+ * have the schedules #schedules.
+ *
+ * A tensor is planned if it is a new allocation (see #isAllocation), and
+ * the values of all of the tensors which it is aliased to (through the
+ * aliasing ops of its sub-graph) are only used by the ops of the sub-graph,
+ * between the op which creates it and its final consumer in the schedule.
+ * This excludes tensors which
+ *
+ *  - are host or remote tensors, which are visible to the user,
+ *  - are references to, or are referenced from, tensors in other
+ *    sub-graphs (see the RefFrom op),
+ *  - are created by initializing ops (variables and constants), whose values
+ *    persist across runs, or have initial values,
+ *  - are copied to or from by ops with callees, or are created by them.
+ *
+ * The lifetime of a planned tensor is the range of the schedule from the
+ * first op which creates a tensor in its alias component to the final op
+ * which uses one. Planned tensors of the same sub-graph, with the same type
+ * and number of elements, whose lifetimes do not overlap share a buffer.
+ * Buffers are not shared between sub-graphs, as a sub-graph can be run
+ * while a sub-graph which calls it is part way through its schedule.
+ * */
+MemoryPlan planMemory(const Graph &graph,
+                      const std::map<SubGraphId, OpIds> &schedules) {
+
+  // The tensors which ops with callees copy to or from.
+  std::set<TensorId> copied;
+  for (auto opId : graph.opIds()) {
+    const auto wc = graph.dynamicCast<WithCallees>(opId);
+    if (!wc) {
+      continue;
+    }
+    for (const auto &ctId : wc->inDsts()) {
+      copied.insert(ctId.tId());
+    }
+    for (CalleeIndex ci = 0; ci < wc->nCallees(); ++ci) {
+      for (OutIndex o = 0; o < wc->nOutTensors(); ++o) {
+        if (wc->isCopiedOut(o, ci)) {
+          copied.insert(wc->srcInCallee(o, ci));
+        }
+      }
+    }
+    if (const auto rpt = graph.dynamicCast<Repeat>(opId)) {
+      for (const auto &tId :
+           rpt->carriedFroms(rpt->inDsts(rpt->carriedInIndices()))) {
+        copied.insert(tId);
+      }
+    }
+  }
+
+  // Views are created by initializing ops, but only allocations by
+  // initializing ops (variables and constants) persist across runs.
+  auto isPlannable = [&graph, &copied](const TensorId &tId) {
+    const auto &op = graph.computeOp(tId.opId());
+    const auto o   = tId.outIndex();
+    return op.outDeviceType(o) == DeviceType::Ipu &&
+           !isRefRelated(graph, tId) && copied.count(tId) == 0 &&
+           !(op.isInitializingOp() && isAllocation(graph, tId.opId(), o)) &&
+           !op.hasCallees() && op.initialValues(o).empty();
+  };
+
+  MemoryPlan plan;
+
+  for (const auto &[sgId, schedule] : schedules) {
+
+    std::map<OpId, uint64_t> positions;
+    for (uint64_t i = 0; i < schedule.size(); ++i) {
+      positions.insert({schedule[i], i});
+    }
+
+    // The lifetimes of the alias components of the sub-graph, and whether
+    // all of their tensors are plannable.
+    struct Component {
+      uint64_t start;
+      uint64_t end;
+      bool plannable;
+    };
+    std::map<TensorId, Component> components;
+
+    const auto roots = getAliasRoots(graph, graph.opIds(sgId));
+    for (const auto &[tId, root] : roots) {
+
+      // Ops which are not scheduled (such as view changes) do not run, and
+      // so do not extend the lifetime.
+      auto start = std::numeric_limits<uint64_t>::max();
+      uint64_t end{0};
+      const auto found = positions.find(tId.opId());
+      if (found != positions.cend()) {
+        start = found->second;
+        end   = found->second;
+      }
+      for (const auto &c : graph.consumptionIds(tId)) {
+        const auto consumer = positions.find(c.opId());
+        if (consumer != positions.cend()) {
+          end = std::max(end, consumer->second);
+        }
+      }
+
+      const bool plannable = isPlannable(tId);
+      auto iter            = components.find(root);
+      if (iter == components.cend()) {
+        components.insert({root, {start, end, plannable}});
+      } else {
+        auto &c     = iter->second;
+        c.start     = std::min(c.start, start);
+        c.end       = std::max(c.end, end);
+        c.plannable = c.plannable && plannable;
+      }
+    }
+
+    // Assign buffers to the planned tensors in the order in which they are
+    // created. A buffer is free once the lifetime of the tensor it was last
+    // assigned to has ended before the current op.
+    using Key = std::pair<poprithms::ndarray::DType, uint64_t>;
+    std::map<Key, std::vector<uint64_t>> freeBuffers;
+
+    // The buffers which are in use, and the ends of the lifetimes of the
+    // tensors which use them, with the earliest end at the top.
+    using Use = std::pair<uint64_t, uint64_t>;
+    std::priority_queue<Use, std::vector<Use>, std::greater<Use>> active;
+
+    for (uint64_t i = 0; i < schedule.size(); ++i) {
+      while (!active.empty() && active.top().first < i) {
+        const auto &b = plan.buffers[active.top().second];
+        freeBuffers[{b.dtype, b.nelms}].push_back(active.top().second);
+        active.pop();
+      }
+
+      for (const auto &tId : graph.outTensorIds(schedule[i])) {
+        const auto &c = components.at(roots.at(tId));
+        if (!c.plannable ||
+            !isAllocation(graph, tId.opId(), tId.outIndex())) {
+          continue;
+        }
+        const Key key{graph.dtype(tId), graph.nelms_u64(tId)};
+        auto &available = freeBuffers[key];
+        uint64_t b;
+        if (available.empty()) {
+          b = plan.buffers.size();
+          plan.buffers.push_back({key.first, key.second});
+        } else {
+          b = available.back();
+          available.pop_back();
+        }
+        plan.bufferIndices.insert({tId, b});
+        active.push({c.end, b});
+      }
+    }
+  }
+
+  return plan;
+}
+
+SimTensorMap initHostSimTensors(const Graph &m, const MemoryPlan &plan) {
 
   SimTensorMap htm;
 
@@ -31,19 +275,112 @@ SimTensorMap initHostSimTensors(const Graph &m) {
       htm.push_back({});
     }
   }
+  htm.initReplicatedSlots(static_cast<uint64_t>(m.nxtOpId().get()));
+
+  // The buffers of the planned tensors, one host tensor per replica.
+  std::vector<HostTensors> buffers(plan.buffers.size());
+  for (uint64_t b = 0; b < buffers.size(); ++b) {
+    for (uint64_t r = 0; r < m.replicationFactor_u64(); ++r) {
+      const auto &buffer = plan.buffers[b];
+      buffers[b].push_back(HostTensor::zeros(
+          buffer.dtype, {static_cast<int64_t>(buffer.nelms)}));
+    }
+  }
+
+  auto views = [&m, &plan, &buffers](const TensorId &tId) {
+    HostTensors vs;
+    for (const auto &t : buffers[plan.bufferIndices.at(tId)]) {
+      vs.push_back(t.reshape_(m.shape(tId)));
+    }
+    return vs;
+  };
 
-  // populate all tensor vectors.
+  // populate all tensor vectors. The outputs of an op which are planned are
+  // views of their buffers, and are set before any of the ops which alias
+  // them are initialized.
   for (auto opId : Scheduler::vanillaLoweringSchedule(m)) {
+    const auto outs = m.outTensorIds(opId);
+    const auto nPlanned =
+        std::count_if(outs.cbegin(), outs.cend(), [&plan](const auto &tId) {
+          return plan.bufferIndices.count(tId) != 0;
+        });
+
+    // Planned tensors are new allocations without initial values, so an op
+    // whose outputs are all planned does not need to be initialized.
+    if (nPlanned != 0 && static_cast<uint64_t>(nPlanned) == outs.size()) {
+      for (const auto &tId : outs) {
+        htm.setValue(tId, views(tId));
+      }
+      continue;
+    }
+
+    // An op with some outputs which are not planned allocates all of its
+    // outputs, and the planned ones are then replaced.
     m.computeOp(opId).initSimOut(htm);
+    if (nPlanned != 0) {
+      for (const auto &tId : outs) {
+        if (plan.bufferIndices.count(tId) != 0) {
+          htm.setValue(tId, views(tId));
+        }
+      }
+    }
   }
 
   return htm;
 }
 
+SimMemoryStats getMemoryStats(const Graph &m,
+                              const MemoryPlan &plan,
+                              const SimTensorMap &htm) {
+  SimMemoryStats stats;
+  uint64_t nPlannedBytes{0};
+  for (auto opId : m.opIds()) {
+    for (OutIndex o = 0; o < m.nOutTensors(opId); ++o) {
+      if (isAllocation(m, opId, o)) {
+        uint64_t n{0};
+        for (const auto &t : htm.getValue({opId, o})) {
+          n += t.nbytes();
+        }
+        stats.peakBytesUnplanned += n;
+        if (plan.bufferIndices.count({opId, o}) != 0) {
+          nPlannedBytes += n;
+          ++stats.nPlannedTensors;
+        }
+      }
+    }
+  }
+
+  uint64_t nBufferBytes{0};
+  for (const auto &b : plan.buffers) {
+    nBufferBytes += b.nelms * poprithms::ndarray::nbytes_u64(b.dtype) *
+                    m.replicationFactor_u64();
+  }
+
+  stats.nBuffers  = plan.buffers.size();
+  stats.peakBytes = stats.peakBytesUnplanned - nPlannedBytes + nBufferBytes;
+  return stats;
+}
+
+// The ops with callees through which the op currently being run on this
+// thread was run. Only maintained while profiling.
+OpIds &currentCallStack() {
+  static thread_local OpIds callStack;
+  return callStack;
+}
+
 class SimState final : public ISimState {
 public:
-  SimState(SimTensorMap &stm, const SimExecutable &se)
-      : pSimTensorMap(&stm), simExecutable(se) {}
+  /**
+   * If #executor is not nullptr, sub-graphs are run with it, using the
+   * SimExecutable's dataflow graphs. If #profiler is not nullptr, every op
+   * run is recorded with it.
+   * */
+  SimState(SimTensorMap &stm,
+           const SimExecutable &se,
+           dataflow::Executor *executor,
+           OpProfiler *profiler)
+      : pSimTensorMap(&stm), simExecutable(se), pExecutor(executor),
+        pProfiler(profiler) {}
 
   const Graph &graph() const { return simExecutable.graph(); }
 
@@ -53,21 +390,254 @@ public:
 
   SimTensorMap &simTensorMap() const final { return *pSimTensorMap; }
 
+  void runSubGraph(SubGraphId sgId) final {
+
+    // The call stack of the ops of #sgId. In dataflow mode the ops might be
+    // run on other threads, so it is captured here.
+    const auto callStack = pProfiler ? currentCallStack() : OpIds{};
+
+    if (!pExecutor) {
+      for (auto opId : schedule(sgId)) {
+        runOp(graph().computeOp(opId), callStack);
+      }
+      return;
+    }
+    // The ops might be run on other threads, which use the buffer pool of
+    // this thread.
+    const auto pool = BufferPool::current();
+    const auto &dfg = simExecutable.dataflowGraph(sgId);
+    pExecutor->run(
+        dfg.edges, dfg.nIns, [this, &dfg, &callStack, &pool](uint64_t i) {
+          const auto &op = graph().computeOp(dfg.ops[i]);
+          if (!op.isInitializingOp()) {
+            BufferPool::Scope scope(pool);
+            runOp(op, callStack);
+          }
+        });
+  }
+
 private:
+  void runOp(const Op &op, const OpIds &callStack) {
+    if (!pProfiler) {
+      op.runSim(*this);
+      return;
+    }
+
+    auto timedRun = [this, &op, &callStack]() {
+      const auto t0 = pProfiler->now();
+      op.runSim(*this);
+      pProfiler->recordOp(op.id(), callStack, t0, pProfiler->now());
+    };
+
+    if (!op.hasCallees()) {
+      timedRun();
+      return;
+    }
+
+    // The callees of #op are run with #op appended to the call stack. The
+    // previous call stack of this thread is restored afterwards, even if
+    // #op throws.
+    struct Restorer {
+      OpIds previous;
+      ~Restorer() { currentCallStack() = std::move(previous); }
+    } restorer{currentCallStack()};
+    currentCallStack() = callStack;
+    currentCallStack().push_back(op.id());
+    timedRun();
+  }
+
   SimTensorMap *pSimTensorMap;
   const SimExecutable &simExecutable;
+  dataflow::Executor *pExecutor;
+  OpProfiler *pProfiler;
+};
+
+/**
+ * Constructs the dataflow graphs of the sub-graphs of a graph.
+ *
+ * The forward edge map of a sub-graph has the data and control dependencies
+ * of its ops, and the constraints which ensure that ops which modify a
+ * tensor are the final consumers of its aliases. Ops which are not ordered
+ * by these may be run concurrently. This is not correct for:
+ *
+ * (1) ops with callees which share a sub-graph (directly or through nested
+ *     callees), as the tensors of the sub-graph are shared.
+ *
+ * (2) ops which use tensors which are references to, or are referenced
+ *     from, tensors in other sub-graphs (see the RefFrom op). Aliasing
+ *     through references is not considered by the modifier constraints,
+ *     and the references can be modified by ops in callees.
+ *
+ * Ops of type (1) which share a sub-graph, and all ops of type (2), are
+ * therefore constrained to run in the order of the schedule.
+ * */
+class DataflowGraphBuilder {
+public:
+  DataflowGraphBuilder(const Graph &g) : graph(g) {}
+
+  SimExecutable::DataflowGraph build(SubGraphId sgId, OpIds &schedule) {
+
+    using namespace poprithms::schedule::vanilla;
+
+    auto fem = graph.getSubGraphForwardEdgeMap_u64(sgId);
+
+    const auto compactSchedule = getSchedule_u64(
+        fem.fwdEdgesCompact(), ErrorIfCycle::Yes, VerifyEdges::No);
+
+    schedule.clear();
+    for (auto c : compactSchedule) {
+      if (!graph.computeOp(fem.opId(c)).isInitializingOp()) {
+        schedule.push_back(fem.opId(c));
+      }
+    }
+
+    const auto sharedTensors = getTensorsAliasedToRefs(sgId);
+
+    std::optional<OpId> prevShared;
+    std::map<SubGraphId, OpId> prevCaller;
+    for (auto opId : schedule) {
+
+      std::set<SubGraphId> called;
+      for (auto callee : graph.computeOp(opId).callees()) {
+        const auto &c = closure(callee);
+        called.insert(c.cbegin(), c.cend());
+      }
+
+      bool shared = std::any_of(
+          called.cbegin(), called.cend(), [this](SubGraphId c) {
+            return hasRefs(c);
+          });
+      for (const auto &tIds :
+           {graph.inTensorIds(opId), graph.outTensorIds(opId)}) {
+        for (const auto &tId : tIds) {
+          shared |= sharedTensors.count(tId) != 0;
+        }
+      }
+
+      if (shared) {
+        if (prevShared.has_value()) {
+          fem.insertEdge(prevShared.value(), opId);
+        }
+        prevShared = opId;
+      }
+
+      for (auto c : called) {
+        auto found = prevCaller.find(c);
+        if (found != prevCaller.cend()) {
+          fem.insertEdge(found->second, opId);
+          found->second = opId;
+        } else {
+          prevCaller.insert({c, opId});
+        }
+      }
+    }
+
+    const auto &fwd = fem.fwdEdgesCompact();
+    std::vector<uint64_t> nIns(fwd.size(), 0);
+    for (const auto &outs : fwd) {
+      for (auto o : outs) {
+        ++nIns[o];
+      }
+    }
+
+    OpIds ops;
+    ops.reserve(fem.nOps());
+    for (uint64_t c = 0; c < fem.nOps(); ++c) {
+      ops.push_back(fem.opId(c));
+    }
+
+    return {std::move(ops), CsrEdges<uint64_t>(fwd), std::move(nIns)};
+  }
+
+private:
+  // The tensors in the sub-graph #sgId which are aliased (through the
+  // aliasing ops of the sub-graph) to a tensor which is a reference to, or
+  // is referenced from, a tensor in another sub-graph.
+  std::set<TensorId> getTensorsAliasedToRefs(SubGraphId sgId) const {
+
+    const auto opIds = graph.opIds(sgId);
+    const auto roots = getAliasRoots(graph, opIds);
+    auto root = [&roots](const TensorId &tId) { return roots.at(tId); };
+
+    std::set<TensorId> sharedRoots;
+    for (auto opId : opIds) {
+      for (const auto &tId : graph.outTensorIds(opId)) {
+        if (isRefRelated(graph, tId)) {
+          sharedRoots.insert(root(tId));
+        }
+      }
+    }
+
+    std::set<TensorId> shared;
+    if (!sharedRoots.empty()) {
+      for (auto opId : opIds) {
+        for (const auto &tId : graph.outTensorIds(opId)) {
+          if (sharedRoots.count(root(tId)) != 0) {
+            shared.insert(tId);
+          }
+        }
+      }
+    }
+    return shared;
+  }
+
+  // The sub-graph #sgId, and all of the sub-graphs which are called from it
+  // (recursively).
+  const std::set<SubGraphId> &closure(SubGraphId sgId) {
+    auto found = closures.find(sgId);
+    if (found != closures.cend()) {
+      return found->second;
+    }
+    std::set<SubGraphId> c{sgId};
+    for (auto opId : graph.opIds(sgId)) {
+      for (auto callee : graph.computeOp(opId).callees()) {
+        const auto &cc = closure(callee);
+        c.insert(cc.cbegin(), cc.cend());
+      }
+    }
+    return closures.insert({sgId, std::move(c)}).first->second;
+  }
+
+  // If any of the tensors in the sub-graph #sgId is a reference to, or is
+  // referenced from, a tensor in another sub-graph.
+  bool hasRefs(SubGraphId sgId) {
+    auto found = refs.find(sgId);
+    if (found != refs.cend()) {
+      return found->second;
+    }
+    bool r{false};
+    for (auto opId : graph.opIds(sgId)) {
+      for (const auto &tId : graph.outTensorIds(opId)) {
+        r |= isRefRelated(graph, tId);
+      }
+    }
+    return refs.insert({sgId, r}).first->second;
+  }
+
+  const Graph &graph;
+  std::map<SubGraphId, std::set<SubGraphId>> closures;
+  std::map<SubGraphId, bool> refs;
 };
 
 } // namespace
 
 void SimExecutable::executableSpecificRun(const SubGraphId subGraphId) {
-  const auto schedule = schedules.at(subGraphId);
 
-  SimState ss(*allVals_.uptr.get(), *this);
-  using namespace poprithms::schedule;
-  for (auto opId : schedule) {
-    graph().computeOp(opId).runSim(ss);
+  // Only replace the caller's buffer pool if this executable has one.
+  std::optional<BufferPool::Scope> scope;
+  if (bufferPool()) {
+    scope.emplace(*bufferPool());
   }
+
+  if (mode_ == SimExecutionMode::Dataflow) {
+    SimState ss(
+        *allVals_.uptr.get(), *this, executor_.uptr.get(), activeProfiler());
+    ss.runSubGraph(subGraphId);
+    return;
+  }
+
+  SimState ss(*allVals_.uptr.get(), *this, nullptr, activeProfiler());
+  ss.runSubGraph(subGraphId);
 }
 
 void SimExecutable::verifyNotReplicated(const TensorId &id) const {
@@ -105,18 +675,213 @@ void SimExecutable::executableSpecificSetRemoteValue(
   vals()[tId][replica].copyFrom_(hostTensor);
 }
 
+void SimExecutable::verifyStreamable(const TensorId &tId,
+                                     const std::string &what) const {
+  const auto dt = graph().deviceType(tId);
+  if (dt != DeviceType::Host && dt != DeviceType::Remote) {
+    std::ostringstream oss;
+    oss << "Invalid stream " << what << " for the tensor " << tId
+        << ", which has device type " << dt
+        << ". Only host and remote tensors can be streamed.";
+    throw error(oss.str());
+  }
+}
+
+void SimExecutable::setStreamSource(const TensorId &tId,
+                                    StreamSource source) {
+  verifyStreamable(tId, "source");
+  streamSources_[tId] = std::move(source);
+}
+
+void SimExecutable::setStreamSink(const TensorId &tId, StreamSink sink) {
+  verifyStreamable(tId, "sink");
+  streamSinks_[tId] = std::move(sink);
+}
+
+void SimExecutable::clearStreams() {
+  streamSources_.clear();
+  streamSinks_.clear();
+}
+
+HostTensors SimExecutable::streamBuffers(const TensorId &tId) const {
+  HostTensors buffers;
+  for (const auto &t : vals().getValue(tId)) {
+    buffers.push_back(t.copy());
+  }
+  return buffers;
+}
+
+void SimExecutable::runStreaming(SubGraphId sgId, uint64_t nIterations) {
+
+  if (nIterations == 0) {
+    return;
+  }
+
+  // The staging buffers of the sources and sinks. Each stream has one
+  // staging buffer (per replica), which together with the tensor itself
+  // makes it double-buffered.
+  std::vector<HostTensors> sourceStages;
+  for (const auto &source : streamSources_) {
+    sourceStages.push_back(streamBuffers(source.first));
+  }
+  std::vector<HostTensors> sinkStages;
+  for (const auto &sink : streamSinks_) {
+    sinkStages.push_back(streamBuffers(sink.first));
+  }
+
+  auto prefetch = [this, &sourceStages](uint64_t iteration) {
+    uint64_t i{0};
+    for (const auto &source : streamSources_) {
+      source.second(iteration, sourceStages[i++]);
+    }
+  };
+
+  auto drain = [this, &sinkStages](uint64_t iteration) {
+    uint64_t i{0};
+    for (const auto &sink : streamSinks_) {
+      sink.second(iteration, sinkStages[i++]);
+    }
+  };
+
+  auto copyIn = [this, &sourceStages]() {
+    uint64_t i{0};
+    for (const auto &source : streamSources_) {
+      const auto &dst = vals().getValue(source.first);
+      for (uint64_t r = 0; r < dst.size(); ++r) {
+        dst[r].update_(sourceStages[i][r]);
+      }
+      ++i;
+    }
+  };
+
+  auto copyOut = [this, &sinkStages]() {
+    uint64_t i{0};
+    for (const auto &sink : streamSinks_) {
+      const auto &src = vals().getValue(sink.first);
+      for (uint64_t r = 0; r < src.size(); ++r) {
+        sinkStages[i][r].update_(src[r]);
+      }
+      ++i;
+    }
+  };
+
+  prefetch(0);
+  copyIn();
+
+  for (uint64_t iteration = 0; iteration < nIterations; ++iteration) {
+
+    // The sinks of the previous iteration and the sources of the next
+    // iteration run while this iteration runs. If #run throws, the
+    // destructor of #background waits for it to complete.
+    auto overlapped = [&drain, &prefetch, iteration, nIterations]() {
+      if (iteration > 0) {
+        drain(iteration - 1);
+      }
+      if (iteration + 1 < nIterations) {
+        prefetch(iteration + 1);
+      }
+    };
+    auto background = std::async(std::launch::async, overlapped);
+
+    run(sgId);
+
+    // Rethrows any exception thrown by a callback.
+    background.get();
+
+    copyOut();
+    if (iteration + 1 < nIterations) {
+      copyIn();
+    }
+  }
+
+  drain(nIterations - 1);
+}
+
+SimMemoryStats SimExecutable::memoryStats() const {
+  auto stats = memoryStats_;
+  if (bufferPool()) {
+    const auto poolStats = bufferPool()->stats();
+    stats.poolPeakBytes  = poolStats.peakBytes;
+    stats.poolBytesHeld  = poolStats.nBytesHeld;
+  }
+  return stats;
+}
+
+void SimExecutable::enableBufferPool(uint64_t maxBytesHeld) {
+  bufferPool_.uptr = std::make_unique<BufferPool>(maxBytesHeld);
+}
+
 SimExecutable::~SimExecutable() = default;
 
 SimExecutable::SimExecutable(Graph &&m)
+    : SimExecutable(std::move(m), SimExecutionMode::Serial, 1) {}
+
+SimExecutable::SimExecutable(Graph &&m,
+                             SimExecutionMode mode,
+                             uint64_t nThreads)
+    : SimExecutable(std::move(m), mode, nThreads, SimMemoryMode::Unplanned) {
+}
+
+SimExecutable::SimExecutable(Graph &&m,
+                             SimExecutionMode mode,
+                             uint64_t nThreads,
+                             SimMemoryMode memoryMode)
     : IExecutable(std::move(m)),
-      allVals_(std::make_unique<SimTensorMap>(initHostSimTensors(graph()))) {
+      allVals_(std::make_unique<SimTensorMap>()), mode_(mode),
+      nThreads_(nThreads), memoryMode_(memoryMode) {
+
+  if (nThreads_ == 0) {
+    throw error("The number of threads of a SimExecutable must be at least "
+                "1.");
+  }
+
+  if (memoryMode_ == SimMemoryMode::Planned &&
+      mode_ != SimExecutionMode::Serial) {
+    throw error("SimMemoryMode::Planned is only supported with "
+                "SimExecutionMode::Serial, as the buffers are shared by "
+                "tensors based on the order of the schedule.");
+  }
+
+  // Ops with callees are validated once here, rather than every time they
+  // are run.
+  for (auto opId : graph().opIds()) {
+    if (graph().computeOp(opId).hasCallees()) {
+      graph().computeOp(opId).verifyValidFromComputeLevel();
+    }
+  }
+
+  if (mode_ == SimExecutionMode::Dataflow) {
+    executor_.uptr = std::make_unique<dataflow::Executor>(nThreads_);
+  }
 
+  DataflowGraphBuilder builder(graph());
   for (uint64_t sgId = 0; sgId < graph().nSubGraphs(); ++sgId) {
 
     auto s = SubGraphId::createSubGraphId(sgId);
 
-    schedules.insert({s, Scheduler::vanillaComputeSchedule(graph(), s)});
+    if (mode_ == SimExecutionMode::Dataflow) {
+      // The schedule is obtained from the same forward edge map as the
+      // dataflow graph, so that it is only constructed once.
+      OpIds schedule;
+      dataflowGraphs.insert({s, builder.build(s, schedule)});
+      schedules.insert({s, std::move(schedule)});
+    } else {
+      schedules.insert({s, Scheduler::vanillaComputeSchedule(graph(), s)});
+    }
+  }
+
+  const auto plan = memoryMode_ == SimMemoryMode::Planned
+                        ? planMemory(graph(), schedules)
+                        : MemoryPlan{};
+
+  // The stored values never use the caller's buffer pool, so that their
+  // sizes are exactly the sizes of the tensors.
+  {
+    BufferPool::Scope noPool(nullptr);
+    allVals_.uptr =
+        std::make_unique<SimTensorMap>(initHostSimTensors(graph(), plan));
   }
+  memoryStats_ = getMemoryStats(graph(), plan, vals());
 }
 
 } // namespace compute
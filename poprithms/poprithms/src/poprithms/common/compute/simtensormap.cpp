@@ -1,8 +1,11 @@
 // Copyright (c) 2022 Graphcore Ltd. All rights reserved.
 
+#include <vector>
+
 #include <common/compute/error.hpp>
 
 #include <poprithms/common/compute/simtensormap.hpp>
+#include <poprithms/compute/host/bufferpool.hpp>
 #include <poprithms/util/copybyclone_impl.hpp>
 #include <poprithms/util/stringutil.hpp>
 
@@ -89,6 +92,55 @@ HostTensors SimTensorMap::getTensors(const TensorIds &ids, uint64_t r) const {
   return ts;
 }
 
+void SimTensorMap::setNReplicaThreads(uint64_t n) {
+  if (n == 0) {
+    throw error("The number of replica threads must be at least 1.");
+  }
+  nReplicaThreads_ = n;
+  replicaPool_.uptr =
+      n > 1 ? std::make_unique<poprithms::util::ThreadPool>(n) : nullptr;
+}
+
+void SimTensorMap::replicaParallelFor(
+    uint64_t n,
+    const std::function<void(uint64_t)> &f) const {
+
+  const auto nThreads = std::min<uint64_t>(nReplicaThreads_, n);
+  if (nThreads <= 1) {
+    for (uint64_t r = 0; r < n; ++r) {
+      f(r);
+    }
+    return;
+  }
+
+  // The replicas use the buffer pool of the calling thread.
+  const auto pool = poprithms::compute::host::BufferPool::current();
+
+  replicaPool_.uptr->parallelFor(
+      n, [&f, &pool](uint64_t, uint64_t begin, uint64_t end) {
+        poprithms::compute::host::BufferPool::Scope scope(pool);
+        for (uint64_t r = begin; r < end; ++r) {
+          f(r);
+        }
+      });
+}
+
+void SimTensorMap::initReplicatedSlots(uint64_t nOps) {
+  slots_.clear();
+  slots_.resize(nOps);
+}
+
+void SimTensorMap::setReplicatedSlots(OpId opId, ReplicatedSlots &&slots) {
+  if (!canStoreReplicatedSlots(opId)) {
+    std::ostringstream oss;
+    oss << "Cannot set the slots of op " << opId << ", storage has only "
+        << "been initialized for " << slots_.size() << " ops.";
+    throw error(oss.str());
+  }
+  slots_[static_cast<uint64_t>(opId.get())] =
+      std::make_shared<ReplicatedSlots>(std::move(slots));
+}
+
 std::unique_ptr<SimTensorMap> SimTensorMap::clone() const {
   return std::make_unique<SimTensorMap>(*this);
 }
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <ostream>
 #include <sstream>
@@ -14,7 +15,6 @@
 #include <poprithms/common/multiout/op.hpp>
 #include <poprithms/common/multiout/traversal.hpp>
 #include <poprithms/util/contiguoussubset.hpp>
-#include <poprithms/util/copybyclone_impl.hpp>
 #include <poprithms/util/printiter.hpp>
 #include <poprithms/util/stringutil.hpp>
 
@@ -99,50 +99,161 @@ FwdEdgeMap Graph::getMultioutForwardEdgeMap_u64() const {
   return fwdEdgeMap;
 }
 
-void Graph::resetGraphOfOps() {
+void Graph::resetGraphOfOps(const Graph &previous) {
+  // Ops which point to another graph are left unchanged, as they might be
+  // bound to (and modified through) that graph.
   for (auto &op_ : ops()) {
-    if (op_.uptr) {
-      op_.uptr->setGraph(*this);
+    if (op_ && op_->multioutGraph_ == &previous) {
+      op_->setGraph(*this);
     }
   }
 }
 
+// The mutex protects the list of graphs, which can be copied concurrently.
+// It does not make re-pointing an op safe while the graphs which share it
+// are modified or read concurrently, which the Graph class does not allow
+// (see the Graph copy constructor).
+class Graph::Family {
+public:
+  explicit Family(Graph *g) : graphs({g}) {}
+
+  // The Graph, other than #self, which holds #opPtr. This Graph (if there is
+  // one) holds it at the same index as #self does, which is the OpId of the
+  // Op. The caller must hold #mutex.
+  Graph *holder(const Graph &self, const std::shared_ptr<Op> &opPtr) const {
+    const auto i = static_cast<uint64_t>(opPtr->id().get());
+    for (auto g : graphs) {
+      if (g != &self && i < g->ops().size() && g->ops()[i] == opPtr) {
+        return g;
+      }
+    }
+    return nullptr;
+  }
+
+  std::mutex mutex;
+  std::vector<Graph *> graphs;
+};
+
+void Graph::joinFamily(const Graph &g) {
+  family_ = g.family_;
+  std::lock_guard<std::mutex> lock(family_->mutex);
+  family_->graphs.push_back(this);
+}
+
+void Graph::leaveFamily() {
+  std::lock_guard<std::mutex> lock(family_->mutex);
+  auto &graphs = family_->graphs;
+  graphs.erase(std::find(graphs.begin(), graphs.end(), this));
+}
+
+void Graph::replaceInFamily(Graph &g) {
+  family_ = g.family_;
+  {
+    std::lock_guard<std::mutex> lock(family_->mutex);
+    auto &graphs = family_->graphs;
+    *std::find(graphs.begin(), graphs.end(), &g) = this;
+  }
+  g.family_ = std::make_shared<Family>(&g);
+}
+
+void Graph::releaseOp(const std::shared_ptr<Op> &opPtr) {
+  if (opPtr.use_count() > 1 && opPtr->multioutGraph_ == this) {
+    std::lock_guard<std::mutex> lock(family_->mutex);
+    if (auto g = family_->holder(*this, opPtr)) {
+      opPtr->setGraph(*g);
+    }
+  }
+}
+
+void Graph::releaseOps() {
+  std::lock_guard<std::mutex> lock(family_->mutex);
+  for (const auto &op_ : ops()) {
+    if (op_ && op_.use_count() > 1 && op_->multioutGraph_ == this) {
+      if (auto g = family_->holder(*this, op_)) {
+        op_->setGraph(*g);
+      }
+    }
+  }
+}
+
+void Graph::bindOp(std::shared_ptr<Op> &opPtr) {
+  if (opPtr.use_count() > 1) {
+    std::shared_ptr<Op> c = opPtr->clone();
+    releaseOp(opPtr);
+    opPtr = std::move(c);
+  }
+  opPtr->setGraph(*this);
+}
+
+void Graph::bindOps() {
+  for (auto &op_ : ops()) {
+    if (op_ && (op_.use_count() > 1 || op_->multioutGraph_ != this)) {
+      bindOp(op_);
+    }
+  }
+}
+
+uint64_t Graph::nSharedOps() const {
+  return static_cast<uint64_t>(
+      std::count_if(ops().cbegin(), ops().cend(), [](const auto &op_) {
+        return op_ && op_.use_count() > 1;
+      }));
+}
+
+Graph::Graph() : family_(std::make_shared<Family>(this)) {}
+
+Graph::~Graph() {
+  releaseOps();
+  leaveFamily();
+}
+
+// Copies share the ops of #g, and the ops are only cloned when modified
+// through the copy. See Graph::op.
 Graph::Graph(Graph &&g) {
   atts = std::move(g.atts);
-  resetGraphOfOps();
+  replaceInFamily(g);
+  resetGraphOfOps(g);
 }
 
 Graph &Graph::operator=(Graph &&g) {
   if (this != &g) {
+    releaseOps();
+    leaveFamily();
     atts = std::move(g.atts);
-    resetGraphOfOps();
+    replaceInFamily(g);
+    resetGraphOfOps(g);
   }
   return *this;
 }
 
 Graph::Graph(const Graph &g) {
   atts = g.atts;
-  resetGraphOfOps();
+  joinFamily(g);
 }
 
 Graph &Graph::operator=(const Graph &g) {
   if (this != &g) {
+    releaseOps();
+    leaveFamily();
     atts = g.atts;
-    resetGraphOfOps();
+    joinFamily(g);
   }
   return *this;
 }
 
 void Graph::verifyOpsConnectedToThisGraph() const {
-  for (const auto &op_ : ops()) {
-    if (op_.uptr) {
-      if (&op_.uptr->multioutGraph() != this) {
+  std::lock_guard<std::mutex> lock(family_->mutex);
+  for (uint64_t i = 0; i < ops().size(); ++i) {
+    if (ops()[i]) {
+      const auto &op_ = *ops()[i];
+      const auto g    = &op_.multioutGraph();
+      if (g != this && g != family_->holder(*this, ops()[i])) {
         std::ostringstream oss;
         oss << "Failed to verify that ops of this graph (" << getName()
-            << ") are connected to it. "
-            << "The op " << *op_.uptr << " (one of the " << ops().size()
+            << ") are connected to it, or to a graph they are shared with. "
+            << "The op " << op_ << " (one of the " << ops().size()
             << " ops created in this graph) "
-            << "has graph pointer " << &op_.uptr->multioutGraph()
+            << "has graph pointer " << &op_.multioutGraph()
             << ", but this graph has address " << this << '.';
         throw error(oss.str());
       }
@@ -205,6 +316,26 @@ void Graph::removeConsumptionId(OpId opId, InIndex inIndex) {
   const auto inOp     = inTensor.opId();
   const auto outIndex = inTensor.outIndex();
   op(inOp).removeConsumptionId(outIndex, ConsumptionId(opId, inIndex));
+  registerConsumersChanged(inOp);
+}
+
+void Graph::registerConsumersChanged(OpId opId) {
+  if (atts.trackConsumerChanges_) {
+    atts.consumerChanges_.push_back(opId);
+  }
+}
+
+void Graph::setTrackConsumerChanges(bool track) {
+  atts.trackConsumerChanges_ = track;
+  if (!track) {
+    atts.consumerChanges_.clear();
+  }
+}
+
+OpIds Graph::takeConsumerChanges() {
+  OpIds changes;
+  std::swap(changes, atts.consumerChanges_);
+  return changes;
 }
 
 void Graph::resetConsumption(OpId opId, InIndex oldIndex, InIndex newIndex) {
@@ -233,9 +364,37 @@ void Graph::removeOp(OpId opId,
   removeOutputs(opId, outIndices(opId), substitutes);
 
   // finally, register removal event, and perform removal.
-  atts.removals_.insert({opId, op(opId).getName(), ops().size(), context});
-  ops()[opId.get()].uptr.reset();
-  atts.live_.erase(opId);
+  atts.removals_.insert({opId, getName(opId), ops().size(), context});
+  releaseOp(ops()[opId.get()]);
+  ops()[opId.get()].reset();
+
+  auto &live = atts.live_;
+  if (live.back() == opId) {
+    live.pop_back();
+  } else {
+    ++atts.nRemovedInLive_;
+  }
+  if (2 * atts.nRemovedInLive_ > live.size()) {
+    live.erase(std::remove_if(live.begin(),
+                              live.end(),
+                              [this](OpId id) { return !isLive(id); }),
+               live.end());
+    atts.nRemovedInLive_ = 0;
+  }
+}
+
+OpIds Graph::opIds() const {
+  if (atts.nRemovedInLive_ == 0) {
+    return atts.live_;
+  }
+  OpIds ids;
+  ids.reserve(nOps());
+  for (auto id : atts.live_) {
+    if (isLive(id)) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
 }
 
 void Graph::removeInputs(OpId opToPrune, const InIndices &toRemove) {
@@ -286,6 +445,7 @@ void Graph::replaceInput(OpId opId,
   op(newConsumed.opId())
       .insertConsumptionId(newConsumed.outIndex(),
                            ConsumptionId(opId, inIndex));
+  registerConsumersChanged(newConsumed.opId());
 
   op(opId).inIds_[inIndex.get()] = newConsumed;
 }
@@ -298,6 +458,13 @@ void Graph::removeOutputs(OpId opToPrune,
   auto &op_        = op(opToPrune);
   op_.verifyDistinct(toRemove);
 
+  // Removing outputs changes the consumers of #opToPrune, even if the
+  // removed outputs have no consumers, as they might be copies out of
+  // callees.
+  if (!toRemove.empty()) {
+    registerConsumersChanged(opToPrune);
+  }
+
   for (auto o : toRemove) {
     if (o.get() >= nOuts) {
       std::ostringstream oss;
@@ -357,6 +524,7 @@ void Graph::removeOutputs(OpId opToPrune,
     for (auto c : consumptionIds({opToPrune, outIndex})) {
       op(c.opId()).resetInTensorId(c.inIndex(), downshifted);
       op(substitute.opId()).insertConsumptionId(substitute.outIndex(), c);
+      registerConsumersChanged(substitute.opId());
     }
   }
 
@@ -434,7 +602,7 @@ void Graph::verifyValidTensorId(const TensorId &tId) const {
     throw error(oss.str());
   }
 
-  if (!ops()[tId.opId().get()].uptr) {
+  if (!ops()[tId.opId().get()]) {
     std::ostringstream oss;
     oss << "Failure in verifyValidTensorId(TensorId=" << tId << "). "
         << "The Op " << tId.opId() << " no longer exists.";
@@ -471,13 +639,15 @@ OpId Graph::insertMultioutOp(std::unique_ptr<Op> createdOp) {
     auto &source        = op(sourceId);
     source.insertConsumptionId(inTensor.outIndex(),
                                {createdOp->id(), InIndex(inIndex)});
+    registerConsumersChanged(sourceId);
   }
 
   ops().emplace_back(std::move(createdOp));
 
-  const auto newId = ops().back().uptr->id();
+  const auto newId = ops().back()->id();
 
-  atts.live_.insert(/* hint = */ atts.live_.end(), newId);
+  // OpIds are increasing, so #live_ remains sorted.
+  atts.live_.push_back(newId);
 
   verifyValidAtMultioutLevel(newId);
 
@@ -506,12 +676,20 @@ bool Graph::operator==(const Graph &rhs) const {
 }
 
 bool Graph::Attributes::operator==(const Graph::Attributes &rhs) const {
+  // The live ops are the ops which are not nullptr, so they are compared
+  // with #ops_.
   return name_ == rhs.name_ && removals_ == rhs.removals_ &&
-         live_ == rhs.live_ && ops_ == rhs.ops_;
+         std::equal(ops_.cbegin(),
+                    ops_.cend(),
+                    rhs.ops_.cbegin(),
+                    rhs.ops_.cend(),
+                    [](const auto &a, const auto &b) {
+                      return a == b || (a && b && *a == *b);
+                    });
 }
 const Op &Graph::op(OpId a) const {
 
-  const auto &opPtr = ops()[static_cast<uint64_t>(a.get())].uptr;
+  const auto &opPtr = atts.ops_[static_cast<uint64_t>(a.get())];
 
   if (!opPtr) {
     if (atts.removals_.registered(a)) {
@@ -532,12 +710,18 @@ const Op &Graph::op(OpId a) const {
       throw error(oss.str());
     }
   }
+
   return *opPtr;
 }
 
-// See Scott Meyers' "Effective C++"
 Op &Graph::op(OpId id) {
-  return const_cast<Op &>(static_cast<const Graph &>(*this).op(id));
+  // Perform the checks.
+  static_cast<const Graph &>(*this).op(id);
+  auto &opPtr = ops()[static_cast<uint64_t>(id.get())];
+  if (opPtr.use_count() > 1 || opPtr->multioutGraph_ != this) {
+    bindOp(opPtr);
+  }
+  return *opPtr;
 }
 
 std::vector<Shape> Graph::shapes(const TensorIds &ids) const {
@@ -743,7 +927,7 @@ Graph::getMultioutColumns(const OpIds &opIds,
 void Graph::verifyValid() const {
 
   {
-    auto L = atts.live_.size();
+    auto L = nOps();
     auto R = atts.removals_.size();
     auto T = ops().size();
     if (L + R != T) {
@@ -798,9 +982,4 @@ void Graph::noWeakVTables() {
 
 } // namespace multiout
 } // namespace common
-
-namespace util {
-template class CopyByClone<common::multiout::Op>;
-}
-
 } // namespace poprithms
@@ -164,10 +164,9 @@ const Op &Graph::op(OpId a) const {
   return static_cast<const Op &>(multioutOp(a));
 }
 
-// See Scott Meyers' "Effective C++"
-Op &Graph::op(OpId id) {
-  return const_cast<Op &>(static_cast<const Graph &>(*this).op(id));
-}
+// The non-const multiout::Graph::op ensures that the op is not shared with
+// another graph, and so this cannot be implemented with the const version.
+Op &Graph::op(OpId id) { return static_cast<Op &>(multioutOp(id)); }
 
 bool Graph::eagerIsEnabled(SubGraphId id_) const {
   return subGraphStates[id_.get_u64()].eagerEnabled();
@@ -200,8 +199,21 @@ void Graph::propagateControlDependencies(
   }
 }
 
-void Graph::SubGraphState::removeOp(OpId opId) {
-  ops_.erase(opId);
+void Graph::SubGraphState::removeOp(OpId opId, const Graph &g) {
+  if (ops_.back() == opId) {
+    ops_.pop_back();
+  } else {
+    ++nRemoved_;
+  }
+  if (2 * nRemoved_ > ops_.size()) {
+    ops_.erase(std::remove_if(ops_.begin(),
+                              ops_.end(),
+                              [opId, &g](OpId id) {
+                                return id == opId || !g.isLive(id);
+                              }),
+               ops_.end());
+    nRemoved_ = 0;
+  }
   if (eagerEnabled()) {
     if (hasKnownLast() && knownLast() == opId) {
       hasLast_ = false;
@@ -225,7 +237,7 @@ void Graph::multiOutTypeSpecificRemoveOp(
 
   auto sgId     = subGraphId(opId);
   auto &sgState = subGraphStates[sgId.get_u64()];
-  sgState.removeOp(opId);
+  sgState.removeOp(opId, *this);
 }
 
 OpIds Graph::allOutOps(OpId opId) const {
@@ -651,12 +663,14 @@ SubGraphIds Graph::subGraphIds(const TensorIds &ids) const {
   return SubGraphId::subGraphIds(*this, ids);
 }
 
-// We could consider keeping an additional datastructre (a field in
-// SubGraphState) which partitions OpIds by Graph, but in my (PopART)
-// experience it's not often that this partition is needed.
 OpIds Graph::opIds(SubGraphId subGraphId_) const {
+  const auto &sgState = subGraphStates.at(subGraphId_.get_u64());
+  if (sgState.nRemoved() == 0) {
+    return sgState.ops();
+  }
   OpIds opIds_;
-  for (auto id : subGraphStates.at(subGraphId_.get_u64()).ops()) {
+  opIds_.reserve(sgState.ops().size() - sgState.nRemoved());
+  for (auto id : sgState.ops()) {
     if (isLive(id)) {
       opIds_.push_back(id);
     }
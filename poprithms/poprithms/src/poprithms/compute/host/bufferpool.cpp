@@ -0,0 +1,134 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <sstream>
+
+#include <compute/host/include/vectorpool.hpp>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+namespace {
+
+// The largest k such that 2^k <= n. n must be positive.
+uint64_t floorLog2(uint64_t n) {
+  uint64_t k = 0;
+  while (n > 1) {
+    n >>= 1;
+    ++k;
+  }
+  return k;
+}
+
+} // namespace
+
+std::shared_ptr<BufferPool::Impl> &BufferPool::Impl::current() {
+  static thread_local std::shared_ptr<Impl> c;
+  return c;
+}
+
+uint64_t BufferPool::Impl::sizeClass(uint64_t n) {
+  if (n <= 4) {
+    return n;
+  }
+  const uint64_t step = uint64_t(1) << (floorLog2(n) - 2);
+  return (n + step - 1) / step * step;
+}
+
+uint64_t BufferPool::Impl::floorSizeClass(uint64_t n) {
+  if (n <= 4) {
+    return n;
+  }
+  const uint64_t step = uint64_t(1) << (floorLog2(n) - 2);
+  return n / step * step;
+}
+
+void BufferPool::Impl::clearLocked() {
+  std::apply(
+      [](auto &...bs) {
+        (bs.clear(), ...);
+      },
+      allBuckets);
+  stats.nBytesHeld = 0;
+}
+
+void BufferPool::Impl::close() {
+  std::lock_guard<std::mutex> lock(mutex);
+  clearLocked();
+  closed = true;
+}
+
+double BufferPool::Stats::hitRate() const {
+  if (nAcquisitions == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(nHits) / static_cast<double>(nAcquisitions);
+}
+
+void BufferPool::Stats::append(std::ostream &ost) const {
+  ost << "nAcquisitions=" << nAcquisitions << ",nHits=" << nHits
+      << ",hitRate=" << hitRate() << ",nReleases=" << nReleases
+      << ",nRejections=" << nRejections << ",nBytesInUse=" << nBytesInUse
+      << ",nBytesHeld=" << nBytesHeld << ",peakBytesInUse=" << peakBytesInUse
+      << ",peakBytesHeld=" << peakBytesHeld << ",peakBytes=" << peakBytes;
+}
+
+std::ostream &operator<<(std::ostream &ost, const BufferPool::Stats &s) {
+  s.append(ost);
+  return ost;
+}
+
+BufferPool::BufferPool(uint64_t maxBytesHeld_)
+    : impl(std::make_shared<Impl>(maxBytesHeld_)) {}
+
+BufferPool::~BufferPool() { impl->close(); }
+
+std::unique_ptr<BufferPool> BufferPool::clone() const {
+  return std::make_unique<BufferPool>(maxBytesHeld());
+}
+
+BufferPool::Scope::Scope(std::shared_ptr<Impl> pool)
+    : previous(std::move(Impl::current())) {
+  Impl::current() = std::move(pool);
+}
+
+BufferPool::Scope::~Scope() { Impl::current() = std::move(previous); }
+
+std::shared_ptr<BufferPool::Impl> BufferPool::current() {
+  return Impl::current();
+}
+
+BufferPool::Stats BufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  return impl->stats;
+}
+
+void BufferPool::resetStats() {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  auto &s = impl->stats;
+  Stats reset;
+  reset.nBytesInUse    = s.nBytesInUse;
+  reset.nBytesHeld     = s.nBytesHeld;
+  reset.peakBytesInUse = s.nBytesInUse;
+  reset.peakBytesHeld  = s.nBytesHeld;
+  reset.peakBytes      = s.nBytesInUse + s.nBytesHeld;
+  s                    = reset;
+}
+
+void BufferPool::clear() {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->clearLocked();
+}
+
+uint64_t BufferPool::maxBytesHeld() const {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  return impl->maxBytesHeld;
+}
+
+void BufferPool::setMaxBytesHeld(uint64_t n) {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->maxBytesHeld = n;
+}
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
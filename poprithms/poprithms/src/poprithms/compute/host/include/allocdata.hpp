@@ -7,6 +7,7 @@
 #include <boost/container/vector.hpp>
 
 #include <compute/host/include/origindata.hpp>
+#include <compute/host/include/vectorpool.hpp>
 
 namespace poprithms {
 namespace compute {
@@ -58,15 +59,27 @@ private:
   friend class Serializer;
 
 public:
-  AllocData(const Primal &v) : up(std::make_unique<Primal>(v)) {}
-  AllocData(Primal &&v) : up(std::make_unique<Primal>(std::move(v))) {}
+  AllocData(const Primal &v)
+      : up(std::make_unique<Primal>(v)), pool(adopt(*up)) {}
+  AllocData(Primal &&v)
+      : up(std::make_unique<Primal>(std::move(v))), pool(adopt(*up)) {}
 
   AllocData(const Dual &v)
-      : up(std::make_unique<Primal>(convertVector<Dual, Primal>(v))) {}
+      : up(std::make_unique<Primal>(convertVector<Dual, Primal>(v))),
+        pool(adopt(*up)) {}
   AllocData(Dual &&v) : AllocData(convertVector<Dual, Primal>(v)) {}
 
   AllocData(T f) : AllocData(Primal{f}) {}
 
+  // If the buffer belongs to a BufferPool, it is returned to it.
+  ~AllocData() override {
+    if constexpr (VectorPool<T>::pooled) {
+      if (pool) {
+        pool->release(std::move(*up));
+      }
+    }
+  }
+
   void append(std::ostream &ost) const final {
     ost << "AllocData(dtype=" << poprithms::ndarray::lcase<T>()
         << ",nelms=" << nelms_u64() << ')';
@@ -77,12 +90,30 @@ public:
   uint64_t nelms_u64() const final { return up->size(); }
 
   BaseDataSP clone() const final {
+    if constexpr (VectorPool<T>::pooled) {
+      auto x = VectorPool<T>::acquire(up->size());
+      std::copy(up->cbegin(), up->cend(), x.begin());
+      return std::make_shared<AllocData<T>>(std::move(x));
+    }
     auto x = *up;
     return std::make_shared<AllocData<T>>(std::move(x));
   }
 
 private:
+  // The buffer belongs to the current BufferPool of the thread which
+  // constructs this AllocData, if there is one. Empty buffers do not belong
+  // to a pool.
+  static std::shared_ptr<BufferPool::Impl> adopt(const Primal &v) {
+    if constexpr (VectorPool<T>::pooled) {
+      if (v.capacity() != 0) {
+        return VectorPool<T>::adopt(v);
+      }
+    }
+    return nullptr;
+  }
+
   std::unique_ptr<Primal> up;
+  std::shared_ptr<BufferPool::Impl> pool;
 };
 
 } // namespace host
@@ -246,6 +246,12 @@ public:
    * */
   virtual bool containsAliases() const = 0;
 
+  /**
+   * \return true iff any element of this BaseData is in memory which must
+   *         not be written to, such as a read-only memory mapped file.
+   * */
+  virtual bool isReadOnly() const = 0;
+
   /**
    * \return The numerical type of this BaseData.
    * */
@@ -0,0 +1,96 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMPUTE_HOST_MAPPEDFILE_HPP
+#define POPRITHMS_COMPUTE_HOST_MAPPEDFILE_HPP
+
+#include <string>
+
+#include <poprithms/ndarray/dtype.hpp>
+#include <poprithms/ndarray/shape.hpp>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+/**
+ * A file which is memory mapped for the lifetime of this object. The
+ * mapping is removed (munmap) in the destructor.
+ *
+ * If #copyOnWrite is false, the pages of the file are mapped read-only and
+ * shared between all processes which map the same file. Writing to the
+ * mapped memory results in a segmentation fault.
+ *
+ * If #copyOnWrite is true, the pages are mapped privately and are writable.
+ * A page is copied the first time it is written to, and the modification is
+ * never visible in the file or to other processes.
+ * */
+class MappedFile {
+public:
+  MappedFile(const std::string &filename, bool copyOnWrite);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &)            = delete;
+  MappedFile(MappedFile &&)                 = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile &operator=(MappedFile &&)      = delete;
+
+  /** The address of the first byte of the mapped file. */
+  char *data() const { return data_; }
+
+  /** The size of the mapped file, in bytes. */
+  uint64_t nbytes() const { return nBytes_; }
+
+  const std::string &filename() const { return filename_; }
+
+  bool copyOnWrite() const { return copyOnWrite_; }
+
+  /**
+   * Throw an error if the region [offset, offset + nBytesRequired) is not
+   * contained in this file, or if #offset is not a multiple of
+   * #elementSize.
+   * */
+  void assertValidRegion(uint64_t offset,
+                         uint64_t nBytesRequired,
+                         uint64_t elementSize) const;
+
+private:
+  std::string filename_;
+  bool copyOnWrite_;
+  char *data_{nullptr};
+  uint64_t nBytes_{0};
+};
+
+/**
+ * The information in the header of a .npy file which is required to
+ * interpret its data as a row-major tensor. See
+ * https://numpy.org/devdocs/reference/generated/numpy.lib.format.html
+ * */
+class NpyHeader {
+public:
+  /**
+   * Parse the header of the .npy file whose first #nBytes bytes start at
+   * #data. Only little-endian (or endian-agnostic) C-ordered arrays of the
+   * numerical types supported by poprithms are supported.
+   * */
+  NpyHeader(const char *data, uint64_t nBytes);
+
+  ndarray::DType dtype() const { return dtype_; }
+  const ndarray::Shape &shape() const { return shape_; }
+
+  /** The number of bytes before the first element of the array. */
+  uint64_t dataOffset() const { return dataOffset_; }
+
+  /** \return The DType corresponding to the numpy 'descr' string #descr,
+   *          such as '<f4' for DType::Float32.  */
+  static ndarray::DType dtypeFromDescr(const std::string &descr);
+
+private:
+  ndarray::DType dtype_;
+  ndarray::Shape shape_;
+  uint64_t dataOffset_;
+};
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
+
+#endif
@@ -2,12 +2,14 @@
 #ifndef POPRITHMS_COMPUTE_HOST_ORIGINDATA_HPP
 #define POPRITHMS_COMPUTE_HOST_ORIGINDATA_HPP
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
 #include <compute/host/include/baseoperators.hpp>
 #include <compute/host/include/ieeehalf.hpp>
 #include <compute/host/include/typeddata.hpp>
+#include <compute/host/include/vectorpool.hpp>
 
 #include <poprithms/compute/host/viewchange.hpp>
 #include <poprithms/ndarray/dtype.hpp>
@@ -28,19 +30,33 @@ public:
   assertSameBinaryOpNelms(uint64_t n0, uint64_t n1, const BaseData &td);
 };
 
-template <typename From, typename To>
-std::vector<To> castPtrToVector(const From *from, uint64_t nElms) {
-  std::vector<To> r(nElms);
+template <typename From, typename To> To castElement(From v) {
+  return static_cast<To>(v);
+}
+
+// There is no direct conversion from double to IeeeHalf.
+template <> inline IeeeHalf castElement<double, IeeeHalf>(double v) {
+  return static_cast<IeeeHalf>(static_cast<float>(v));
+}
+
+/**
+ * Cast the #nElms elements starting at #from, writing them to the #nElms
+ * elements starting at #to.
+ * */
+template <typename From, typename To, typename OutIter>
+void castPtr(const From *from, uint64_t nElms, OutIter to) {
   std::transform(from,
                  std::next(from, static_cast<int64_t>(nElms)),
-                 r.begin(),
-                 [](From v) { return static_cast<To>(v); });
-  return r;
+                 to,
+                 [](From v) { return castElement<From, To>(v); });
 }
 
-template <>
-std::vector<IeeeHalf> castPtrToVector<double, IeeeHalf>(const double *from,
-                                                        uint64_t nElms);
+template <typename From, typename To>
+std::vector<To> castPtrToVector(const From *from, uint64_t nElms) {
+  auto r = VectorPool<To>::acquire(nElms);
+  castPtr<From, To>(from, nElms, r.begin());
+  return r;
+}
 
 /**
  * A BaseData with contiguous, row-major elements.
@@ -63,6 +79,7 @@ public:
   virtual T *dataPtr() const = 0;
   bool isOriginData() const final { return true; }
   bool containsAliases() const final { return false; }
+  bool isReadOnly() const override { return false; }
 
   std::vector<char> getNativeCharVector() const final {
     std::vector<char> chars(nelms_u64() * sizeof(T));
@@ -375,11 +392,61 @@ public:
     }
   }
 
+  /**
+   * Write the matrix product of #lhs, which has M * K elements, and #rhs,
+   * which has K * N elements, to the M * N elements starting at #out. All
+   * are contiguous and row-major. #out is a pointer or a random access
+   * iterator (the outplace result of type bool is a std::vector<bool>).
+   *
+   * Each output element accumulates its terms in order of increasing k. The
+   * loop over k is outside the loop over n, so that the rows of #rhs are
+   * traversed contiguously.
+   * */
+  template <typename OutIter>
+  static void matmulInto(const T *lhs,
+                         const T *rhs,
+                         OutIter out,
+                         uint64_t M,
+                         uint64_t N,
+                         uint64_t K) {
+    // basic tiling will greatly accelerate this (TODO(T39155))
+    std::fill(out, out + M * N, T(0));
+    for (uint64_t m = 0; m < M; ++m) {
+      for (uint64_t k = 0; k < K; ++k) {
+        const auto l = lhs[m * K + k];
+        for (uint64_t n = 0; n < N; ++n) {
+          const auto iOut = m * N + n;
+          // += doesn't work for bool.
+          out[iOut] = out[iOut] + rhs[k * N + n] * l;
+        }
+      }
+    }
+  }
+
+  /**
+   * Reduce the elements starting at #from, which have Shape #fromShape, to
+   * Shape #to with the BinaryOp, writing the result to the elements starting
+   * at #out, which is a pointer or a random access iterator.
+   * */
+  template <class BinaryOp, typename OutIter>
+  static void reduceInto(const T *from,
+                         const Shape &fromShape,
+                         const Shape &to,
+                         OutIter out) {
+    const BinaryOp op;
+    std::fill(out, out + to.nelms_u64(), BinaryOp::identity());
+    const auto reducedIndices = fromShape.getReducedRowMajorIndices(to);
+    for (uint64_t i = 0; i < fromShape.nelms_u64(); ++i) {
+      const auto outIndex = reducedIndices[i];
+      out[outIndex]       = op(out[outIndex], from[i]);
+    }
+  }
+
 private:
   template <class UnaryOp, class... Args>
   BaseDataSP unary(Args... args) const {
     const UnaryOp op(args...);
-    Vec out(nelms_u64());
+    auto out = VectorPool<T>::acquire(nelms_u64());
 
     const auto *srcBegin = dataPtr();
     const auto *srcEnd   = std::next(srcBegin, nelms_i64());
@@ -425,10 +492,9 @@ private:
     if (auto rhs_ = dynamic_cast<const OriginData<T> *>(&rhs)) {
       const auto rhsData_  = rhs_->dataPtr();
       const auto thisData_ = dataPtr();
-      std::vector<ReturnType> out;
-      out.reserve(nelms_u64());
+      auto out = VectorPool<ReturnType>::acquire(nelms_u64());
       for (uint64_t i = 0; i < nelms_u64(); ++i) {
-        out.push_back(op(thisData_[i], rhsData_[i]));
+        out[i] = op(thisData_[i], rhsData_[i]);
       }
 
       return std::make_shared<AllocData<ReturnType>>(std::move(out));
@@ -463,23 +529,8 @@ private:
         throw error(oss.str());
       }
 
-      // basic tiling will greatly accelerate this (TODO(T39155))
-      const auto dRhs = rhs->dataPtr();
-      const auto dLhs = dataPtr();
-      std::vector<T> out;
-      out.resize(M * N, 0);
-      for (uint64_t m = 0; m < M; ++m) {
-        for (uint64_t n = 0; n < N; ++n) {
-          for (uint64_t k = 0; k < K; ++k) {
-            const auto iLhs = m * K + k;
-            const auto iRhs = k * N + n;
-            const auto iOut = m * N + n;
-            // += doesn't work for bool.
-            out[iOut] = out[iOut] + dRhs[iRhs] * dLhs[iLhs];
-          }
-        }
-      }
-
+      auto out = VectorPool<T>::acquire(M * N);
+      matmulInto(dataPtr(), rhs->dataPtr(), out.begin(), M, N, K);
       return std::make_shared<AllocData<T>>(std::move(out));
     }
 
@@ -492,16 +543,8 @@ private:
   template <class BinaryOp>
   std::shared_ptr<AllocData<T>> reduce(const Shape &from,
                                        const Shape &to) const {
-    const BinaryOp op;
-    const auto thisData_ = dataPtr();
-    std::vector<T> out(to.nelms_u64(), BinaryOp::identity());
-
-    const auto reducedIndices = from.getReducedRowMajorIndices(to);
-    for (uint64_t i = 0; i < nelms_u64(); ++i) {
-      auto outIndex = reducedIndices[i];
-      out[outIndex] = op(out[outIndex], thisData_[i]);
-    }
-
+    auto out = VectorPool<T>::acquire(to.nelms_u64());
+    reduceInto<BinaryOp>(dataPtr(), from, to, out.begin());
     return std::make_shared<AllocData<T>>(std::move(out));
   }
 
@@ -2,6 +2,7 @@
 #ifndef POPRITHMS_COMPUTE_HOST_POINTERDATA_HPP
 #define POPRITHMS_COMPUTE_HOST_POINTERDATA_HPP
 
+#include <memory>
 #include <sstream>
 
 #include <compute/host/include/basedata.hpp>
@@ -15,11 +16,23 @@ namespace host {
 /**
  * An OriginData which does not contain an internal buffer, only a raw
  * pointer to underlying data is kept.
+ *
+ * Optionally, an owner of the memory which the pointer points into can be
+ * kept. The owner (for example a memory mapped file) is kept alive until
+ * this PointerData, and all PointerDatas cloned from it, are destroyed.
+ * If the owned memory must not be written to, the PointerData is read-only.
  * */
 template <class T> class PointerData : public OriginData<T> {
 public:
   PointerData(T *data__, uint64_t nElms__) : data_(data__), nElms_(nElms__) {}
 
+  PointerData(T *data__,
+              uint64_t nElms__,
+              std::shared_ptr<const void> owner__,
+              bool readOnly__)
+      : data_(data__), nElms_(nElms__), owner_(std::move(owner__)),
+        readOnly_(readOnly__) {}
+
   void append(std::ostream &ost) const final {
     ost << "PointerData(dtype=" << poprithms::ndarray::lcase<T>()
         << ",nelms=" << nelms_u64() << ')';
@@ -39,14 +52,19 @@ public:
   uint64_t nelms_u64() const final { return nElms_; }
 
   BaseDataSP clone() const final {
-    return std::make_shared<PointerData<T>>(data_, nElms_);
+    return std::make_shared<PointerData<T>>(
+        data_, nElms_, owner_, readOnly_);
   }
 
+  bool isReadOnly() const final { return readOnly_; }
+
   void updateData(T *n) { data_ = n; }
 
 private:
   T *data_;
   const uint64_t nElms_;
+  std::shared_ptr<const void> owner_;
+  bool readOnly_{false};
 };
 
 } // namespace host
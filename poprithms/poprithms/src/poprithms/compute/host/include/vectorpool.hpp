@@ -0,0 +1,199 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_COMPUTE_HOST_VECTORPOOL_HPP
+#define POPRITHMS_COMPUTE_HOST_VECTORPOOL_HPP
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <compute/host/include/ieeehalf.hpp>
+
+#include <poprithms/compute/host/bufferpool.hpp>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+/**
+ * The state of a BufferPool: its statistics, and the buffers it retains
+ * (for each element type, bucketed by size class). It is shared by the
+ * BufferPool and all of the AllocDatas whose buffers belong to it, so that
+ * buffers can be returned to it after the BufferPool has been destroyed, in
+ * which case they are freed.
+ * */
+class BufferPool::Impl {
+public:
+  explicit Impl(uint64_t maxBytesHeld_) : maxBytesHeld(maxBytesHeld_) {}
+
+  /**
+   * The pool of the innermost Scope of the calling thread.
+   * */
+  static std::shared_ptr<Impl> &current();
+
+  // std::vector<bool> does not store its elements contiguously, and
+  // AllocData<bool> does not store a std::vector, so bools are not pooled.
+  template <typename T>
+  static constexpr bool pooled = !std::is_same<T, bool>::value;
+
+  /**
+   * The smallest size class of at least #n elements. The size classes are
+   * all integers up to 4, and above that, the multiples of 2^(k-2) in
+   * [2^k, 2^(k+1)].
+   * */
+  static uint64_t sizeClass(uint64_t n);
+
+  /**
+   * The largest size class of at most #n elements. #n must be positive.
+   * */
+  static uint64_t floorSizeClass(uint64_t n);
+
+  /**
+   * A vector with #n elements, whose values are unspecified. All elements
+   * must be written before they are read.
+   * */
+  template <typename T> std::vector<T> acquire(uint64_t n) {
+    const auto c = sizeClass(n);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++stats.nAcquisitions;
+      auto found = buckets<T>().find(c);
+      if (found != buckets<T>().end() && !found->second.empty()) {
+        ++stats.nHits;
+        auto v = std::move(found->second.back());
+        found->second.pop_back();
+        stats.nBytesHeld -= v.capacity() * sizeof(T);
+        v.resize(n);
+        return v;
+      }
+    }
+    std::vector<T> v;
+    v.reserve(c);
+    v.resize(n);
+    return v;
+  }
+
+  /**
+   * Register #v as a buffer which is in use, and which is returned to this
+   * pool with #release.
+   * */
+  template <typename T> void adopt(const std::vector<T> &v) {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.nBytesInUse += v.capacity() * sizeof(T);
+    updatePeaks();
+  }
+
+  /**
+   * Return #v, which was adopted, to the pool. If the pool has been
+   * destroyed, or is full, #v is freed.
+   * */
+  template <typename T> void release(std::vector<T> &&v) {
+    const auto nBytes = v.capacity() * sizeof(T);
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.nBytesInUse -= nBytes;
+    if (closed || nBytes == 0) {
+      return;
+    }
+    if (stats.nBytesHeld + nBytes > maxBytesHeld) {
+      ++stats.nRejections;
+      return;
+    }
+    ++stats.nReleases;
+    stats.nBytesHeld += nBytes;
+    updatePeaks();
+    buckets<T>()[floorSizeClass(v.capacity())].push_back(std::move(v));
+  }
+
+  /**
+   * Free all retained buffers. The mutex must be held by the caller.
+   * */
+  void clearLocked();
+
+  /**
+   * Free all retained buffers, and do not retain any more.
+   * */
+  void close();
+
+  std::mutex mutex;
+  BufferPool::Stats stats;
+  uint64_t maxBytesHeld;
+
+private:
+  void updatePeaks() {
+    stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.nBytesInUse);
+    stats.peakBytesHeld  = std::max(stats.peakBytesHeld, stats.nBytesHeld);
+    stats.peakBytes =
+        std::max(stats.peakBytes, stats.nBytesInUse + stats.nBytesHeld);
+  }
+
+  template <typename T>
+  using Buckets = std::unordered_map<uint64_t, std::vector<std::vector<T>>>;
+
+  template <typename T> Buckets<T> &buckets() {
+    return std::get<Buckets<T>>(allBuckets);
+  }
+
+  std::tuple<Buckets<double>,
+             Buckets<float>,
+             Buckets<IeeeHalf>,
+             Buckets<int8_t>,
+             Buckets<int16_t>,
+             Buckets<int32_t>,
+             Buckets<int64_t>,
+             Buckets<uint8_t>,
+             Buckets<uint16_t>,
+             Buckets<uint32_t>,
+             Buckets<uint64_t>>
+      allBuckets;
+
+  bool closed{false};
+};
+
+/**
+ * The buffers of type std::vector<T>, taken from the current BufferPool of
+ * the calling thread (see BufferPool::Scope).
+ * */
+template <typename T> class VectorPool {
+public:
+  using Vec = std::vector<T>;
+
+  static constexpr bool pooled = BufferPool::Impl::pooled<T>;
+
+  /**
+   * A vector with #n elements, whose values are unspecified if there is a
+   * current pool. All elements must be written before they are read.
+   * */
+  static Vec acquire(uint64_t n) {
+    if constexpr (pooled) {
+      const auto &pool = BufferPool::Impl::current();
+      if (pool && n != 0) {
+        return pool->acquire<T>(n);
+      }
+    }
+    return Vec(n);
+  }
+
+  /**
+   * The current pool, which #v is registered with, or nullptr if there is
+   * no current pool. \sa BufferPool::Impl::adopt.
+   * */
+  static std::shared_ptr<BufferPool::Impl> adopt(const Vec &v) {
+    if constexpr (pooled) {
+      const auto &pool = BufferPool::Impl::current();
+      if (pool) {
+        pool->adopt<T>(v);
+        return pool;
+      }
+    }
+    return nullptr;
+  }
+};
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
+
+#endif
@@ -2,6 +2,8 @@
 #ifndef POPRITHMS_COMPUTE_HOST_VIEWDATA_HPP
 #define POPRITHMS_COMPUTE_HOST_VIEWDATA_HPP
 
+#include <algorithm>
+
 #include <compute/host/include/baseoperators.hpp>
 #include <compute/host/include/gridpointhelper.hpp>
 #include <compute/host/include/typeddata.hpp>
@@ -475,6 +477,12 @@ public:
     binary_<Exponentiater<T>>(rhs);
   }
 
+  bool isReadOnly() const final {
+    return std::any_of(rowMajorOriginDatas.cbegin(),
+                       rowMajorOriginDatas.cend(),
+                       [](const auto &o) { return o->isReadOnly(); });
+  }
+
   bool containsAliases() const final {
     return !GridPointHelper::allUnique(indices(), offsets());
   }
@@ -0,0 +1,523 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+#include <compute/host/error.hpp>
+#include <compute/host/include/allocdata.hpp>
+#include <compute/host/include/baseoperators.hpp>
+#include <compute/host/include/externdecl.hpp>
+#include <compute/host/include/typeswitch.hpp>
+
+#include <poprithms/compute/host/lazytensor.hpp>
+#include <poprithms/compute/host/tensor.hpp>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+enum class LazyTensor::OpType {
+  Leaf = 0,
+
+  // Binary:
+  Add,
+  Mul,
+  Subtract,
+  Divide,
+  Max,
+  Min,
+  Pow,
+  Mod,
+
+  // Unary:
+  Abs,
+  Exp,
+  Log,
+  Sqrt,
+  Sin,
+  Cos,
+  Ceil,
+  Floor,
+  Reciprocal,
+  Neg,
+  Relu
+};
+
+class LazyTensor::Node {
+public:
+  explicit Node(const Tensor &t)
+      : type(OpType::Leaf), shape(t.shape()), dtype(t.dtype()), leaf({t}) {}
+
+  Node(OpType t,
+       const Shape &s,
+       DType d,
+       std::vector<std::shared_ptr<const Node>> &&ins_)
+      : type(t), shape(s), dtype(d), ins(std::move(ins_)) {}
+
+  static std::string str(OpType t) {
+    switch (t) {
+    case OpType::Leaf:
+      return "Leaf";
+    case OpType::Add:
+      return "Add";
+    case OpType::Mul:
+      return "Mul";
+    case OpType::Subtract:
+      return "Subtract";
+    case OpType::Divide:
+      return "Divide";
+    case OpType::Max:
+      return "Max";
+    case OpType::Min:
+      return "Min";
+    case OpType::Pow:
+      return "Pow";
+    case OpType::Mod:
+      return "Mod";
+    case OpType::Abs:
+      return "Abs";
+    case OpType::Exp:
+      return "Exp";
+    case OpType::Log:
+      return "Log";
+    case OpType::Sqrt:
+      return "Sqrt";
+    case OpType::Sin:
+      return "Sin";
+    case OpType::Cos:
+      return "Cos";
+    case OpType::Ceil:
+      return "Ceil";
+    case OpType::Floor:
+      return "Floor";
+    case OpType::Reciprocal:
+      return "Reciprocal";
+    case OpType::Neg:
+      return "Neg";
+    case OpType::Relu:
+      return "Relu";
+    }
+    throw error("Unrecognised LazyTensor::OpType");
+  }
+
+  const OpType type;
+  const Shape shape;
+  const DType dtype;
+
+  // Contains exactly 1 Tensor for nodes of type Leaf, and is empty for all
+  // other nodes.
+  const Tensors leaf;
+
+  // Empty for nodes of type Leaf.
+  const std::vector<std::shared_ptr<const Node>> ins;
+};
+
+namespace {
+
+// relu(x) = x * (x > 0), exactly as in the eager Tensor::relu.
+template <typename T> class Relu {
+public:
+  T operator()(T a) const {
+    return Multiplier<T>()(a, static_cast<T>(GreaterThan<T>()(a, T(0))));
+  }
+};
+
+// neg(x) = -1 * x, exactly as in the eager Tensor::neg.
+template <typename T> class Neg {
+public:
+  T operator()(T a) const { return Multiplier<T>()(fromDouble<T>(-1.), a); }
+};
+
+template <typename T, class Op>
+void applyUnary(const T *in, T *out, uint64_t n) {
+  const Op op;
+  for (uint64_t i = 0; i < n; ++i) {
+    out[i] = op(in[i]);
+  }
+}
+
+template <typename T, class Op>
+void applyBinary(const T *in0, const T *in1, T *out, uint64_t n) {
+  const Op op;
+  for (uint64_t i = 0; i < n; ++i) {
+    out[i] = op(in0[i], in1[i]);
+  }
+}
+
+} // namespace
+
+/**
+ * Evaluates the expression rooted at a Node, in blocks of contiguous output
+ * elements. For each block, the nodes are processed in topological order,
+ * with each node writing its values for the block into a buffer of the
+ * block size. Only the root node writes into the (full size) output buffer.
+ * */
+class LazyTensor::Evaluator {
+public:
+  // The number of output elements processed together. Small enough that the
+  // buffers of all nodes stay in cache, large enough that the per-block
+  // overhead is negligible.
+  static constexpr uint64_t BlockSize = 1024;
+
+  template <typename T>
+  static std::shared_ptr<BaseData> go(const Node &root) {
+
+    using Primal = typename Container<T>::Primal;
+
+    // Nodes in topological order (inputs before consumers), each node
+    // appearing once even if it is used multiple times in the expression.
+    const auto order = topologicalOrder(root);
+
+    const uint64_t nOut = root.shape.nelms_u64();
+    Primal out(nOut);
+    if (nOut == 0) {
+      return std::make_shared<AllocData<T>>(std::move(out));
+    }
+
+    std::unordered_map<const Node *, uint64_t> index;
+    for (uint64_t i = 0; i < order.size(); ++i) {
+      index.insert({order[i], i});
+    }
+
+    const auto outDims    = root.shape.get();
+    const auto outStrides = root.shape.getRowMajorStrides();
+    const auto rank       = outDims.size();
+
+    // Per-node state.
+    std::vector<Primal> buffers(order.size());
+    std::vector<const T *> current(order.size(), nullptr);
+
+    // Leaf specific state. Leaves which are not contiguous are copied to
+    // origin (contiguous) tensors, which are kept alive here.
+    enum class LeafKind { Direct, Scalar, Broadcast };
+    std::vector<LeafKind> leafKinds(order.size(), LeafKind::Direct);
+    std::vector<const T *> leafBases(order.size(), nullptr);
+    std::vector<std::vector<int64_t>> leafStrides(order.size());
+    Tensors origins;
+    origins.reserve(order.size());
+
+    for (uint64_t i = 0; i < order.size(); ++i) {
+      const auto &n = *order[i];
+      if (n.type != OpType::Leaf) {
+        if (&n != &root) {
+          buffers[i].resize(std::min(BlockSize, nOut));
+        }
+        continue;
+      }
+
+      const auto &t = n.leaf[0];
+      origins.push_back(t.implIsOrigin() ? t : t.copy());
+      leafBases[i] =
+          static_cast<const T *>(origins.back().getPtrToOriginData(0));
+
+      if (t.shape() == root.shape) {
+        leafKinds[i] = LeafKind::Direct;
+      } else if (t.nelms_u64() == 1) {
+        // A broadcast scalar: fill a buffer once, which is then used for
+        // every block.
+        leafKinds[i] = LeafKind::Scalar;
+        buffers[i]   = Primal(std::min(BlockSize, nOut), leafBases[i][0]);
+        current[i]   = buffers[i].data();
+      } else {
+        // A general numpy broadcast. The stride in the leaf of every
+        // dimension of the output, which is 0 for broadcast dimensions.
+        leafKinds[i] = LeafKind::Broadcast;
+        const auto leafShape = t.shape().prependOnes(rank - t.rank_u64());
+        const auto rms       = leafShape.getRowMajorStrides();
+        leafStrides[i]       = std::vector<int64_t>(rank, 0);
+        for (uint64_t d = 0; d < rank; ++d) {
+          if (leafShape.dim(d) == outDims[d]) {
+            leafStrides[i][d] = rms[d];
+          }
+        }
+        buffers[i].resize(std::min(BlockSize, nOut));
+      }
+    }
+
+    for (uint64_t start = 0; start < nOut; start += BlockSize) {
+      const uint64_t len = std::min(BlockSize, nOut - start);
+
+      for (uint64_t i = 0; i < order.size(); ++i) {
+        const auto &n = *order[i];
+        T *dst = &n == &root ? out.data() + start : buffers[i].data();
+
+        if (n.type == OpType::Leaf) {
+          switch (leafKinds[i]) {
+          case LeafKind::Direct: {
+            current[i] = leafBases[i] + start;
+            break;
+          }
+          case LeafKind::Scalar: {
+            break;
+          }
+          case LeafKind::Broadcast: {
+            fillBroadcast(leafBases[i],
+                          leafStrides[i],
+                          outDims,
+                          outStrides,
+                          start,
+                          len,
+                          buffers[i].data());
+            current[i] = buffers[i].data();
+            break;
+          }
+          }
+          if (&n == &root) {
+            std::copy(current[i], current[i] + len, dst);
+          }
+          continue;
+        }
+
+        const T *in0 = current[index.at(n.ins[0].get())];
+        if (n.ins.size() == 1) {
+          unary(n.type, in0, dst, len);
+        } else {
+          const T *in1 = current[index.at(n.ins[1].get())];
+          binary(n.type, in0, in1, dst, len);
+        }
+        current[i] = dst;
+      }
+    }
+
+    return std::make_shared<AllocData<T>>(std::move(out));
+  }
+
+  static std::string str() { return "LazyTensor::Evaluator"; }
+
+  static std::vector<const Node *> topologicalOrder(const Node &root) {
+    std::vector<const Node *> order;
+    std::unordered_map<const Node *, bool> visited;
+
+    // Iterative post-order depth first search, so that very long chains do
+    // not overflow the stack.
+    std::vector<std::pair<const Node *, uint64_t>> stack{{&root, 0}};
+    visited.insert({&root, true});
+    while (!stack.empty()) {
+      auto &[node, nextIn] = stack.back();
+      if (nextIn < node->ins.size()) {
+        const Node *in = node->ins[nextIn].get();
+        ++nextIn;
+        if (visited.count(in) == 0) {
+          visited.insert({in, true});
+          stack.push_back({in, 0});
+        }
+      } else {
+        order.push_back(node);
+        stack.pop_back();
+      }
+    }
+    return order;
+  }
+
+private:
+  template <typename T>
+  static void fillBroadcast(const T *base,
+                            const std::vector<int64_t> &leafStrides,
+                            const std::vector<int64_t> &outDims,
+                            const std::vector<int64_t> &outStrides,
+                            uint64_t start,
+                            uint64_t len,
+                            T *dst) {
+
+    const auto rank = outDims.size();
+
+    // The multi-dimensional index of the first element of the block, and the
+    // corresponding offset into the leaf.
+    std::vector<int64_t> idx(rank);
+    int64_t offset = 0;
+    auto rem       = static_cast<int64_t>(start);
+    for (uint64_t d = 0; d < rank; ++d) {
+      idx[d] = rem / outStrides[d];
+      rem    = rem % outStrides[d];
+      offset += idx[d] * leafStrides[d];
+    }
+
+    for (uint64_t j = 0; j < len; ++j) {
+      if (j != 0) {
+        // Increment the multi-dimensional index, odometer style.
+        auto d = rank - 1;
+        ++idx[d];
+        offset += leafStrides[d];
+        while (idx[d] == outDims[d]) {
+          offset -= leafStrides[d] * outDims[d];
+          idx[d] = 0;
+          --d;
+          ++idx[d];
+          offset += leafStrides[d];
+        }
+      }
+      dst[j] = base[offset];
+    }
+  }
+
+  template <typename T>
+  static void unary(OpType t, const T *in, T *out, uint64_t n) {
+    switch (t) {
+    case OpType::Abs:
+      return applyUnary<T, Abs<T>>(in, out, n);
+    case OpType::Exp:
+      return applyUnary<T, Exp<T>>(in, out, n);
+    case OpType::Log:
+      return applyUnary<T, Log<T>>(in, out, n);
+    case OpType::Sqrt:
+      return applyUnary<T, Sqrt<T>>(in, out, n);
+    case OpType::Sin:
+      return applyUnary<T, Sin<T>>(in, out, n);
+    case OpType::Cos:
+      return applyUnary<T, Cos<T>>(in, out, n);
+    case OpType::Ceil:
+      return applyUnary<T, Ceil<T>>(in, out, n);
+    case OpType::Floor:
+      return applyUnary<T, Floor<T>>(in, out, n);
+    case OpType::Reciprocal:
+      return applyUnary<T, Reciprocal<T>>(in, out, n);
+    case OpType::Neg:
+      return applyUnary<T, Neg<T>>(in, out, n);
+    case OpType::Relu:
+      return applyUnary<T, Relu<T>>(in, out, n);
+    default:
+      throw error("Invalid unary LazyTensor::OpType " + Node::str(t));
+    }
+  }
+
+  template <typename T>
+  static void
+  binary(OpType t, const T *in0, const T *in1, T *out, uint64_t n) {
+    switch (t) {
+    case OpType::Add:
+      return applyBinary<T, Adder<T>>(in0, in1, out, n);
+    case OpType::Mul:
+      return applyBinary<T, Multiplier<T>>(in0, in1, out, n);
+    case OpType::Subtract:
+      return applyBinary<T, Subtracter<T>>(in0, in1, out, n);
+    case OpType::Divide:
+      return applyBinary<T, Divider<T>>(in0, in1, out, n);
+    case OpType::Max:
+      return applyBinary<T, MaxTaker<T>>(in0, in1, out, n);
+    case OpType::Min:
+      return applyBinary<T, MinTaker<T>>(in0, in1, out, n);
+    case OpType::Pow:
+      return applyBinary<T, Exponentiater<T>>(in0, in1, out, n);
+    case OpType::Mod:
+      return applyBinary<T, Modder<T>>(in0, in1, out, n);
+    default:
+      throw error("Invalid binary LazyTensor::OpType " + Node::str(t));
+    }
+  }
+};
+
+LazyTensor::LazyTensor(const Tensor &t)
+    : node_(std::make_shared<const Node>(t)) {}
+
+LazyTensor Tensor::lazy() const { return LazyTensor(*this); }
+
+const Shape &LazyTensor::shape() const { return node_->shape; }
+
+DType LazyTensor::dtype() const { return node_->dtype; }
+
+LazyTensor LazyTensor::binary(OpType t, const LazyTensor &rhs) const {
+  if (dtype() != rhs.dtype()) {
+    std::ostringstream oss;
+    oss << "Failed to record the binary operation " << Node::str(t)
+        << " between LazyTensors of types " << dtype() << " and "
+        << rhs.dtype() << ". Implicit casting is never performed. ";
+    throw error(oss.str());
+  }
+  const auto outShape = shape().numpyBinary(rhs.shape());
+  return LazyTensor(std::make_shared<const Node>(
+      t,
+      outShape,
+      dtype(),
+      std::vector<std::shared_ptr<const Node>>{node_, rhs.node_}));
+}
+
+LazyTensor LazyTensor::unary(OpType t) const {
+  return LazyTensor(std::make_shared<const Node>(
+      t, shape(), dtype(), std::vector<std::shared_ptr<const Node>>{node_}));
+}
+
+LazyTensor LazyTensor::add(const LazyTensor &rhs) const {
+  return binary(OpType::Add, rhs);
+}
+LazyTensor LazyTensor::mul(const LazyTensor &rhs) const {
+  return binary(OpType::Mul, rhs);
+}
+LazyTensor LazyTensor::subtract(const LazyTensor &rhs) const {
+  return binary(OpType::Subtract, rhs);
+}
+LazyTensor LazyTensor::divide(const LazyTensor &rhs) const {
+  return binary(OpType::Divide, rhs);
+}
+LazyTensor LazyTensor::max(const LazyTensor &rhs) const {
+  return binary(OpType::Max, rhs);
+}
+LazyTensor LazyTensor::min(const LazyTensor &rhs) const {
+  return binary(OpType::Min, rhs);
+}
+LazyTensor LazyTensor::pow(const LazyTensor &rhs) const {
+  return binary(OpType::Pow, rhs);
+}
+LazyTensor LazyTensor::mod(const LazyTensor &rhs) const {
+  return binary(OpType::Mod, rhs);
+}
+
+LazyTensor LazyTensor::abs() const { return unary(OpType::Abs); }
+LazyTensor LazyTensor::exp() const { return unary(OpType::Exp); }
+LazyTensor LazyTensor::log() const { return unary(OpType::Log); }
+LazyTensor LazyTensor::sqrt() const { return unary(OpType::Sqrt); }
+LazyTensor LazyTensor::sin() const { return unary(OpType::Sin); }
+LazyTensor LazyTensor::cos() const { return unary(OpType::Cos); }
+LazyTensor LazyTensor::ceil() const { return unary(OpType::Ceil); }
+LazyTensor LazyTensor::floor() const { return unary(OpType::Floor); }
+LazyTensor LazyTensor::reciprocal() const {
+  return unary(OpType::Reciprocal);
+}
+LazyTensor LazyTensor::neg() const { return unary(OpType::Neg); }
+LazyTensor LazyTensor::relu() const { return unary(OpType::Relu); }
+
+Tensor LazyTensor::eval() const {
+  return Tensor(
+      shape(), dtype(), typeSwitch<Evaluator, BaseDataSP>(dtype(), *node_));
+}
+
+uint64_t LazyTensor::nOps() const {
+  uint64_t n{0};
+  for (auto node : Evaluator::topologicalOrder(*node_)) {
+    if (node->type != OpType::Leaf) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+void LazyTensor::append(std::ostream &ost) const {
+  const auto order = Evaluator::topologicalOrder(*node_);
+  std::unordered_map<const Node *, uint64_t> index;
+  ost << "LazyTensor(shape=" << shape() << ",dtype=" << dtype() << ",ops=(";
+  for (uint64_t i = 0; i < order.size(); ++i) {
+    index.insert({order[i], i});
+    if (i != 0) {
+      ost << ',';
+    }
+    ost << '%' << i << '=' << Node::str(order[i]->type);
+    if (order[i]->type == OpType::Leaf) {
+      ost << order[i]->shape;
+    } else {
+      ost << '(';
+      for (uint64_t j = 0; j < order[i]->ins.size(); ++j) {
+        ost << (j == 0 ? "%" : ",%") << index.at(order[i]->ins[j].get());
+      }
+      ost << ')';
+    }
+  }
+  ost << "))";
+}
+
+std::ostream &operator<<(std::ostream &ost, const LazyTensor &t) {
+  t.append(ost);
+  return ost;
+}
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
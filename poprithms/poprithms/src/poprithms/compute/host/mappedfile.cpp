@@ -0,0 +1,277 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <compute/host/error.hpp>
+#include <compute/host/include/mappedfile.hpp>
+
+namespace poprithms {
+namespace compute {
+namespace host {
+
+namespace {
+
+std::string systemErrorString(const std::string &what,
+                              const std::string &filename) {
+  std::ostringstream oss;
+  oss << "Failed to " << what << " the file '" << filename
+      << "': " << std::strerror(errno) << '.';
+  return oss.str();
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string &filename, bool copyOnWrite)
+    : filename_(filename), copyOnWrite_(copyOnWrite) {
+
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw error(systemErrorString("open", filename));
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    auto msg = systemErrorString("stat", filename);
+    ::close(fd);
+    throw error(msg);
+  }
+
+  nBytes_ = static_cast<uint64_t>(st.st_size);
+  if (nBytes_ == 0) {
+    ::close(fd);
+    throw error("Cannot map the empty file '" + filename + "'.");
+  }
+
+  // Private mappings are writable, with modified pages copied on write.
+  // Shared mappings are read-only, so that the file is never modified.
+  const int prot  = copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+  const int flags = copyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+
+  void *addr = ::mmap(nullptr, nBytes_, prot, flags, fd, 0);
+
+  // The mapping remains valid after the file descriptor is closed.
+  ::close(fd);
+
+  if (addr == MAP_FAILED) {
+    throw error(systemErrorString("mmap", filename));
+  }
+  data_ = static_cast<char *>(addr);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    ::munmap(data_, nBytes_);
+  }
+}
+
+void MappedFile::assertValidRegion(uint64_t offset,
+                                   uint64_t nBytesRequired,
+                                   uint64_t elementSize) const {
+  if (offset + nBytesRequired > nbytes()) {
+    std::ostringstream oss;
+    oss << "The file '" << filename() << "' has " << nbytes()
+        << " bytes, which is too few to map " << nBytesRequired
+        << " bytes starting at byte offset " << offset << '.';
+    throw error(oss.str());
+  }
+
+  // The mapping starts at a page boundary, so the alignment of elements is
+  // determined by the offset alone.
+  if (elementSize != 0 && offset % elementSize != 0) {
+    std::ostringstream oss;
+    oss << "Invalid byte offset " << offset << " into the file '"
+        << filename() << "'. It must be a multiple of the element size, "
+        << elementSize << '.';
+    throw error(oss.str());
+  }
+}
+
+namespace {
+
+// Return the value in the header dictionary string #dict which follows the
+// key #key. For example, if #dict is "{'descr': '<f4', 'shape': (2,)}" and
+// #key is "shape", then the position of the '(' is returned.
+uint64_t valueStart(const std::string &dict, const std::string &key) {
+  const auto quoted = '\'' + key + '\'';
+  auto found        = dict.find(quoted);
+  if (found == std::string::npos) {
+    throw error("No key '" + key + "' in the .npy header " + dict);
+  }
+  auto colon = dict.find(':', found + quoted.size());
+  if (colon == std::string::npos) {
+    throw error("No ':' after key '" + key + "' in the .npy header " + dict);
+  }
+  auto start = dict.find_first_not_of(' ', colon + 1);
+  if (start == std::string::npos) {
+    throw error("No value for key '" + key + "' in the .npy header " + dict);
+  }
+  return start;
+}
+
+std::string parseDescr(const std::string &dict) {
+  auto start = valueStart(dict, "descr");
+  if (dict[start] != '\'') {
+    throw error("Expected a quoted string for 'descr' in the .npy header " +
+                dict + ". Structured types are not supported.");
+  }
+  auto end = dict.find('\'', start + 1);
+  if (end == std::string::npos) {
+    throw error("Unterminated 'descr' in the .npy header " + dict);
+  }
+  return dict.substr(start + 1, end - start - 1);
+}
+
+bool parseFortranOrder(const std::string &dict) {
+  auto start = valueStart(dict, "fortran_order");
+  if (dict.compare(start, 4, "True") == 0) {
+    return true;
+  }
+  if (dict.compare(start, 5, "False") == 0) {
+    return false;
+  }
+  throw error("Invalid value for 'fortran_order' in the .npy header " + dict);
+}
+
+ndarray::Shape parseShape(const std::string &dict) {
+  auto start = valueStart(dict, "shape");
+  if (dict[start] != '(') {
+    throw error("Expected a tuple for 'shape' in the .npy header " + dict);
+  }
+  auto end = dict.find(')', start);
+  if (end == std::string::npos) {
+    throw error("Unterminated 'shape' in the .npy header " + dict);
+  }
+
+  std::vector<int64_t> dims;
+  std::istringstream iss(dict.substr(start + 1, end - start - 1));
+  std::string token;
+  while (std::getline(iss, token, ',')) {
+    auto first = token.find_first_not_of(' ');
+    if (first == std::string::npos) {
+      // The trailing comma of a rank-1 shape, as in "(5,)".
+      continue;
+    }
+    auto last = token.find_last_not_of(" L");
+    dims.push_back(std::stoll(token.substr(first, last - first + 1)));
+  }
+  return ndarray::Shape(dims);
+}
+
+} // namespace
+
+ndarray::DType NpyHeader::dtypeFromDescr(const std::string &descr) {
+
+  if (descr.size() < 3) {
+    throw error("Invalid .npy type description '" + descr + "'.");
+  }
+
+  // The byte order character. Little-endian ('<'), not applicable ('|') and
+  // native ('=') are accepted, as poprithms only targets little-endian
+  // hosts.
+  const auto order = descr[0];
+  if (order != '<' && order != '|' && order != '=') {
+    throw error("Unsupported byte order in .npy type description '" + descr +
+                "'. Only little-endian data is supported.");
+  }
+
+  const auto kind = descr.substr(1);
+  using ndarray::DType;
+  if (kind == "f8") {
+    return DType::Float64;
+  }
+  if (kind == "f4") {
+    return DType::Float32;
+  }
+  if (kind == "f2") {
+    return DType::Float16;
+  }
+  if (kind == "i8") {
+    return DType::Int64;
+  }
+  if (kind == "i4") {
+    return DType::Int32;
+  }
+  if (kind == "i2") {
+    return DType::Int16;
+  }
+  if (kind == "i1") {
+    return DType::Int8;
+  }
+  if (kind == "u8") {
+    return DType::Unsigned64;
+  }
+  if (kind == "u4") {
+    return DType::Unsigned32;
+  }
+  if (kind == "u2") {
+    return DType::Unsigned16;
+  }
+  if (kind == "u1") {
+    return DType::Unsigned8;
+  }
+  if (kind == "b1") {
+    return DType::Boolean;
+  }
+  throw error("Unsupported .npy type description '" + descr + "'.");
+}
+
+NpyHeader::NpyHeader(const char *data, uint64_t nBytes)
+    : dtype_(ndarray::DType::N), shape_(std::vector<int64_t>{}),
+      dataOffset_(0) {
+
+  // The magic string, followed by 2 bytes for the major and minor versions.
+  const std::string magic("\x93NUMPY");
+  if (nBytes < magic.size() + 2 ||
+      std::string(data, magic.size()) != magic) {
+    throw error("Invalid .npy file: the magic string '\\x93NUMPY' was not "
+                "found at the start of the file.");
+  }
+
+  const auto majorVersion = static_cast<uint8_t>(data[magic.size()]);
+
+  // Version 1.0 has a 2 byte header length, versions 2.0 and 3.0 have a 4
+  // byte header length. All are little-endian.
+  const uint64_t lenBytes = majorVersion == 1 ? 2 : 4;
+  if (majorVersion < 1 || majorVersion > 3) {
+    std::ostringstream oss;
+    oss << "Unsupported .npy format major version "
+        << static_cast<uint32_t>(majorVersion) << '.';
+    throw error(oss.str());
+  }
+
+  const uint64_t lenStart = magic.size() + 2;
+  if (nBytes < lenStart + lenBytes) {
+    throw error("Invalid .npy file: truncated header length.");
+  }
+
+  uint64_t headerLen{0};
+  for (uint64_t i = 0; i < lenBytes; ++i) {
+    headerLen |= static_cast<uint64_t>(
+                     static_cast<uint8_t>(data[lenStart + i]))
+                 << (8 * i);
+  }
+
+  dataOffset_ = lenStart + lenBytes + headerLen;
+  if (nBytes < dataOffset_) {
+    throw error("Invalid .npy file: truncated header.");
+  }
+
+  const std::string dict(data + lenStart + lenBytes, headerLen);
+
+  if (parseFortranOrder(dict)) {
+    throw error("Fortran ordered (column-major) .npy files are not "
+                "supported, only C ordered (row-major) files are.");
+  }
+
+  dtype_ = dtypeFromDescr(parseDescr(dict));
+  shape_ = parseShape(dict);
+}
+
+} // namespace host
+} // namespace compute
+} // namespace poprithms
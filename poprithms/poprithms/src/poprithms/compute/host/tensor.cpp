@@ -14,6 +14,7 @@
 #include <compute/host/include/basedata.hpp>
 #include <compute/host/include/externdecl.hpp>
 #include <compute/host/include/ieeehalf.hpp>
+#include <compute/host/include/mappedfile.hpp>
 #include <compute/host/include/pointerdata.hpp>
 #include <compute/host/include/typeswitch.hpp>
 #include <compute/host/include/viewdata.hpp>
@@ -209,6 +210,42 @@ Tensor Tensor::uninitializedRef(const Shape &s, const DType t) {
   return typeSwitch<UninitializedPointer, Tensor>(t, s);
 }
 
+class Tensor::FileMapper {
+public:
+  template <typename T>
+  static Tensor go(const Shape &s,
+                   const std::shared_ptr<MappedFile> &mapped,
+                   uint64_t byteOffset) {
+    mapped->assertValidRegion(
+        byteOffset, s.nelms_u64() * sizeof(T), sizeof(T));
+    auto element0 = reinterpret_cast<T *>(mapped->data() + byteOffset);
+    return Tensor(
+        s,
+        ndarray::get<T>(),
+        std::make_shared<PointerData<T>>(
+            element0, s.nelms_u64(), mapped, !mapped->copyOnWrite()));
+  }
+  static std::string str() { return "Tensor::FileMapper"; }
+};
+
+Tensor Tensor::mapRaw(DType t,
+                      const Shape &s,
+                      const std::string &filename,
+                      MapMode mode,
+                      uint64_t byteOffset) {
+  auto mapped =
+      std::make_shared<MappedFile>(filename, mode == MapMode::CopyOnWrite);
+  return typeSwitch<FileMapper, Tensor>(t, s, mapped, byteOffset);
+}
+
+Tensor Tensor::mapNpy(const std::string &filename, MapMode mode) {
+  auto mapped =
+      std::make_shared<MappedFile>(filename, mode == MapMode::CopyOnWrite);
+  const NpyHeader header(mapped->data(), mapped->nbytes());
+  return typeSwitch<FileMapper, Tensor>(
+      header.dtype(), header.shape(), mapped, header.dataOffset());
+}
+
 class Tensor::Caster {
 public:
   template <typename T> static Tensor go(const Shape &s, const void *vp) {
@@ -602,7 +639,7 @@ Tensor Tensor::add(const Tensor &rhs) const {
 }
 Tensor Tensor::add_(const Tensor &rhs) const {
   verifySameType(*this, rhs);
-  tData().add_(getArg1InplaceTarget(rhs, shape()).tData());
+  mutableTData("add_").add_(getArg1InplaceTarget(rhs, shape()).tData());
   return *this;
 }
 
@@ -618,7 +655,7 @@ Tensor Tensor::encodeOneHot_(const std::vector<uint64_t> &indices) const {
       throw error(oss.str());
     }
   }
-  tData().encodeOneHot_(indices);
+  mutableTData("encodeOneHot_").encodeOneHot_(indices);
   return *this;
 }
 
@@ -629,7 +666,7 @@ Tensor Tensor::mul(const Tensor &rhs) const {
 }
 Tensor Tensor::mul_(const Tensor &rhs) const {
   verifySameType(*this, rhs);
-  tData().mul_(getArg1InplaceTarget(rhs, shape()).tData());
+  mutableTData("mul_").mul_(getArg1InplaceTarget(rhs, shape()).tData());
   return *this;
 }
 
@@ -676,7 +713,7 @@ Tensor Tensor::pow(const Tensor &rhs) const {
 }
 Tensor Tensor::pow_(const Tensor &rhs) const {
   verifySameType(*this, rhs);
-  tData().pow_(getArg1InplaceTarget(rhs, shape()).tData());
+  mutableTData("pow_").pow_(getArg1InplaceTarget(rhs, shape()).tData());
   return *this;
 }
 
@@ -685,7 +722,7 @@ Tensor Tensor::copyFrom_(const Tensor &rhs) const {
   if (&tData() != &rhs.tData()) {
     verifySameType(*this, rhs);
     auto rhsTarg = getArg1InplaceTarget(rhs, shape());
-    tData().copyFrom_(rhsTarg.tData());
+    mutableTData("copyFrom_").copyFrom_(rhsTarg.tData());
   }
   return *this;
 }
@@ -759,7 +796,8 @@ Tensor Tensor::subtract(const Tensor &rhs) const {
 }
 Tensor Tensor::subtract_(const Tensor &rhs) const {
   verifySameType(*this, rhs);
-  tData().subtract_(getArg1InplaceTarget(rhs, shape()).tData());
+  mutableTData("subtract_").subtract_(
+      getArg1InplaceTarget(rhs, shape()).tData());
   return *this;
 }
 
@@ -772,7 +810,7 @@ Tensor Tensor::divide(const Tensor &rhs) const {
 Tensor Tensor::divide_(const Tensor &rhs) const {
 
   verifySameType(*this, rhs);
-  tData().divide_(getArg1InplaceTarget(rhs, shape()).tData());
+  mutableTData("divide_").divide_(getArg1InplaceTarget(rhs, shape()).tData());
   return *this;
 }
 
@@ -785,7 +823,7 @@ Tensor Tensor::mod(const Tensor &rhs) const {
 Tensor Tensor::mod_(const Tensor &rhs) const {
 
   verifySameType(*this, rhs);
-  tData().mod_(getArg1InplaceTarget(rhs, shape()).tData());
+  mutableTData("mod_").mod_(getArg1InplaceTarget(rhs, shape()).tData());
   return *this;
 }
 
@@ -801,7 +839,7 @@ Tensor Tensor::reciprocal() const {
 }
 
 Tensor Tensor::reciprocal_() const {
-  tData().reciprocal_();
+  mutableTData("reciprocal_").reciprocal_();
   return *this;
 }
 
@@ -858,37 +896,37 @@ Tensor Tensor::copy() const {
 }
 Tensor Tensor::abs() const { return {shape(), dtype(), tData().abs()}; }
 Tensor Tensor::abs_() const {
-  tData().abs_();
+  mutableTData("abs_").abs_();
   return *this;
 }
 
 Tensor Tensor::exp() const { return {shape(), dtype(), tData().exp()}; }
 Tensor Tensor::exp_() const {
-  tData().exp_();
+  mutableTData("exp_").exp_();
   return *this;
 }
 
 Tensor Tensor::log() const { return {shape(), dtype(), tData().log()}; }
 Tensor Tensor::log_() const {
-  tData().log_();
+  mutableTData("log_").log_();
   return *this;
 }
 
 Tensor Tensor::sqrt() const { return {shape(), dtype(), tData().sqrt()}; }
 Tensor Tensor::sqrt_() const {
-  tData().sqrt_();
+  mutableTData("sqrt_").sqrt_();
   return *this;
 }
 
 Tensor Tensor::sin() const { return {shape(), dtype(), tData().sin()}; }
 Tensor Tensor::sin_() const {
-  tData().sin_();
+  mutableTData("sin_").sin_();
   return *this;
 }
 
 Tensor Tensor::cos() const { return {shape(), dtype(), tData().cos()}; }
 Tensor Tensor::cos_() const {
-  tData().cos_();
+  mutableTData("cos_").cos_();
   return *this;
 }
 
@@ -909,13 +947,13 @@ Tensor Tensor::mod_(int64_t modulo) const {
 
 Tensor Tensor::ceil() const { return {shape(), dtype(), tData().ceil()}; }
 Tensor Tensor::ceil_() const {
-  tData().ceil_();
+  mutableTData("ceil_").ceil_();
   return *this;
 }
 
 Tensor Tensor::floor() const { return {shape(), dtype(), tData().floor()}; }
 Tensor Tensor::floor_() const {
-  tData().floor_();
+  mutableTData("floor_").floor_();
   return *this;
 }
 
@@ -1245,6 +1283,20 @@ Tensor Tensor::slice_(const Starts &starts,
 
 bool Tensor::containsAliases() const { return tData().containsAliases(); }
 
+bool Tensor::isReadOnly() const { return tData().isReadOnly(); }
+
+const BaseData &Tensor::mutableTData(const char *method) const {
+  if (isReadOnly()) {
+    std::ostringstream oss;
+    oss << "Invalid call to Tensor::" << method << " on a Tensor of shape "
+        << shape() << ", which is read-only. It aliases a file which was "
+        << "memory mapped with MapMode::ReadOnly. Use MapMode::CopyOnWrite "
+        << "to create a Tensor which can be modified.";
+    throw error(oss.str());
+  }
+  return tData();
+}
+
 // get the BaseData for each Tensor in tIns.
 std::vector<const BaseData *> Tensor::getBaseDataPtrs(const Tensors &tIns) {
   std::vector<const BaseData *> tDatas;
@@ -2236,6 +2288,325 @@ Tensor Tensor::scalarFromElement(uint64_t rowMajorIndex) const {
   return flatten_().slice({rmi}, {rmi + 1}).reshape({});
 }
 
+namespace {
+
+// Throw an error if #out does not have Shape #s and DType #t, which are the
+// Shape and DType of the result of the destination passing method #method.
+void assertValidDestination(const Tensor &out,
+                            const Shape &s,
+                            DType t,
+                            const std::string &method) {
+  if (out.shape() != s || out.dtype() != t) {
+    std::ostringstream oss;
+    oss << "Invalid destination in Tensor::" << method
+        << ". The result has shape " << s << " and type " << t
+        << ", but the destination has shape " << out.shape()
+        << " and type " << out.dtype() << '.';
+    throw error(oss.str());
+  }
+  if (out.isReadOnly()) {
+    std::ostringstream oss;
+    oss << "Invalid destination in Tensor::" << method
+        << ". The destination is read-only, as it aliases a file which was "
+        << "memory mapped with MapMode::ReadOnly.";
+    throw error(oss.str());
+  }
+}
+
+// Call f(dst), where dst is #out if #out has origin data. Otherwise dst is a
+// new tensor with origin data, which is copied to #out after f returns.
+template <typename F> void intoOrigin(const Tensor &out, F &&f) {
+  if (out.nelms_u64() == 0) {
+    return;
+  }
+  if (out.implIsOrigin()) {
+    f(out);
+    return;
+  }
+  const auto dst = Tensor::zeros(out.dtype(), out.shape());
+  f(dst);
+  out.update_(dst);
+}
+
+template <typename T> T *originPtr(const Tensor &t) {
+  return static_cast<T *>(t.getPtrToOriginData(0));
+}
+
+// -x. Not in baseoperators.hpp, as the outplace Tensor::neg is a
+// multiplication by -1.
+template <typename T> class Negater {
+public:
+  T operator()(T a) const { return static_cast<T>(-a); }
+};
+
+template <> class Negater<bool> {
+public:
+  bool operator()(bool a) const { return a; }
+};
+
+// The binary min and max are reductions (see Tensor::accumulate), which
+// start from the identity of the reduction.
+template <typename T> class BinaryMinTaker {
+public:
+  T operator()(T a, T b) const {
+    return op(op(MinTaker<T>::identity(), a), b);
+  }
+  MinTaker<T> op;
+};
+
+template <typename T> class BinaryMaxTaker {
+public:
+  T operator()(T a, T b) const {
+    return op(op(MaxTaker<T>::identity(), a), b);
+  }
+  MaxTaker<T> op;
+};
+
+// Write op(a[i], b[i]) to out[i], where #a, #b, and #out have origin data
+// and the same number of elements.
+template <template <typename...> class Op> class BinaryInto {
+public:
+  template <typename T>
+  static void go(const Tensor &a, const Tensor &b, const Tensor &out) {
+    using R = decltype(Op<T>()(T(), T()));
+    const Op<T> op;
+    const T *a0 = originPtr<T>(a);
+    const T *b0 = originPtr<T>(b);
+    std::transform(a0,
+                   a0 + a.nelms_u64(),
+                   b0,
+                   originPtr<R>(out),
+                   [op](T x, T y) { return op(x, y); });
+  }
+  static std::string str() { return "BinaryInto"; }
+};
+
+template <template <typename...> class Op>
+void binaryInto(const Tensor &a,
+                const Tensor &b,
+                const Tensor &out,
+                DType outType,
+                const std::string &method) {
+  verifySameType(a, b);
+  assertValidDestination(
+      out, a.shape().numpyBinary(b.shape()), outType, method);
+  intoOrigin(out, [&a, &b](const Tensor &dst) {
+    const auto co = getRowMajorPair(a, b);
+    typeSwitch<BinaryInto<Op>, void>(a.dtype(), co.arg0, co.arg1, dst);
+  });
+}
+
+// Write op(in[i]) to out[i], where #in and #out have origin data and the
+// same number of elements.
+template <template <typename...> class Op> class UnaryInto {
+public:
+  template <typename T> static void go(const Tensor &in, const Tensor &out) {
+    const Op<T> op;
+    const T *i0 = originPtr<T>(in);
+    std::transform(
+        i0, i0 + in.nelms_u64(), originPtr<T>(out), [op](T x) {
+          return op(x);
+        });
+  }
+  static std::string str() { return "UnaryInto"; }
+};
+
+template <template <typename...> class Op>
+void unaryInto(const Tensor &in,
+               const Tensor &out,
+               const std::string &method) {
+  assertValidDestination(out, in.shape(), in.dtype(), method);
+  intoOrigin(out, [&in](const Tensor &dst) {
+    // If #in is not contiguous, it is copied into #dst, and the unary
+    // operation is then performed inplace on #dst.
+    const auto src = in.implIsOrigin() ? in : dst.update_(in);
+    typeSwitch<UnaryInto<Op>, void>(in.dtype(), src, dst);
+  });
+}
+
+template <typename From> class CastInto {
+public:
+  template <typename To>
+  static void go(const Tensor &in, const Tensor &out) {
+    castPtr<From, To>(
+        originPtr<From>(in), in.nelms_u64(), originPtr<To>(out));
+  }
+  static std::string str() { return "CastInto"; }
+};
+
+class CastIntoFrom {
+public:
+  template <typename From>
+  static void go(const Tensor &in, const Tensor &out) {
+    typeSwitch<CastInto<From>, void>(out.dtype(), in, out);
+  }
+  static std::string str() { return "CastIntoFrom"; }
+};
+
+// The grouped matrix multiplication of #lhs, of shape (nGroups, M, K), and
+// #rhs, of shape (nGroups, K, N), into #out, with nGroups * M * N elements.
+class MatMulInto {
+public:
+  template <typename T>
+  static void go(const Tensor &lhs,
+                 const Tensor &rhs,
+                 const Tensor &out,
+                 uint64_t nGroups,
+                 uint64_t M,
+                 uint64_t N,
+                 uint64_t K) {
+    const T *l0 = originPtr<T>(lhs);
+    const T *r0 = originPtr<T>(rhs);
+    T *o0       = originPtr<T>(out);
+    for (uint64_t g = 0; g < nGroups; ++g) {
+      OriginData<T>::matmulInto(
+          l0 + g * M * K, r0 + g * K * N, o0 + g * M * N, M, N, K);
+    }
+  }
+  static std::string str() { return "MatMulInto"; }
+};
+
+template <template <typename> class Op> class ReduceInto {
+public:
+  template <typename T> static void go(const Tensor &in, const Tensor &out) {
+    OriginData<T>::template reduceInto<Op<T>>(
+        originPtr<T>(in), in.shape(), out.shape(), originPtr<T>(out));
+  }
+  static std::string str() { return "ReduceInto"; }
+};
+
+} // namespace
+
+void Tensor::addInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<Adder>(*this, rhs, out, dtype(), "addInto");
+}
+
+void Tensor::subtractInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<Subtracter>(*this, rhs, out, dtype(), "subtractInto");
+}
+
+void Tensor::mulInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<Multiplier>(*this, rhs, out, dtype(), "mulInto");
+}
+
+void Tensor::divideInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<Divider>(*this, rhs, out, dtype(), "divideInto");
+}
+
+void Tensor::powInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<Exponentiater>(*this, rhs, out, dtype(), "powInto");
+}
+
+void Tensor::modInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<Modder>(*this, rhs, out, dtype(), "modInto");
+}
+
+void Tensor::minInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<BinaryMinTaker>(*this, rhs, out, dtype(), "minInto");
+}
+
+void Tensor::maxInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<BinaryMaxTaker>(*this, rhs, out, dtype(), "maxInto");
+}
+
+void Tensor::greaterThanInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<GreaterThan>(
+      *this, rhs, out, DType::Boolean, "greaterThanInto");
+}
+
+void Tensor::equalToInto(const Tensor &rhs, const Tensor &out) const {
+  binaryInto<EqualTo>(*this, rhs, out, DType::Boolean, "equalToInto");
+}
+
+void Tensor::absInto(const Tensor &out) const {
+  unaryInto<Abs>(*this, out, "absInto");
+}
+
+void Tensor::expInto(const Tensor &out) const {
+  unaryInto<Exp>(*this, out, "expInto");
+}
+
+void Tensor::logInto(const Tensor &out) const {
+  unaryInto<Log>(*this, out, "logInto");
+}
+
+void Tensor::sqrtInto(const Tensor &out) const {
+  unaryInto<Sqrt>(*this, out, "sqrtInto");
+}
+
+void Tensor::sinInto(const Tensor &out) const {
+  unaryInto<Sin>(*this, out, "sinInto");
+}
+
+void Tensor::cosInto(const Tensor &out) const {
+  unaryInto<Cos>(*this, out, "cosInto");
+}
+
+void Tensor::negInto(const Tensor &out) const {
+  unaryInto<Negater>(*this, out, "negInto");
+}
+
+void Tensor::reciprocalInto(const Tensor &out) const {
+  unaryInto<Reciprocal>(*this, out, "reciprocalInto");
+}
+
+void Tensor::toInto(const Tensor &out) const {
+  assertValidDestination(out, shape(), out.dtype(), "toInto");
+  intoOrigin(out, [this](const Tensor &dst) {
+    const auto src = implIsOrigin() ? *this : copy();
+    typeSwitch<CastIntoFrom, void>(dtype(), src, dst);
+  });
+}
+
+void Tensor::matmulInto(const Tensor &rhs, const Tensor &out) const {
+  verifySameType(*this, rhs);
+  const ndarray::GroupedMatMulPack<MatMulMolder, Tensor> mmp(*this, rhs);
+  assertValidDestination(out, mmp.outShape(), out.dtype(), "matmulInto");
+  if (out.dtype() != dtype()) {
+    matmul(rhs).toInto(out);
+    return;
+  }
+  intoOrigin(out, [this, &mmp](const Tensor &dst) {
+    auto lhs3d = mmp.lhs3d();
+    auto rhs3d = mmp.rhs3d();
+    lhs3d      = lhs3d.implIsOrigin() ? lhs3d : lhs3d.copy();
+    rhs3d      = rhs3d.implIsOrigin() ? rhs3d : rhs3d.copy();
+    typeSwitch<MatMulInto, void>(dtype(),
+                                 lhs3d,
+                                 rhs3d,
+                                 dst,
+                                 mmp.nGroups_u64(),
+                                 mmp.M(),
+                                 mmp.N(),
+                                 mmp.K());
+  });
+}
+
+void Tensor::reduceInto(const Tensor &out, CommutativeOp op) const {
+  shape().assertCanReduceTo(out.shape());
+  assertValidDestination(out, out.shape(), dtype(), "reduceInto");
+  intoOrigin(out, [this, op](const Tensor &dst) {
+    const auto src = implIsOrigin() ? *this : copy();
+    switch (op) {
+    case CommutativeOp::Sum: {
+      return typeSwitch<ReduceInto<Adder>, void>(dtype(), src, dst);
+    }
+    case CommutativeOp::Product: {
+      return typeSwitch<ReduceInto<Multiplier>, void>(dtype(), src, dst);
+    }
+    case CommutativeOp::Min: {
+      return typeSwitch<ReduceInto<MinTaker>, void>(dtype(), src, dst);
+    }
+    case CommutativeOp::Max: {
+      return typeSwitch<ReduceInto<MaxTaker>, void>(dtype(), src, dst);
+    }
+    default: {
+      throw error("unrecognised CommutativeOp");
+    }
+    }
+  });
+}
+
 } // namespace host
 } // namespace compute
 } // namespace poprithms
@@ -14,17 +14,6 @@ template <> DType get<copied_from_poplar::IeeeHalf>() {
 }
 } // namespace ndarray
 } // namespace poprithms
-namespace poprithms {
-namespace compute {
-namespace host {
-template <>
-std::vector<IeeeHalf> castPtrToVector<>(const double *from, uint64_t nElms) {
-  auto a = castPtrToVector<double, float>(from, nElms);
-  return castPtrToVector<float, IeeeHalf>(a.data(), nElms);
-}
-} // namespace host
-} // namespace compute
-} // namespace poprithms
 
 // The standard templates, being instantiated:
 namespace poprithms {
@@ -42,6 +42,43 @@ Tensors Graph::tensors(const TensorIds &tIds) {
 
 Graph::~Graph() = default;
 
+void Graph::resetGraphOfNodes() {
+  for (auto &n : nodes) {
+    n.uptr->setGraph(*this);
+  }
+}
+
+Graph::Graph(const Graph &g)
+    : nodes(g.nodes), allocUsers(g.allocUsers), wspace(g.wspace) {
+  resetGraphOfNodes();
+}
+
+Graph::Graph(Graph &&g)
+    : nodes(std::move(g.nodes)), allocUsers(std::move(g.allocUsers)),
+      wspace(std::move(g.wspace)) {
+  resetGraphOfNodes();
+}
+
+Graph &Graph::operator=(const Graph &g) {
+  if (this != &g) {
+    nodes      = g.nodes;
+    allocUsers = g.allocUsers;
+    wspace     = g.wspace;
+    resetGraphOfNodes();
+  }
+  return *this;
+}
+
+Graph &Graph::operator=(Graph &&g) {
+  if (this != &g) {
+    nodes      = std::move(g.nodes);
+    allocUsers = std::move(g.allocUsers);
+    wspace     = std::move(g.wspace);
+    resetGraphOfNodes();
+  }
+  return *this;
+}
+
 std::ostream &operator<<(std::ostream &ost, BroadcastPadding single) {
   switch (single) {
   case BroadcastPadding::Yes: {
@@ -114,6 +151,9 @@ void Graph::completeInputlessReplacement(TensorId beingTransformed,
   auto toUpdate = depthFirstFwdAliases(beingTransformed);
   std::reverse(toUpdate.begin(), toUpdate.end());
 
+  // The Origins of the Node being replaced are lost when it is replaced, so
+  // they must be removed from the index first.
+  unindexOrigins(beingTransformed);
   nodes[beingTransformed.get()] = UpNode(createNodeWithOutsAndId<T>(
       newIns, n.outs(), n.shape(), n.id(), args...));
 
@@ -448,8 +488,39 @@ public:
 };
 } // namespace
 
+void Graph::indexOrigins(TensorId id) {
+  if (allocUsers.size() < nTensors()) {
+    allocUsers.resize(nTensors());
+  }
+  for (auto allocId : node(id).getAllocIds()) {
+    allocUsers[allocId.get()].insert(id);
+  }
+}
+
+void Graph::unindexOrigins(TensorId id) {
+  for (auto allocId : node(id).getAllocIds()) {
+    allocUsers[allocId.get()].erase(id);
+  }
+}
+
+TensorIds Graph::sharedAllocationTensors(TensorId id) const {
+  const auto allocIds = node(id).getAllocIds();
+  if (allocIds.size() == 1) {
+    const auto &users = allocUsers[allocIds[0].get()];
+    return TensorIds(users.cbegin(), users.cend());
+  }
+  std::set<TensorId> users;
+  for (auto allocId : allocIds) {
+    const auto &x = allocUsers[allocId.get()];
+    users.insert(x.cbegin(), x.cend());
+  }
+  return TensorIds(users.cbegin(), users.cend());
+}
+
 void Graph::setOrigins(TensorId id) {
 
+  unindexOrigins(id);
+
   auto &nd = node(id);
   nd.clearOrigins();
 
@@ -502,6 +573,8 @@ void Graph::setOrigins(TensorId id) {
       nd.insertOriginsFrom(node(inId));
     }
   }
+
+  indexOrigins(id);
 }
 
 bool Graph::areAliased(TensorId tenId0, TensorId tenId1) const {
@@ -547,35 +620,38 @@ bool Graph::containsColor(TensorId id, Color c) const {
 // edge case: what about the empty Tensor, does it alias itself? No, by
 // definition of set intersection. A aliases B iff there exists at least 1
 // element in both.
+//
+// Only Tensors which share an allocation with id can be aliased to it, so
+// only they are tested.
 TensorIds Graph::allAliases(TensorId id) const {
   TensorIds allAliased;
-
-  TensorIds toProcess{id};
-  auto seen = toProcess;
-
-  // perform breadth first search in both DAG directions.
-  while (!toProcess.empty()) {
-    const auto nxt = toProcess.back();
-    toProcess.pop_back();
-    if (areAliased(nxt, id)) {
-      allAliased.push_back(nxt);
-      for (auto o : node(nxt).insAndOuts()) {
-        if (std::find(seen.cbegin(), seen.cend(), o) == seen.cend()) {
-          toProcess.push_back(o);
-          seen.push_back(o);
-        }
-      }
+  for (auto candidate : sharedAllocationTensors(id)) {
+    if (areAliased(candidate, id)) {
+      allAliased.push_back(candidate);
     }
   }
-
-  std::sort(allAliased.begin(), allAliased.end());
   return allAliased;
 }
 
+// A single pass over all pairs of Tensors which share an allocation. As
+// aliasing is symmetric, each such pair (i, j) with i < j is tested once.
+// Tensors are processed in ascending order, so each vector of aliases is
+// constructed in ascending order.
 std::vector<TensorIds> Graph::allAliases() const {
   std::vector<TensorIds> x(nTensors());
   for (uint64_t i = 0; i < nTensors(); ++i) {
-    x[i] = allAliases(i);
+    const TensorId id(i);
+    const auto candidates = sharedAllocationTensors(id);
+    if (areAliased(id, id)) {
+      x[i].push_back(id);
+    }
+    auto iter = std::upper_bound(candidates.cbegin(), candidates.cend(), id);
+    for (; iter != candidates.cend(); ++iter) {
+      if (areAliased(id, *iter)) {
+        x[i].push_back(*iter);
+        x[iter->get()].push_back(id);
+      }
+    }
   }
   return x;
 }
@@ -781,13 +857,14 @@ TensorId Graph::clone(TensorId toCloneId, CloneColorMethod cloneColorMethod) {
       node(inId).insertOut(newId);
     }
     nodes.push_back(std::move(newNode));
+    indexOrigins(newId);
   }
 
   wspace.clear(oldsToClone);
   return nTensors() - 1;
 }
 
-const std::vector<DisjointRegions> &
+std::vector<DisjointRegions>
 Graph::allocRegions(TensorId query, TensorId allocation) const {
   if (!allocates(allocation)) {
     error("Not an allocation");
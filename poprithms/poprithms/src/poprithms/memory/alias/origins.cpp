@@ -3,6 +3,7 @@
 #include <memory>
 #include <numeric>
 #include <ostream>
+#include <sstream>
 #include <vector>
 
 #include <memory/alias/error.hpp>
@@ -18,24 +19,27 @@ static_assert(std::is_nothrow_move_constructible<Origins>::value,
 
 bool Origins::isAliasedTo(const Origins &rhs) const {
 
-  std::vector<AllocId> commonAllocIds;
-  const auto v1 = getAllocIds();
-  const auto v2 = rhs.getAllocIds();
-  std::set_intersection(v1.cbegin(),
-                        v1.cend(),
-                        v2.cbegin(),
-                        v2.cend(),
-                        std::back_inserter(commonAllocIds));
-
-  for (auto ai : commonAllocIds) {
-    const auto &regs0 = at(ai);
-    const auto &regs1 = rhs.at(ai);
-    for (const auto &dj0 : regs0) {
-      for (const auto &dj1 : regs1) {
-        if (!dj0.disjoint(dj1)) {
-          return true;
+  // Both Origins are sorted by AllocId, so the common allocations are found
+  // by iterating through them together.
+  uint64_t i0 = 0;
+  uint64_t i1 = 0;
+  while (i0 < nEntries() && i1 < rhs.nEntries()) {
+    const auto &e0 = entry(i0);
+    const auto &e1 = rhs.entry(i1);
+    if (e0.id < e1.id) {
+      ++i0;
+    } else if (e1.id < e0.id) {
+      ++i1;
+    } else {
+      for (const auto &dj0 : e0) {
+        for (const auto &dj1 : e1) {
+          if (!dj0.disjoint(dj1)) {
+            return true;
+          }
         }
       }
+      ++i0;
+      ++i1;
     }
   }
   return false;
@@ -50,13 +54,13 @@ bool Origins::contains(const Origins &subOrigins) const {
   // 2) contained in a corresponding region in this object, the proposed
   //    super-origins.
   //
-  for (const auto &[allocId, regsSub] : subOrigins.oMap) {
-    DisjointRegions regsSubUnion = DisjointRegions::createUnion(regsSub);
+  for (uint64_t i = 0; i < subOrigins.nEntries(); ++i) {
+    const auto &sub              = subOrigins.entry(i);
+    const auto regsSubUnion = sub.createUnion();
     if (!regsSubUnion.empty()) {
-      auto foundSuper = oMap.find(allocId);
-      if (foundSuper != oMap.cend()) {
-        const auto &regsSuper = foundSuper->second;
-        auto regsSuperUnion   = DisjointRegions::createUnion(regsSuper);
+      const auto foundSuper = find(sub.id);
+      if (foundSuper) {
+        const auto regsSuperUnion = foundSuper->createUnion();
         if (!regsSuperUnion.contains(regsSubUnion)) {
           return false;
         }
@@ -73,9 +77,10 @@ std::unique_ptr<Origins> Origins::clone() const {
 }
 
 void Origins::append(std::ostream &os) const {
-  for (auto &[k, v] : oMap) {
-    os << "[" << k << "]:(";
-    for (const auto &regs : v) {
+  for (uint64_t i = 0; i < nEntries(); ++i) {
+    const auto &e = entry(i);
+    os << "[" << e.id << "]:(";
+    for (const auto &regs : e) {
       os << regs;
     }
     os << ")\n";
@@ -87,20 +92,89 @@ std::ostream &operator<<(std::ostream &os, const Origins &o) {
   return os;
 }
 
+const Origins::Entry *Origins::find(AllocId id) const {
+  if (nEntries() == 0) {
+    return nullptr;
+  }
+  if (first.id == id) {
+    return &first;
+  }
+  const auto found = std::lower_bound(
+      rest.cbegin(), rest.cend(), id, [](const Entry &e, AllocId x) {
+        return e.id < x;
+      });
+  if (found != rest.cend() && found->id == id) {
+    return &*found;
+  }
+  return nullptr;
+}
+
+DisjointRegions Origins::Entry::createUnion() const {
+  if (tail.empty()) {
+    return head;
+  }
+  return DisjointRegions::createUnion(toVector());
+}
+
+std::vector<DisjointRegions> Origins::Entry::toVector() const {
+  std::vector<DisjointRegions> regs;
+  regs.reserve(size());
+  regs.push_back(head);
+  regs.insert(regs.end(), tail.cbegin(), tail.cend());
+  return regs;
+}
+
+std::vector<DisjointRegions> Origins::at(AllocId id) const {
+  const auto found = find(id);
+  if (!found) {
+    std::ostringstream oss;
+    oss << "No allocation " << id << " in Origins::at. Origins are:\n";
+    append(oss);
+    throw error(oss.str());
+  }
+  return found->toVector();
+}
+
 void Origins::insert(AllocId id, const DisjointRegions &regs) {
-  const auto found = oMap.find(id);
-  if (found == oMap.cend()) {
-    oMap.emplace(id, std::vector<DisjointRegions>{regs});
+  incrementSumTotalRegionSizes(regs.totalElms());
+
+  if (nEntries() == 0) {
+    first    = Entry(id, regs);
+    hasFirst = true;
+    return;
+  }
+
+  if (first.id == id) {
+    first.push_back(regs);
+    ++nRepeatedAllocs;
+    return;
+  }
+
+  // The new allocation has the smallest AllocId, so it replaces the inline
+  // allocation, which moves to the front of the sorted vector.
+  if (id < first.id) {
+    rest.insert(rest.begin(), std::move(first));
+    first = Entry(id, regs);
+    return;
+  }
+
+  const auto found = std::lower_bound(
+      rest.begin(), rest.end(), id, [](const Entry &e, AllocId x) {
+        return e.id < x;
+      });
+  if (found != rest.end() && found->id == id) {
+    found->push_back(regs);
+    ++nRepeatedAllocs;
   } else {
-    found->second.push_back(regs);
+    rest.insert(found, Entry(id, regs));
   }
-  incrementSumTotalRegionSizes(regs.totalElms());
 }
 
 void Origins::insert(const Origins &oris) {
-  for (const auto &[k, v] : oris.oMap) {
-    for (const auto &v2 : v) {
-      insert(k, v2);
+  for (uint64_t i = 0; i < oris.nEntries(); ++i) {
+    const auto &e = oris.entry(i);
+    for (const auto &regs : e) {
+      insert(e.id, regs);
     }
   }
 }
@@ -121,9 +195,9 @@ void Origins::incrementSumTotalRegionSizes(uint64_t n) {
 
 std::vector<AllocId> Origins::getAllocIds() const {
   std::vector<AllocId> ids;
-  ids.reserve(oMap.size());
-  for (const auto &kv : oMap) {
-    ids.push_back(kv.first);
+  ids.reserve(nEntries());
+  for (uint64_t i = 0; i < nEntries(); ++i) {
+    ids.push_back(entry(i).id);
   }
   return ids;
 }
@@ -138,14 +212,18 @@ bool Origins::containsAliases() const {
     return true;
   }
 
-  // Total registered allocations is shape.nelms_u64(). Are they all actually
-  // distinct?
-  for (const auto &[id, allRegs] : oMap) {
-    (void)id;
-    for (auto iter0 = allRegs.cbegin(); iter0 != allRegs.cend(); ++iter0) {
-      for (auto iter1 = std::next(iter0, 1); iter1 != allRegs.cend();
-           ++iter1) {
-        if (!iter0->disjoint(*iter1)) {
+  // Total registered allocations is shape.nelms_u64(). If no allocation
+  // has more than 1 DisjointRegions, they are all distinct.
+  if (nRepeatedAllocs == 0) {
+    return false;
+  }
+
+  // Are they all actually distinct?
+  for (uint64_t i = 0; i < nEntries(); ++i) {
+    const auto &allRegs = entry(i);
+    for (uint64_t i0 = 0; i0 < allRegs.size(); ++i0) {
+      for (uint64_t i1 = i0 + 1; i1 < allRegs.size(); ++i1) {
+        if (!allRegs[i0].disjoint(allRegs[i1])) {
           return true;
         }
       }
@@ -156,10 +234,18 @@ bool Origins::containsAliases() const {
 
 bool Origins::isRowMajorSetContiguous() const {
 
-  const std::vector<DisjointRegions> *drp{nullptr};
-  for (const auto &[id, regions] : oMap) {
-    (void)id;
-    if (std::any_of(regions.cbegin(), regions.cend(), [](const auto &r) {
+  // Fast path for the most common case, where the Tensor is composed of all
+  // of the elements of a single allocation, each exactly once.
+  if (nEntries() == 1 && nRepeatedAllocs == 0 &&
+      sumTotalRegionSizes == shape.nelms_u64() &&
+      first[0].shape().nelms_u64() == sumTotalRegionSizes) {
+    return true;
+  }
+
+  const Entry *drp{nullptr};
+  for (uint64_t i = 0; i < nEntries(); ++i) {
+    const auto &regions = entry(i);
+    if (std::any_of(regions.begin(), regions.end(), [](const auto &r) {
           return !r.empty();
         })) {
 
@@ -175,7 +261,7 @@ bool Origins::isRowMajorSetContiguous() const {
     return true;
   }
 
-  int64_t globalLow = drp->front().shape().nelms();
+  int64_t globalLow = (*drp)[0].shape().nelms();
   int64_t globalUpp = 0;
 
   for (const auto &regs : *drp) {
@@ -214,14 +300,14 @@ bool Origins::isRowMajorSetContiguous() const {
 }
 
 Origins Origins::remap(const std::vector<uint64_t> &toNew) const {
-  std::map<AllocId, std::vector<DisjointRegions>> newMap;
-
-  for (const auto &[k, v] : oMap) {
-    const auto n       = toNew.at(k.get());
-    newMap[AllocId(n)] = v;
+  Origins remapped(shape);
+  for (uint64_t i = 0; i < nEntries(); ++i) {
+    const auto &e = entry(i);
+    const AllocId n(toNew.at(e.id.get()));
+    for (const auto &regs : e) {
+      remapped.insert(n, regs);
+    }
   }
-  auto remapped = *this;
-  remapped.oMap = newMap;
   return remapped;
 }
 
@@ -1,9 +1,11 @@
 // Copyright (c) 2021 Graphcore Ltd. All rights reserved.
 
 #include <numeric>
+#include <random>
 #include <sstream>
 #include <unordered_set>
 #include <variant>
+#include <vector>
 
 #include <memory/chain/disjointregionsmapper.hpp>
 #include <memory/chain/error.hpp>
@@ -410,10 +412,6 @@ bool Chain::isIdentity(uint64_t opIndex) const {
   throw error("Exited switch in Chain::isIdentity without returning");
 }
 
-// TODO(T32931) check for "high probability" of equivalence.
-//   bool Chain::randomRegionMappingEquivalent(const Chain &rhs,
-//                                      uint64_t nRandomRegions) const;
-
 void Chain::canonicalize(const Types &targetOrder) {
 
   // assert that #targetOrder has no duplicates and is not missing any Types
@@ -681,6 +679,56 @@ bool Chain::operator==(const Chain &rhs) const {
   return ops_ == rhs.ops_;
 }
 
+bool Chain::randomlyEquivalent(const Chain &rhs,
+                               uint64_t nTrials,
+                               uint32_t seed) const {
+  if (inShape() != rhs.inShape() || outShape() != rhs.outShape()) {
+    return false;
+  }
+
+  std::mt19937 gen(seed);
+  const int64_t bound = 1 << 20;
+  std::uniform_int_distribution<int64_t> dis(-bound, bound);
+  std::vector<int64_t> vs(inShape().nelms_u64());
+  for (uint64_t trial = 0; trial < nTrials; ++trial) {
+    for (auto &v : vs) {
+      v = dis(gen);
+    }
+    const auto t = compute::host::Tensor::int64(inShape(), vs);
+    if (!apply(t).allEquivalent(rhs.apply(t))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Chain::equivalent(const Chain &rhs) const {
+
+  if (*this == rhs) {
+    return true;
+  }
+
+  // The early-out for most Chains which are not equivalent.
+  if (!randomlyEquivalent(rhs, 1)) {
+    return false;
+  }
+
+  if (canonicalized() == rhs.canonicalized()) {
+    return true;
+  }
+
+  const auto n = inShape().nelms();
+  for (int64_t i = 0; i < n; ++i) {
+    const auto element =
+        DisjointRegions(Region::fromBounds({n}, {i}, {i + 1}))
+            .reshape(inShape());
+    if (!Region::equivalent(apply(element), rhs.apply(element))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void Chain::confirmNotEqual(const Chain &rhs) const {
   if (*this == rhs) {
     std::ostringstream oss;
@@ -2,6 +2,7 @@
 #include "ops.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -20,6 +21,7 @@
 #include <poprithms/schedule/transitiveclosure/partitionedtransitiveclosure.hpp>
 #include <poprithms/schedule/vanilla/vanilla.hpp>
 #include <poprithms/util/copybyclone_impl.hpp>
+#include <poprithms/util/parallelfor.hpp>
 #include <poprithms/util/printiter.hpp>
 #include <poprithms/util/stringutil.hpp>
 
@@ -117,6 +119,73 @@ TensorId Graph::pad(const TensorId &id,
   return current;
 }
 
+std::ostream &operator<<(std::ostream &ost, ScheduleUpdate u) {
+  switch (u) {
+  case ScheduleUpdate::Full: {
+    ost << "ScheduleUpdate::Full";
+    break;
+  }
+
+  case ScheduleUpdate::Incremental: {
+    ost << "ScheduleUpdate::Incremental";
+    break;
+  }
+
+  case ScheduleUpdate::IncrementalDebug: {
+    ost << "ScheduleUpdate::IncrementalDebug";
+    break;
+  }
+  }
+  return ost;
+}
+
+std::ostream &operator<<(std::ostream &ost, AliasCacheDebug d) {
+  switch (d) {
+  case AliasCacheDebug::On: {
+    ost << "AliasCacheDebug::On";
+    break;
+  }
+
+  case AliasCacheDebug::Off: {
+    ost << "AliasCacheDebug::Off";
+    break;
+  }
+  }
+  return ost;
+}
+
+double ScheduleUpdateStats::fastPathRate() const {
+  const auto nUpdates = nFull + nUnchanged + nIncremental;
+  if (nUpdates == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(nUnchanged + nIncremental) /
+         static_cast<double>(nUpdates);
+}
+
+void ScheduleUpdateStats::append(std::ostream &ost) const {
+  ost << "nFull=" << nFull << ",nUnchanged=" << nUnchanged
+      << ",nIncremental=" << nIncremental << ",nCycles=" << nCycles
+      << ",nOpsVisited=" << nOpsVisited << ",nOpsMoved=" << nOpsMoved
+      << ",fastPathRate=" << fastPathRate();
+}
+
+ScheduleUpdateStats &
+ScheduleUpdateStats::operator+=(const ScheduleUpdateStats &rhs) {
+  nFull += rhs.nFull;
+  nUnchanged += rhs.nUnchanged;
+  nIncremental += rhs.nIncremental;
+  nCycles += rhs.nCycles;
+  nOpsVisited += rhs.nOpsVisited;
+  nOpsMoved += rhs.nOpsMoved;
+  return *this;
+}
+
+std::ostream &operator<<(std::ostream &ost, const ScheduleUpdateStats &s) {
+  s.append(ost);
+  return ost;
+}
+
 std::ostream &operator<<(std::ostream &ost, CheckParallelWriteable check) {
   switch (check) {
   case CheckParallelWriteable::Yes: {
@@ -185,7 +254,12 @@ OpId Graph::createOp(const TensorIds &inIds,
 }
 
 OpId Graph::insertOp(std::unique_ptr<Op> createdOp) {
-  scheduleIsValid  = false;
+  scheduleIsValid = false;
+  ++nMutations_;
+
+  // The output of the new Op might be aliased to existing Tensors.
+  aliasCache_.clear();
+
   const auto inIds = createdOp->inTensorIds();
   const auto newId = insertMultioutOp(std::move(createdOp));
   for (const auto &inId : inIds) {
@@ -235,6 +309,7 @@ TensorId Graph::concat(const TensorIds &ids, uint64_t axis) {
 }
 
 void Graph::constraint(const OpId before, const OpId after) {
+  ++nMutations_;
   op(before).insertOut(after);
   op(after).insertIn(before);
   // If 'after' appears before 'before' in current schedule, label invalid.
@@ -269,6 +344,164 @@ OpeningStatuses Graph::tryOpenings(const Proposals &proposals,
   return statuses;
 }
 
+OpeningStatuses Graph::tryOpeningsBatched(const Proposals &proposals,
+                                          CheckParallelWriteable check,
+                                          AllowMultiGateAlias allow,
+                                          uint64_t nThreads) {
+
+  // The weakly connected component of each Op, and the Ops in each
+  // component. The ins and outs of an Op include its Constraints.
+  const auto unset = nOps();
+  std::vector<uint64_t> component(nOps(), unset);
+  std::vector<OpIds> componentOps;
+  for (uint64_t start = 0; start < nOps(); ++start) {
+    if (component[start] != unset) {
+      continue;
+    }
+    const auto c = componentOps.size();
+    componentOps.push_back({});
+    auto &ops = componentOps.back();
+    component[start] = c;
+    OpIds toProcess{OpId(start)};
+    auto visit = [&component, &toProcess, c, unset](const OpIds &nbrs) {
+      for (auto n : nbrs) {
+        if (component[n.get()] == unset) {
+          component[n.get()] = c;
+          toProcess.push_back(n);
+        }
+      }
+    };
+    while (!toProcess.empty()) {
+      const auto nxt = toProcess.back();
+      toProcess.pop_back();
+      ops.push_back(nxt);
+      visit(op(nxt).ins());
+      visit(op(nxt).outs());
+    }
+  }
+
+  // The indices of the Proposals of each component, in order.
+  std::vector<std::vector<uint64_t>> groups;
+  std::vector<uint64_t> groupComponent;
+  std::unordered_map<uint64_t, uint64_t> componentToGroup;
+  bool allOpen{true};
+  for (uint64_t i = 0; i < proposals.size(); ++i) {
+    const auto &gate = asAliasGate(proposals[i].aliasGateId());
+    allOpen          = allOpen && gate.open();
+    const auto c     = component[gate.id().get()];
+    const auto found = componentToGroup.emplace(c, groups.size());
+    if (found.second) {
+      groups.push_back({});
+      groupComponent.push_back(c);
+    }
+    groups[found.first->second].push_back(i);
+  }
+
+  nThreads = std::min<uint64_t>(nThreads, groups.size());
+  if (nThreads <= 1 || scheduleUpdate_ == ScheduleUpdate::Full) {
+    return tryOpenings(proposals, check, allow);
+  }
+
+  // The schedule is computed once here, rather than once on each copy.
+  if (!allOpen && !scheduleIsValid) {
+    computeSchedule("tryOpeningsBatched");
+  }
+
+  OpeningStatuses statuses(proposals.size(), OpeningStatus::AlreadyOpen);
+  std::vector<Constraints> newConstraints(proposals.size());
+  std::vector<std::vector<uint64_t>> groupsOfThread(nThreads);
+  std::atomic<uint64_t> nextGroup{0};
+
+  // The copies of this Graph from the previous batch are reused if this
+  // Graph has not changed since.
+  auto &copies = workers_.graphs;
+  if (workers_.syncedAt != nMutations_) {
+    copies.clear();
+  }
+  // The copies are made on this thread, and do not share Ops with this
+  // Graph or with each other, so that they can be modified concurrently
+  // (see multiout::Graph::bindOps).
+  while (copies.size() < nThreads) {
+    copies.push_back(std::make_unique<Graph>(*this));
+    copies.back()->bindOps();
+  }
+
+  poprithms::util::forEachThread(nThreads, [&](uint64_t t) {
+    auto &g            = *copies[t];
+    g.scheduleUpdate_  = scheduleUpdate_;
+    g.aliasCacheDebug_ = aliasCacheDebug_;
+    g.resetScheduleUpdateStats();
+    for (auto gi = nextGroup++; gi < groups.size(); gi = nextGroup++) {
+      groupsOfThread[t].push_back(gi);
+      for (auto i : groups[gi]) {
+        const auto r = g.tryOpeningPartial(proposals[i], check, allow);
+        if (r.isValid()) {
+          g.completeOpening(r);
+          newConstraints[i] = r.constraints();
+        }
+        statuses[i] = r.status();
+      }
+    }
+  });
+
+  // The Ops of a component occupy the same schedule indices in this Graph
+  // and in all of the copies, so the schedule of each component can be
+  // copied from the copy which processed it.
+  if (scheduleIsValid) {
+    for (uint64_t t = 0; t < nThreads; ++t) {
+      const auto &g = *copies[t];
+      for (auto gi : groupsOfThread[t]) {
+        for (auto opId : componentOps[groupComponent[gi]]) {
+          const auto index = g.invSched[opId.get()];
+          sched[index]     = opId;
+          invSched[opId.get()] = index;
+        }
+      }
+    }
+  }
+
+  // The copies never compute the schedule from scratch.
+  for (uint64_t t = 0; t < nThreads; ++t) {
+    scheduleUpdateStats_ += copies[t]->scheduleUpdateStats();
+  }
+
+  for (uint64_t i = 0; i < proposals.size(); ++i) {
+    if (statuses[i] == OpeningStatus::Valid) {
+      const auto &p = proposals[i];
+      openAliasGate(asAliasGate(p.aliasGateId()), p.inIndex());
+      constraints(newConstraints[i]);
+    }
+  }
+
+  // Bring all of the copies up to date with this Graph, by applying the
+  // openings which were made on the other copies, and the final schedule.
+  std::vector<uint64_t> threadOfProposal(proposals.size(), nThreads);
+  for (uint64_t t = 0; t < nThreads; ++t) {
+    for (auto gi : groupsOfThread[t]) {
+      for (auto i : groups[gi]) {
+        threadOfProposal[i] = t;
+      }
+    }
+  }
+  poprithms::util::forEachThread(copies.size(), [&](uint64_t t) {
+    auto &g = *copies[t];
+    for (uint64_t i = 0; i < proposals.size(); ++i) {
+      if (statuses[i] == OpeningStatus::Valid && threadOfProposal[i] != t) {
+        const auto &p = proposals[i];
+        g.openAliasGate(g.asAliasGate(p.aliasGateId()), p.inIndex());
+        g.constraints(newConstraints[i]);
+      }
+    }
+    g.sched           = sched;
+    g.invSched        = invSched;
+    g.scheduleIsValid = scheduleIsValid;
+    g.pendingScheduleChanges.clear();
+  });
+  workers_.syncedAt = nMutations_;
+
+  return statuses;
+}
+
 OpeningStatuses Graph::tryOpenings0(const TensorIds &ids,
                                     CheckParallelWriteable xp,
                                     AllowMultiGateAlias allow) {
@@ -329,11 +562,55 @@ uint64_t Graph::scheduleIndex(OpId id) const {
 
 // Possible optimizations for the inplacing algorithm:
 //
-// 1) Cache aliases between calls to tryOpening (T29079)
-//
-// 2) use the DAG structure to reduce alias computation, and sparsify
+// 1) use the DAG structure to reduce alias computation, and sparsify
 //    constraint calculation and insertion (T29080)
 
+TensorIds Graph::cachedAliases(const TensorId &id) {
+  auto found = aliasCache_.find(id);
+  if (found == aliasCache_.cend()) {
+    return aliasCache_.insert({id, allAliases(id)}).first->second;
+  }
+
+  if (aliasCacheDebug_ == AliasCacheDebug::On) {
+    auto cached   = found->second;
+    auto uncached = allAliases(id);
+    std::sort(cached.begin(), cached.end());
+    std::sort(uncached.begin(), uncached.end());
+    if (cached != uncached) {
+      std::ostringstream oss;
+      oss << "Error in Graph::cachedAliases(" << id
+          << "). The cached aliases are " << cached
+          << ", but the aliases computed without the cache are " << uncached
+          << ". The cache was not correctly invalidated.";
+      throw error(oss.str());
+    }
+  }
+  return found->second;
+}
+
+// When an AliasGate is opened or closed, the Tensors whose aliases might
+// change are those whose memory overlaps the memory of the AliasGate's
+// output while it is open (when the output's memory is the input's memory).
+// These are exactly the aliases of the AliasGate's output, while it is open.
+void Graph::eraseCachedAliases(const TensorId &aliasGateOut) {
+  aliasCache_.erase(aliasGateOut);
+  for (const auto &id : allAliases(aliasGateOut)) {
+    aliasCache_.erase(id);
+  }
+}
+
+void Graph::openAliasGate(AliasGate &aliasGate_, InIndex i) {
+  ++nMutations_;
+  aliasGate_.openAt(aGraph(), tensorMap, i);
+  eraseCachedAliases(aliasGate_.outTensorId(0));
+}
+
+void Graph::closeAliasGate(AliasGate &aliasGate_) {
+  ++nMutations_;
+  eraseCachedAliases(aliasGate_.outTensorId(0));
+  aliasGate_.close(aGraph(), tensorMap);
+}
+
 const AliasGate &Graph::asAliasGate(OpId mid) const {
   auto proposedBaseOp = &op(mid);
   auto proposedAliasGateOpPtr =
@@ -357,16 +634,46 @@ bool Graph::aliasGateIsClosed(OpId mid) const {
   return asAliasGate(mid).closed();
 }
 
-// See Scott Meyers' "Effective C++"
+// See Scott Meyers' "Effective C++". The call to the non-const Graph::op
+// ensures that the op is not shared with another graph.
 AliasGate &Graph::asAliasGate(OpId mid) {
+  op(mid);
   return const_cast<AliasGate &>(
       static_cast<const Graph &>(*this).asAliasGate(mid));
 }
 
+void Graph::computeSchedule(const std::string &ctxt) {
+  const auto fwdEdges = getFwdEdges<int64_t>({});
+
+  setSchedule(toOpIds(poprithms::schedule::vanilla::getSchedule_i64(
+      fwdEdges,
+      schedule::vanilla::ErrorIfCycle::No,
+      schedule::vanilla::VerifyEdges::Yes)));
+
+  if (sched.size() != nOps()) {
+    std::ostringstream oss;
+    oss << "A cycle detected in Graph::" << ctxt << ". "
+        << "Only " << sched.size() << " of " << nOps()
+        << " were scheduled. This suggests a cycle was present "
+        << "in the constructed Graph. Summary from "
+           "poprithms::schedule::scc:\n";
+    poprithms::schedule::scc::getSummary_i64(
+        fwdEdges,
+        getOpNames(),
+        poprithms::schedule::scc::IncludeCyclelessComponents::No);
+    throw error(oss.str());
+  }
+  scheduleIsValid = true;
+  ++scheduleUpdateStats_.nFull;
+}
+
 OpeningResult Graph::tryOpeningPartial(const Proposal &p,
                                        CheckParallelWriteable check,
                                        AllowMultiGateAlias allow) {
 
+  // Only the schedule changes of the most recent Proposal can be reverted.
+  pendingScheduleChanges.clear();
+
   auto &aliasGate_ = asAliasGate(p.aliasGateId());
 
   if (aliasGate_.nInTensors() <= p.inIndex().get()) {
@@ -387,28 +694,10 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
   // The schedule is not kept up-to-date while the Graph is being constructed,
   // so we update it here, if necessary.
   if (!scheduleIsValid) {
-    const auto fwdEdges = getFwdEdges<int64_t>({});
-
-    setSchedule(toOpIds(poprithms::schedule::vanilla::getSchedule_i64(
-        fwdEdges,
-        schedule::vanilla::ErrorIfCycle::No,
-        schedule::vanilla::VerifyEdges::Yes)));
-
-    if (sched.size() != nOps()) {
-      std::ostringstream oss;
-      oss << "A cycle detected in Graph::tryOpeningPartial, "
-          << "before the proposal " << p << " was processed. "
-          << "Only " << sched.size() << " of " << nOps()
-          << " were scheduled. This suggests a cycle was present "
-          << "in the constructed Graph. Summary from "
-             "poprithms::schedule::scc:\n";
-      poprithms::schedule::scc::getSummary_i64(
-          fwdEdges,
-          getOpNames(),
-          poprithms::schedule::scc::IncludeCyclelessComponents::No);
-      throw error(oss.str());
-    }
-    scheduleIsValid = true;
+    std::ostringstream ctxt;
+    ctxt << "tryOpeningPartial, before the proposal " << p
+         << " was processed";
+    computeSchedule(ctxt.str());
   }
 
   struct AliInfo {
@@ -433,11 +722,11 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
   //       aliasGate (proposal to make reshape_)
   //
   std::vector<AliInfo> inAliasModified;
-  const auto aliasesOfInTensorToAlias = allAliases(inTensorToAlias);
+  const auto aliasesOfInTensorToAlias = cachedAliases(inTensorToAlias);
   for (auto ali : aliasesOfInTensorToAlias) {
     const auto m = modifiers(ali);
     if (!m.empty()) {
-      inAliasModified.push_back({ali, m, allAliases(ali)});
+      inAliasModified.push_back({ali, m, cachedAliases(ali)});
     }
   }
 
@@ -461,16 +750,16 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
   //   unary
   //
   std::vector<AliInfo> outAliasModified;
-  const auto aliasesOfOutTensorToAlias = allAliases(outTensorToAlias);
+  const auto aliasesOfOutTensorToAlias = cachedAliases(outTensorToAlias);
   for (auto ali : aliasesOfOutTensorToAlias) {
     const auto m = modifiers(ali);
     if (!m.empty()) {
-      outAliasModified.push_back({ali, m, allAliases(ali)});
+      outAliasModified.push_back({ali, m, cachedAliases(ali)});
     }
   }
 
   // Open the AliasGate, let the aliases "flow"
-  aliasGate_.openAt(aGraph(), tensorMap, p.inIndex());
+  openAliasGate(aliasGate_, p.inIndex());
 
   if (check == CheckParallelWriteable::Yes) {
 
@@ -492,7 +781,7 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
       const auto tId  = tensorMap.toAliasGraphId(op_.inTensorId(m.inIndex()));
       if (aGraph().containsColor(tId, ConstantColor) ||
           aGraph().containsAliases(tId)) {
-        aliasGate_.close(aGraph(), tensorMap);
+        closeAliasGate(aliasGate_);
         return OpeningResult::notParallelWriteable();
       }
     }
@@ -530,7 +819,7 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
       const auto openIndex = aliGate->inIndex().get();
       for (uint64_t i = 0; i < aliGate->nInTensors(); ++i) {
         if (i != openIndex && areAliased(inIds[i], inIds[openIndex])) {
-          aliasGate_.close(aGraph(), tensorMap);
+          closeAliasGate(aliasGate_);
           return OpeningResult::gateMultiInAlias();
         }
       }
@@ -543,7 +832,7 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
   // aliased to the inputs of aliasGate. ConsumptionIds of these new aliases
   // must execute before the modifier, so that behaviour is unchanged.
   for (const auto &x : outAliasModified) {
-    for (auto newAlias : setDifference(allAliases(x.id), x.aliases)) {
+    for (auto newAlias : setDifference(cachedAliases(x.id), x.aliases)) {
       for (auto c : consumptionIds(newAlias)) {
         for (auto m : x.modifiers) {
           newConstraints.push_back({c.opId(), m.opId()});
@@ -561,7 +850,7 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
   // through all in modifiers, only the ones which might be scheduled first
   // (T29080)
   for (const auto &x : inAliasModified) {
-    auto diff = setDifference(allAliases(x.id), x.aliases);
+    auto diff = setDifference(cachedAliases(x.id), x.aliases);
     for (auto m : x.modifiers) {
       if (scheduleIndex(m.opId()) > scheduleIndex(aliasGate_.id())) {
 
@@ -584,10 +873,30 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
   newConstraints.erase(E, newConstraints.cend());
 
   if (satisifedWithoutAnyChange(newConstraints)) {
+    ++scheduleUpdateStats_.nUnchanged;
     return OpeningResult::validWithUnchangedSchedule(
         std::move(newConstraints));
   }
 
+  if (scheduleUpdate_ != ScheduleUpdate::Full) {
+
+    // Update the current schedule in place, moving only the Ops which must
+    // move to satisfy the new constraints.
+    const auto isAcyclic = reorder(newConstraints);
+    if (scheduleUpdate_ == ScheduleUpdate::IncrementalDebug) {
+      verifyReorder(newConstraints, isAcyclic);
+    }
+    if (!isAcyclic) {
+      revertPendingScheduleChanges();
+      ++scheduleUpdateStats_.nCycles;
+      closeAliasGate(aliasGate_);
+      return OpeningResult::cycle();
+    }
+    ++scheduleUpdateStats_.nIncremental;
+    return OpeningResult::validWithScheduleChangedInGraph(
+        std::move(newConstraints));
+  }
+
   auto proposedSchedule =
       toOpIds(poprithms::schedule::vanilla::getSchedule_i64(
           getFwdEdges<int64_t>(newConstraints),
@@ -595,9 +904,11 @@ OpeningResult Graph::tryOpeningPartial(const Proposal &p,
           schedule::vanilla::VerifyEdges::No));
 
   if (proposedSchedule.size() != nOps()) {
-    aliasGate_.close(aGraph(), tensorMap);
+    ++scheduleUpdateStats_.nCycles;
+    closeAliasGate(aliasGate_);
     return OpeningResult::cycle();
   }
+  ++scheduleUpdateStats_.nFull;
 
   return OpeningResult::validWithChangedSchedule(std::move(newConstraints),
                                                  std::move(proposedSchedule));
@@ -621,19 +932,190 @@ void Graph::completeOpening(const OpeningResult &r) {
         << ". Status must be Valid.";
     throw error(oss.str());
   }
-  if (r.scheduleChange()) {
+  if (r.scheduleStored()) {
     auto sch = r.schedule();
     setSchedule(std::move(sch));
   }
+  pendingScheduleChanges.clear();
   constraints(r.constraints());
   scheduleIsValid = true;
 }
 
 void Graph::backoutOpening(const Proposal &proposal) {
-  asAliasGate(proposal.aliasGateId()).close(aGraph(), tensorMap);
+  revertPendingScheduleChanges();
+  closeAliasGate(asAliasGate(proposal.aliasGateId()));
+}
+
+void Graph::revertPendingScheduleChanges() {
+  ++nMutations_;
+  const auto &changes = pendingScheduleChanges;
+  for (auto iter = changes.crbegin(); iter != changes.crend(); ++iter) {
+    sched[iter->first] = iter->second;
+  }
+  for (const auto &change : changes) {
+    invSched[sched[change.first].get()] = change.first;
+  }
+  pendingScheduleChanges.clear();
+}
+
+bool Graph::reorder(const Constraints &cs) {
+  ++nMutations_;
+
+  auto &order = sched;
+  auto &inv   = invSched;
+
+  // The constraints processed so far. These are not edges in this Graph, but
+  // the schedule must continue to satisfy them.
+  std::unordered_map<OpId, OpIds> extraOuts;
+  std::unordered_map<OpId, OpIds> extraIns;
+
+  // Depth-first search from #start, through out-edges if #forwards is true
+  // and through in-edges otherwise, visiting only Ops which satisfy
+  // #inWindow. Returns false if an Op satisfying #isTarget is reached.
+  auto search = [this, &extraOuts, &extraIns](OpId start,
+                                               bool forwards,
+                                               auto &&inWindow,
+                                               auto &&isTarget,
+                                               OpIds &visited) {
+    std::unordered_set<OpId> seen{start};
+    OpIds toProcess{start};
+    while (!toProcess.empty()) {
+      const auto nxt = toProcess.back();
+      toProcess.pop_back();
+      visited.push_back(nxt);
+      auto nbrs = forwards ? op(nxt).outs() : op(nxt).ins();
+      const auto &extra = forwards ? extraOuts : extraIns;
+      const auto found  = extra.find(nxt);
+      if (found != extra.cend()) {
+        nbrs.insert(nbrs.end(), found->second.cbegin(), found->second.cend());
+      }
+      for (auto nbr : nbrs) {
+        if (isTarget(nbr)) {
+          return false;
+        }
+        if (inWindow(nbr) && seen.insert(nbr).second) {
+          toProcess.push_back(nbr);
+        }
+      }
+    }
+    return true;
+  };
+
+  for (const auto &[before, after] : cs) {
+    if (before == after) {
+      return false;
+    }
+
+    const auto lower = inv[after.get()];
+    const auto upper = inv[before.get()];
+
+    if (upper > lower) {
+
+      // The Ops which are after 'after' and before 'before'. These must all
+      // be moved to after 'before'. If 'before' is reached, then 'before'
+      // is already constrained to be after 'after': a cycle.
+      OpIds fwd;
+      if (!search(
+              after,
+              true,
+              [&inv, upper](OpId x) { return inv[x.get()] < upper; },
+              [before = before](OpId x) { return x == before; },
+              fwd)) {
+        return false;
+      }
+
+      // The Ops which 'before' is after, and which are after 'after'. These
+      // must all be moved to before 'after'.
+      OpIds bwd;
+      search(
+          before,
+          false,
+          [&inv, lower](OpId x) { return inv[x.get()] > lower; },
+          [](OpId) { return false; },
+          bwd);
+
+      // The 2 sets of Ops are disjoint. Their schedule indices are
+      // reassigned, preserving the relative order within each set, with all
+      // Ops in 'bwd' before all Ops in 'fwd'.
+      auto byIndex = [&inv](OpId a, OpId b) {
+        return inv[a.get()] < inv[b.get()];
+      };
+      std::sort(bwd.begin(), bwd.end(), byIndex);
+      std::sort(fwd.begin(), fwd.end(), byIndex);
+
+      std::vector<uint64_t> indices;
+      indices.reserve(bwd.size() + fwd.size());
+      for (const auto &ids : {bwd, fwd}) {
+        for (auto id : ids) {
+          indices.push_back(inv[id.get()]);
+        }
+      }
+      std::sort(indices.begin(), indices.end());
+
+      uint64_t i = 0;
+      for (const auto &ids : {bwd, fwd}) {
+        for (auto id : ids) {
+          if (inv[id.get()] != indices[i]) {
+            ++scheduleUpdateStats_.nOpsMoved;
+            pendingScheduleChanges.push_back({indices[i], order[indices[i]]});
+          }
+          order[indices[i]] = id;
+          inv[id.get()]     = indices[i];
+          ++i;
+        }
+      }
+      scheduleUpdateStats_.nOpsVisited += indices.size();
+    }
+
+    extraOuts[before].push_back(after);
+    extraIns[after].push_back(before);
+  }
+  return true;
+}
+
+void Graph::verifyReorder(const Constraints &cs, bool isAcyclic) const {
+
+  const auto fwdEdges = getFwdEdges<int64_t>(cs);
+  const auto vanilla  = poprithms::schedule::vanilla::getSchedule_i64(
+      fwdEdges,
+      schedule::vanilla::ErrorIfCycle::No,
+      schedule::vanilla::VerifyEdges::No);
+
+  if ((vanilla.size() == nOps()) != isAcyclic) {
+    std::ostringstream oss;
+    oss << "The incremental schedule update found the constraints " << cs
+        << " to be " << (isAcyclic ? "acyclic" : "cyclic")
+        << ", but the vanilla scheduler found them to be "
+        << (isAcyclic ? "cyclic" : "acyclic") << '.';
+    throw error(oss.str());
+  }
+
+  if (!isAcyclic) {
+    return;
+  }
+
+  for (uint64_t i = 0; i < nOps(); ++i) {
+    if (invSched[sched[i].get()] != i) {
+      std::ostringstream oss;
+      oss << "After the incremental schedule update for the constraints "
+          << cs << ", the schedule is not a permutation of the Ops.";
+      throw error(oss.str());
+    }
+    for (auto to : fwdEdges[i]) {
+      if (invSched[i] >= invSched[static_cast<uint64_t>(to)]) {
+        std::ostringstream oss;
+        oss << "After the incremental schedule update for the constraints "
+            << cs << ", Op " << i << " is not scheduled before Op " << to
+            << ", although there is an edge between them.";
+        throw error(oss.str());
+      }
+    }
+  }
 }
 
 void Graph::setSchedule(OpIds &&schedule_) {
+  ++nMutations_;
+  pendingScheduleChanges.clear();
   sched = std::move(schedule_);
   invSched.resize(nOps(), std::numeric_limits<uint64_t>::max());
   for (uint64_t i = 0; i < sched.size(); ++i) {
@@ -116,6 +116,12 @@ OpeningResult OpeningResult::validWithChangedSchedule(Constraints &&cs,
   return OpeningResult(
       OpeningStatus::Valid, std::move(cs), std::move(sched), true);
 }
+OpeningResult
+OpeningResult::validWithScheduleChangedInGraph(Constraints &&cs) {
+  auto r = OpeningResult(OpeningStatus::Valid, std::move(cs), {}, true);
+  r.scheduleStored_ = false;
+  return r;
+}
 
 OpeningResult OpeningResult::cycle() {
   return OpeningResult(OpeningStatus::Cycle, {}, {}, false);
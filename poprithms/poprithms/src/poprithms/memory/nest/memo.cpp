@@ -0,0 +1,177 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <atomic>
+#include <sstream>
+
+#include <memory/nest/error.hpp>
+#include <memory/nest/memotable.hpp>
+
+#include <poprithms/memory/nest/logging.hpp>
+#include <poprithms/memory/nest/memo.hpp>
+#include <poprithms/util/hashcombine.hpp>
+
+namespace poprithms {
+namespace memory {
+namespace nest {
+
+namespace {
+
+constexpr uint64_t nOps = static_cast<uint64_t>(MemoizedOp::N);
+
+std::atomic<bool> enabled_{false};
+std::atomic<uint64_t> capacity_{1 << 20};
+std::array<std::atomic<uint64_t>, nOps> hits_{};
+std::array<std::atomic<uint64_t>, nOps> misses_{};
+
+uint64_t index(MemoizedOp op) {
+  const auto i = static_cast<uint64_t>(op);
+  if (i >= nOps) {
+    std::ostringstream oss;
+    oss << "Invalid MemoizedOp, " << i << ". There are only " << nOps
+        << " memoized operations.";
+    throw error(oss.str());
+  }
+  return i;
+}
+
+} // namespace
+
+std::ostream &operator<<(std::ostream &ost, MemoizedOp op) {
+  switch (op) {
+  case MemoizedOp::Intersect: {
+    ost << "Intersect";
+    break;
+  }
+  case MemoizedOp::Subtract: {
+    ost << "Subtract";
+    break;
+  }
+  case MemoizedOp::Complement: {
+    ost << "Complement";
+    break;
+  }
+  case MemoizedOp::Merge: {
+    ost << "Merge";
+    break;
+  }
+  case MemoizedOp::Reshape: {
+    ost << "Reshape";
+    break;
+  }
+  case MemoizedOp::N: {
+    ost << "N";
+    break;
+  }
+  }
+  return ost;
+}
+
+namespace memo {
+
+void Key::append(int64_t v) {
+  vs.push_back(v);
+  util::hash_combine(hash_, v);
+}
+
+void Key::append(const Sett &sett) {
+  const auto &stripes = sett.getStripes();
+  append(static_cast<int64_t>(stripes.size()));
+  for (const auto &stripe : stripes) {
+    append(stripe.on());
+    append(stripe.off());
+    append(stripe.phase());
+  }
+}
+
+void Key::append(const Shape &shape) {
+  append(static_cast<int64_t>(shape.rank_u64()));
+  for (auto d : shape.get()) {
+    append(d);
+  }
+}
+
+void Key::append(const Region &region) {
+  append(region.shape());
+  for (const auto &sett : region.setts()) {
+    append(sett);
+  }
+}
+
+void recordHit(MemoizedOp op) { ++hits_[index(op)]; }
+void recordMiss(MemoizedOp op) { ++misses_[index(op)]; }
+
+Table<DisjointSetts> &intersections() {
+  static Table<DisjointSetts> t(MemoizedOp::Intersect);
+  return t;
+}
+
+Table<DisjointSetts> &subtractions() {
+  static Table<DisjointSetts> t(MemoizedOp::Subtract);
+  return t;
+}
+
+Table<DisjointSetts> &complements() {
+  static Table<DisjointSetts> t(MemoizedOp::Complement);
+  return t;
+}
+
+Table<Setts> &merges() {
+  static Table<Setts> t(MemoizedOp::Merge);
+  return t;
+}
+
+Table<DisjointRegions> &reshapes() {
+  static Table<DisjointRegions> t(MemoizedOp::Reshape);
+  return t;
+}
+
+} // namespace memo
+
+void Memo::enable() { enabled_ = true; }
+void Memo::disable() { enabled_ = false; }
+bool Memo::enabled() { return enabled_; }
+
+void Memo::clear() {
+  memo::intersections().clear();
+  memo::subtractions().clear();
+  memo::complements().clear();
+  memo::merges().clear();
+  memo::reshapes().clear();
+  for (uint64_t i = 0; i < nOps; ++i) {
+    hits_[i]   = 0;
+    misses_[i] = 0;
+  }
+}
+
+void Memo::setCapacity(uint64_t c) { capacity_ = c; }
+uint64_t Memo::capacity() { return capacity_; }
+
+uint64_t Memo::hits(MemoizedOp op) { return hits_[index(op)]; }
+uint64_t Memo::misses(MemoizedOp op) { return misses_[index(op)]; }
+
+double Memo::hitRate(MemoizedOp op) {
+  const auto h = hits(op);
+  const auto n = h + misses(op);
+  return n == 0 ? 0. : static_cast<double>(h) / static_cast<double>(n);
+}
+
+void Memo::appendStats(std::ostream &ost) {
+  ost << "Memo(enabled=" << (enabled() ? "yes" : "no");
+  for (uint64_t i = 0; i < nOps; ++i) {
+    const auto op = static_cast<MemoizedOp>(i);
+    ost << ',' << op << "(hits=" << hits(op) << ",misses=" << misses(op)
+        << ",hitRate=" << hitRate(op) << ')';
+  }
+  ost << ')';
+}
+
+void Memo::logStats() {
+  if (log().shouldLogInfo()) {
+    std::ostringstream oss;
+    appendStats(oss);
+    log().info(oss.str());
+  }
+}
+
+} // namespace nest
+} // namespace memory
+} // namespace poprithms
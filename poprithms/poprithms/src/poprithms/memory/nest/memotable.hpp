@@ -0,0 +1,111 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_MEMORY_NEST_MEMOTABLE_HPP
+#define POPRITHMS_MEMORY_NEST_MEMOTABLE_HPP
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <poprithms/memory/nest/memo.hpp>
+#include <poprithms/memory/nest/region.hpp>
+#include <poprithms/memory/nest/sett.hpp>
+
+namespace poprithms {
+namespace memory {
+namespace nest {
+namespace memo {
+
+/**
+ * The arguments of a memoized operation, flattened into integers. A Sett is
+ * its number of Stripes followed by the (on, off, phase) of each Stripe, and
+ * a Shape is its rank followed by its dimensions.
+ * */
+class Key {
+public:
+  void append(const Sett &);
+  void append(const Shape &);
+  void append(const Region &);
+
+  bool operator==(const Key &rhs) const { return vs == rhs.vs; }
+
+  // The hash is updated as integers are appended.
+  size_t hash() const { return hash_; }
+
+private:
+  void append(int64_t);
+  std::vector<int64_t> vs;
+  size_t hash_{0};
+};
+
+struct KeyHash {
+  size_t operator()(const Key &k) const { return k.hash(); }
+};
+
+// Record that a result of #op was (or was not) found in the cache.
+void recordHit(MemoizedOp op);
+void recordMiss(MemoizedOp op);
+
+/**
+ * The cached results of 1 operation. The results are partitioned into
+ * shards by hash, each with its own mutex, so that threads evaluating
+ * different arguments rarely wait for each other.
+ * */
+template <typename Value> class Table {
+public:
+  explicit Table(MemoizedOp op) : op_(op) {}
+
+  // Return the cached result for #key if there is one, otherwise compute it
+  // with #f and cache it. #f is called without holding a lock, so 2 threads
+  // might compute the same result.
+  template <typename F> Value get(const Key &key, F &&f) {
+    auto &shard = shards[key.hash() % nShards];
+    {
+      std::lock_guard<std::mutex> lock(shard.mut);
+      const auto found = shard.values.find(key);
+      if (found != shard.values.cend()) {
+        recordHit(op_);
+        return found->second;
+      }
+    }
+    recordMiss(op_);
+    Value v = f();
+    std::lock_guard<std::mutex> lock(shard.mut);
+    if (shard.values.size() >= Memo::capacity() / nShards + 1) {
+      shard.values.clear();
+    }
+    shard.values.emplace(key, v);
+    return v;
+  }
+
+  void clear() {
+    for (auto &shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mut);
+      shard.values.clear();
+    }
+  }
+
+private:
+  static constexpr uint64_t nShards{16};
+  struct Shard {
+    std::mutex mut;
+    std::unordered_map<Key, Value, KeyHash> values;
+  };
+  std::array<Shard, nShards> shards;
+  MemoizedOp op_;
+};
+
+Table<DisjointSetts> &intersections();
+Table<DisjointSetts> &subtractions();
+Table<DisjointSetts> &complements();
+Table<Setts> &merges();
+Table<DisjointRegions> &reshapes();
+
+} // namespace memo
+} // namespace nest
+} // namespace memory
+} // namespace poprithms
+
+#endif
@@ -1,10 +1,12 @@
 // Copyright (c) 2021 Graphcore Ltd. All rights reserved.
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <ostream>
 #include <sstream>
 
 #include <memory/nest/error.hpp>
+#include <memory/nest/memotable.hpp>
 
 #include <poprithms/memory/nest/optionalset.hpp>
 #include <poprithms/memory/nest/region.hpp>
@@ -212,14 +214,193 @@ OptionalRegion Region::merge(const Region &rhs) const {
   return OptionalRegion::None();
 }
 
-// TODO(T24990) accelerate this (make sub-quadratic) with spatial
-// data-structure.
+namespace {
+
+/**
+ * The smallest hyper-rectangle which contains a non-empty Region, with
+ * inclusive lower and upper bounds in each dimension.
+ * */
+class BoundingBox {
+public:
+  explicit BoundingBox(const Region &r) {
+    low.reserve(r.rank_u64());
+    upp.reserve(r.rank_u64());
+    for (uint64_t d = 0; d < r.rank_u64(); ++d) {
+      const auto nOn = r.sett(d).n(0, r.dim(d));
+      low.push_back(r.sett(d).find(0));
+      upp.push_back(r.sett(d).getOn(nOn - 1));
+    }
+  }
+
+  bool intersects(const BoundingBox &rhs) const {
+    for (uint64_t d = 0; d < low.size(); ++d) {
+      if (low[d] > rhs.upp[d] || rhs.low[d] > upp[d]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<int64_t> low;
+  std::vector<int64_t> upp;
+};
+
+/**
+ * An index over the bounding boxes of a set of Regions, for finding the
+ * Regions whose bounding boxes intersect a query box without testing every
+ * Region. Empty Regions, which have no bounding box and intersect nothing,
+ * are not indexed.
+ *
+ * The boxes are sorted by their lower bound in a single (sweep) dimension,
+ * and a segment tree stores the maximum upper bound in the sweep dimension
+ * over ranges of the sorted boxes. A query for the interval [l, u] in the
+ * sweep dimension visits only the boxes with lower bound at most u, and
+ * prunes sub-trees in which no upper bound is at least l. The remaining
+ * dimensions are then checked box by box.
+ * */
+class BoundingBoxIndex {
+public:
+  explicit BoundingBoxIndex(const std::vector<Region> &regs) {
+    boxes.reserve(regs.size());
+    regIndices.reserve(regs.size());
+    for (uint64_t i = 0; i < regs.size(); ++i) {
+      if (!regs[i].empty()) {
+        boxes.push_back(BoundingBox(regs[i]));
+        regIndices.push_back(i);
+      }
+    }
+
+    // The sweep dimension is the one in which the boxes are narrowest
+    // relative to the full dimension, as it is the most selective.
+    const auto &shape = regs[0].shape();
+    double bestScore{-1};
+    for (uint64_t d = 0; d < shape.rank_u64(); ++d) {
+      double score{0};
+      for (const auto &b : boxes) {
+        score += static_cast<double>(shape.dim(d) - (b.upp[d] - b.low[d]));
+      }
+      if (score > bestScore) {
+        bestScore = score;
+        sweep     = d;
+      }
+    }
+
+    order.resize(boxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint64_t a, uint64_t b) {
+      return boxes[a].low[sweep] < boxes[b].low[sweep];
+    });
+    sortedLows.reserve(order.size());
+    for (auto i : order) {
+      sortedLows.push_back(boxes[i].low[sweep]);
+    }
+
+    // A segment tree with the sorted boxes at its leaves. The tree is padded
+    // to a power of 2 leaves, padding leaves are never visited.
+    nLeaves = 1;
+    while (nLeaves < order.size()) {
+      nLeaves *= 2;
+    }
+    maxUpps.resize(2 * nLeaves, std::numeric_limits<int64_t>::min());
+    for (uint64_t i = 0; i < order.size(); ++i) {
+      maxUpps[nLeaves + i] = boxes[order[i]].upp[sweep];
+    }
+    for (uint64_t i = nLeaves - 1; i > 0; --i) {
+      maxUpps[i] = std::max(maxUpps[2 * i], maxUpps[2 * i + 1]);
+    }
+  }
+
+  /**
+   * \return The indices, in ascending order, of the Regions whose bounding
+   *         boxes intersect #query.
+   * */
+  std::vector<uint64_t> candidates(const BoundingBox &query) const {
+
+    // The sorted boxes in [0, end) have lower bounds not greater than the
+    // query's upper bound.
+    const auto end = static_cast<uint64_t>(
+        std::distance(sortedLows.cbegin(),
+                      std::upper_bound(sortedLows.cbegin(),
+                                       sortedLows.cend(),
+                                       query.upp[sweep])));
+
+    std::vector<uint64_t> found;
+    collect(1, 0, nLeaves, end, query, found);
+    std::sort(found.begin(), found.end());
+    return found;
+  }
+
+private:
+  // Collect the boxes in the sub-tree rooted at #node, which covers the
+  // sorted boxes [nodeBegin, nodeEnd), which are before #end and which
+  // intersect #query.
+  void collect(uint64_t node,
+               uint64_t nodeBegin,
+               uint64_t nodeEnd,
+               uint64_t end,
+               const BoundingBox &query,
+               std::vector<uint64_t> &found) const {
+    if (nodeBegin >= end || maxUpps[node] < query.low[sweep]) {
+      return;
+    }
+    if (node >= nLeaves) {
+      const auto i = order[nodeBegin];
+      if (boxes[i].intersects(query)) {
+        found.push_back(regIndices[i]);
+      }
+      return;
+    }
+    const auto mid = (nodeBegin + nodeEnd) / 2;
+    collect(2 * node, nodeBegin, mid, end, query, found);
+    collect(2 * node + 1, mid, nodeEnd, end, query, found);
+  }
+
+  std::vector<BoundingBox> boxes;
+
+  // The index of the Region of each box, in the Regions indexed.
+  std::vector<uint64_t> regIndices;
+
+  uint64_t sweep{0};
+  std::vector<uint64_t> order;
+  std::vector<int64_t> sortedLows;
+  uint64_t nLeaves{1};
+  std::vector<int64_t> maxUpps;
+};
+
+// Below this number of Region pairs, testing all pairs is faster than
+// building a BoundingBoxIndex.
+constexpr uint64_t minPairsForIndex{64};
+
+bool useIndex(const DisjointRegions &a, const DisjointRegions &b) {
+  return a.rank_u64() > 0 && a.size() * b.size() >= minPairsForIndex;
+}
+
+} // namespace
+
 DisjointRegions DisjointRegions::intersect(const DisjointRegions &rhs) const {
 
   std::vector<Region> out;
+
+  if (!useIndex(*this, rhs)) {
+    for (const auto &a : get()) {
+      for (const auto &b : rhs.get()) {
+        const auto aInterB = a.intersect(b).get();
+        out.insert(out.end(), aInterB.cbegin(), aInterB.cend());
+      }
+    }
+    return DisjointRegions(shape(), out);
+  }
+
+  // Only the pairs of Regions whose bounding boxes intersect can intersect.
+  // The candidates are processed in the same order as in the all-pairs
+  // loop above, so that the output is identical.
+  const BoundingBoxIndex index(rhs.get());
   for (const auto &a : get()) {
-    for (const auto &b : rhs.get()) {
-      const auto aInterB = a.intersect(b).get();
+    if (a.empty()) {
+      continue;
+    }
+    for (auto i : index.candidates(BoundingBox(a))) {
+      const auto aInterB = a.intersect(rhs.at(i)).get();
       out.insert(out.end(), aInterB.cbegin(), aInterB.cend());
     }
   }
@@ -588,9 +769,15 @@ DisjointRegions Region::reshape(const Shape &to) const {
     return createFull(to);
   }
 
-  const auto flatRegion      = flatten();
-  auto unFlatDisjointRegions = flatRegion.unflatten(to);
-  return unFlatDisjointRegions;
+  auto compute = [this, &to]() { return flatten().unflatten(to); };
+
+  if (!Memo::enabled()) {
+    return compute();
+  }
+  memo::Key key;
+  key.append(*this);
+  key.append(to);
+  return memo::reshapes().get(key, compute);
 }
 
 Region Region::flatten() const {
@@ -944,9 +1131,24 @@ bool DisjointRegions::disjoint(const DisjointRegions &rhs) const {
     return false;
   }
 
+  if (!useIndex(*this, rhs)) {
+    for (const auto &reg0 : get()) {
+      for (const auto &reg1 : rhs.get()) {
+        if (!reg0.disjoint(reg1)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  const BoundingBoxIndex index(rhs.get());
   for (const auto &reg0 : get()) {
-    for (const auto &reg1 : rhs.get()) {
-      if (!reg0.disjoint(reg1)) {
+    if (reg0.empty()) {
+      continue;
+    }
+    for (auto i : index.candidates(BoundingBox(reg0))) {
+      if (!reg0.disjoint(rhs.at(i))) {
         return false;
       }
     }
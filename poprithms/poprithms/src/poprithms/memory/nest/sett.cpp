@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include <memory/nest/error.hpp>
+#include <memory/nest/memotable.hpp>
 
 #include <poprithms/memory/nest/logging.hpp>
 #include <poprithms/memory/nest/sett.hpp>
@@ -732,21 +733,31 @@ Sett Sett::fromDepth(int d) const {
 }
 
 DisjointSetts Sett::intersect(const Sett &lhs, const Sett &rhs) {
-  auto scm          = lhs.smallestCommonMultiple(rhs);
-  auto intersection = intersectRecurse(lhs,
-                                       rhs,
-                                       0,  // depth
-                                       0,  // lowCorrect
-                                       scm // uppCorrect
-  );
-  std::vector<Sett> polishedAndPrefixed;
-  for (auto &x : intersection.get()) {
-    x = x.adjustedPrepend({scm, 0, 0});
-    if (!x.alwaysOff()) {
-      polishedAndPrefixed.push_back(x);
+  auto compute = [&lhs, &rhs]() {
+    auto scm          = lhs.smallestCommonMultiple(rhs);
+    auto intersection = intersectRecurse(lhs,
+                                         rhs,
+                                         0,  // depth
+                                         0,  // lowCorrect
+                                         scm // uppCorrect
+    );
+    std::vector<Sett> polishedAndPrefixed;
+    for (auto &x : intersection.get()) {
+      x = x.adjustedPrepend({scm, 0, 0});
+      if (!x.alwaysOff()) {
+        polishedAndPrefixed.push_back(x);
+      }
     }
+    return DisjointSetts(polishedAndPrefixed);
+  };
+
+  if (!Memo::enabled()) {
+    return compute();
   }
-  return DisjointSetts(polishedAndPrefixed);
+  memo::Key key;
+  key.append(lhs);
+  key.append(rhs);
+  return memo::intersections().get(key, compute);
 }
 
 DisjointSetts Sett::intersectRecurse(const Sett &lhsIn,
@@ -1652,17 +1663,36 @@ OptionalSett2 Sett::transfer(const Sett &lhs, const Sett &rhs) {
 }
 
 OptionalSet<1, Sett> Sett::merge(const Sett &lhs, const Sett &rhs) {
-  auto merged = mergeA(lhs, rhs);
-  if (merged.full()) {
-    return merged;
-  }
+  auto compute = [&lhs, &rhs]() {
+    auto merged = mergeA(lhs, rhs);
+    if (merged.full()) {
+      return merged;
+    }
 
-  merged = mergeB(lhs, rhs);
-  if (merged.full()) {
-    return merged;
-  }
+    merged = mergeB(lhs, rhs);
+    if (merged.full()) {
+      return merged;
+    }
+
+    return mergeC(lhs, rhs);
+  };
 
-  return mergeC(lhs, rhs);
+  if (!Memo::enabled()) {
+    return compute();
+  }
+  // OptionalSett1 is not copyable, so the merged Sett (if there is one) is
+  // cached in a vector.
+  memo::Key key;
+  key.append(lhs);
+  key.append(rhs);
+  const auto merged = memo::merges().get(key, [&compute]() {
+    const auto m = compute();
+    return m.full() ? Setts{m.first()} : Setts{};
+  });
+  if (merged.empty()) {
+    return OptionalSett1::None();
+  }
+  return OptionalSett1({merged[0]});
 }
 
 int Sett::depthWhereFirstDifference(const Sett &rhs) const {
@@ -2249,25 +2279,43 @@ DisjointSetts Sett::getComplement() const {
     return createAlwaysOn();
   }
 
-  std::vector<Sett> complements;
-  complements.push_back(Sett({atDepth(0).getComplement()}));
-  auto subComplement = fromDepth(1).getComplement();
-  for (auto &sub : subComplement) {
-    sub.prependStripes({atDepth(0)});
-    complements.push_back(sub);
-  }
+  auto compute = [this]() {
+    std::vector<Sett> complements;
+    complements.push_back(Sett({atDepth(0).getComplement()}));
+    auto subComplement = fromDepth(1).getComplement();
+    for (auto &sub : subComplement) {
+      sub.prependStripes({atDepth(0)});
+      complements.push_back(sub);
+    }
+    return DisjointSetts(complements);
+  };
 
-  return DisjointSetts(complements);
+  if (!Memo::enabled()) {
+    return compute();
+  }
+  memo::Key key;
+  key.append(*this);
+  return memo::complements().get(key, compute);
 }
 
 DisjointSetts Sett::subtract(const Sett &rhs) const {
-  const auto rhsCompl = rhs.getComplement();
-  std::vector<Sett> diff;
-  for (const auto &rhsComplElm : rhsCompl.get()) {
-    const auto inter = intersect(rhsComplElm);
-    diff.insert(diff.end(), inter.cbegin(), inter.cend());
+  auto compute = [this, &rhs]() {
+    const auto rhsCompl = rhs.getComplement();
+    std::vector<Sett> diff;
+    for (const auto &rhsComplElm : rhsCompl.get()) {
+      const auto inter = intersect(rhsComplElm);
+      diff.insert(diff.end(), inter.cbegin(), inter.cend());
+    }
+    return DisjointSetts(diff);
+  };
+
+  if (!Memo::enabled()) {
+    return compute();
   }
-  return DisjointSetts(diff);
+  memo::Key key;
+  key.append(*this);
+  key.append(rhs);
+  return memo::subtractions().get(key, compute);
 }
 
 } // namespace nest
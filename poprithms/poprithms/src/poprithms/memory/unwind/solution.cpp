@@ -1,6 +1,7 @@
 // Copyright (c) 2022 Graphcore Ltd. All rights reserved.
 
 #include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <memory>
 #include <numeric>
@@ -134,34 +135,29 @@ void Solution::setPathsBackToSinks() {
   }
 }
 
-double Solution::getScore() const {
+double Solution::getScore(const ValuedPair &att) const {
 
   double score{0.0};
-  // double maxScore{0.0};
-  const auto allAttractors = graph().valuedPairs();
-  for (const auto &att : allAttractors) {
-    // maxScore += att.valPerElm() * (graph().nelms(att.id0()));
-    const auto &paths0 = inwardsPaths(att.id0());
-    const auto &paths1 = inwardsPaths(att.id1());
-    for (const auto &p0 : paths0) {
-      for (const auto &p1 : paths1) {
-        if (p0.src() == p1.src()) {
-          const auto allInter = p0.dstRegions().intersect(p1.dstRegions());
-          for (auto dstIntersection : allInter.get()) {
-            const auto dstIntersectionSize = dstIntersection.totalElms();
-
-            if (dstIntersectionSize != 0) {
-              auto c0 = p0.chain();
-              c0.settSample(dstIntersection);
-              c0.canonicalize();
-
-              auto c1 = p1.chain();
-              c1.settSample(dstIntersection);
-              c1.canonicalize();
-
-              if (c0 == c1) {
-                score += att.valPerElm() * dstIntersectionSize;
-              }
+  const auto &paths0 = inwardsPaths(att.id0());
+  const auto &paths1 = inwardsPaths(att.id1());
+  for (const auto &p0 : paths0) {
+    for (const auto &p1 : paths1) {
+      if (p0.src() == p1.src()) {
+        const auto allInter = p0.dstRegions().intersect(p1.dstRegions());
+        for (auto dstIntersection : allInter.get()) {
+          const auto dstIntersectionSize = dstIntersection.totalElms();
+
+          if (dstIntersectionSize != 0) {
+            auto c0 = p0.chain();
+            c0.settSample(dstIntersection);
+            c0.canonicalize();
+
+            auto c1 = p1.chain();
+            c1.settSample(dstIntersection);
+            c1.canonicalize();
+
+            if (c0 == c1) {
+              score += att.valPerElm() * dstIntersectionSize;
             }
           }
         }
@@ -171,6 +167,15 @@ double Solution::getScore() const {
   return score;
 }
 
+double Solution::getScore() const {
+
+  double score{0.0};
+  for (const auto &att : graph().valuedPairs()) {
+    score += getScore(att);
+  }
+  return score;
+}
+
 void Solution::setPathStackToSources() {
   // Sources have no dependencies, their layouts are know immediately.
   for (const auto src : graph().sources()) {
@@ -183,9 +188,11 @@ void Solution::setPathStackToSources() {
   }
 }
 
-Solution::Solution(const Graph &g, Algo a) : Solution(Graph(g), a) {}
+Solution::Solution(const Graph &g, Algo a, const RefinementBudget &b)
+    : Solution(Graph(g), a, b) {}
 
-Solution::Solution(Graph &&g, Algo a) : graph_(std::move(g)) {
+Solution::Solution(Graph &&g, Algo a, const RefinementBudget &b)
+    : graph_(std::move(g)) {
 
   initPaths();
 
@@ -194,6 +201,10 @@ Solution::Solution(Graph &&g, Algo a) : graph_(std::move(g)) {
     setPathsGreedy0();
     break;
   }
+  case (Algo::Greedy0Refine): {
+    setPathsGreedy0Refine(b);
+    break;
+  }
   default: {
     throw error("unrecognised Unwinding Algorithm");
   }
@@ -236,7 +247,90 @@ Solution::Solution(const Graph &g, const Paths &sourcesAndBsToSinks)
   assertCompletelyCovererdByPaths();
 }
 
-void Solution::setPathsGreedy0() {
+void Solution::setPathsGreedy0Refine(const RefinementBudget &budget) {
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  auto secondsElapsed = [t0]() {
+    const std::chrono::duration<double> d =
+        std::chrono::steady_clock::now() - t0;
+    return d.count();
+  };
+
+  const auto valuedPairs = graph().valuedPairs();
+
+  auto key = [](const ValuedPair &vp) {
+    return std::make_pair(std::min(vp.id0(), vp.id1()),
+                          std::max(vp.id0(), vp.id1()));
+  };
+
+  // A value which is larger than the attraction value of every ValuedPair.
+  // ValuedPairs with priorities above this are processed first by Greedy0.
+  double topPriority{0.0};
+  for (const auto &vp : valuedPairs) {
+    topPriority = std::max(topPriority, vp.valPerElm());
+  }
+
+  Priorities priorities;
+  setPathsGreedy0(priorities);
+  auto bestScore           = getScore();
+  auto bestInwardsPaths    = inwardsPaths_;
+  auto bestBarriersToSinks = barriersToSinks_;
+
+  // The indices of the ValuedPairs which do not obtain their maximum
+  // possible value in the current best Solution, and which have not been
+  // moved to the front of the queue. The ValuedPairs which obtain the
+  // smallest fraction of their maximum value are last, to be popped first.
+  auto getCandidates = [this, &valuedPairs, &priorities, &key]() {
+    std::vector<std::tuple<double, double, uint64_t>> unmet;
+    for (uint64_t i = 0; i < valuedPairs.size(); ++i) {
+      const auto &vp = valuedPairs[i];
+      if (priorities.count(key(vp)) != 0) {
+        continue;
+      }
+      const auto maxScore =
+          vp.valPerElm() * static_cast<double>(graph().nelms(vp.id0()));
+      const auto deficit = maxScore - getScore(vp);
+      if (deficit > 0) {
+        unmet.push_back({deficit / maxScore, deficit, i});
+      }
+    }
+    std::sort(unmet.begin(), unmet.end());
+    std::vector<uint64_t> candidates;
+    candidates.reserve(unmet.size());
+    for (const auto &x : unmet) {
+      candidates.push_back(std::get<2>(x));
+    }
+    return candidates;
+  };
+
+  auto candidates = getCandidates();
+  uint64_t iteration{0};
+  while (!candidates.empty() && iteration < budget.maxIterations &&
+         secondsElapsed() < budget.maxSeconds) {
+    ++iteration;
+    const auto &vp = valuedPairs[candidates.back()];
+    candidates.pop_back();
+
+    auto trial     = priorities;
+    trial[key(vp)] = topPriority + 1.0;
+    setPathsGreedy0(trial);
+    const auto score = getScore();
+    if (score > bestScore) {
+      bestScore           = score;
+      bestInwardsPaths    = inwardsPaths_;
+      bestBarriersToSinks = barriersToSinks_;
+      priorities          = trial;
+      topPriority += 1.0;
+      candidates = getCandidates();
+    }
+  }
+
+  inwardsPaths_    = std::move(bestInwardsPaths);
+  barriersToSinks_ = std::move(bestBarriersToSinks);
+}
+
+void Solution::setPathsGreedy0(const Priorities &priorities) {
 
   auto fwdEdgeMap = graph().getMultioutForwardEdgeMap_u64();
 
@@ -250,11 +344,20 @@ void Solution::setPathsGreedy0() {
   }();
 
   resetAllPathInfo();
+  barriersToSinks_.clear();
   setPathStackToSources();
 
-  // TODO(T33922) the next step is refinement. starting from a complete
-  // solution, see which values were not obtained and see if an adjustment
-  // can make overall score increase.
+  // The value used to order the pair (t0, t1) in the queue.
+  auto priority = [&priorities](const TensorId &t0,
+                                const TensorId &t1,
+                                double value) {
+    if (priorities.empty()) {
+      return value;
+    }
+    const auto found =
+        priorities.find({std::min(t0, t1), std::max(t0, t1)});
+    return found == priorities.cend() ? value : found->second;
+  };
 
   std::priority_queue<ExtendedValuedPair> valueQueue;
 
@@ -284,7 +387,7 @@ void Solution::setPathsGreedy0() {
           ExtendedValuedPair p{
               source,
               destination.tensorId(),
-              destination.value(),
+              priority(source, destination.tensorId(), destination.value()),
               lengths[fwdEdgeMap.compactId(destination.tensorId().opId())]};
           valueQueue.push(p);
         }
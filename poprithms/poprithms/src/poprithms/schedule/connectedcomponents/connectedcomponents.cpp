@@ -13,15 +13,12 @@ namespace poprithms {
 namespace schedule {
 namespace connectedcomponents {
 
-template <typename T>
-ConnectedComponents::ConnectedComponents(const Edges<T> &edges, bool) {
+template <typename TEdges>
+ConnectedComponents::ConnectedComponents(const TEdges &edges, bool) {
 
   const auto N = edges.size();
   toLocal.resize(N);
 
-  // for every edge a->b in edges, the object bidirectional (below) will
-  // contain a-> and b->a.
-  auto bidirectional = edges;
   for (uint64_t i = 0; i < N; ++i) {
     for (auto j : edges[i]) {
       if (static_cast<uint64_t>(j) >= N) {
@@ -30,10 +27,13 @@ ConnectedComponents::ConnectedComponents(const Edges<T> &edges, bool) {
             << '.';
         throw schedule::connectedcomponents::error(oss.str());
       }
-      bidirectional[j].push_back(i);
     }
   }
 
+  // for every edge a->b in edges, there is an edge b->a in reversed. The
+  // traversal below follows the edges in both directions.
+  const auto reversed = vanilla::CsrEdges<uint64_t>::reversed(edges);
+
   std::vector<bool> visited(N, false);
   std::vector<uint64_t> toProcess;
 
@@ -55,7 +55,12 @@ ConnectedComponents::ConnectedComponents(const Edges<T> &edges, bool) {
         toProcess.pop_back();
         toLocal[nxt] = {componentgraph, toGlobal.back().size()};
         toGlobal.back().push_back(nxt);
-        for (auto end_ : bidirectional[nxt]) {
+        for (auto end_ : edges[nxt]) {
+          if (!visited[end_]) {
+            enqueue(end_);
+          }
+        }
+        for (auto end_ : reversed[nxt]) {
           if (!visited[end_]) {
             enqueue(end_);
           }
@@ -116,6 +121,10 @@ ConnectedComponents::ConnectedComponents(const Edges<int64_t> &edges)
 ConnectedComponents::ConnectedComponents(const Edges<uint64_t> &edges)
     : ConnectedComponents(edges, false) {}
 
+ConnectedComponents::ConnectedComponents(
+    const vanilla::CsrEdges<uint64_t> &edges)
+    : ConnectedComponents(edges, false) {}
+
 } // namespace connectedcomponents
 } // namespace schedule
 } // namespace poprithms
@@ -7,6 +7,8 @@ namespace poprithms {
 namespace schedule {
 namespace dfs {
 
+namespace {
+
 // Example:
 //
 //
@@ -34,7 +36,8 @@ namespace dfs {
 // {}     {6,2,1,3,0,7,9}
 //
 
-std::vector<uint64_t> postOrder(const Edges &edges) {
+template <typename TEdges>
+std::vector<uint64_t> tPostOrder(const TEdges &edges) {
 
   const auto N = edges.size();
 
@@ -75,6 +78,15 @@ std::vector<uint64_t> postOrder(const Edges &edges) {
   }
   return schedule;
 }
+} // namespace
+
+std::vector<uint64_t> postOrder(const Edges &edges) {
+  return tPostOrder(edges);
+}
+
+std::vector<uint64_t> postOrder(const vanilla::CsrEdges<uint64_t> &edges) {
+  return tPostOrder(edges);
+}
 
 } // namespace dfs
 } // namespace schedule
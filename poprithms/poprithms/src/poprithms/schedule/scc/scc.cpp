@@ -27,29 +27,17 @@ using Component  = util::TypedInteger<'C', uint64_t>;
 using Components = std::vector<Component>;
 const Component Undefined{std::numeric_limits<uint64_t>::max()};
 
-// Replace all a->b edges with b->a edges, i.e. reverse a directed graph.
-using BwdEdges = FwdEdges;
-BwdEdges getReverseEdges(const FwdEdges &fwdEdges) {
-  const auto N = fwdEdges.size();
-  BwdEdges bwdEdges(N);
-  for (uint64_t from = 0; from < N; ++from) {
-    for (auto to : fwdEdges[from]) {
-      bwdEdges[to].push_back(from);
-    }
-  }
-  return bwdEdges;
-}
-
 /**
  *
  * Starting at the node \a start, traverse through all nodes which do not have
  * a defined Component, and set Component to \a c.
  *
  * */
+template <typename TEdges>
 void depthFirstComponentFill(uint64_t start,
                              Component c,
                              Components &components,
-                             const FwdEdges &fwdEdges) {
+                             const TEdges &fwdEdges) {
 
   if (components[start] != Undefined) {
     return;
@@ -70,10 +58,10 @@ void depthFirstComponentFill(uint64_t start,
   }
 }
 
-void confirmValidEdges(const FwdEdges &edges) {
+template <typename TEdges> void confirmValidEdges(const TEdges &edges) {
   const auto N = edges.size();
   for (uint64_t from = 0; from < N; ++from) {
-    const auto &destinations = edges[from];
+    const auto destinations = edges[from];
     for (auto d : destinations) {
       if (d >= N) {
         std::ostringstream oss;
@@ -86,15 +74,17 @@ void confirmValidEdges(const FwdEdges &edges) {
   }
 }
 
-} // namespace
-
-SCCs getStronglyConnectedComponents(const FwdEdges &edges) {
+template <typename TEdges>
+SCCs tGetStronglyConnectedComponents(const TEdges &edges) {
 
   confirmValidEdges(edges);
 
   const auto N = edges.size();
 
-  const auto revEdges = getReverseEdges(edges);
+  // Replace all a->b edges with b->a edges, i.e. reverse the directed graph.
+  // This is done in compressed sparse row format, which requires 2 (rather
+  // than N) allocations.
+  const auto revEdges = vanilla::CsrEdges<uint64_t>::reversed(edges);
 
   // highest post-order is in the final component of the forward graph.
   //
@@ -129,6 +119,17 @@ SCCs getStronglyConnectedComponents(const FwdEdges &edges) {
   return sccs;
 }
 
+} // namespace
+
+SCCs getStronglyConnectedComponents(const FwdEdges &edges) {
+  return tGetStronglyConnectedComponents(edges);
+}
+
+SCCs getStronglyConnectedComponents(
+    const vanilla::CsrEdges<uint64_t> &edges) {
+  return tGetStronglyConnectedComponents(edges);
+}
+
 std::vector<std::vector<uint64_t>> getCycles(const SCCs &sccs,
                                              const FwdEdges &fwdEdges) {
 
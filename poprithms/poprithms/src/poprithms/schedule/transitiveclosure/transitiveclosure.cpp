@@ -65,9 +65,10 @@ std::ostream &operator<<(std::ostream &, IsFinal);
 
 namespace {
 
-void verifyOpAddresses(const Edges &edges, uint64_t nOps) {
-  for (const auto &evs : edges) {
-    for (auto e : evs) {
+template <typename TEdges>
+void verifyOpAddresses(const TEdges &edges, uint64_t nOps) {
+  for (uint64_t i = 0; i < edges.size(); ++i) {
+    for (auto e : edges[i]) {
       if (e >= nOps) {
         std::ostringstream oss;
         oss << "Invalid edge end, " << e << ", with only " << nOps << " Ops.";
@@ -77,7 +78,10 @@ void verifyOpAddresses(const Edges &edges, uint64_t nOps) {
   }
 }
 
-void propagate(const Edges &fwd, const Edges &bwd, BitSets &edgeSet) {
+template <typename TFwdEdges, typename TBwdEdges>
+void propagate(const TFwdEdges &fwd,
+               const TBwdEdges &bwd,
+               BitSets &edgeSet) {
 
   const auto nOps          = fwd.size();
   const auto nBitSetsPerOp = TransitiveClosure::getNBitSetsPerOp(nOps);
@@ -284,30 +288,35 @@ TransitiveClosure::TransitiveClosure(const Edges &fwd)
   bidirectionalPropagate(fwd);
 }
 
-void TransitiveClosure::bidirectionalPropagate(const Edges &fwd) {
+TransitiveClosure::TransitiveClosure(const vanilla::CsrEdges<OpId> &fwd)
+    : nOps(fwd.size()), nBitSetsPerOp(getNBitSetsPerOp(nOps)),
+      fwdEdgeSet(nBitSetsPerOp * nOps), bwdEdgeSet(nBitSetsPerOp * nOps) {
 
-  for (const auto &evs : fwd) {
-    for (auto e : evs) {
-      if (e >= nOps) {
-        std::ostringstream oss;
-        oss << "Invalid edge end, " << e << ", with only " << nOps << " Ops.";
-        throw error(oss.str());
-      }
-    }
-  }
+  bidirectionalPropagate(fwd);
+}
 
-  // setting bwd
-  std::vector<OpIds> bwd(nOps);
-  for (uint64_t i = 0; i < nOps; ++i) {
-    for (auto j : fwd[i]) {
-      bwd[j].push_back(i);
-    }
-  }
+template <typename TEdges>
+void TransitiveClosure::tBidirectionalPropagate(const TEdges &fwd) {
+
+  verifyOpAddresses(fwd, nOps);
+
+  // setting bwd. This is done in compressed sparse row format, which
+  // requires 2 (rather than nOps) allocations.
+  const auto bwd = vanilla::CsrEdges<OpId>::reversed(fwd);
 
   propagate(fwd, bwd, fwdEdgeSet);
   propagate(bwd, fwd, bwdEdgeSet);
 }
 
+void TransitiveClosure::bidirectionalPropagate(const Edges &fwd) {
+  tBidirectionalPropagate(fwd);
+}
+
+void TransitiveClosure::bidirectionalPropagate(
+    const vanilla::CsrEdges<OpId> &fwd) {
+  tBidirectionalPropagate(fwd);
+}
+
 bool TransitiveClosure::operator==(const TransitiveClosure &x) const {
   return fwdEdgeSet == x.fwdEdgeSet && bwdEdgeSet == x.bwdEdgeSet;
 }
@@ -19,7 +19,8 @@ namespace fifo {
  * */
 template <typename TNode> class SchedulerWithoutPriorities {
 public:
-  static std::vector<TNode> kahn(const Edges<TNode> &fwdEdges) {
+  template <typename TEdges>
+  static std::vector<TNode> kahn(const TEdges &fwdEdges) {
 
     // The total number of nodes in the graph.
     const auto N = fwdEdges.size();
@@ -80,8 +81,9 @@ public:
 template <typename TNode, typename TPriority>
 class SchedulerWithManyPriorities {
 public:
+  template <typename TEdges>
   static std::vector<TNode>
-  kahn(const Edges<TNode> &fwdEdges,
+  kahn(const TEdges &fwdEdges,
        const Priorities<TNode, TPriority> &priorities) {
     auto a_ = StackWithManyPriorities<TNode, TPriority>(fwdEdges.size(),
                                                         priorities);
@@ -89,8 +91,8 @@ public:
   }
 };
 
-template <typename TNode, typename TPriority>
-static std::vector<TNode> kahn(const Edges<TNode> &fwdEdges,
+template <typename TNode, typename TPriority, typename TEdges>
+static std::vector<TNode> kahn(const TEdges &fwdEdges,
                                const Priorities<TNode, TPriority> &priorities,
                                const Links<TNode> &links,
                                ErrorIfCycle eic,
@@ -32,7 +32,8 @@ private:
 
 template <typename TNode> class SchedulerWithoutPriorities {
 public:
-  static std::vector<TNode> kahn(const Edges<TNode> &fwdEdges) {
+  template <typename TEdges>
+  static std::vector<TNode> kahn(const TEdges &fwdEdges) {
     auto schedulerStack = StackWithoutPriorities<TNode>(fwdEdges.size());
     return stackBasedKahn<TNode>(fwdEdges, schedulerStack);
   }
@@ -56,8 +57,9 @@ public:
 template <typename TNode, typename TPriority>
 class SchedulerWithManyPriorities {
 public:
+  template <typename TEdges>
   static std::vector<TNode>
-  kahn(const Edges<TNode> &fwdEdges,
+  kahn(const TEdges &fwdEdges,
        const Priorities<TNode, TPriority> &priorities) {
     auto schedulerStack = StackWithManyPriorities<TNode, TPriority>(
         fwdEdges.size(), priorities);
@@ -65,8 +67,8 @@ public:
   }
 };
 
-template <typename TNode, typename TPriority>
-static std::vector<TNode> kahn(const Edges<TNode> &fwdEdges,
+template <typename TNode, typename TPriority, typename TEdges>
+static std::vector<TNode> kahn(const TEdges &fwdEdges,
                                const Priorities<TNode, TPriority> &priorities,
                                const Links<TNode> &links,
                                ErrorIfCycle eic,
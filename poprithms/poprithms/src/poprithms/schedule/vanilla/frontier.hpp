@@ -0,0 +1,227 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPRITHMS_SCHEDULE_VANILLA_FRONTIER_HPP
+#define POPRITHMS_SCHEDULE_VANILLA_FRONTIER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <schedule/vanilla/error.hpp>
+#include <schedule/vanilla/kahn.hpp>
+
+#include <poprithms/schedule/vanilla/vanilla.hpp>
+#include <poprithms/util/parallelfor.hpp>
+
+namespace poprithms {
+namespace schedule {
+namespace vanilla {
+namespace frontier {
+
+/**
+ * Frontiers (levels) of nodes are only split across threads if there are at
+ * least this many nodes per thread. For smaller frontiers the overhead of
+ * starting threads is greater than the work.
+ * */
+static constexpr uint64_t MinNodesPerThread = 1024;
+
+/**
+ * The number of threads used by parallelFor to process #n nodes, if
+ * #nThreads are available.
+ * */
+inline uint64_t nThreadsUsed(uint64_t nThreads, uint64_t n) {
+  return std::max<uint64_t>(
+      1, std::min<uint64_t>(nThreads, n / MinNodesPerThread));
+}
+
+/**
+ * Call f(t, begin, end) for t in [0, nThreadsUsed(nThreads, n)), where the
+ * ranges [begin, end) partition [0, n) into contiguous and ordered chunks.
+ * This returns the number of threads used.
+ * */
+template <typename F>
+uint64_t parallelFor(uint64_t nThreads, uint64_t n, F &&f) {
+  nThreads = nThreadsUsed(nThreads, n);
+  poprithms::util::parallelFor(nThreads, n, std::forward<F>(f));
+  return nThreads;
+}
+
+/**
+ * Decrement #a and return the new value. If #a is not being concurrently
+ * modified, the (faster) non-atomic decrement can be used.
+ * */
+inline uint64_t decrement(std::atomic<uint64_t> &a, bool concurrent) {
+  if (concurrent) {
+    return a.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  }
+  const auto v = a.load(std::memory_order_relaxed) - 1;
+  a.store(v, std::memory_order_relaxed);
+  return v;
+}
+
+/**
+ * Set #a to the maximum of #a and #v.
+ * */
+inline void atomicMax(std::atomic<uint64_t> &a, uint64_t v) {
+  auto prev = a.load(std::memory_order_relaxed);
+  while (prev < v &&
+         !a.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * A schedule, partitioned into frontiers. The nodes in frontier i are
+ * schedule[starts[i]], ... , schedule[starts[i+1] - 1]. Frontier 0 contains
+ * the nodes with no input edges, and frontier i+1 contains the nodes whose
+ * final input edge is from a node in frontier i.
+ * */
+struct Frontiers {
+  std::vector<uint64_t> schedule;
+  std::vector<uint64_t> starts;
+  uint64_t nFrontiers() const { return starts.size() - 1; }
+};
+
+/**
+ * Kahn's algorithm, processing all of the nodes in a frontier concurrently.
+ *
+ * The schedule is the same as that of sequential Kahn's algorithm with fifo
+ * tie-breaking (see fifo::SchedulerWithoutPriorities). Fifo scheduling
+ * processes the nodes frontier by frontier, and the nodes of frontier i+1 are
+ * in the order in which their final input edge is visited. When a frontier
+ * is processed on multiple threads, the edges are visited in a different
+ * order, so each edge is given an index (its position in the sequential
+ * visiting order) and the nodes of the next frontier are sorted by the
+ * largest index of their input edges.
+ * */
+template <typename TEdges>
+Frontiers frontierKahn(const TEdges &fwdEdges,
+                       uint64_t nThreads,
+                       ErrorIfCycle eic,
+                       VerifyEdges ve) {
+
+  if (ve == VerifyEdges::Yes) {
+    verifyEdges<uint64_t>(fwdEdges);
+  }
+
+  const auto N = fwdEdges.size();
+  nThreads     = std::max<uint64_t>(1, nThreads);
+
+  // The number of input edges of each node which have not been visited. The
+  // atomics are value-initialized, to zero. They are only modified
+  // atomically when they are being modified on multiple threads.
+  std::vector<std::atomic<uint64_t>> nOutstandingDeps(N);
+  const auto countConcurrently = nThreadsUsed(nThreads, N) > 1;
+  auto countDeps = [&fwdEdges, &nOutstandingDeps, countConcurrently](
+                       uint64_t, uint64_t b, uint64_t e) {
+    for (uint64_t from = b; from < e; ++from) {
+      for (auto to : fwdEdges[from]) {
+        auto &c = nOutstandingDeps[to];
+        if (countConcurrently) {
+          c.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          c.store(c.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+        }
+      }
+    }
+  };
+  parallelFor(nThreads, N, countDeps);
+
+  Frontiers fs;
+  fs.schedule.reserve(N);
+  fs.starts = {0};
+  for (uint64_t i = 0; i < N; ++i) {
+    if (nOutstandingDeps[i].load(std::memory_order_relaxed) == 0) {
+      fs.schedule.push_back(i);
+    }
+  }
+
+  // The largest index of a visited input edge of each node. Only set in
+  // frontiers which are processed on multiple threads, and only allocated
+  // if there is such a frontier.
+  std::vector<std::atomic<uint64_t>> lastVisit;
+
+  // The number of edges visited in all previous frontiers.
+  uint64_t nVisited{0};
+
+  // The index of the first edge of each node in the current frontier.
+  std::vector<uint64_t> firstVisit;
+
+  // The nodes of the next frontier, found by each thread.
+  std::vector<std::vector<uint64_t>> released(nThreads);
+
+  while (fs.starts.back() != fs.schedule.size()) {
+    const auto begin = fs.starts.back();
+    const auto end   = fs.schedule.size();
+    fs.starts.push_back(end);
+
+    const auto parallel = nThreadsUsed(nThreads, end - begin) > 1;
+
+    if (parallel) {
+      if (lastVisit.empty()) {
+        lastVisit = std::vector<std::atomic<uint64_t>>(N);
+      }
+      firstVisit.resize(end - begin);
+      for (uint64_t k = begin; k < end; ++k) {
+        firstVisit[k - begin] = nVisited;
+        nVisited += fwdEdges[fs.schedule[k]].size();
+      }
+    }
+
+    auto visitFrontier = [&, begin, parallel](
+                             uint64_t t, uint64_t b, uint64_t e) {
+      auto &rel = released[t];
+      rel.clear();
+      for (uint64_t k = b; k < e; ++k) {
+        // The index (plus 1) of the edge being visited, in the sequential
+        // visiting order.
+        uint64_t visit = parallel ? firstVisit[k] + 1 : 0;
+        for (auto to : fwdEdges[fs.schedule[begin + k]]) {
+          if (parallel) {
+            atomicMax(lastVisit[to], visit);
+            ++visit;
+          }
+          if (decrement(nOutstandingDeps[to], parallel) == 0) {
+            rel.push_back(to);
+          }
+        }
+      }
+    };
+    const auto nUsed = parallelFor(nThreads, end - begin, visitFrontier);
+
+    if (nUsed == 1) {
+      // The edges were visited in the sequential order.
+      fs.schedule.insert(
+          fs.schedule.end(), released[0].cbegin(), released[0].cend());
+    } else {
+      const auto nextBegin = fs.schedule.size();
+      for (uint64_t t = 0; t < nUsed; ++t) {
+        fs.schedule.insert(
+            fs.schedule.end(), released[t].cbegin(), released[t].cend());
+      }
+      std::sort(fs.schedule.begin() + nextBegin,
+                fs.schedule.end(),
+                [&lastVisit](uint64_t a, uint64_t b) {
+                  return lastVisit[a].load(std::memory_order_relaxed) <
+                         lastVisit[b].load(std::memory_order_relaxed);
+                });
+    }
+  }
+
+  if (eic == ErrorIfCycle::Yes && fs.schedule.size() != N) {
+    std::ostringstream oss;
+    oss << "Only " << fs.schedule.size() << " of " << N
+        << " nodes are scheduled, there is a cycle in the graph. ";
+    throw error(oss.str());
+  }
+
+  return fs;
+}
+
+} // namespace frontier
+} // namespace vanilla
+} // namespace schedule
+} // namespace poprithms
+
+#endif
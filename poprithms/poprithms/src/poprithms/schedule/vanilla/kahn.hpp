@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -29,7 +30,8 @@ namespace vanilla {
  *
  * 1) node type,
  * 2) priority type,
- * 3) stack type.
+ * 3) stack type,
+ * 4) edge type, which is either Edges<TNode> or CsrEdges<TNode>.
  * */
 
 template <typename T> bool valid(T x, uint64_t end) {
@@ -40,7 +42,8 @@ template <> inline bool valid(int64_t x, uint64_t end) {
   return x >= 0 && static_cast<uint64_t>(x) < end;
 }
 
-template <typename T> void verifyEdges(const Edges<T> &fwdEdges) {
+template <typename T, typename TEdges = Edges<T>>
+void verifyEdges(const TEdges &fwdEdges) {
   const auto N = fwdEdges.size();
   for (uint64_t start = 0; start < N; ++start) {
     for (auto end : fwdEdges[start]) {
@@ -55,8 +58,8 @@ template <typename T> void verifyEdges(const Edges<T> &fwdEdges) {
 }
 
 // return the number of input edges for each node.
-template <typename TNode>
-std::vector<uint64_t> getOutstandingCount(const Edges<TNode> &fwdEdges) {
+template <typename TEdges>
+std::vector<uint64_t> getOutstandingCount(const TEdges &fwdEdges) {
 
   // The total number of nodes in the graph.
   const auto N = fwdEdges.size();
@@ -71,9 +74,8 @@ std::vector<uint64_t> getOutstandingCount(const Edges<TNode> &fwdEdges) {
   return nOutstandingDeps;
 }
 
-template <typename TNode, typename Stack>
-std::vector<TNode> stackBasedKahn(const Edges<TNode> &fwdEdges,
-                                  Stack &ready) {
+template <typename TNode, typename TEdges, typename Stack>
+std::vector<TNode> stackBasedKahn(const TEdges &fwdEdges, Stack &ready) {
 
   // assert that the stack is empty.
   if (!ready.empty()) {
@@ -162,9 +164,9 @@ LinkMap<TNode> getToLinked(uint64_t nNodes, const Links<TNode> &links) {
   return {toCompressed, toExpanded};
 }
 
-template <typename TNode>
+template <typename TNode, typename TEdges>
 Edges<TNode> getCompressedEdges(const LinkMap<TNode> &lm,
-                                const Edges<TNode> &fwdEdges) {
+                                const TEdges &fwdEdges) {
 
   std::vector<std::vector<TNode>> compressedEdges(lm.nCompressed());
 
@@ -241,9 +243,10 @@ template <typename TNode,
           typename TPriority,
           class SchedulerWithoutPriorities,
           class SchedulerWithPriorities,
+          class TEdges,
           class... Args>
 std::vector<TNode>
-linklessDelegate(const Edges<TNode> &fwdEdges,
+linklessDelegate(const TEdges &fwdEdges,
                  const Priorities<TNode, TPriority> &priorities,
                  const Args &...args) {
 
@@ -266,9 +269,10 @@ template <typename TNode,
           typename TPriority,
           class SchedulerWithoutPriorities,
           class SchedulerWithPriorities,
+          class TEdges,
           class GetLinkedArgs,
           class... Args>
-std::vector<TNode> delegate(const Edges<TNode> &fwdEdges,
+std::vector<TNode> delegate(const TEdges &fwdEdges,
                             ErrorIfCycle eic,
                             VerifyEdges ve,
                             const Priorities<TNode, TPriority> &priorities,
@@ -287,6 +291,7 @@ std::vector<TNode> delegate(const Edges<TNode> &fwdEdges,
                             TPriority,
                             SchedulerWithoutPriorities,
                             SchedulerWithPriorities,
+                            TEdges,
                             Args...>(fwdEdges, priorities, args...);
   };
 
@@ -302,6 +307,7 @@ std::vector<TNode> delegate(const Edges<TNode> &fwdEdges,
                               TPriority,
                               SchedulerWithoutPriorities,
                               SchedulerWithPriorities,
+                              Edges<TNode>,
                               Args...>(
           compressedEdges, compressedPriorities, linkedArgs...);
     };
@@ -1,6 +1,7 @@
 // Copyright (c) 2021 Graphcore Ltd. All rights reserved.
 
 #include "error.hpp"
+#include "frontier.hpp"
 
 #include <algorithm>
 #include <limits>
@@ -34,8 +35,8 @@ std::ostream &operator<<(std::ostream &ost, CountType ct) {
   throw error("Unrecognised CountType");
 }
 
-template <typename Helper>
-std::vector<uint64_t> tPathCount(const Edges<uint64_t> &fwdEdges,
+template <typename Helper, typename TEdges>
+std::vector<uint64_t> tPathCount(const TEdges &fwdEdges,
                                  ErrorIfCycle eic,
                                  VerifyEdges ves) {
 
@@ -50,10 +51,11 @@ std::vector<uint64_t> tPathCount(const Edges<uint64_t> &fwdEdges,
   std::vector<uint64_t> counts(N);
   std::vector<uint64_t> downStreams;
   for (uint64_t i = 0; i < N; ++i) {
-    const auto node = sc[N - i - 1];
-    downStreams.resize(fwdEdges[node].size());
-    for (uint64_t j = 0; j < fwdEdges[node].size(); ++j) {
-      downStreams[j] = counts[fwdEdges[node][j]];
+    const auto node  = sc[N - i - 1];
+    const auto &outs = fwdEdges[node];
+    downStreams.resize(outs.size());
+    for (uint64_t j = 0; j < outs.size(); ++j) {
+      downStreams[j] = counts[outs[j]];
     }
     counts[node] = Helper::get(downStreams);
   }
@@ -94,26 +96,118 @@ public:
   }
 };
 
-// template <typename Helper>
+namespace {
+template <typename TEdges>
+std::vector<uint64_t> tCount(const TEdges &fwdEdges,
+                             CountType t,
+                             ErrorIfCycle eic,
+                             VerifyEdges ves) {
+
+  switch (t) {
+  case CountType::Add: {
+    return tPathCount<CountAdd>(fwdEdges, eic, ves);
+  }
+  case CountType::Max: {
+    return tPathCount<CountMax>(fwdEdges, eic, ves);
+  }
+  case CountType::Min: {
+    return tPathCount<CountMin>(fwdEdges, eic, ves);
+  }
+  }
+
+  throw error("Unrecognised CountType");
+}
+} // namespace
+
 std::vector<uint64_t> PathCounter::count(const Edges<uint64_t> &fwdEdges,
                                          CountType t,
                                          ErrorIfCycle eic,
                                          VerifyEdges ves) {
+  return tCount(fwdEdges, t, eic, ves);
+}
 
+std::vector<uint64_t> PathCounter::count(const CsrEdges<uint64_t> &fwdEdges,
+                                         CountType t,
+                                         ErrorIfCycle eic,
+                                         VerifyEdges ves) {
+  return tCount(fwdEdges, t, eic, ves);
+}
+
+namespace {
+template <typename Helper, typename TEdges>
+std::vector<uint64_t> tPathCountParallel(const TEdges &fwdEdges,
+                                         uint64_t nThreads,
+                                         ErrorIfCycle eic,
+                                         VerifyEdges ves) {
+
+  const auto fs = frontier::frontierKahn(fwdEdges, nThreads, eic, ves);
+
+  // All of the outputs of a node are in later frontiers, so going through
+  // the frontiers in reverse order, the counts of the nodes in a frontier
+  // can be set concurrently.
+  std::vector<uint64_t> counts(fwdEdges.size());
+  for (uint64_t f = fs.nFrontiers(); f-- > 0;) {
+    const auto begin = fs.starts[f];
+    const auto end   = fs.starts[f + 1];
+
+    auto setCounts = [&fs, &fwdEdges, &counts, begin](uint64_t,
+                                                      uint64_t b,
+                                                      uint64_t e) {
+      std::vector<uint64_t> downStreams;
+      for (uint64_t k = begin + b; k < begin + e; ++k) {
+        const auto node  = fs.schedule[k];
+        const auto &outs = fwdEdges[node];
+        downStreams.resize(outs.size());
+        for (uint64_t j = 0; j < outs.size(); ++j) {
+          downStreams[j] = counts[outs[j]];
+        }
+        counts[node] = Helper::get(downStreams);
+      }
+    };
+    frontier::parallelFor(nThreads, end - begin, setCounts);
+  }
+  return counts;
+}
+
+template <typename TEdges>
+std::vector<uint64_t> tCountParallel(const TEdges &fwdEdges,
+                                     CountType t,
+                                     uint64_t nThreads,
+                                     ErrorIfCycle eic,
+                                     VerifyEdges ves) {
   switch (t) {
   case CountType::Add: {
-    return tPathCount<CountAdd>(fwdEdges, eic, ves);
+    return tPathCountParallel<CountAdd>(fwdEdges, nThreads, eic, ves);
   }
   case CountType::Max: {
-    return tPathCount<CountMax>(fwdEdges, eic, ves);
+    return tPathCountParallel<CountMax>(fwdEdges, nThreads, eic, ves);
   }
   case CountType::Min: {
-    return tPathCount<CountMin>(fwdEdges, eic, ves);
+    return tPathCountParallel<CountMin>(fwdEdges, nThreads, eic, ves);
   }
   }
 
   throw error("Unrecognised CountType");
 }
+} // namespace
+
+std::vector<uint64_t>
+PathCounter::countParallel(const Edges<uint64_t> &fwdEdges,
+                           CountType t,
+                           uint64_t nThreads,
+                           ErrorIfCycle eic,
+                           VerifyEdges ves) {
+  return tCountParallel(fwdEdges, t, nThreads, eic, ves);
+}
+
+std::vector<uint64_t>
+PathCounter::countParallel(const CsrEdges<uint64_t> &fwdEdges,
+                           CountType t,
+                           uint64_t nThreads,
+                           ErrorIfCycle eic,
+                           VerifyEdges ves) {
+  return tCountParallel(fwdEdges, t, nThreads, eic, ves);
+}
 
 } // namespace vanilla
 } // namespace schedule
@@ -48,7 +48,8 @@ private:
 
 template <typename TNode> class SchedulerWithoutPriorities {
 public:
-  static std::vector<TNode> kahn(const Edges<TNode> &fwdEdges,
+  template <typename TEdges>
+  static std::vector<TNode> kahn(const TEdges &fwdEdges,
                                  uint32_t seed) {
     auto a_ = StackWithoutPriorities<TNode>(fwdEdges.size(), seed);
     return stackBasedKahn<TNode>(fwdEdges, a_);
@@ -90,8 +91,9 @@ private:
 template <typename TNode, typename TPriority>
 class SchedulerWithManyPriorities {
 public:
+  template <typename TEdges>
   static std::vector<TNode>
-  kahn(const Edges<TNode> &fwdEdges,
+  kahn(const TEdges &fwdEdges,
        const Priorities<TNode, TPriority> &priorities,
        uint64_t seed) {
     auto a_ = StackWithManyPriorities(fwdEdges.size(), priorities, seed);
@@ -99,8 +101,8 @@ public:
   }
 };
 
-template <typename TNode, typename TPriority>
-static std::vector<TNode> kahn(const Edges<TNode> &fwdEdges,
+template <typename TNode, typename TPriority, typename TEdges>
+static std::vector<TNode> kahn(const TEdges &fwdEdges,
                                const Priorities<TNode, TPriority> &priorities,
                                const Links<TNode> &links,
                                uint32_t seed,
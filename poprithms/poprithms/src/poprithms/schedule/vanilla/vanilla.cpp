@@ -11,6 +11,7 @@
 #include <schedule/vanilla/error.hpp>
 #include <schedule/vanilla/fifostack.hpp>
 #include <schedule/vanilla/filostack.hpp>
+#include <schedule/vanilla/frontier.hpp>
 #include <schedule/vanilla/greedystack.hpp>
 #include <schedule/vanilla/kahn.hpp>
 #include <schedule/vanilla/randomstack.hpp>
@@ -21,10 +22,10 @@ namespace poprithms {
 namespace schedule {
 namespace vanilla {
 
-template <typename TNode, typename Stack>
-bool isComplete(const Edges<TNode> &es, VerifyEdges ve) {
+template <typename TNode, typename Stack, typename TEdges>
+bool isComplete(const TEdges &es, VerifyEdges ve) {
   if (ve == VerifyEdges::Yes) {
-    verifyEdges(es);
+    verifyEdges<TNode>(es);
   }
   auto outstandingCount = getOutstandingCount(es);
   uint64_t nScheduled{0};
@@ -75,6 +76,11 @@ bool Query<TNode>::isSchedulable(const Edges<TNode> &es, VerifyEdges ve) {
   return isComplete<TNode, IsSchedulableStack<TNode>>(es, ve);
 }
 
+template <typename TNode>
+bool Query<TNode>::isSchedulable(const CsrEdges<TNode> &es, VerifyEdges ve) {
+  return isComplete<TNode, IsSchedulableStack<TNode>>(es, ve);
+}
+
 template <typename TNode>
 bool Query<TNode>::isSchedulable(const Edges<TNode> &es,
                                  const Links<TNode> &links,
@@ -102,6 +108,12 @@ bool Query<TNode>::hasUniqueSchedule(const Edges<TNode> &fwdEdges,
   return isComplete<TNode, HasUniqueSchedule<TNode>>(fwdEdges, ve);
 }
 
+template <typename TNode>
+bool Query<TNode>::hasUniqueSchedule(const CsrEdges<TNode> &fwdEdges,
+                                     VerifyEdges ve) {
+  return isComplete<TNode, HasUniqueSchedule<TNode>>(fwdEdges, ve);
+}
+
 template <typename TNode, typename TPriority>
 std::vector<TNode> Scheduler<TNode, TPriority>::filo(
     const Edges<TNode> &fwdEdges,
@@ -134,6 +146,38 @@ std::vector<TNode> Scheduler<TNode, TPriority>::random(
       fwdEdges, priorities, links, seed, eic, ve);
 }
 
+template <typename TNode, typename TPriority>
+std::vector<TNode> Scheduler<TNode, TPriority>::filo(
+    const CsrEdges<TNode> &fwdEdges,
+    const Priorities<TNode, TPriority> &priorities,
+    const Links<TNode> &links,
+    ErrorIfCycle eic,
+    VerifyEdges ve) {
+  return filo::kahn<TNode, TPriority>(fwdEdges, priorities, links, eic, ve);
+}
+
+template <typename TNode, typename TPriority>
+std::vector<TNode> Scheduler<TNode, TPriority>::fifo(
+    const CsrEdges<TNode> &fwdEdges,
+    const Priorities<TNode, TPriority> &priorities,
+    const Links<TNode> &links,
+    ErrorIfCycle eic,
+    VerifyEdges ve) {
+  return fifo::kahn<TNode, TPriority>(fwdEdges, priorities, links, eic, ve);
+}
+
+template <typename TNode, typename TPriority>
+std::vector<TNode> Scheduler<TNode, TPriority>::random(
+    const CsrEdges<TNode> &fwdEdges,
+    const Priorities<TNode, TPriority> &priorities,
+    const Links<TNode> &links,
+    uint32_t seed,
+    ErrorIfCycle eic,
+    VerifyEdges ve) {
+  return random::kahn<TNode, TPriority>(
+      fwdEdges, priorities, links, seed, eic, ve);
+}
+
 std::vector<int64_t>
 getSchedule_i64(const std::vector<std::vector<int64_t>> &fwdEdges,
                 ErrorIfCycle eic,
@@ -148,6 +192,34 @@ getSchedule_u64(const std::vector<std::vector<uint64_t>> &fwdEdges,
   return Scheduler<uint64_t, double>::filo(fwdEdges, {}, {}, eic, ve);
 }
 
+std::vector<int64_t> getSchedule_i64(const CsrEdges<int64_t> &fwdEdges,
+                                     ErrorIfCycle eic,
+                                     VerifyEdges ve) {
+  return Scheduler<int64_t, double>::filo(fwdEdges, {}, {}, eic, ve);
+}
+
+std::vector<uint64_t> getSchedule_u64(const CsrEdges<uint64_t> &fwdEdges,
+                                      ErrorIfCycle eic,
+                                      VerifyEdges ve) {
+  return Scheduler<uint64_t, double>::filo(fwdEdges, {}, {}, eic, ve);
+}
+
+std::vector<uint64_t>
+getParallelFifoSchedule_u64(const Edges<uint64_t> &fwdEdges,
+                            uint64_t nThreads,
+                            ErrorIfCycle eic,
+                            VerifyEdges ve) {
+  return frontier::frontierKahn(fwdEdges, nThreads, eic, ve).schedule;
+}
+
+std::vector<uint64_t>
+getParallelFifoSchedule_u64(const CsrEdges<uint64_t> &fwdEdges,
+                            uint64_t nThreads,
+                            ErrorIfCycle eic,
+                            VerifyEdges ve) {
+  return frontier::frontierKahn(fwdEdges, nThreads, eic, ve).schedule;
+}
+
 template <typename TNode, typename TPriority, typename TAllocSize>
 std::vector<TNode> GreedyScheduler<TNode, TPriority, TAllocSize>::kahn(
     const Edges<TNode> &fwdEdges,
@@ -0,0 +1,109 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <util/error.hpp>
+
+#include <poprithms/util/threadpool.hpp>
+
+namespace poprithms {
+namespace util {
+
+ThreadPool::ThreadPool(uint64_t nThreads)
+    : nThreads_(nThreads), errors(nThreads) {
+  if (nThreads_ == 0) {
+    throw error("The number of threads of a ThreadPool must be at least 1.");
+  }
+  threads.reserve(nThreads_ - 1);
+  for (uint64_t t = 1; t < nThreads_; ++t) {
+    threads.emplace_back([this, t]() { work(t); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  jobReady.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::work(uint64_t t) {
+  uint64_t previous{0};
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    jobReady.wait(lock, [this, previous]() {
+      return stopping || jobIndex != previous;
+    });
+    if (stopping) {
+      return;
+    }
+    previous = jobIndex;
+    auto &f  = *job;
+    lock.unlock();
+    try {
+      f(t);
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+    lock.lock();
+    if (--nRunning == 0) {
+      jobDone.notify_one();
+    }
+  }
+}
+
+void ThreadPool::forEachThread(const std::function<void(uint64_t)> &f) {
+
+  bool expected{false};
+  if (nThreads_ == 1 || !inUse.compare_exchange_strong(expected, true)) {
+    for (uint64_t t = 0; t < nThreads_; ++t) {
+      f(t);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job      = &f;
+    nRunning = nThreads_ - 1;
+    ++jobIndex;
+  }
+  jobReady.notify_all();
+
+  try {
+    f(0);
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this]() { return nRunning == 0; });
+    job = nullptr;
+  }
+
+  std::exception_ptr e;
+  for (auto &error_ : errors) {
+    if (error_ && !e) {
+      e = error_;
+    }
+    error_ = nullptr;
+  }
+  inUse.store(false);
+  if (e) {
+    std::rethrow_exception(e);
+  }
+}
+
+void ThreadPool::parallelFor(
+    uint64_t n,
+    const std::function<void(uint64_t, uint64_t, uint64_t)> &f) {
+  const auto N = nThreads_;
+  forEachThread(
+      [&f, n, N](uint64_t t) { f(t, n * t / N, n * (t + 1) / N); });
+}
+
+} // namespace util
+} // namespace poprithms
@@ -0,0 +1,170 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <functional>
+#include <sstream>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Check that running the ops of sub-graphs with the dataflow executor gives
+// exactly the same values as running them in the order of the schedule.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+// Run #sg #nRuns times with each mode and number of threads, after
+// initializing the host values with #init, and compare the values of #ids.
+// The final run is on a copy of the executable.
+void compareModes(const SlickGraph &g,
+                  SubGraphId sg,
+                  const TensorIds &ids,
+                  const std::function<void(SimExecutable &)> &init,
+                  uint64_t nRuns = 3) {
+
+  auto run = [&](SimExecutionMode mode, uint64_t nThreads) {
+    SimExecutable se(g, mode, nThreads);
+    if (se.mode() != mode || se.nThreads() != nThreads) {
+      throw poprithms::test::error("Unexpected mode or number of threads");
+    }
+    init(se);
+    for (uint64_t i = 1; i < nRuns; ++i) {
+      se.run(sg);
+    }
+
+    // The final run is on a copy, which has its own threads.
+    SimExecutable copy(se);
+    copy.run(sg);
+    HostTensors ts;
+    for (const auto &id : ids) {
+      ts.push_back(copy.getHostValue(id).copy());
+    }
+    return ts;
+  };
+
+  const auto expected = run(SimExecutionMode::Serial, 1);
+  for (uint64_t nThreads : {1, 2, 3, 8}) {
+    const auto observed = run(SimExecutionMode::Dataflow, nThreads);
+    for (uint64_t i = 0; i < ids.size(); ++i) {
+      observed[i].assertAllEquivalent(expected[i]);
+    }
+  }
+}
+
+// Independent branches with aliasing and inplace ops, and a final inplace
+// modification of the shared input.
+void testBranches0() {
+
+  SlickGraph g;
+  auto sg = g.createSubGraph("sg0");
+  auto x  = sg.hostFloat32Variable({64});
+
+  Tensor sum = x.constant(0.0);
+  for (uint64_t i = 0; i < 8; ++i) {
+    auto head = (x + x.constant(0.5 * i)).sin_().mul(x.cos());
+    head.reshape_({8, 8}).slice_({0, 0}, {4, 8}).abs_();
+    sum = sum + head.reduceSum(Shape{});
+  }
+
+  // Modifies x, and so must run after all of the branches have read x.
+  x.add_(sum);
+
+  g.setRunnable({sg});
+
+  compareModes(g, sg, {x, sum}, [x](SimExecutable &se) {
+    se.setHostValue(x, HostTensor::uniformFloat32(-1, 1, {64}, 1011));
+  });
+}
+
+// Calls of the same callee (which must not run concurrently), and of
+// different callees, and a repeat.
+void testCallees0() {
+
+  SlickGraph g;
+
+  auto sgA  = g.createSubGraph("sgA");
+  auto inA  = sgA.hostFloat32Variable({4});
+  auto outA = inA.sin().exp();
+
+  auto sgB  = g.createSubGraph("sgB");
+  auto inB  = sgB.hostFloat32Variable({4});
+  auto outB = inB.cos().abs().sqrt();
+
+  auto sg = g.createSubGraph("caller");
+  auto x  = sg.hostFloat32Variable({4});
+
+  TensorIds outs;
+  for (uint64_t i = 0; i < 4; ++i) {
+    auto xi = x + x.constant(1.0 * i);
+    auto cA = sg.call(sgA, {{xi, inA}}, {outA});
+    auto cB = sg.call(sgB, {{xi, inB}}, {outB});
+    outs.push_back(outA.dstInCaller(cA).id());
+    outs.push_back(outB.dstInCaller(cB).id());
+  }
+
+  auto rpt =
+      sg.repeat(sgA, 3, {}, {{{x, inA, outA}}}, {{outA, IsStackedCopy::No}});
+  outs.push_back(outA.dstInCaller(rpt).id());
+
+  g.setRunnable({sg});
+
+  compareModes(g, sg, outs, [x](SimExecutable &se) {
+    se.setHostValue(x, HostTensor::uniformFloat32(-1, 1, {4}, 1012));
+  });
+}
+
+// A tensor which is referenced from 2 sub-graphs, and which is read in the
+// caller and modified in a callee.
+void testRefs0() {
+
+  SlickGraph g;
+  auto sgW = g.createSubGraph("weights");
+  auto w   = sgW.hostFloat32Variable({4});
+
+  auto sgU  = g.createSubGraph("update");
+  auto inU  = sgU.hostFloat32Variable({4});
+  auto wU   = w.refTo_(sgU);
+  auto outU = wU.add_(inU).sin();
+
+  auto sg    = g.createSubGraph("caller");
+  auto x     = sg.hostFloat32Variable({4});
+  auto wRef  = w.refTo_(sg);
+  auto read0 = wRef.cos();
+  auto c0    = sg.call(sgU, {{x, inU}}, {outU});
+  auto read1 = wRef.reshape_({2, 2}).exp() + read0.reshape({2, 2});
+  auto out   = outU.dstInCaller(c0) + read0;
+
+  g.setRunnable({sg});
+
+  compareModes(g, sg, {read0, read1, out}, [x, w](SimExecutable &se) {
+    se.setHostValue(x, HostTensor::uniformFloat32(-1, 1, {4}, 1013));
+    se.setHostValue(w, HostTensor::uniformFloat32(-1, 1, {4}, 1014));
+  });
+}
+
+void testInvalidNumberOfThreads0() {
+  SlickGraph g;
+  auto sg = g.createSubGraph("sg0");
+  sg.hostFloat32Variable({2});
+  g.setRunnable({sg});
+  bool caught{false};
+  try {
+    SimExecutable se(g, SimExecutionMode::Dataflow, 0);
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to catch 0 threads");
+  }
+}
+
+} // namespace
+
+int main() {
+  testBranches0();
+  testCallees0();
+  testRefs0();
+  testInvalidNumberOfThreads0();
+  return 0;
+}
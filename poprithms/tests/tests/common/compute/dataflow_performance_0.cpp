@@ -0,0 +1,106 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Time a graph with many independent branches (heads) with the ops run
+// serially, and with the dataflow executor with different numbers of
+// threads.
+//
+// Usage: dataflow_performance_0 [N n]
+//
+// where n is the size of the (n x n) matrices (default 128). There are 16
+// heads, each a chain of 8 matmuls.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+void benchmarkHeads(int64_t n) {
+
+  const uint64_t nHeads{16};
+  const uint64_t depth{8};
+  const uint64_t nRuns{4};
+
+  SlickGraph g;
+  auto sg = g.createSubGraph("heads");
+  auto x  = sg.hostFloat32Variable({n, n});
+
+  Tensor sum = x.constant(0.0);
+  for (uint64_t h = 0; h < nHeads; ++h) {
+    auto w = x.variable();
+    auto y = x;
+    for (uint64_t d = 0; d < depth; ++d) {
+      y = y.matmul(w).sin();
+    }
+    sum = sum + y.reduceSum(Shape{});
+  }
+  g.setRunnable({sg});
+
+  std::cout << "nHeads=" << nHeads << ", depth=" << depth << ", n=" << n
+            << ", hardware threads=" << std::thread::hardware_concurrency()
+            << "\n\n"
+            << std::setw(12) << "mode" << std::setw(12) << "nThreads"
+            << std::setw(16) << "time/run [s]" << std::setw(12) << "speedup"
+            << std::endl;
+
+  double tSerial{0};
+  HostTensor expected = HostTensor::float32(0);
+
+  auto time = [&](SimExecutionMode mode, uint64_t nThreads) {
+    SimExecutable se(g, mode, nThreads);
+    se.setHostValue(x, HostTensor::uniformFloat32(-1, 1, {n, n}, 1011));
+
+    // Warm up (this populates the buffer pool).
+    se.run(sg);
+
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < nRuns; ++i) {
+      se.run(sg);
+    }
+    const auto t = seconds(t0) / nRuns;
+
+    if (mode == SimExecutionMode::Serial) {
+      tSerial  = t;
+      expected = se.getHostValue(sum).copy();
+    } else {
+      se.getHostValue(sum).assertAllEquivalent(expected);
+    }
+
+    std::cout << std::setw(12)
+              << (mode == SimExecutionMode::Serial ? "serial" : "dataflow")
+              << std::setw(12) << nThreads << std::setw(16) << t
+              << std::setw(12) << tSerial / t << std::endl;
+  };
+
+  time(SimExecutionMode::Serial, 1);
+  for (uint64_t nThreads : {1, 2, 4, 8, 16}) {
+    time(SimExecutionMode::Dataflow, nThreads);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  int64_t n{128};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stol(argv[2]);
+  }
+
+  benchmarkHeads(n);
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Time copying a graph with many ops, where the copy shares the ops of the
+// original, and compare it to copying the graph and cloning all of its ops.
+//
+// Usage: graph_copy_performance_0 [N n]
+//
+// where n is the number of ops in the graph, in thousands (default 100).
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+void benchmarkCopy(uint64_t nOps) {
+
+  SlickGraph g;
+  auto sg = g.createSubGraph("sg0");
+  auto x  = sg.hostFloat32Variable({4});
+  for (uint64_t i = 1; i < nOps / 2; ++i) {
+    x = x.sin().abs();
+  }
+  g.setRunnable({sg});
+
+  auto report = [nOps](const std::string &what,
+                       double t,
+                       const SlickGraph &copy) {
+    std::cout << what << ": " << t << " [s], " << 1e9 * t / nOps
+              << " [ns/op], " << copy.nOps() - copy.nSharedOps()
+              << " ops cloned" << std::endl;
+  };
+
+  // 1) A copy which shares all of the ops of #g.
+  auto t0 = std::chrono::high_resolution_clock::now();
+  SlickGraph shared(g);
+  report("copy", seconds(t0), shared);
+  if (shared.nSharedOps() != shared.nOps()) {
+    throw poprithms::test::error("Expected all ops to be shared");
+  }
+
+  // 2) A copy in which a single op is modified.
+  t0 = std::chrono::high_resolution_clock::now();
+  SlickGraph modified(g);
+  modified.setName(x.opId(), "modified");
+  report("copy and modify 1 op", seconds(t0), modified);
+  if (g.getName(x.opId()) == "modified") {
+    throw poprithms::test::error("Modifying the copy modified the original");
+  }
+
+  // 3) A copy in which all ops are cloned. This is what copying a graph
+  // cost before ops were shared.
+  t0 = std::chrono::high_resolution_clock::now();
+  SlickGraph cloned(g);
+  cloned.bindOps();
+  report("copy and clone all ops", seconds(t0), cloned);
+
+  if (cloned != g || modified == g || shared != g) {
+    throw poprithms::test::error("Unexpected comparison of copies");
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{100};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  benchmarkCopy(1000 * n);
+  return 0;
+}
@@ -0,0 +1,206 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <sstream>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Check that sharing the buffers of intermediate tensors
+// (SimMemoryMode::Planned) gives exactly the same values as allocating all
+// tensors (SimMemoryMode::Unplanned), and that it reduces the peak
+// simulated host memory.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+// Run #sg #nRuns times with each memory mode, and compare the values of
+// the host tensor #out. Returns the stats of the planned executable.
+SimMemoryStats compareModes(const SlickGraph &g,
+                            SubGraphId sg,
+                            const TensorId &in,
+                            const TensorId &out,
+                            uint64_t nRuns = 3) {
+
+  auto run = [&](SimMemoryMode memoryMode, SimMemoryStats &stats) {
+    SimExecutable se(g, SimExecutionMode::Serial, 1, memoryMode);
+    if (se.memoryMode() != memoryMode) {
+      throw poprithms::test::error("Unexpected memory mode");
+    }
+    HostTensors ts;
+    for (uint64_t i = 0; i < nRuns; ++i) {
+      se.setHostValue(
+          in,
+          HostTensor::uniformFloat32(-1, 1, g.shape(in), 1011 + i));
+      se.run(sg);
+      ts.push_back(se.getHostValue(out).copy());
+    }
+    stats = se.memoryStats();
+    return ts;
+  };
+
+  SimMemoryStats unplanned;
+  SimMemoryStats planned;
+  const auto expected = run(SimMemoryMode::Unplanned, unplanned);
+  const auto observed = run(SimMemoryMode::Planned, planned);
+  for (uint64_t i = 0; i < nRuns; ++i) {
+    observed[i].assertAllEquivalent(expected[i]);
+  }
+
+  if (unplanned.nPlannedTensors != 0 || unplanned.nBuffers != 0 ||
+      unplanned.peakBytes != unplanned.peakBytesUnplanned) {
+    throw poprithms::test::error(
+        "Expected no tensors to be planned with SimMemoryMode::Unplanned");
+  }
+
+  if (planned.peakBytesUnplanned != unplanned.peakBytes) {
+    throw poprithms::test::error(
+        "Expected the same unplanned memory with both memory modes");
+  }
+
+  return planned;
+}
+
+// A long chain of ops on ipu tensors, with views and inplace ops, and one
+// intermediate which is live until the end of the schedule.
+void testChain0() {
+
+  const uint64_t rf{2};
+  SlickGraph g(32, ReplicationFactor::create(rf));
+  auto sg  = g.createSubGraph("sg0");
+  auto hIn = sg.hostFloat32Variable({1, rf, 16});
+  auto x   = hIn.hostToIpu(g.rootIpu());
+
+  auto early = x.cos();
+  for (uint64_t i = 0; i < 16; ++i) {
+    x = (x.sin() * x.constant(0.5)).add(x.abs());
+    if (i % 4 == 0) {
+      x.reshape_({4, 4}).slice_({0, 0}, {2, 4}).neg_();
+    }
+  }
+  auto hOut = (x + early).ipuToHost(1);
+
+  g.setRunnable({sg});
+
+  const auto stats = compareModes(g, sg, hIn, hOut);
+
+  // Each intermediate is 16 float32 elements on each replica. The chain has
+  // 4 intermediates per iteration (sin, mul, abs, add), and only a few
+  // intermediates are live at once.
+  if (stats.nPlannedTensors < 64 || stats.nBuffers > 8) {
+    std::ostringstream oss;
+    oss << "Expected at least 64 planned tensors sharing at most 8 "
+        << "buffers, but " << stats.nPlannedTensors << " tensors share "
+        << stats.nBuffers << " buffers.";
+    throw poprithms::test::error(oss.str());
+  }
+
+  if (stats.peakBytes >= stats.peakBytesUnplanned ||
+      stats.peakBytesUnplanned - stats.peakBytes !=
+          (stats.nPlannedTensors - stats.nBuffers) * 16 * 4 * rf) {
+    std::ostringstream oss;
+    oss << "Unexpected peak memory of " << stats.peakBytes
+        << " bytes, with " << stats.peakBytesUnplanned
+        << " bytes when unplanned.";
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+// The intermediates of a callee which is repeated are planned, the tensors
+// which are copied to and from the callee are not.
+void testRepeat0() {
+
+  SlickGraph g(32, ReplicationFactor::create(1));
+
+  auto callee = g.createSubGraph("callee");
+  auto x0     = callee.rootIpuFloat32Variable({4});
+  auto x1     = x0;
+  for (uint64_t i = 0; i < 6; ++i) {
+    x1 = (x1.sin() * x0.constant(0.5)).add(x0.cos());
+  }
+
+  auto caller = g.createSubGraph("caller");
+  auto hIn    = caller.hostFloat32Variable({1, 1, 4});
+  auto in0    = hIn.hostToIpu(g.rootIpu());
+  auto rpt    = caller.repeat(
+      callee, 5, {}, {{{in0, x0, x1}}}, {{x1, IsStackedCopy::No}});
+  auto hOut = x1.dstInCaller(rpt).ipuToHost(1);
+  g.setRunnable({caller});
+
+  const auto stats = compareModes(g, caller, hIn, hOut);
+  if (stats.nPlannedTensors == 0 ||
+      stats.peakBytes >= stats.peakBytesUnplanned) {
+    throw poprithms::test::error(
+        "Expected the intermediates of the callee to share buffers");
+  }
+}
+
+// The temporary tensors created while ops are run are reported through the
+// buffer pool, and the stored values do not use the caller's pool.
+void testPoolStats0() {
+
+  SlickGraph g(32, ReplicationFactor::create(1));
+  auto sg  = g.createSubGraph("sg0");
+  auto hIn = sg.hostFloat32Variable({1, 1, 100});
+  auto x   = hIn.hostToIpu(g.rootIpu());
+  for (uint64_t i = 0; i < 4; ++i) {
+    x = x.sin().add(x.cos());
+  }
+  x.ipuToHost(1);
+  g.setRunnable({sg});
+
+  poprithms::compute::host::BufferPool callerPool;
+  poprithms::compute::host::BufferPool::Scope scope(callerPool);
+  SimExecutable se(g, SimExecutionMode::Serial, 1, SimMemoryMode::Planned);
+  if (callerPool.stats().nAcquisitions != 0) {
+    throw poprithms::test::error(
+        "The stored values should not use the caller's buffer pool");
+  }
+
+  se.run(sg);
+  if (se.memoryStats().poolPeakBytes != 0) {
+    throw poprithms::test::error("Expected no pool bytes without a pool");
+  }
+
+  se.enableBufferPool();
+  se.run(sg);
+  se.run(sg);
+  const auto stats = se.memoryStats();
+  if (stats.poolPeakBytes < 100 * 4 ||
+      stats.poolPeakBytes != se.bufferPool()->stats().peakBytes ||
+      stats.poolBytesHeld != se.bufferPool()->stats().nBytesHeld) {
+    std::ostringstream oss;
+    oss << "Unexpected pool stats, poolPeakBytes=" << stats.poolPeakBytes
+        << " and poolBytesHeld=" << stats.poolBytesHeld << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void testDataflowNotSupported0() {
+  SlickGraph g;
+  auto sg = g.createSubGraph("sg0");
+  sg.hostFloat32Variable({2});
+  g.setRunnable({sg});
+  bool caught{false};
+  try {
+    SimExecutable se(
+        g, SimExecutionMode::Dataflow, 2, SimMemoryMode::Planned);
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error(
+        "Failed to catch planned memory with the dataflow executor");
+  }
+}
+
+} // namespace
+
+int main() {
+  testChain0();
+  testRepeat0();
+  testPoolStats0();
+  testDataflowNotSupported0();
+  return 0;
+}
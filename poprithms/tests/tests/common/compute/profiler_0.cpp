@@ -0,0 +1,130 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <sstream>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Check the events recorded by the op profiler of SimExecutable, and the
+// statistics aggregated from them, with both execution modes.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+void testProfile0(SimExecutionMode mode, uint64_t nThreads) {
+
+  SlickGraph g;
+
+  auto callee = g.createSubGraph("body");
+  auto in0    = callee.hostFloat32Variable({8});
+  auto sin0   = in0.sin();
+  auto out0   = sin0.exp();
+
+  auto caller = g.createSubGraph("main");
+  auto x      = caller.hostFloat32Variable({8});
+  auto y      = x.cos();
+  auto rpt    = caller.repeat(
+      callee, 3, {}, {{{y, in0, out0}}}, {{out0, IsStackedCopy::No}});
+  auto z = out0.dstInCaller(rpt).abs();
+
+  g.setRunnable({caller});
+
+  SimExecutable se(g, mode, nThreads);
+  se.setHostValue(x, HostTensor::uniformFloat32(-1, 1, {8}, 1011));
+
+  // Profiling is disabled by default.
+  se.run(caller);
+  if (se.isProfiling() || !se.profiler().opEvents().empty() ||
+      !se.profiler().runEvents().empty()) {
+    throw poprithms::test::error("Expected no events without profiling");
+  }
+
+  se.enableProfiling();
+  const uint64_t nRuns{2};
+  for (uint64_t i = 0; i < nRuns; ++i) {
+    se.run(caller);
+  }
+  se.disableProfiling();
+  se.run(caller);
+
+  const auto &p = se.profiler();
+  if (p.runEvents().size() != nRuns) {
+    throw poprithms::test::error("Expected 1 run event per profiled run");
+  }
+
+  // The variables are not run. Every other op in the caller runs once per
+  // run, and every op in the callee runs 3 times per run.
+  const auto byOp = p.statsByOp(g);
+  if (byOp.size() != 5 || byOp.count(x.opId()) != 0) {
+    throw poprithms::test::error("Expected events for 5 ops");
+  }
+  for (auto opId : {y.opId(), rpt, z.opId()}) {
+    if (byOp.at(opId).nInvocations != nRuns) {
+      throw poprithms::test::error("Expected each caller op to run once");
+    }
+  }
+  for (auto opId : {sin0.opId(), out0.opId()}) {
+    if (byOp.at(opId).nInvocations != 3 * nRuns) {
+      throw poprithms::test::error("Expected each callee op to run 3 times");
+    }
+  }
+
+  // The sin op reads and writes 8 float32 values.
+  const auto &sinStats = byOp.at(sin0.opId());
+  if (sinStats.bytesRead != 3 * nRuns * 8 * 4 ||
+      sinStats.bytesWritten != 3 * nRuns * 8 * 4) {
+    throw poprithms::test::error("Unexpected number of bytes for sin");
+  }
+
+  // The repeat op's self time excludes the time of the ops in the callee.
+  const auto &rptStats = byOp.at(rpt);
+  if (rptStats.selfSeconds > rptStats.seconds) {
+    throw poprithms::test::error("Self time cannot exceed total time");
+  }
+
+  const auto byType = p.statsByOpType(g);
+  if (byType.at("Abs").nInvocations != nRuns ||
+      byType.at("Repeat").nInvocations != nRuns ||
+      byType.at("Sin").nInvocations != 3 * nRuns) {
+    throw poprithms::test::error("Unexpected number of invocations by type");
+  }
+
+  const auto byStack = p.statsByCallStack(g);
+  const auto inBody =
+      "main/Repeat(op=" + std::to_string(rpt.get()) + ")/body";
+  if (byStack.at("main").nInvocations != 3 * nRuns ||
+      byStack.at(inBody).nInvocations != 2 * 3 * nRuns) {
+    std::ostringstream oss;
+    oss << "Unexpected invocations by call stack, summary is\n"
+        << se.profileSummary();
+    throw poprithms::test::error(oss.str());
+  }
+
+  std::ostringstream trace;
+  se.appendProfileChromeTrace(trace);
+  const auto t = trace.str();
+  if (t.find("{\"traceEvents\":[") != 0 ||
+      t.find("\"cat\":\"op\"") == std::string::npos ||
+      t.find(inBody) == std::string::npos) {
+    throw poprithms::test::error("Unexpected chrome trace:\n" + t);
+  }
+
+  if (se.profileSummary().find("Call stack") == std::string::npos) {
+    throw poprithms::test::error("Expected a summary by call stack");
+  }
+
+  se.clearProfile();
+  if (!p.opEvents().empty()) {
+    throw poprithms::test::error("Expected no events after clearing");
+  }
+}
+
+} // namespace
+
+int main() {
+  testProfile0(SimExecutionMode::Serial, 1);
+  testProfile0(SimExecutionMode::Dataflow, 3);
+  return 0;
+}
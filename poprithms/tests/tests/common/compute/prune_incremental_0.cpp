@@ -0,0 +1,193 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+#include <poprithms/common/compute/prune/incrementalpruner.hpp>
+#include <poprithms/common/compute/prune/pruner.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+#include <poprithms/util/printiter.hpp>
+
+// Check that pruning with the IncrementalPruner after a sequence of
+// transformations gives the same graph as pruning with Pruner::prune.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+// Check that #a and #b have the same live ops, with the same inputs and
+// number of outputs.
+void assertSamePruned(const Graph &a, const Graph &b) {
+  const auto opIds = a.opIds();
+  bool same        = opIds == b.opIds();
+  for (auto opId : opIds) {
+    same = same && a.inTensorIds(opId) == b.inTensorIds(opId) &&
+           a.nOutTensors(opId) == b.nOutTensors(opId) &&
+           a.typeString(opId) == b.typeString(opId);
+  }
+  if (!same) {
+    std::ostringstream oss;
+    oss << "Incremental pruning gives the ops ";
+    poprithms::util::append(oss, a.opIds());
+    oss << ", but pruning the complete graph gives the ops ";
+    poprithms::util::append(oss, b.opIds());
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+// Prune #g incrementally with #pruner, and compare to pruning a copy of #g
+// with Pruner::prune.
+void pruneAndCompare(SlickGraph &g,
+                     IncrementalPruner &pruner,
+                     const TensorIds &retain) {
+  SlickGraph expected = g;
+  Pruner::prune(expected, retain);
+  pruner.prune();
+  assertSamePruned(g, expected);
+}
+
+// Random transformations of a graph with a single sub-graph: inserting ops
+// (some of which are not on a path to a retained tensor), replacing inputs,
+// and removing ops.
+void testRandomTransforms0() {
+
+  SlickGraph g;
+  auto sg = g.createSubGraph("sg0");
+
+  std::vector<Tensor> ts{sg.hostFloat32Variable({4})};
+  std::mt19937 gen(1011);
+  auto any = [&]() { return ts[gen() % ts.size()]; };
+
+  auto insert = [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      auto a = any();
+      switch (gen() % 4) {
+      case 0:
+        ts.push_back(a.sin());
+        break;
+      case 1:
+        ts.push_back(a.abs());
+        break;
+      case 2:
+        ts.push_back(a + any());
+        break;
+      default:
+        ts.push_back(a * any());
+      }
+    }
+  };
+
+  insert(60);
+  const TensorIds retain{ts[20].id(), ts[45].id(), ts.back().id()};
+  g.setRunnable({sg});
+
+  SlickGraph expected = g;
+  Pruner::prune(expected, retain);
+
+  IncrementalPruner pruner(g, retain);
+  assertSamePruned(g, expected);
+
+  auto isRetained = [&retain](OpId opId) {
+    return std::any_of(
+        retain.cbegin(), retain.cend(), [opId](const TensorId &t) {
+          return t.opId() == opId;
+        });
+  };
+
+  uint64_t nExamined{0};
+  for (uint64_t round = 0; round < 20; ++round) {
+
+    // Only the tensors which were not pruned.
+    std::vector<Tensor> live;
+    for (const auto &t : ts) {
+      if (g.isLive(t.opId())) {
+        live.push_back(t);
+      }
+    }
+    ts = live;
+    insert(5);
+
+    // Replace an input of an op with an older tensor.
+    auto consumer = ts[1 + gen() % (ts.size() - 1)];
+    auto ins      = g.inTensorIds(consumer.opId());
+    if (!ins.empty()) {
+      auto older = ts[gen() % ts.size()];
+      if (older.opId() < consumer.opId()) {
+        g.replaceInput(consumer.opId(), InIndex(0), older.id());
+      }
+    }
+
+    // Remove an op, with an older tensor as the substitute of its output.
+    auto toRemove = ts[1 + gen() % (ts.size() - 1)];
+    if (!isRetained(toRemove.opId())) {
+      auto substitute = ts[gen() % ts.size()];
+      if (substitute.opId() < toRemove.opId()) {
+        g.removeOp(
+            toRemove.opId(), {substitute.id()}, "testRandomTransforms0");
+      }
+    }
+
+    pruneAndCompare(g, pruner, retain);
+    nExamined += pruner.nExamined();
+  }
+
+  if (pruner.nFullPrunes() != 1 || pruner.nIncrementalPrunes() != 20 ||
+      nExamined == 0) {
+    throw poprithms::test::error(
+        "Expected only the first prune to prune the complete graph");
+  }
+}
+
+// Changes to the ops of a callee, and to the op which calls it, cannot be
+// pruned incrementally.
+void testCallee0() {
+
+  SlickGraph g;
+  auto callee = g.createSubGraph("callee");
+  auto in0    = callee.hostFloat32Variable({4});
+  auto out0   = in0.sin();
+  auto out1   = in0.cos();
+
+  auto caller = g.createSubGraph("caller");
+  auto x      = caller.hostFloat32Variable({4});
+  auto c0     = caller.call(callee, {{x, in0}}, {out0, out1});
+  auto y0     = out0.dstInCaller(c0).abs();
+  auto y1     = out1.dstInCaller(c0).exp();
+  g.setRunnable({caller});
+
+  const TensorIds retain{y0.id(), y1.id()};
+  IncrementalPruner pruner(g, retain);
+
+  // A change in the caller which does not involve the call op.
+  y0.sqrt();
+  pruneAndCompare(g, pruner, retain);
+  if (pruner.nFullPrunes() != 1) {
+    throw poprithms::test::error("Expected an incremental prune");
+  }
+
+  // A change in the callee.
+  out0.neg();
+  pruneAndCompare(g, pruner, retain);
+  if (pruner.nFullPrunes() != 2) {
+    throw poprithms::test::error("Expected a change in the callee to prune "
+                                 "the complete graph");
+  }
+
+  // A change to the consumers of the call op. The output at index 1 is
+  // then not on a path to a retained tensor.
+  g.replaceInput(y1.opId(), InIndex(0), x.id());
+  pruneAndCompare(g, pruner, retain);
+  if (pruner.nFullPrunes() != 3) {
+    throw poprithms::test::error("Expected a change to the consumers of the "
+                                 "call op to prune the complete graph");
+  }
+}
+
+} // namespace
+
+int main() {
+  testRandomTransforms0();
+  testCallee0();
+  return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Time a repeat of a callee with many small ops, for which the time taken
+// by SimExecutable is dominated by the bookkeeping of running the ops, and
+// not by the computation.
+//
+// Usage: repeat_performance_0 [N n]
+//
+// where n is the repeat count (default 10000). The callee has 16 ops on
+// tensors of 4 elements, and is run on 2 replicas.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+void benchmarkRepeat(uint64_t repeatCount) {
+
+  const int64_t rf{2};
+  SlickGraph g(32, ReplicationFactor::create(rf));
+
+  auto callee = g.createSubGraph("callee");
+  auto x0     = callee.rootIpuFloat32Variable({4});
+  auto x1     = x0;
+  for (uint64_t i = 0; i < 8; ++i) {
+    x1 = (x1.sin() * x0.constant(0.5)).add(x0.cos());
+  }
+
+  auto caller = g.createSubGraph("caller");
+  auto hIn    = caller.hostFloat32Variable({1, 1, 4});
+  auto in0    = hIn.hostToIpu(g.rootIpu());
+  auto rpt    = caller.repeat(
+      callee, repeatCount, {}, {{{in0, x0, x1}}}, {{x1, IsStackedCopy::No}});
+  auto hOut = x1.dstInCaller(rpt).ipuToHost(1);
+  g.setRunnable({caller});
+
+  SimExecutable se(g);
+  se.setHostValue(hIn, HostTensor::uniformFloat32(-1, 1, {1, 1, 4}, 1011));
+
+  // The first run resolves and validates the tensors of the ops.
+  auto t0 = std::chrono::high_resolution_clock::now();
+  se.run(caller);
+  const auto tFirst = seconds(t0);
+
+  const auto expected = se.getHostValue(hOut).copy();
+
+  const uint64_t nRuns{3};
+  t0 = std::chrono::high_resolution_clock::now();
+  for (uint64_t i = 0; i < nRuns; ++i) {
+    se.run(caller);
+  }
+  const auto tNext = seconds(t0) / nRuns;
+
+  se.getHostValue(hOut).assertAllEquivalent(expected);
+
+  std::cout << "repeatCount=" << repeatCount << ", rf=" << rf
+            << "\nfirst run: " << tFirst << " [s], "
+            << 1e9 * tFirst / repeatCount << " [ns/iteration]"
+            << "\nlater runs: " << tNext << " [s], "
+            << 1e9 * tNext / repeatCount << " [ns/iteration]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{10000};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  benchmarkRepeat(n);
+  return 0;
+}
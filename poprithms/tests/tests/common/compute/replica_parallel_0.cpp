@@ -0,0 +1,117 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <iostream>
+#include <sstream>
+
+#include <poprithms/common/compute/autodiff/autodiffer.hpp>
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Check that running the replicas of ops concurrently gives exactly the same
+// values as running them one after another.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+void testTrainingStep0() {
+
+  const int64_t rf{4};
+  const int64_t B{3};
+  const int64_t D{5};
+
+  SlickGraph g(32, ReplicationFactor::create(rf));
+  auto sg = g.createSubGraph("trainStep");
+
+  // The weights are on host, and are broadcast to all replicas. The data is
+  // different on each replica.
+  auto hw0   = sg.hostFloat32Variable({D, D});
+  auto hw1   = hw0.variable();
+  auto hData = sg.hostFloat32Variable({1, rf, B, D});
+  auto w0    = hw0.reshape({1, 1, D, D}).hostToIpu(g.rootIpu());
+  auto w1    = hw1.reshape({1, 1, D, D}).hostToIpu(g.rootIpu());
+  auto d0    = hData.hostToIpu(g.rootIpu());
+
+  auto loss = d0.matmul(w0)
+                  .relu()
+                  .matmul(w1)
+                  .sin()
+                  .reduceSum(Shape{})
+                  .reduceSumAcrossReplicas();
+
+  auto grads = Autodiffer(g).backward(loss, {hw0, hw1});
+
+  // A reduction over groups of 2 replicas, and one over all replicas.
+  auto pairs = d0.abs().reduceSumAcrossReplicas(2, Stride(1));
+  auto all   = d0.abs().reduceSumAcrossReplicas();
+
+  auto lossHost  = loss.ipuToHost(1);
+  auto pairsHost = pairs.ipuToHost(1);
+  auto allHost   = all.ipuToHost(1);
+
+  hw0.sub_(g.tensor(grads[0]).mul(0.125));
+  hw1.sub_(g.tensor(grads[1]).mul(0.125));
+
+  g.setRunnable({sg});
+
+  auto run = [&](uint64_t nThreads) {
+    SimExecutable se(g);
+    se.setNReplicaThreads(nThreads);
+    if (se.nReplicaThreads() != nThreads) {
+      throw poprithms::test::error("Failed to set the number of threads");
+    }
+    se.setHostValue(hw0, HostTensor::uniformFloat32(-1, 1, {D, D}, 1011));
+    se.setHostValue(hw1, HostTensor::uniformFloat32(-1, 1, {D, D}, 1012));
+    for (uint32_t i = 0; i < 5; ++i) {
+      se.setHostValue(
+          hData, HostTensor::uniformFloat32(-1, 1, {1, rf, B, D}, 1013 + i));
+      se.run(sg);
+    }
+    return HostTensors{se.getHostValue(hw0).copy(),
+                       se.getHostValue(hw1).copy(),
+                       se.getHostValue(lossHost).copy(),
+                       se.getHostValue(pairsHost).copy(),
+                       se.getHostValue(allHost).copy()};
+  };
+
+  const auto expected = run(1);
+
+  // The reduction over pairs of replicas, checked against the values on
+  // host.
+  const auto pairs_ = expected[3].at(0);
+  (pairs_.at(0) + pairs_.at(2))
+      .assertAllClose(expected[4].at(0).at(1), 1e-5, 1e-5);
+
+  for (uint64_t nThreads : {2, 3, 4, 8}) {
+    const auto observed = run(nThreads);
+    for (uint64_t i = 0; i < expected.size(); ++i) {
+      observed[i].assertAllEquivalent(expected[i]);
+    }
+  }
+}
+
+void testInvalidNumberOfThreads0() {
+  SlickGraph g;
+  auto sg = g.createSubGraph("sg0");
+  sg.hostFloat32Variable({2});
+  g.setRunnable({sg});
+  SimExecutable se(g);
+  bool caught{false};
+  try {
+    se.setNReplicaThreads(0);
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to catch 0 replica threads");
+  }
+}
+
+} // namespace
+
+int main() {
+  testTrainingStep0();
+  testInvalidNumberOfThreads0();
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <poprithms/common/compute/autodiff/autodiffer.hpp>
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Time a replicated (data parallel) training step of a 2 layer MLP, with the
+// replicas of each op run serially and concurrently.
+//
+// Usage: replica_parallel_performance_0 [N n]
+//
+// where n is the hidden size of the MLP (default 256). The replication
+// factor is 16 and the batch size on each replica is n.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+void benchmarkTrainingStep(int64_t D) {
+
+  const int64_t rf{16};
+  const int64_t nSteps{4};
+
+  SlickGraph g(32, ReplicationFactor::create(rf));
+  auto sg = g.createSubGraph("trainStep");
+
+  auto hw0   = sg.hostFloat32Variable({D, D});
+  auto hw1   = hw0.variable();
+  auto hData = sg.hostFloat32Variable({1, rf, D, D});
+  auto w0    = hw0.reshape({1, 1, D, D}).hostToIpu(g.rootIpu());
+  auto w1    = hw1.reshape({1, 1, D, D}).hostToIpu(g.rootIpu());
+  auto d0    = hData.hostToIpu(g.rootIpu());
+
+  auto loss = d0.matmul(w0)
+                  .relu()
+                  .matmul(w1)
+                  .sin()
+                  .reduceSum(Shape{})
+                  .reduceSumAcrossReplicas();
+
+  auto grads    = Autodiffer(g).backward(loss, {hw0, hw1});
+  auto lossHost = loss.ipuToHost(1);
+  hw0.sub_(g.tensor(grads[0]).mul(0.125));
+  hw1.sub_(g.tensor(grads[1]).mul(0.125));
+
+  g.setRunnable({sg});
+
+  std::cout << "rf=" << rf << ", D=" << D << ", hardware threads="
+            << std::thread::hardware_concurrency() << "\n\n"
+            << std::setw(12) << "nThreads" << std::setw(16) << "time/step [s]"
+            << std::setw(12) << "speedup" << std::endl;
+
+  double tSerial{0};
+  HostTensor expected = HostTensor::float32(0);
+  for (uint64_t nThreads : {1, 2, 4, 8, 16}) {
+    SimExecutable se(g);
+    se.setNReplicaThreads(nThreads);
+    se.setHostValue(hw0, HostTensor::uniformFloat32(-1, 1, {D, D}, 1011));
+    se.setHostValue(hw1, HostTensor::uniformFloat32(-1, 1, {D, D}, 1012));
+    se.setHostValue(hData,
+                    HostTensor::uniformFloat32(-1, 1, {1, rf, D, D}, 1013));
+
+    // Warm up (this populates the buffer pool).
+    se.run(sg);
+
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    for (int64_t i = 0; i < nSteps; ++i) {
+      se.run(sg);
+    }
+    const auto t = seconds(t0) / nSteps;
+
+    if (nThreads == 1) {
+      tSerial  = t;
+      expected = se.getHostValue(lossHost).copy();
+    } else {
+      se.getHostValue(lossHost).assertAllEquivalent(expected);
+    }
+
+    std::cout << std::setw(12) << nThreads << std::setw(16) << t
+              << std::setw(12) << tSerial / t << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  int64_t D{256};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    D = std::stol(argv[2]);
+  }
+
+  benchmarkTrainingStep(D);
+  return 0;
+}
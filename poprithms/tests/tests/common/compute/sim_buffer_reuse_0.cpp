@@ -0,0 +1,68 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <iostream>
+#include <sstream>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/compute/host/bufferpool.hpp>
+#include <poprithms/compute/host/tensor.hpp>
+#include <poprithms/error/error.hpp>
+
+namespace {
+using namespace poprithms::common::compute;
+
+void testSteadyState0() {
+
+  SlickGraph graph;
+  auto sg = graph.createSubGraph("sg0");
+
+  const auto x0 = sg.variable(DType::Float32, {20, 30}, graph.host());
+  const auto x1 = sg.variable(DType::Float32, {30}, graph.host());
+  const auto y  = (x0.sin().abs() + x1).exp().reduceSum(Dimension(0));
+  const auto z  = (y * x1.cos()).relu();
+
+  graph.setRunnable({sg.id()});
+
+  SimExecutable se(graph);
+  if (se.bufferPool()) {
+    throw poprithms::test::error(
+        "The buffer pool should not be used unless it is enabled");
+  }
+  se.enableBufferPool();
+  const auto &pool = *se.bufferPool();
+
+  se.setHostValue(x0.id(), HostTensor::uniformFloat32(-1, 1, {20, 30}, 1));
+  se.setHostValue(x1.id(), HostTensor::uniformFloat32(-1, 1, {30}, 2));
+
+  se.run(sg.id());
+  const auto expected = se.getHostValue(z.id()).copy();
+
+  // Warm up the pool.
+  se.run(sg.id());
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    const auto before = pool.stats();
+    se.run(sg.id());
+    const auto after = pool.stats();
+    // The outplace ops write their results directly into their (already
+    // allocated) outputs, so no buffers are required, and none are in use
+    // after the run.
+    if (after.nAcquisitions != before.nAcquisitions ||
+        after.nMisses() != before.nMisses() || after.nBytesInUse != 0) {
+      std::ostringstream oss;
+      oss << "Expected a steady state in which no buffers are acquired, "
+          << "but the buffer pool statistics are " << after
+          << " after the run, and " << before << " before it.";
+      throw poprithms::test::error(oss.str());
+    }
+    se.getHostValue(z.id()).assertAllEquivalent(expected);
+  }
+}
+
+} // namespace
+
+int main() {
+  testSteadyState0();
+  return 0;
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <string>
+#include <vector>
+
+#include <poprithms/common/compute/simexecutable.hpp>
+#include <poprithms/common/compute/slickgraph.hpp>
+#include <poprithms/error/error.hpp>
+
+// Check that running a sub-graph with streamed host and remote tensors gives
+// the same values as setting and getting the tensors between runs.
+
+namespace {
+
+using namespace poprithms::common::compute;
+
+HostTensor value(uint64_t seed, const Shape &s) {
+  return HostTensor::uniformFloat32(-1, 1, s, 1011 + seed);
+}
+
+// A step with a different input on each replica, and weights which are
+// broadcast to all replicas. Both are streamed from host, as is the output.
+void testHostStreams0(SimExecutionMode mode, uint64_t nThreads) {
+
+  const int64_t rf{2};
+  SlickGraph g(32, ReplicationFactor::create(rf));
+  auto sg = g.createSubGraph("step");
+
+  auto hx = sg.hostFloat32Variable({1, rf, 4});
+  auto hw = sg.hostFloat32Variable({1, 1, 4});
+  auto x  = hx.hostToIpu(g.rootIpu());
+  auto w  = hw.hostToIpu(g.rootIpu());
+  auto hy = x.sin().mul(w).ipuToHost(1);
+  g.setRunnable({sg});
+
+  const uint64_t nIterations{6};
+  auto input   = [rf](uint64_t i) { return value(i, {1, rf, 4}); };
+  auto weights = [](uint64_t i) { return value(100 + i, {1, 1, 4}); };
+
+  // Set the inputs and get the outputs between runs.
+  SimExecutable expected(g, mode, nThreads);
+  std::vector<HostTensor> expectedOuts;
+  for (uint64_t i = 0; i < nIterations; ++i) {
+    expected.setHostValue(hx, input(i));
+    expected.setHostValue(hw, weights(i));
+    expected.run(sg);
+    expectedOuts.push_back(expected.getHostValue(hy).copy());
+  }
+
+  // Stream the inputs and outputs.
+  SimExecutable se(g, mode, nThreads);
+  std::vector<uint64_t> sourceIterations;
+  std::vector<uint64_t> sinkIterations;
+  std::vector<HostTensor> outs;
+  se.setStreamSource(hx, [&](uint64_t i, const HostTensors &buffers) {
+    sourceIterations.push_back(i);
+    buffers.at(0).update_(input(i));
+  });
+  se.setStreamSource(hw, [&](uint64_t i, const HostTensors &buffers) {
+    buffers.at(0).update_(weights(i));
+  });
+  se.setStreamSink(hy, [&](uint64_t i, const HostTensors &values) {
+    sinkIterations.push_back(i);
+    outs.push_back(values.at(0).copy());
+  });
+  se.runStreaming(sg, nIterations);
+
+  std::vector<uint64_t> iterations;
+  for (uint64_t i = 0; i < nIterations; ++i) {
+    iterations.push_back(i);
+  }
+  if (sourceIterations != iterations || sinkIterations != iterations) {
+    throw poprithms::test::error(
+        "Expected each callback to be called once per iteration, in order");
+  }
+
+  for (uint64_t i = 0; i < nIterations; ++i) {
+    outs[i].assertAllEquivalent(expectedOuts[i]);
+  }
+}
+
+// A remote tensor with a different value on each replica is streamed in,
+// and a remote tensor computed from it is streamed out.
+void testRemoteStreams0() {
+
+  const int64_t rf{3};
+  SlickGraph g(32, ReplicationFactor::create(rf));
+  auto sg = g.createSubGraph("step");
+
+  auto rx = sg.remoteVariable(DType::Float32, {1, 4}, g.rootIpu());
+  auto ry = rx.remoteToIpu().abs().ipuToRemote({});
+  g.setRunnable({sg});
+
+  const uint64_t nIterations{4};
+  auto input = [](uint64_t i, uint64_t r) {
+    return value(10 * i + r, {1, 4});
+  };
+
+  SimExecutable se(g);
+  se.setStreamSource(rx, [&](uint64_t i, const HostTensors &buffers) {
+    if (buffers.size() != rf) {
+      throw poprithms::test::error("Expected 1 buffer per replica");
+    }
+    for (uint64_t r = 0; r < rf; ++r) {
+      buffers[r].update_(input(i, r));
+    }
+  });
+
+  std::vector<HostTensors> outs;
+  se.setStreamSink(ry, [&](uint64_t, const HostTensors &values) {
+    HostTensors copies;
+    for (const auto &v : values) {
+      copies.push_back(v.copy());
+    }
+    outs.push_back(copies);
+  });
+  se.runStreaming(sg, nIterations);
+
+  for (uint64_t i = 0; i < nIterations; ++i) {
+    for (uint64_t r = 0; r < rf; ++r) {
+      outs.at(i).at(r).assertAllEquivalent(input(i, r).abs());
+    }
+  }
+}
+
+void testErrors0() {
+
+  SlickGraph g;
+  auto sg = g.createSubGraph("step");
+  auto hx = sg.hostFloat32Variable({1, 1, 4});
+  auto x  = hx.hostToIpu(g.rootIpu());
+  auto hy = x.sin().ipuToHost(1);
+  g.setRunnable({sg});
+
+  SimExecutable se(g);
+
+  // Only host and remote tensors can be streamed.
+  bool caught{false};
+  try {
+    se.setStreamSource(x, [](uint64_t, const HostTensors &) {});
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to catch streaming an ipu tensor");
+  }
+
+  // An exception in a callback is rethrown.
+  se.setStreamSink(hy, [](uint64_t i, const HostTensors &) {
+    if (i == 2) {
+      throw poprithms::test::error("sink failure");
+    }
+  });
+  caught = false;
+  try {
+    se.runStreaming(sg, 5);
+  } catch (const poprithms::error::error &e) {
+    caught = std::string(e.what()).find("sink failure") != std::string::npos;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to rethrow a callback's exception");
+  }
+
+  // Without streams, runStreaming just runs the sub-graph.
+  se.clearStreams();
+  se.setHostValue(hx, HostTensor::uniformFloat32(-1, 1, {1, 1, 4}, 1011));
+  se.runStreaming(sg, 2);
+  se.getHostValue(hy).assertAllEquivalent(se.getHostValue(hx).sin());
+}
+
+} // namespace
+
+int main() {
+  testHostStreams0(SimExecutionMode::Serial, 1);
+  testHostStreams0(SimExecutionMode::Dataflow, 3);
+  testRemoteStreams0();
+  testErrors0();
+  return 0;
+}
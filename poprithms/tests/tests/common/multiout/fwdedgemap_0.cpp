@@ -0,0 +1,32 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <poprithms/common/multiout/fwdedgemap.hpp>
+#include <poprithms/error/error.hpp>
+
+namespace {
+
+using namespace poprithms::common::multiout;
+
+void testCsr0() {
+
+  FwdEdgeMap fem({OpId(10), OpId(4), OpId(7)});
+  fem.insertEdge(OpId(10), OpId(7));
+  fem.insertEdge(OpId(4), OpId(7));
+  fem.insertEdge(OpId(10), OpId(4));
+
+  if (fem.fwdEdgesCsr().toNested() != fem.fwdEdgesCompact()) {
+    throw poprithms::test::error(
+        "Expected the CSR edges of the FwdEdgeMap to be the same");
+  }
+
+  if (fem.createBwdEdgesCsr().toNested() != fem.createBwdEdgesCompact()) {
+    throw poprithms::test::error(
+        "Expected the CSR bwd edges of the FwdEdgeMap to be the same");
+  }
+}
+
+} // namespace
+
+int main() {
+  testCsr0();
+  return 0;
+}
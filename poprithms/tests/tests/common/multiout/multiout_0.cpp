@@ -62,6 +62,9 @@ public:
     return insertMultioutOp(std::make_unique<test::Op>(s));
   }
 
+  // The input shapes of #id, which are read from the graph #id points to.
+  Shapes inShapes(OpId id) const { return multioutOp(id).inShapes(); }
+
   using multiout::Graph::removeInputs;
   using multiout::Graph::removeOutputs;
   virtual ~Graph() override = default;
@@ -643,6 +646,86 @@ void testMovesAndCopies() {
   }
 }
 
+// Copies share ops, and ops are only cloned when they are modified.
+void testCopyOnWrite0() {
+  test::Graph g;
+  auto a = g.insert({}, 2);
+  auto b = g.insert({{a, 0}}, 1);
+  auto c = g.insert({{a, 1}, {b, 0}}, 1);
+
+  auto g1 = g;
+  if (g.nSharedOps() != 3 || g1.nSharedOps() != 3) {
+    throw poprithms::test::error("Expected all ops to be shared after copy");
+  }
+
+  // Reading c through g1 does not clone it.
+  if (g1.inTensorIds(c) != TensorIds{{a, 1}, {b, 0}} ||
+      g1.inShapes(c) != Shapes{{1}, {1}}) {
+    throw poprithms::test::error("Unexpected inputs of c in the copy");
+  }
+  if (g1.nSharedOps() != 3) {
+    throw poprithms::test::error("Expected c to be shared after reading");
+  }
+
+  // Modifying a through g1 does not modify a in g, or in a copy of g.
+  auto g2 = g;
+  g1.insert({{a, 0}}, 1);
+  if (g1.consumptionIds({a, 0}).size() != 2 ||
+      g.consumptionIds({a, 0}).size() != 1 ||
+      g2.consumptionIds({a, 0}).size() != 1) {
+    throw poprithms::test::error("Modifying a copy modified the original");
+  }
+
+  // And vice versa.
+  g.insert({{b, 0}}, 1);
+  if (g.consumptionIds({b, 0}).size() != 2 ||
+      g1.consumptionIds({b, 0}).size() != 1 ||
+      g2.consumptionIds({b, 0}).size() != 1) {
+    throw poprithms::test::error("Modifying the original modified a copy");
+  }
+
+  g.verifyOpsConnectedToThisGraph();
+  g1.verifyOpsConnectedToThisGraph();
+  g2.verifyOpsConnectedToThisGraph();
+
+  auto g3 = g2;
+  g3.bindOps();
+  if (g3.nSharedOps() != 0 || g3 != g2) {
+    throw poprithms::test::error("Expected bindOps to clone all ops");
+  }
+}
+
+// The ops of a copy can be read after the graph which they point to stops
+// sharing them, because it is destroyed or because they are removed from it.
+void testCopyOnWrite1() {
+  auto g  = std::make_unique<test::Graph>();
+  auto a  = g->insert({}, 2);
+  auto b  = g->insert({{a, 0}}, 1);
+  auto c  = g->insert({{a, 1}, {b, 0}}, 1);
+  auto g1 = std::make_unique<test::Graph>(*g);
+  auto g2 = *g1;
+
+  g->removeOp(c, {OptionalTensorId{}}, "testCopyOnWrite1");
+  g.reset(nullptr);
+  for (auto g_ : {g1.get(), &g2}) {
+    g_->verifyOpsConnectedToThisGraph();
+    if (g_->inShapes(c) != Shapes{{1}, {1}} ||
+        g_->inShapes(b) != Shapes{{1}}) {
+      throw poprithms::test::error(
+          "Unexpected input shapes after the original was destroyed");
+    }
+  }
+
+  // The ops point to one of g1 and g2, and so can be read after that one is
+  // destroyed too.
+  g1.reset(nullptr);
+  g2.verifyOpsConnectedToThisGraph();
+  if (g2.inShapes(c) != Shapes{{1}, {1}} || g2.nSharedOps() != 0) {
+    throw poprithms::test::error(
+        "Unexpected input shapes after the copies were destroyed");
+  }
+}
+
 void testOptionalTensorIds0() {
 
   auto a = OptionalTensorId(TensorId(0, 0));
@@ -947,6 +1030,8 @@ int main() {
   testTraversal1();
   testTraversal2();
   testMovesAndCopies();
+  testCopyOnWrite0();
+  testCopyOnWrite1();
   testOutConsumers0();
   testOptionalTensorIds0();
   testRemoveEdges0();
@@ -4,6 +4,7 @@
 #include <map>
 #include <numeric>
 #include <random>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -385,6 +386,73 @@ void testCycle0() {
   // schedulable_test::Op::2 2             (0)                   (additional)
 }
 
+// Remove ops in a random order, interleaved with insertions, and check
+// that the live ops of the graph and of its sub-graphs are correct after
+// every removal.
+void removalMany0() {
+  Graph g;
+  const auto sg0 = g.createSubGraphId("sg0");
+  const auto sg1 = g.createSubGraphId("sg1");
+
+  // All live ops, in all sub-graphs.
+  auto liveOps = [](const Graph &x) {
+    return x.poprithms::common::multiout::Graph::opIds();
+  };
+
+  std::set<OpId> expected0;
+  std::set<OpId> expected1;
+
+  auto check = [&]() {
+    auto both = expected0;
+    both.insert(expected1.cbegin(), expected1.cend());
+    if (liveOps(g) != OpIds(both.cbegin(), both.cend()) ||
+        g.nOps() != both.size() ||
+        g.opIds(sg0) != OpIds(expected0.cbegin(), expected0.cend()) ||
+        g.opIds(sg1) != OpIds(expected1.cbegin(), expected1.cend())) {
+      std::ostringstream oss;
+      oss << "Unexpected live ops " << liveOps(g) << ", with " << g.opIds(sg0)
+          << " in sg0 and " << g.opIds(sg1) << " in sg1.";
+      throw error(oss.str());
+    }
+    for (auto id : both) {
+      if (!g.isLive(id)) {
+        throw error("Expected op to be live");
+      }
+    }
+  };
+
+  std::mt19937 gen(1011);
+  auto insert = [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      const bool first = gen() % 3 != 0;
+      const auto id    = g.insert({}, 1, first ? sg0 : sg1, "");
+      (first ? expected0 : expected1).insert(id);
+    }
+  };
+
+  insert(100);
+  for (uint64_t round = 0; round < 3; ++round) {
+    auto ids = liveOps(g);
+    std::shuffle(ids.begin(), ids.end(), gen);
+    for (uint64_t i = 0; i < ids.size() * 3 / 4; ++i) {
+      g.removeOp(ids[i], {{}}, "removalMany0");
+      expected0.erase(ids[i]);
+      expected1.erase(ids[i]);
+      if (g.isLive(ids[i])) {
+        throw error("Expected removed op to not be live");
+      }
+      check();
+    }
+    insert(50);
+    check();
+  }
+
+  auto copy = g;
+  if (copy != g || liveOps(copy) != liveOps(g)) {
+    throw error("Expected copy to be equal to the original");
+  }
+}
+
 } // namespace
 
 int main() {
@@ -400,6 +468,7 @@ int main() {
   testConstraintPhobic0();
   testConstraintPhobic1();
   testCycle0();
+  removalMany0();
 
   return 0;
 }
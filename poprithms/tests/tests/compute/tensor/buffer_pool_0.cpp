@@ -0,0 +1,211 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <poprithms/compute/host/bufferpool.hpp>
+#include <poprithms/compute/host/tensor.hpp>
+#include <poprithms/error/error.hpp>
+
+namespace {
+
+using namespace poprithms::compute::host;
+
+void assertStat(const BufferPool &pool,
+                uint64_t observed,
+                uint64_t expected,
+                const std::string &n) {
+  if (observed != expected) {
+    std::ostringstream oss;
+    oss << "Expected " << n << " to be " << expected << ", not " << observed
+        << ". Stats are " << pool.stats() << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void assertStatInRange(const BufferPool &pool,
+                       uint64_t observed,
+                       uint64_t lower,
+                       uint64_t upper,
+                       const std::string &n) {
+  if (observed < lower || observed > upper) {
+    std::ostringstream oss;
+    oss << "Expected " << n << " to be in [" << lower << ", " << upper
+        << "], not " << observed << ". Stats are " << pool.stats() << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void testNoScope0() {
+  BufferPool pool;
+  if (BufferPool::current()) {
+    throw poprithms::test::error("There should be no pool without a Scope");
+  }
+  const auto a = Tensor::arangeFloat32(0, 10, 1);
+  a.add(a).abs();
+  assertStat(pool, pool.stats().nAcquisitions, 0, "nAcquisitions");
+  assertStat(pool, pool.stats().nBytesHeld, 0, "nBytesHeld");
+}
+
+void testReuse0() {
+
+  BufferPool pool;
+  BufferPool::Scope scope(pool);
+
+  const auto a = Tensor::arangeFloat32(0, 100, 1);
+  const auto b = Tensor::uniformFloat32(-1, 1, {100}, 1011);
+
+  auto compute = [&a, &b]() { return a.mul(b).add(a).relu().sqrt(); };
+
+  // The first time, the results must all be allocated.
+  const auto expected = compute();
+  assertStatInRange(pool, pool.stats().nMisses(), 1, 100, "nMisses");
+
+  // Once the pool has warmed up, computations (and the comparisons of their
+  // results) do not allocate.
+  compute().assertAllEquivalent(expected);
+  for (uint64_t i = 0; i < 5; ++i) {
+    pool.resetStats();
+    compute().assertAllEquivalent(expected);
+    assertStatInRange(
+        pool, pool.stats().nAcquisitions, 4, 100, "nAcquisitions");
+    assertStat(pool, pool.stats().nMisses(), 0, "nMisses");
+    assertStat(pool, pool.stats().nRejections, 0, "nRejections");
+  }
+
+  // The buffers of the temporaries, each of at least 100 floats, are held.
+  // The size class of 100 is 112.
+  assertStatInRange(pool,
+                    pool.stats().nBytesHeld,
+                    4 * 100 * 4,
+                    pool.maxBytesHeld(),
+                    "nBytesHeld");
+
+  // The tensors which are still alive (a, b, and the expected result) are
+  // in use.
+  assertStatInRange(pool,
+                    pool.stats().nBytesInUse,
+                    3 * 100 * 4,
+                    3 * 112 * 4,
+                    "nBytesInUse");
+
+  // A slightly smaller tensor, in the same size class, can reuse a buffer.
+  pool.resetStats();
+  Tensor::arangeFloat32(0, 98, 1).sqrt();
+  assertStat(pool, pool.stats().nMisses(), 0, "nMisses");
+
+  // A much smaller one cannot, as the buffers are only used for tensors of
+  // the same size class.
+  pool.resetStats();
+  Tensor::arangeFloat32(0, 70, 1).sqrt();
+  assertStat(pool, pool.stats().nHits, 0, "nHits");
+
+  // A buffer of a different type cannot be reused.
+  pool.resetStats();
+  Tensor::arangeInt32(0, 100, 1).abs();
+  assertStat(pool, pool.stats().nHits, 0, "nHits");
+
+  pool.clear();
+  assertStat(pool, pool.stats().nBytesHeld, 0, "nBytesHeld");
+}
+
+void testSizeClasses0() {
+
+  // A buffer is at most 25% larger than the tensor which requests it.
+  BufferPool pool;
+  BufferPool::Scope scope(pool);
+  for (int64_t n : {1, 5, 9, 17, 100, 1000, 1025, 4097}) {
+    pool.resetStats();
+    const auto t = Tensor::arangeInt64(0, n, 1).abs();
+    const auto inUse = pool.stats().nBytesInUse;
+    assertStatInRange(pool,
+                      inUse,
+                      8 * static_cast<uint64_t>(n),
+                      10 * static_cast<uint64_t>(n),
+                      "nBytesInUse");
+  }
+}
+
+void testMaxBytes0() {
+  BufferPool pool(1000);
+  BufferPool::Scope scope(pool);
+
+  // 256 doubles (2048 bytes) do not fit in the pool.
+  Tensor::arangeFloat64(0, 256, 1).abs();
+  assertStatInRange(pool, pool.stats().nRejections, 1, 2, "nRejections");
+  assertStat(pool, pool.stats().nBytesHeld, 0, "nBytesHeld");
+
+  // 64 doubles (512 bytes) do, but not twice.
+  Tensor::arangeFloat64(0, 64, 1).abs();
+  assertStatInRange(pool, pool.stats().nBytesHeld, 512, 1000, "nBytesHeld");
+  assertStat(pool,
+             pool.stats().peakBytesHeld,
+             pool.stats().nBytesHeld,
+             "peakBytesHeld");
+}
+
+void testThreads0() {
+  BufferPool pool;
+  const auto current = [&pool]() {
+    BufferPool::Scope scope(pool);
+    return BufferPool::current();
+  }();
+  std::vector<std::thread> threads;
+  for (int64_t t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([t, &current]() {
+      BufferPool::Scope scope(current);
+      const auto a = Tensor::uniformFloat64(-1, 1, {50 + t, 3}, 1011 + t);
+      const auto e = a.mul(a).exp().reduceSum();
+      for (uint64_t i = 0; i < 20; ++i) {
+        a.mul(a).exp().reduceSum().assertAllEquivalent(e);
+      }
+    }));
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  assertStatInRange(pool, pool.stats().nHits, 1, 10000, "nHits");
+  assertStat(pool, pool.stats().nBytesInUse, 0, "nBytesInUse");
+}
+
+void testDestroyedPool0() {
+
+  // Tensors can outlive the pool of their buffers.
+  const auto t = []() {
+    BufferPool pool;
+    BufferPool::Scope scope(pool);
+    return Tensor::arangeFloat32(0, 10, 1).abs();
+  }();
+  t.add_(t);
+  t.assertAllEquivalent(Tensor::arangeFloat32(0, 20, 2));
+  if (BufferPool::current()) {
+    throw poprithms::test::error("The Scope should have been exited");
+  }
+}
+
+void testNestedScopes0() {
+  BufferPool p0;
+  BufferPool p1;
+  BufferPool::Scope s0(p0);
+  {
+    BufferPool::Scope s1(p1);
+    Tensor::arangeFloat32(0, 10, 1).abs();
+  }
+  Tensor::arangeFloat32(0, 10, 1).abs();
+  assertStat(p0, p0.stats().nAcquisitions, 1, "nAcquisitions");
+  assertStat(p1, p1.stats().nAcquisitions, 1, "nAcquisitions");
+}
+
+} // namespace
+
+int main() {
+  testNoScope0();
+  testReuse0();
+  testSizeClasses0();
+  testMaxBytes0();
+  testThreads0();
+  testDestroyedPool0();
+  testNestedScopes0();
+  return 0;
+}
@@ -0,0 +1,225 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <poprithms/compute/host/tensor.hpp>
+#include <poprithms/error/error.hpp>
+
+// Check that the destination passing methods (addInto, sinInto, etc.) give
+// the same values as the outplace methods, and that they write into the
+// destination tensor.
+
+namespace {
+
+using namespace poprithms::compute::host;
+using poprithms::ndarray::DType;
+
+using Into = std::function<void(const Tensor &)>;
+
+// Check that #into(out) has the same effect as out.update_(#expected), for
+// a destination #out which is (1) contiguous (2) a slice of a larger tensor.
+void assertInto(const Into &into,
+                const Tensor &expected,
+                const std::string &what) {
+
+  // 1) A contiguous destination. The result is written directly into it.
+  const auto out   = Tensor::zeros(expected.dtype(), expected.shape());
+  const auto alias = out.reshape_({out.nelms()});
+  into(out);
+  if (!out.allEquivalent(expected) ||
+      !alias.allEquivalent(expected.flatten())) {
+    throw poprithms::test::error("Unexpected values for " + what +
+                                 " with a contiguous destination");
+  }
+
+  // 2) A destination which is not contiguous. The values are copied into it.
+  auto dims = expected.shape().get();
+  dims[0] *= 2;
+  const auto big   = Tensor::zeros(expected.dtype(), dims);
+  const auto slice = big.slice_(Dimension(0), 0, expected.dim(0));
+  into(slice);
+  if (!slice.allEquivalent(expected) ||
+      !big.slice(Dimension(0), expected.dim(0), 2 * expected.dim(0))
+           .allZero()) {
+    throw poprithms::test::error("Unexpected values for " + what +
+                                 " with a sliced destination");
+  }
+}
+
+void testBinary0() {
+  for (auto t : {DType::Float32, DType::Float64, DType::Int32}) {
+    const auto a = Tensor::uniformFloat64(1, 4, {3, 1, 5}, 1011).to(t);
+    const auto b = Tensor::uniformFloat64(1, 4, {4, 1}, 1012).to(t);
+
+    // #c is a view of a tensor, and not contiguous.
+    const auto c = Tensor::uniformFloat64(1, 4, {5, 3, 2}, 1013)
+                       .to(t)
+                       .dimShuffle_({{2, 1, 0}});
+    const auto d = Tensor::uniformFloat64(1, 4, {2, 3, 5}, 1014).to(t);
+
+    for (const auto &[x, y] : std::vector<std::pair<Tensor, Tensor>>{
+             {a, b}, {c, d}, {d, c}}) {
+      assertInto(
+          [&](const Tensor &o) { x.addInto(y, o); }, x.add(y), "add");
+      assertInto([&](const Tensor &o) { x.subtractInto(y, o); },
+                 x.subtract(y),
+                 "subtract");
+      assertInto(
+          [&](const Tensor &o) { x.mulInto(y, o); }, x.mul(y), "mul");
+      assertInto([&](const Tensor &o) { x.divideInto(y, o); },
+                 x.divide(y),
+                 "divide");
+      assertInto(
+          [&](const Tensor &o) { x.powInto(y, o); }, x.pow(y), "pow");
+      assertInto(
+          [&](const Tensor &o) { x.modInto(y, o); }, x.mod(y), "mod");
+
+      // Tensor::min and Tensor::max do not broadcast.
+      const auto s  = x.shape().numpyBinary(y.shape());
+      const auto xs = x.expand(s);
+      const auto ys = y.expand(s);
+      assertInto(
+          [&](const Tensor &o) { x.minInto(y, o); }, xs.min(ys), "min");
+      assertInto(
+          [&](const Tensor &o) { x.maxInto(y, o); }, xs.max(ys), "max");
+      assertInto([&](const Tensor &o) { x.greaterThanInto(y, o); },
+                 x > y,
+                 "greaterThan");
+      assertInto([&](const Tensor &o) { x.equalToInto(y, o); },
+                 x == y,
+                 "equalTo");
+    }
+  }
+
+  const auto t = Tensor::boolean({2, 2}, {true, false, false, true});
+  const auto f = Tensor::boolean({2}, {true, false});
+  assertInto([&](const Tensor &o) { t.addInto(f, o); }, t.add(f), "or");
+  assertInto([&](const Tensor &o) { t.mulInto(f, o); }, t.mul(f), "and");
+}
+
+void testUnary0() {
+  const auto a = Tensor::uniformFloat32(0.5, 2., {4, 6}, 1015);
+  for (const auto &x : {a, a.slice({1, 1}, {3, 5}), a.dimShuffle()}) {
+    assertInto([&](const Tensor &o) { x.absInto(o); }, x.abs(), "abs");
+    assertInto([&](const Tensor &o) { x.expInto(o); }, x.exp(), "exp");
+    assertInto([&](const Tensor &o) { x.logInto(o); }, x.log(), "log");
+    assertInto([&](const Tensor &o) { x.sqrtInto(o); }, x.sqrt(), "sqrt");
+    assertInto([&](const Tensor &o) { x.sinInto(o); }, x.sin(), "sin");
+    assertInto([&](const Tensor &o) { x.cosInto(o); }, x.cos(), "cos");
+    assertInto([&](const Tensor &o) { x.negInto(o); }, x.neg(), "neg");
+    assertInto([&](const Tensor &o) { x.reciprocalInto(o); },
+               x.reciprocal(),
+               "reciprocal");
+  }
+
+  const auto i = Tensor::arangeInt16(-5, 5, 1).reshape({2, 5});
+  assertInto([&](const Tensor &o) { i.negInto(o); }, i.neg(), "neg (int)");
+  assertInto([&](const Tensor &o) { i.absInto(o); }, i.abs(), "abs (int)");
+}
+
+void testCast0() {
+  const auto a = Tensor::uniformFloat64(-10, 10, {3, 4}, 1016);
+  for (auto from : {DType::Float64,
+                    DType::Float32,
+                    DType::Float16,
+                    DType::Int32,
+                    DType::Unsigned8,
+                    DType::Boolean}) {
+    const auto x = a.abs().to(from);
+    for (const auto &y : {x, x.dimShuffle()}) {
+      for (auto to : {DType::Float64,
+                      DType::Float32,
+                      DType::Float16,
+                      DType::Int64,
+                      DType::Int8,
+                      DType::Unsigned16,
+                      DType::Boolean}) {
+        assertInto([&](const Tensor &o) { y.toInto(o); },
+                   y.to(to),
+                   "cast from " + poprithms::ndarray::lcase(from) + " to " +
+                       poprithms::ndarray::lcase(to));
+      }
+    }
+  }
+}
+
+void testMatMul0() {
+  for (auto t : {DType::Float32, DType::Int64}) {
+    const auto a = Tensor::uniformFloat64(-2, 2, {2, 1, 3, 4}, 1017).to(t);
+    const auto b = Tensor::uniformFloat64(-2, 2, {3, 4, 5}, 1018).to(t);
+    const auto c = Tensor::uniformFloat64(-2, 2, {4}, 1019).to(t);
+    const auto s = a.slice_({0, 0, 1, 0}, {2, 1, 3, 4});
+    for (const auto &[x, y] : std::vector<std::pair<Tensor, Tensor>>{
+             {a, b}, {c, b}, {a, c}, {s, b}}) {
+      assertInto([&](const Tensor &o) { x.matmulInto(y, o); },
+                 x.matmul(y),
+                 "matmul");
+      assertInto([&](const Tensor &o) { x.matmulInto(y, o); },
+                 x.matmul(y).to(DType::Float64),
+                 "matmul with a cast");
+    }
+  }
+}
+
+void testReduce0() {
+  const auto a = Tensor::uniformFloat32(-1, 1, {3, 4, 5}, 1020);
+  for (const auto &x : {a, a.dimShuffle()}) {
+    for (auto op : {CommutativeOp::Sum,
+                    CommutativeOp::Product,
+                    CommutativeOp::Min,
+                    CommutativeOp::Max}) {
+      for (auto s : std::vector<Shape>{{1, 1, 1}, {1, 4, 1}, x.shape()}) {
+        assertInto([&](const Tensor &o) { x.reduceInto(o, op); },
+                   x.reduce(s, op),
+                   "reduce to " + s.str());
+      }
+    }
+  }
+}
+
+void testInplace0() {
+  // The destination is exactly the same as the first argument.
+  const auto a = Tensor::uniformFloat32(-1, 1, {3, 4}, 1021);
+  const auto b = Tensor::uniformFloat32(-1, 1, {4}, 1022);
+  const auto x = a.copy();
+  x.addInto(b, x);
+  x.assertAllEquivalent(a.add(b));
+  x.sinInto(x);
+  x.assertAllEquivalent(a.add(b).sin());
+}
+
+void testInvalid0() {
+  const auto a = Tensor::uniformFloat32(-1, 1, {3, 4}, 1023);
+  for (const auto &out : {Tensor::zeros(DType::Float32, {4, 3}),
+                          Tensor::zeros(DType::Float64, {3, 4})}) {
+    bool caught{false};
+    try {
+      a.addInto(a, out);
+    } catch (const poprithms::error::error &) {
+      caught = true;
+    }
+    if (!caught) {
+      throw poprithms::test::error("Failed to catch an invalid destination");
+    }
+  }
+
+  // No elements: nothing is written.
+  const auto e = Tensor::zeros(DType::Float32, {0, 4});
+  e.addInto(e, e);
+  e.matmulInto(Tensor::zeros(DType::Float32, {4, 2}),
+               Tensor::zeros(DType::Float32, {0, 2}));
+}
+
+} // namespace
+
+int main() {
+  testBinary0();
+  testUnary0();
+  testCast0();
+  testMatMul0();
+  testReduce0();
+  testInplace0();
+  testInvalid0();
+  return 0;
+}
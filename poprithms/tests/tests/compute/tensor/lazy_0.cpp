@@ -0,0 +1,143 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <iostream>
+#include <sstream>
+
+#include <poprithms/compute/host/lazytensor.hpp>
+#include <poprithms/compute/host/tensor.hpp>
+#include <poprithms/error/error.hpp>
+
+namespace {
+
+using namespace poprithms::compute::host;
+
+void testChain0() {
+  const auto a = Tensor::uniformFloat64(-1, 1, {3, 1, 5}, 1011);
+  const auto b = Tensor::uniformFloat64(-1, 1, {4, 1}, 1012);
+  const auto c = Tensor::uniformFloat64(-1, 1, {5}, 1013);
+
+  const auto eager = a.mul(b).add(c).relu().mul(2.).sub(c.abs());
+  const auto lazy  = a.lazy().mul(b).add(c).relu().mul(2.).subtract(c.abs());
+
+  if (lazy.shape() != Shape{3, 4, 5}) {
+    throw poprithms::test::error("Incorrect shape of lazy tensor");
+  }
+
+  // The lazy and eager computations must agree exactly, as the same
+  // operations are performed in the same order.
+  lazy.eval().assertAllEquivalent(eager);
+}
+
+void testUnaryChain0() {
+  const auto a     = Tensor::uniformFloat32(0.5, 2.0, {200, 30}, 1014);
+  const auto eager = a.sqrt().log().exp().reciprocal().neg().abs().floor();
+  const auto lazy =
+      a.lazy().sqrt().log().exp().reciprocal().neg().abs().floor();
+  lazy.eval().assertAllEquivalent(eager);
+
+  const auto b      = Tensor::uniformFloat32(-3, 3, {1000, 3}, 1015);
+  const auto eager2 = b.sin().add(b.cos()).ceil().max(b).min(b.pow(2.f));
+  const auto lazy2  = b.lazy()
+                         .sin()
+                         .add(b.lazy().cos())
+                         .ceil()
+                         .max(b)
+                         .min(b.lazy().pow(2.));
+  lazy2.eval().assertAllEquivalent(eager2);
+}
+
+void testIntegral0() {
+  const auto a = Tensor::arangeInt32(0, 24, 1).reshape({2, 3, 4});
+  const auto b = Tensor::arangeInt32(1, 5, 1);
+  const auto eager =
+      a.mod(b).add(a.divide(b)).mul(Tensor::int32(3)).subtract(b);
+  const auto lazy =
+      a.lazy().mod(b).add(a.lazy().divide(b)).mul(3.).subtract(b);
+  lazy.eval().assertAllEquivalent(eager);
+
+  const auto t = Tensor::boolean({2, 2}, {true, false, false, true});
+  const auto f = Tensor::boolean({2}, {true, false});
+  t.lazy().mul(f).add(t).eval().assertAllEquivalent(t.mul(f).add(t));
+}
+
+void testViewsAndAliases0() {
+  // Inputs which are not contiguous (views), and an expression in which the
+  // same sub-expression is used multiple times.
+  const auto base = Tensor::arangeFloat64(0, 60, 1).reshape({6, 10});
+  const auto v0   = base.slice_({1, 2}, {5, 7}).dimShuffle_();
+  const auto v1   = base.reverse_(0).slice_({0, 0}, {5, 4});
+
+  const auto x = v0.lazy().add(v1).mul(0.5);
+  const auto y = x.mul(x).subtract(x);
+
+  // x is only computed once.
+  if (y.nOps() != 4) {
+    std::ostringstream oss;
+    oss << "Expected 4 distinct operations in " << y
+        << ", the sub-expression x should only appear once.";
+    throw poprithms::test::error(oss.str());
+  }
+
+  const auto xe = v0.add(v1).mul(0.5);
+  y.eval().assertAllEquivalent(xe.mul(xe).subtract(xe));
+
+  // The inputs are referenced, not copied: modifications made before
+  // evaluation are seen.
+  base.add_(1.);
+  const auto xe1 = v0.add(v1).mul(0.5);
+  y.eval().assertAllEquivalent(xe1.mul(xe1).subtract(xe1));
+}
+
+void testLarge0() {
+  // Larger than a single block, with a broadcast input which does not
+  // divide the block size.
+  const auto a = Tensor::uniformFloat32(-1, 1, {7, 333, 13}, 1016);
+  const auto b = Tensor::uniformFloat32(-1, 1, {333, 1}, 1017);
+  const auto s = Tensor::float32(0.25);
+  a.lazy().add(b).mul(s).relu().eval().assertAllEquivalent(
+      a.add(b).mul(s).relu());
+}
+
+void testLeafOnly0() {
+  const auto a = Tensor::arangeInt64(0, 6, 1).reshape({2, 3});
+  const auto b = a.lazy().eval();
+  b.assertAllEquivalent(a);
+  b.add_(Tensor::int64(1));
+  a.assertAllEquivalent(Tensor::arangeInt64(0, 6, 1).reshape({2, 3}));
+}
+
+void testBadArgs0() {
+  bool caught{false};
+  try {
+    Tensor::float32(1.f).lazy().add(Tensor::float64(1.));
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to catch type mismatch");
+  }
+
+  caught = false;
+  try {
+    Tensor::zeros(DType::Float32, {2, 3})
+        .lazy()
+        .add(Tensor::zeros(DType::Float32, {2}));
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to catch shape mismatch");
+  }
+}
+
+} // namespace
+
+int main() {
+  testChain0();
+  testUnaryChain0();
+  testIntegral0();
+  testViewsAndAliases0();
+  testLarge0();
+  testLeafOnly0();
+  testBadArgs0();
+  return 0;
+}
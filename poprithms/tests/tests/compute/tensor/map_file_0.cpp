@@ -0,0 +1,258 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <poprithms/compute/host/tensor.hpp>
+#include <poprithms/error/error.hpp>
+
+namespace {
+
+using namespace poprithms::compute::host;
+
+template <typename T>
+void writeRaw(const std::string &fn,
+              const std::vector<T> &vs,
+              const std::string &prefix = {}) {
+  std::ofstream out(fn, std::ios::binary);
+  out.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+  out.write(reinterpret_cast<const char *>(vs.data()),
+            static_cast<std::streamsize>(vs.size() * sizeof(T)));
+}
+
+// Write a version 1.0 .npy file, with a header padded to 64 bytes as numpy
+// does.
+template <typename T>
+void writeNpy(const std::string &fn,
+              const std::string &descr,
+              const std::string &shape,
+              const std::vector<T> &vs,
+              bool fortranOrder = false) {
+  std::string dict = "{'descr': '" + descr + "', 'fortran_order': " +
+                     (fortranOrder ? "True" : "False") +
+                     ", 'shape': " + shape + ", }";
+  const uint64_t preamble = 10;
+  while ((preamble + dict.size() + 1) % 64 != 0) {
+    dict += ' ';
+  }
+  dict += '\n';
+
+  std::string header("\x93NUMPY");
+  header += char(1);
+  header += char(0);
+  header += char(dict.size() % 256);
+  header += char(dict.size() / 256);
+  header += dict;
+  writeRaw(fn, vs, header);
+}
+
+void testMapRaw0() {
+  const std::string fn = "map_file_0_raw.bin";
+  const std::vector<float> vs{1, 2, 3, 4, 5, 6, 7, 8};
+  writeRaw(fn, vs);
+
+  const auto a =
+      Tensor::mapRaw(DType::Float32, {2, 4}, fn, Tensor::MapMode::ReadOnly);
+  a.assertAllEquivalent(Tensor::float32({2, 4}, vs));
+
+  // Map the final 4 elements only.
+  const auto b = Tensor::mapRaw(
+      DType::Float32, {4}, fn, Tensor::MapMode::ReadOnly, 4 * sizeof(float));
+  b.assertAllEquivalent(Tensor::float32({4}, {5, 6, 7, 8}));
+
+  // Views of the mapped tensor keep the mapping alive.
+  const auto c = Tensor::mapRaw(DType::Float32,
+                                {2, 4},
+                                fn,
+                                Tensor::MapMode::ReadOnly)
+                     .slice_({1, 0}, {2, 2});
+  c.assertAllEquivalent(Tensor::float32({1, 2}, {5, 6}));
+
+  std::remove(fn.c_str());
+}
+
+void testCopyOnWrite0() {
+  const std::string fn = "map_file_0_cow.bin";
+  const std::vector<int32_t> vs{1, 2, 3, 4};
+  writeRaw(fn, vs);
+
+  const auto a =
+      Tensor::mapRaw(DType::Int32, {4}, fn, Tensor::MapMode::CopyOnWrite);
+  a.add_(Tensor::int32(10));
+  a.assertAllEquivalent(Tensor::int32({4}, {11, 12, 13, 14}));
+
+  // The modification is private to the mapping, it is not in the file.
+  const auto b =
+      Tensor::mapRaw(DType::Int32, {4}, fn, Tensor::MapMode::ReadOnly);
+  b.assertAllEquivalent(Tensor::int32({4}, vs));
+
+  std::remove(fn.c_str());
+}
+
+void testReadOnlyInplace0() {
+  const std::string fn = "map_file_0_ro.bin";
+  const std::vector<float> vs{1, 2, 3, 4};
+  writeRaw(fn, vs);
+
+  const auto a =
+      Tensor::mapRaw(DType::Float32, {2, 2}, fn, Tensor::MapMode::ReadOnly);
+
+  auto assertThrows = [](const std::function<void()> &f,
+                         const std::string &ctxt) {
+    bool caught{false};
+    try {
+      f();
+    } catch (const poprithms::error::error &) {
+      caught = true;
+    }
+    if (!caught) {
+      throw poprithms::test::error("Expected " + ctxt +
+                                   " of a read-only mapped Tensor to fail.");
+    }
+  };
+
+  // The Tensor, and all of its aliases, are read-only.
+  const auto other   = Tensor::float32({1, 2}, {5, 6});
+  const auto aliases = Tensor::concat_({a.slice_({0, 0}, {1, 2}), other}, 0);
+  if (!a.isReadOnly() || !a.reverse_(0).isReadOnly() ||
+      !aliases.isReadOnly()) {
+    throw poprithms::test::error(
+        "Expected the mapped Tensor and its aliases to be read-only.");
+  }
+
+  assertThrows([&a]() { a.add_(Tensor::float32(1)); }, "add_");
+  assertThrows([&a]() { a.exp_(); }, "exp_");
+  assertThrows([&a]() { a.slice_({0, 0}, {1, 2}).zeroAll_(); },
+               "zeroAll_ of a slice");
+  assertThrows(
+      [&aliases, &vs]() { aliases.update_(Tensor::float32({2, 2}, vs)); },
+      "update_ of a concatenation");
+  assertThrows([&a]() { a.addInto(a, a); }, "addInto");
+
+  // The failed inplace methods did not modify the file.
+  a.assertAllEquivalent(Tensor::float32({2, 2}, vs));
+
+  // Outplace methods and copies are fine.
+  a.add(a).assertAllEquivalent(Tensor::float32({2, 2}, {2, 4, 6, 8}));
+  const auto b = a.copy();
+  if (b.isReadOnly()) {
+    throw poprithms::test::error("Expected a copy to not be read-only.");
+  }
+  b.add_(Tensor::float32(1));
+
+  const auto c =
+      Tensor::mapRaw(DType::Float32, {4}, fn, Tensor::MapMode::CopyOnWrite);
+  if (c.isReadOnly()) {
+    throw poprithms::test::error(
+        "Expected a copy-on-write mapped Tensor to not be read-only.");
+  }
+
+  std::remove(fn.c_str());
+}
+
+void testBadRaw0() {
+  const std::string fn = "map_file_0_bad.bin";
+  writeRaw<float>(fn, {1, 2, 3});
+
+  auto assertThrows = [&fn](const Shape &s, uint64_t offset) {
+    bool caught{false};
+    try {
+      Tensor::mapRaw(
+          DType::Float32, s, fn, Tensor::MapMode::ReadOnly, offset);
+    } catch (const poprithms::error::error &) {
+      caught = true;
+    }
+    if (!caught) {
+      std::ostringstream oss;
+      oss << "Expected mapping a file of 3 floats with shape " << s
+          << " and byte offset " << offset << " to fail.";
+      throw poprithms::test::error(oss.str());
+    }
+  };
+
+  // Too many elements:
+  assertThrows({4}, 0);
+  assertThrows({3}, 4);
+
+  // Misaligned offset:
+  assertThrows({1}, 2);
+
+  std::remove(fn.c_str());
+
+  // The file does not exist:
+  assertThrows({1}, 0);
+}
+
+void testMapNpy0() {
+  const std::string fn0 = "map_file_0_f8.npy";
+  writeNpy<double>(fn0, "<f8", "(2, 3)", {1, 2, 3, 4, 5, 6});
+  const auto a = Tensor::mapNpy(fn0, Tensor::MapMode::ReadOnly);
+  a.assertAllEquivalent(Tensor::float64({2, 3}, {1, 2, 3, 4, 5, 6}));
+
+  const std::string fn1 = "map_file_0_i8.npy";
+  writeNpy<int64_t>(fn1, "<i8", "(3,)", {-1, 0, 1});
+  const auto b = Tensor::mapNpy(fn1, Tensor::MapMode::CopyOnWrite);
+  b.assertAllEquivalent(Tensor::int64({3}, {-1, 0, 1}));
+
+  const std::string fn2 = "map_file_0_u1.npy";
+  writeNpy<uint8_t>(fn2, "|u1", "()", {7});
+  const auto c = Tensor::mapNpy(fn2, Tensor::MapMode::ReadOnly);
+  c.assertAllEquivalent(Tensor::unsigned8(7));
+
+  // The mapping of a removed file remains valid until it is unmapped.
+  std::remove(fn0.c_str());
+  a.assertAllEquivalent(Tensor::float64({2, 3}, {1, 2, 3, 4, 5, 6}));
+
+  std::remove(fn1.c_str());
+  std::remove(fn2.c_str());
+}
+
+void testBadNpy0() {
+  const std::string fn = "map_file_0_bad.npy";
+
+  auto assertThrows = [&fn](const std::string &ctxt) {
+    bool caught{false};
+    try {
+      Tensor::mapNpy(fn, Tensor::MapMode::ReadOnly);
+    } catch (const poprithms::error::error &) {
+      caught = true;
+    }
+    if (!caught) {
+      throw poprithms::test::error("Expected mapping .npy file to fail: " +
+                                   ctxt);
+    }
+  };
+
+  writeNpy<float>(fn, ">f4", "(2,)", {1, 2});
+  assertThrows("big-endian data");
+
+  writeNpy<float>(fn, "<f4", "(2, 2)", {1, 2, 3, 4}, true);
+  assertThrows("fortran order");
+
+  writeNpy<float>(fn, "<c8", "(1,)", {1, 2});
+  assertThrows("complex type");
+
+  writeNpy<float>(fn, "<f4", "(3,)", {1, 2});
+  assertThrows("too few elements");
+
+  writeRaw<float>(fn, {1, 2, 3, 4});
+  assertThrows("no magic string");
+
+  std::remove(fn.c_str());
+}
+
+} // namespace
+
+int main() {
+  testMapRaw0();
+  testCopyOnWrite0();
+  testReadOnlyInplace0();
+  testBadRaw0();
+  testMapNpy0();
+  testBadNpy0();
+  return 0;
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/alias/graph.hpp>
+#include <poprithms/util/printiter.hpp>
+
+// Compare Graph::allAliases, which only visits Tensors which share an
+// allocation with the queried Tensor, to the definition of aliasing, on a
+// Graph with many chains of view changes. The Graph is then modified with
+// toAllocation, allocationToReshape and clone, and the comparison is
+// repeated.
+//
+// Usage: all_aliases_performance_0 [N n]
+//
+// where n is the number of view changes (default 100000).
+
+namespace {
+
+using namespace poprithms::memory::alias;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+// All Tensors in #g which are aliased to #id, by testing every Tensor.
+TensorIds bruteForceAliases(const Graph &g, TensorId id) {
+  TensorIds aliases;
+  for (uint64_t i = 0; i < g.nTensors(); ++i) {
+    if (g.areAliased(TensorId(i), id)) {
+      aliases.push_back(TensorId(i));
+    }
+  }
+  return aliases;
+}
+
+void assertSame(const TensorIds &observed,
+                const TensorIds &expected,
+                TensorId id,
+                const std::string &ctxt) {
+  if (observed != expected) {
+    std::ostringstream oss;
+    oss << "Incorrect aliases of Tensor " << id << " " << ctxt
+        << ". Expected ";
+    poprithms::util::append(oss, expected);
+    oss << " but observed ";
+    poprithms::util::append(oss, observed);
+    oss << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+// Compare to the brute force aliases of every stride'th Tensor, and check
+// that allAliases() agrees with allAliases(TensorId) for all Tensors.
+void verify(const Graph &g, uint64_t stride, const std::string &ctxt) {
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (uint64_t i = 0; i < g.nTensors(); i += stride) {
+    assertSame(g.allAliases(TensorId(i)),
+               bruteForceAliases(g, TensorId(i)),
+               TensorId(i),
+               ctxt);
+  }
+  const auto tSample = seconds(t0);
+
+  t0              = std::chrono::high_resolution_clock::now();
+  const auto all  = g.allAliases();
+  const auto tAll = seconds(t0);
+
+  for (uint64_t i = 0; i < g.nTensors(); ++i) {
+    assertSame(all[i],
+               g.allAliases(TensorId(i)),
+               TensorId(i),
+               ctxt + " (allAliases())");
+  }
+
+  std::cout << ctxt << " : nTensors=" << g.nTensors()
+            << ". sampled allAliases(TensorId) + brute force=" << tSample
+            << " [s], allAliases()=" << tAll << " [s]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{100000};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  // Chains of view changes on nChains allocations, with slices and
+  // concatenations branching off of them. Creating a view change traces back
+  // through its chain to the allocation, so the chains are kept short.
+  const uint64_t nChains = std::max<uint64_t>(1, n / 100);
+  Graph g;
+  g.reserve(2 * n);
+  TensorIds ends;
+  for (uint64_t i = 0; i < nChains; ++i) {
+    ends.push_back(g.allocate({2, 3}, i % 2));
+  }
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (uint64_t i = 0; i < n; ++i) {
+    auto &end = ends[i % nChains];
+    switch ((i / nChains) % 4) {
+    case 0: {
+      end             = g.reshape(end, {6});
+      const int64_t l = i % 3;
+      g.settSample(end, Region::fromBounds({6}, {l}, {l + 3}));
+      break;
+    }
+    case 1: {
+      end = g.reverse(end, {0});
+      break;
+    }
+    case 2: {
+      end = g.reshape(end, {3, 2});
+      break;
+    }
+    default: {
+      end = g.dimShuffle(end, {{1, 0}});
+      const auto other = ends[(i + 1) % nChains];
+      g.concat({g.reshape(end, {6}), g.reshape(other, {6})}, 0);
+    }
+    }
+  }
+  std::cout << "Constructed Graph with " << n << " view changes in "
+            << seconds(t0) << " [s]" << std::endl;
+
+  const uint64_t stride = std::max<uint64_t>(1, g.nTensors() / 20);
+  verify(g, stride, "after construction");
+
+  // Convert the middle of some of the chains to allocations, so that their
+  // downstream Tensors are no longer aliased to the chains' initial
+  // allocations.
+  for (uint64_t i = 0; i < nChains; i += 3) {
+    g.toAllocation(TensorId(n / 2 + i), i % 2);
+  }
+  verify(g, stride, "after toAllocation");
+
+  // Convert one of the initial allocations into a reshape of another chain.
+  if (nChains > 1) {
+    g.allocationToReshape(ends[1], TensorId(0));
+    verify(g, stride, "after allocationToReshape");
+  }
+
+  // Clone the ends of some of the chains.
+  for (uint64_t i = 0; i < nChains; i += 7) {
+    g.clone(ends[i]);
+  }
+  verify(g, stride, "after clone");
+
+  return 0;
+}
@@ -1,6 +1,7 @@
 // Copyright (c) 2020 Graphcore Ltd. All rights reserved.
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include <poprithms/error/error.hpp>
 #include <poprithms/memory/alias/origins.hpp>
@@ -79,6 +80,57 @@ void test2() {
   }
 }
 
+void test3() {
+
+  // Allocations inserted in decreasing order, so that the inline allocation
+  // is replaced.
+  Origins o({4, 3});
+  o.insert({7}, Region::fromBounds({2, 3}, {0, 0}, {1, 3}));
+  o.insert({5}, Region::fromBounds({3, 2}, {0, 0}, {1, 2}));
+  o.insert({2}, Region::fromBounds({1, 4}, {0, 0}, {1, 4}));
+  o.insert({7}, Region::fromBounds({2, 3}, {1, 0}, {2, 2}));
+  o.insert({5}, Region::fromBounds({3, 2}, {2, 1}, {3, 2}));
+
+  if (o.getAllocIds() != std::vector<AllocId>{2, 5, 7}) {
+    throw poprithms::test::error("Expected the AllocIds to be sorted");
+  }
+  if (o.at(7).size() != 2 || o.at(5).size() != 2 || o.at(2).size() != 1) {
+    throw poprithms::test::error("Incorrect number of DisjointRegions");
+  }
+  if (o.containsAliases()) {
+    throw poprithms::test::error(
+        "12 distinct elements, in 3 allocations, are not aliased");
+  }
+
+  bool caught{false};
+  try {
+    o.at(3);
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Allocation 3 is not in the Origins");
+  }
+
+  // Remapping changes the order of the allocations.
+  std::vector<uint64_t> toNew(8, 0);
+  toNew[2]            = 9;
+  toNew[5]            = 1;
+  toNew[7]            = 4;
+  const auto remapped = o.remap(toNew);
+  if (remapped.getAllocIds() != std::vector<AllocId>{1, 4, 9} ||
+      remapped.at(9).size() != 1 || remapped.at(1).size() != 2) {
+    throw poprithms::test::error("Incorrect remapped Origins");
+  }
+
+  Origins other({2});
+  other.insert({4}, Region::fromBounds({2, 3}, {1, 1}, {2, 2}));
+  if (!remapped.isAliasedTo(other) || o.isAliasedTo(other)) {
+    throw poprithms::test::error(
+        "Only the remapped Origins contain allocation 4");
+  }
+}
+
 } // namespace
 
 int main() {
@@ -86,6 +138,7 @@ int main() {
   test0();
   test1();
   test2();
+  test3();
 
   return 0;
 }
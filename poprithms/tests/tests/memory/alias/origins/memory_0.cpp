@@ -0,0 +1,123 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <malloc.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/alias/graph.hpp>
+
+// Report the heap memory per Tensor of an alias::Graph in which most Tensors
+// alias exactly 1 allocation through 1 Region, and the time taken to query
+// containsAliases and isRowMajorSetContiguous for all of its Tensors.
+//
+// Usage: memory_0 [N n]
+//
+// where n is the approximate number of Tensors (default 1000000).
+
+namespace {
+
+using namespace poprithms::memory::alias;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+// The number of bytes currently allocated on the heap, or 0 if this is not
+// available.
+uint64_t heapBytes() {
+#if defined(__GLIBC__) &&                                                    \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+void assertExpected(bool observed,
+                    bool expected,
+                    const std::string &query,
+                    TensorId id,
+                    const Graph &g) {
+  if (observed != expected) {
+    std::ostringstream oss;
+    oss << "Expected " << query << " of " << id << " to be " << expected
+        << ". Origins of the Graph are:";
+    g.appendSettwiseOrigins(oss);
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{1000000};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  // Each allocation is followed by 8 Tensors.
+  const uint64_t nChains = std::max<uint64_t>(1, n / 9);
+
+  const auto m0 = heapBytes();
+  auto t0       = std::chrono::high_resolution_clock::now();
+
+  Graph g;
+  g.reserve(9 * nChains + 1);
+  TensorId previous = g.allocate({4, 6});
+  for (uint64_t i = 0; i < nChains; ++i) {
+    const auto a  = g.allocate({4, 6});
+    const auto r0 = g.reshape(a, {6, 4});
+    const auto s0 =
+        g.settSample(r0, Region::fromBounds({6, 4}, {0, 1}, {6, 3}));
+    const auto d0 = g.dimShuffle(s0, {{1, 0}});
+    const auto v0 = g.reverse(d0, {0});
+    const auto f0 = g.reshape(v0, {12});
+    g.concat({g.reshape(a, {24}), g.reshape(previous, {24})}, 0);
+    (void)f0;
+    previous = a;
+  }
+  const auto tConstruct = seconds(t0);
+  const auto m1         = heapBytes();
+
+  t0                   = std::chrono::high_resolution_clock::now();
+  uint64_t nAliases    = 0;
+  uint64_t nContiguous = 0;
+  for (uint64_t i = 0; i < g.nTensors(); ++i) {
+    nAliases += g.containsAliases(i);
+    nContiguous += g.isRowMajorSetContiguous(i);
+  }
+  const auto tQuery = seconds(t0);
+
+  std::cout << "nTensors=" << g.nTensors() << ". construction=" << tConstruct
+            << " [s], queries=" << tQuery << " [s], heap bytes per Tensor="
+            << static_cast<double>(m1 - m0) /
+                   static_cast<double>(g.nTensors())
+            << ", nContainsAliases=" << nAliases
+            << ", nRowMajorSetContiguous=" << nContiguous << std::endl;
+
+  // No Tensor in the Graph contains aliases. The column slices, and the
+  // concatenations of different allocations, are not contiguous. The last
+  // chain starts at Tensor 1 + 9*(nChains - 1).
+  if (nAliases != 0) {
+    throw poprithms::test::error("Expected no Tensor to contain aliases");
+  }
+  const uint64_t c = 1 + 9 * (nChains - 1);
+  const std::vector<bool> expected{
+      true, true, false, false, false, false, true, true, false};
+  for (uint64_t i = 0; i < expected.size(); ++i) {
+    assertExpected(g.isRowMajorSetContiguous(c + i),
+                   expected[i],
+                   "isRowMajorSetContiguous",
+                   c + i,
+                   g);
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <sstream>
+#include <string>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/chain/chain.hpp>
+
+namespace {
+
+using namespace poprithms::memory::chain;
+
+void assertEquivalent(const Chain &a,
+                      const Chain &b,
+                      bool expected,
+                      const std::string &ctxt) {
+  for (auto [x, y] : {std::pair<Chain, Chain>{a, b}, {b, a}}) {
+    if (x.equivalent(y) != expected || x.randomlyEquivalent(y) != expected) {
+      std::ostringstream oss;
+      oss << "Expected the Chains \n"
+          << x << "\nand\n"
+          << y << "\nto " << (expected ? "" : "not ") << "be equivalent ("
+          << ctxt << ").";
+      throw poprithms::test::error(oss.str());
+    }
+  }
+}
+
+void testReverse0() {
+
+  // Reversing a flattened (2,2) Tensor is the same as reversing both of its
+  // dimensions.
+  Chain a({2, 2});
+  a.flatten();
+  a.reverse(Dimension(0));
+  a.reshape({2, 2});
+
+  Chain b({2, 2});
+  b.reverse(Dimensions({0, 1}));
+
+  assertEquivalent(a, b, true, "reversal of flattened");
+
+  Chain c({2, 2});
+  c.reverse(Dimension(0));
+  assertEquivalent(a, c, false, "reversal of dimension 0 only");
+  assertEquivalent(b, c, false, "reversal of dimension 0 only");
+}
+
+void testRubixTwist0() {
+  Chain a({2, 3});
+  a.reverse(Dimension(0));
+  a.dimShuffle({{1, 0}});
+  a.reverse(Dimension(1));
+  a.dimShuffle({{1, 0}});
+  assertEquivalent(a, Chain({2, 3}), true, "rubix twist is identity");
+
+  Chain b({2, 3});
+  b.reverse(Dimension(0));
+  b.dimShuffle({{1, 0}});
+  b.reverse(Dimension(0));
+  b.dimShuffle({{1, 0}});
+  assertEquivalent(b, Chain({2, 3}), false, "reversal of both dimensions");
+}
+
+void testReduce0() {
+
+  // Expanding and then reducing doubles every element, so it has the same
+  // Regions as the identity, but it is not equivalent to it.
+  Chain a({1, 3});
+  a.expand({2, 3});
+  a.reduce({1, 3});
+  assertEquivalent(a, Chain({1, 3}), false, "expand and reduce");
+
+  Chain b({1, 3});
+  b.reshape({3});
+  b.expand({2, 3});
+  b.reduce({1, 3});
+  assertEquivalent(a, b, true, "expand and reduce, with a reshape");
+}
+
+void testMask0() {
+
+  // Masking the even and then the odd elements gives an empty Region.
+  Chain a({10});
+  a.mask(Region::fromStripe({10}, 0, {1, 1, 0}));
+  a.mask(Region::fromStripe({10}, 0, {1, 1, 1}));
+
+  Chain b({10});
+  b.mask(Region::createEmpty({10}));
+  assertEquivalent(a, b, true, "masks");
+
+  Chain c({10});
+  c.mask(Region::fromStripe({10}, 0, {1, 1, 0}));
+  assertEquivalent(a, c, false, "masks of the odd elements");
+}
+
+void testShapes0() {
+  Chain a({2, 3});
+  a.reshape({3, 2});
+  Chain b({3, 2});
+  assertEquivalent(a, b, false, "different input Shapes");
+  Chain c({2, 3});
+  c.reshape({6});
+  assertEquivalent(a, c, false, "different output Shapes");
+}
+
+} // namespace
+
+int main() {
+  testReverse0();
+  testRubixTwist0();
+  testReduce0();
+  testMask0();
+  testShapes0();
+  return 0;
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <array>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/inplace/graph.hpp>
+#include <poprithms/memory/inplace/tensor.hpp>
+
+namespace {
+
+using namespace poprithms::memory::inplace;
+
+// A Graph with many AliasGates, whose inputs and outputs are aliased to each
+// other through view changes and concatenations, and which are modified.
+std::vector<Tensor> getGraph(Graph &g, uint32_t seed) {
+
+  std::mt19937 rng(seed);
+
+  std::vector<Tensor> gates;
+  std::vector<Tensor> pool{Tensor::variable(g, {4, 4}),
+                           Tensor::variable(g, {4, 4})};
+
+  for (uint64_t i = 0; i < 30; ++i) {
+    const auto a = pool[rng() % pool.size()];
+    const auto b = pool[rng() % pool.size()];
+    Tensor out   = a;
+    switch (rng() % 5) {
+    case 0: {
+      out = a.dimShuffle({{1, 0}}).closedAliasGate();
+      break;
+    }
+    case 1: {
+      out = Tensor::concat({a.slice({0, 0}, {2, 4}), b.slice({2, 0}, {4, 4})},
+                           0)
+                .closedAliasGate();
+      break;
+    }
+    case 2: {
+      out = a.reverse(0).closedAliasGate();
+      out.modify();
+      break;
+    }
+    case 3: {
+      out = Tensor::aliasGate({a, b});
+      break;
+    }
+    default: {
+      out = a.flatten().reshape({4, 4}).closedAliasGate();
+      out.slice({1, 1}, {3, 3}).modify();
+    }
+    }
+    if (out.opTypeString().find("AliasGate") != std::string::npos) {
+      gates.push_back(out);
+    }
+    pool.push_back(out);
+  }
+
+  return gates;
+}
+
+void testEquivalentToUncached0() {
+  for (uint32_t seed = 0; seed < 20; ++seed) {
+    for (auto check :
+         {CheckParallelWriteable::No, CheckParallelWriteable::Yes}) {
+      for (auto allow : {AllowMultiGateAlias::No, AllowMultiGateAlias::Yes}) {
+
+        Graph g0;
+        Graph g1;
+        const auto gates0 = getGraph(g0, seed);
+        const auto gates1 = getGraph(g1, seed);
+
+        // Every cached answer in g0 is compared to the uncached answer, g1
+        // trusts the cache.
+        g0.setAliasCacheDebug(AliasCacheDebug::On);
+
+        // Between the proposals, the same Ops are inserted into both Graphs.
+        // The inserted Ops alias and modify the output of an AliasGate, and
+        // so change the aliases of Tensors which might be in the cache.
+        OpeningStatuses s0;
+        OpeningStatuses s1;
+        for (uint64_t i = 0; i < gates0.size(); ++i) {
+          s0.push_back(g0.tryOpening({gates0[i].opId(), 0}, check, allow));
+          s1.push_back(g1.tryOpening({gates1[i].opId(), 0}, check, allow));
+          gates0[i].reverse(0).modify();
+          gates1[i].reverse(0).modify();
+          Tensor::variable(g0, {1});
+          Tensor::variable(g1, {1});
+        }
+
+        if (s0 != s1) {
+          std::ostringstream oss;
+          oss << "The opening statuses with the alias cache verified differ "
+              << "from the opening statuses with the cache trusted, with Ops "
+              << "inserted between the openings, for seed " << seed << '.';
+          throw poprithms::test::error(oss.str());
+        }
+      }
+    }
+  }
+}
+
+// The Graph in testBackout0, whose AliasGates are returned.
+std::array<Tensor, 2> getBackoutGraph(Graph &g) {
+  const auto x0 = Tensor::variable(g, {3, 3});
+  const auto m0 = x0.reverse(0).closedAliasGate();
+  m0.modify();
+  x0.modify();
+
+  const auto m1 = x0.slice({0, 0}, {1, 3}).closedAliasGate();
+  m1.modify();
+  return {m0, m1};
+}
+
+void testBackout0() {
+
+  // The aliases of x0 change when the AliasGate m0 is opened, and again when
+  // the opening is backed out. After the backouts, the openings are the same
+  // as in a Graph in which m0 was never opened.
+  Graph g;
+  g.setAliasCacheDebug(AliasCacheDebug::On);
+  const auto [m0, m1] = getBackoutGraph(g);
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    auto r = g.tryOpeningPartial({m0, 0}, CheckParallelWriteable::No);
+    if (r.status() != OpeningStatus::Valid) {
+      throw poprithms::test::error("Expected the opening of m0 to be valid");
+    }
+    g.backoutOpening({m0, 0});
+  }
+
+  Graph expected;
+  const auto [e0, e1] = getBackoutGraph(expected);
+
+  auto assertSameOpening = [&g, &expected](const Tensor &gate,
+                                           const Tensor &expectedGate) {
+    const auto s0 = g.tryOpening({gate, 0}, CheckParallelWriteable::No);
+    const auto s1 =
+        expected.tryOpening({expectedGate, 0}, CheckParallelWriteable::No);
+    if (s0 != s1) {
+      std::ostringstream oss;
+      oss << "Expected the opening status after backouts to be " << s1
+          << ", not " << s0 << '.';
+      throw poprithms::test::error(oss.str());
+    }
+  };
+
+  assertSameOpening(m1, e1);
+  assertSameOpening(m0, e0);
+}
+
+} // namespace
+
+int main() {
+  testEquivalentToUncached0();
+  testBackout0();
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/inplace/graph.hpp>
+#include <poprithms/memory/inplace/tensor.hpp>
+
+// Compare Graph::tryOpeningsBatched, which processes the Proposals of
+// different connected components concurrently, to Graph::tryOpenings, on a
+// Graph with many independent components. The first three quarters of the
+// Proposals are processed in batches, and the last quarter is processed one
+// at a time on both Graphs, which checks that the schedules are still
+// consistent with each other after the batches.
+//
+// Proposals are only processed concurrently with incremental schedule
+// updates. With full recomputation, tryOpeningsBatched is tryOpenings.
+//
+// Usage: batched_openings_0 [N n]
+//
+// where n is the number of AliasGates in each component (default 500).
+
+namespace {
+
+using namespace poprithms::memory::inplace;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+// A Graph with #nComponents components, each with #nGates AliasGates. The
+// Ops of the components are interleaved, so that the schedule indices of
+// each component are not contiguous.
+TensorIds getGraph(Graph &g, uint64_t nComponents, uint64_t nGates) {
+
+  std::mt19937 rng(1011);
+  std::vector<std::vector<Tensor>> pools;
+  for (uint64_t c = 0; c < nComponents; ++c) {
+    pools.push_back({Tensor::variable(g, {4, 4}), Tensor::variable(g, {4, 4})});
+  }
+
+  TensorIds gates;
+  for (uint64_t i = 0; i < nGates; ++i) {
+    for (auto &pool : pools) {
+      const auto a =
+          pool[pool.size() - 1 - rng() % std::min<uint64_t>(pool.size(), 8)];
+      const auto b = pool[rng() % pool.size()];
+      Tensor out   = a;
+      switch (rng() % 3) {
+      case 0: {
+        out = a.dimShuffle({{1, 0}}).closedAliasGate();
+        out.modify();
+        break;
+      }
+      case 1: {
+        out = Tensor::concat(
+                  {a.slice({0, 0}, {2, 4}), b.slice({2, 0}, {4, 4})}, 0)
+                  .closedAliasGate();
+        a.modify();
+        break;
+      }
+      default: {
+        out = a.reverse(0).closedAliasGate();
+        b.modify();
+      }
+      }
+      gates.push_back(out.id());
+      pool.push_back(out);
+    }
+  }
+  return gates;
+}
+
+void assertSame(const OpeningStatuses &expected,
+                const OpeningStatuses &observed,
+                const std::string &ctxt) {
+  if (expected != observed) {
+    std::ostringstream oss;
+    oss << "Statuses of tryOpeningsBatched differ from those of tryOpenings "
+        << ctxt << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void test(uint64_t nComponents,
+          uint64_t nGates,
+          uint64_t nThreads,
+          ScheduleUpdate u) {
+
+  Graph g0;
+  Graph g1;
+  const auto gates = getGraph(g0, nComponents, nGates);
+  getGraph(g1, nComponents, nGates);
+  g0.setScheduleUpdate(u);
+  g1.setScheduleUpdate(u);
+
+  // The Proposals are split into 4 quarters. The first 2 are processed in
+  // consecutive batches, so that the second batch reuses the copies made by
+  // the first. An Op is then inserted, so that the third batch makes new
+  // copies. The last quarter is processed one at a time.
+  std::vector<Proposals> quarters;
+  for (uint64_t q = 0; q < 4; ++q) {
+    const auto begin = gates.cbegin() + q * gates.size() / 4;
+    const auto end   = gates.cbegin() + (q + 1) * gates.size() / 4;
+    quarters.push_back(Proposal::open0(TensorIds(begin, end)));
+  }
+
+  std::ostringstream ctxt;
+  ctxt << "(nComponents=" << nComponents << ", nThreads=" << nThreads
+       << ", " << u << ")";
+
+  for (uint64_t q = 0; q < 3; ++q) {
+    if (q == 2) {
+      for (auto *g : {&g0, &g1}) {
+        g->modify(g->variable({4, 4}));
+      }
+    }
+    auto t0         = std::chrono::high_resolution_clock::now();
+    const auto s0   = g0.tryOpenings(quarters[q], CheckParallelWriteable::Yes);
+    const auto tSeq = seconds(t0);
+    t0              = std::chrono::high_resolution_clock::now();
+    const auto s1   = g1.tryOpeningsBatched(quarters[q],
+                                          CheckParallelWriteable::Yes,
+                                          AllowMultiGateAlias::Yes,
+                                          nThreads);
+    const auto tPar = seconds(t0);
+
+    std::cout << ctxt.str() << " batch " << q << ": sequential=" << tSeq
+              << " [s], batched=" << tPar << " [s]. "
+              << g1.scheduleUpdateStats() << std::endl;
+
+    assertSame(s0, s1, "for batch " + std::to_string(q) + " " + ctxt.str());
+
+    if (g0 != g1) {
+      throw poprithms::test::error("Graphs differ after batch " +
+                                   std::to_string(q) + " " + ctxt.str());
+    }
+  }
+
+  assertSame(g0.tryOpenings(quarters[3], CheckParallelWriteable::Yes),
+             g1.tryOpenings(quarters[3], CheckParallelWriteable::Yes),
+             "after the batches " + ctxt.str());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{500};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  // With 1 component, tryOpeningsBatched is tryOpenings.
+  test(1, n, 4, ScheduleUpdate::Incremental);
+  for (uint64_t nThreads : {1, 2, 4}) {
+    test(8, n, nThreads, ScheduleUpdate::Incremental);
+  }
+  test(8, n, 4, ScheduleUpdate::Full);
+  return 0;
+}
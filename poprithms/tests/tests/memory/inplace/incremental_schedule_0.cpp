@@ -0,0 +1,254 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/inplace/graph.hpp>
+#include <poprithms/memory/inplace/tensor.hpp>
+
+// Compare the incremental schedule update (ScheduleUpdate::Incremental) to
+// the full recomputation of the schedule (ScheduleUpdate::Full).
+//
+// The Constraints of a Proposal depend on the schedule when it is
+// processed, and the two do not maintain the same schedule, so a sequence
+// of Proposals is not necessarily accepted by both. But for every Proposal,
+// starting from the same schedule, they must agree on the status and on
+// the Constraints inserted. This is checked on random Graphs, with every
+// incremental update compared to the vanilla scheduler
+// (ScheduleUpdate::IncrementalDebug).
+//
+// The time of processing all Proposals with each of the 2 options is also
+// reported.
+//
+// Usage: incremental_schedule_0 [N n]
+//
+// where n is the number of AliasGates in the Graph (default 500).
+
+namespace {
+
+using namespace poprithms::memory::inplace;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+// A Graph with many AliasGates, with many modifiers which must be
+// constrained to be scheduled after the reads of their new aliases.
+TensorIds getGraph(Graph &g, uint64_t nGates, uint32_t seed) {
+
+  std::mt19937 rng(seed);
+
+  TensorIds gates;
+  std::vector<Tensor> pool{Tensor::variable(g, {4, 4}),
+                           Tensor::variable(g, {4, 4})};
+
+  for (uint64_t i = 0; i < nGates; ++i) {
+    // Mostly choose recent Tensors, so that the Graph is deep.
+    const auto a =
+        pool[pool.size() - 1 - rng() % std::min<uint64_t>(pool.size(), 8)];
+    const auto b = pool[rng() % pool.size()];
+    Tensor out   = a;
+    switch (rng() % 4) {
+    case 0: {
+      out = a.dimShuffle({{1, 0}}).closedAliasGate();
+      out.modify();
+      break;
+    }
+    case 1: {
+      out = Tensor::concat({a.slice({0, 0}, {2, 4}), b.slice({2, 0}, {4, 4})},
+                           0)
+                .closedAliasGate();
+      a.modify();
+      break;
+    }
+    case 2: {
+      out = a.reverse(0).closedAliasGate();
+      out.slice({1, 1}, {3, 3}).modify();
+      break;
+    }
+    default: {
+      out = a.flatten().reshape({4, 4}).closedAliasGate();
+      b.modify();
+    }
+    }
+    gates.push_back(out.id());
+    pool.push_back(out);
+  }
+
+  return gates;
+}
+
+void assertStat(uint64_t observed,
+                uint64_t expected,
+                const std::string &n,
+                const Graph &g) {
+  if (observed != expected) {
+    std::ostringstream oss;
+    oss << "Expected " << n << " to be " << expected << ", not " << observed
+        << ". Stats are " << g.scheduleUpdateStats() << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+// Force the schedule of #g to be recomputed from scratch, which throws an
+// error if the Graph contains a cycle.
+void assertNoCycle(Graph &g) {
+  const auto gate = Tensor::variable(g, {1}).closedAliasGate();
+  g.tryOpening({gate, 0}, CheckParallelWriteable::No);
+}
+
+void testIncremental(uint64_t nGates, uint32_t seed) {
+
+  Graph g0;
+  Graph g1;
+  const auto gates0 = getGraph(g0, nGates, seed);
+  const auto gates1 = getGraph(g1, nGates, seed);
+  g0.setScheduleUpdate(ScheduleUpdate::Incremental);
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  OpeningStatuses s0;
+  for (auto id : gates0) {
+    s0.push_back(g0.tryOpening({id.opId(), 0}, CheckParallelWriteable::No));
+  }
+  const auto tIncremental = seconds(t0);
+
+  t0 = std::chrono::high_resolution_clock::now();
+  OpeningStatuses s1;
+  for (auto id : gates1) {
+    s1.push_back(g1.tryOpening({id.opId(), 0}, CheckParallelWriteable::No));
+  }
+  const auto tFull = seconds(t0);
+
+  auto count = [](const OpeningStatuses &ss, OpeningStatus s) {
+    return static_cast<uint64_t>(std::count(ss.cbegin(), ss.cend(), s));
+  };
+  const auto nValid = count(s0, OpeningStatus::Valid);
+  const auto nCycle = count(s0, OpeningStatus::Cycle);
+
+  std::cout << "seed=" << seed << " nGates=" << nGates
+            << ". incremental=" << tIncremental << " [s] (" << nValid
+            << " valid), full=" << tFull << " [s] ("
+            << count(s1, OpeningStatus::Valid) << " valid). "
+            << g0.scheduleUpdateStats() << std::endl;
+
+  const auto &stats = g0.scheduleUpdateStats();
+  assertStat(stats.nFull, 1, "nFull", g0);
+  assertStat(
+      stats.nUnchanged + stats.nIncremental, nValid, "nUnchanged+nInc", g0);
+  assertStat(stats.nCycles, nCycle, "nCycles", g0);
+
+  g0.resetScheduleUpdateStats();
+  assertStat(g0.scheduleUpdateStats().nIncremental, 0, "nIncremental", g0);
+
+  assertNoCycle(g0);
+  assertStat(g0.scheduleUpdateStats().nFull, 1, "nFull", g0);
+  assertNoCycle(g1);
+}
+
+// For each Proposal, process it on a Graph with incremental updates, and on
+// a copy of the Graph with full recomputation.
+void testSameAsFull(uint64_t nGates, uint32_t seed) {
+
+  Graph g;
+  const auto gates = getGraph(g, nGates, seed);
+  g.setScheduleUpdate(ScheduleUpdate::IncrementalDebug);
+
+  for (auto id : gates) {
+    Graph full = g;
+    full.setScheduleUpdate(ScheduleUpdate::Full);
+    const auto s0 = g.tryOpening({id.opId(), 0}, CheckParallelWriteable::No);
+    const auto s1 =
+        full.tryOpening({id.opId(), 0}, CheckParallelWriteable::No);
+    if (s0 != s1) {
+      std::ostringstream oss;
+      oss << "With seed " << seed << ", the status of opening " << id
+          << " with the incremental schedule update is " << s0
+          << ", but with full recomputation it is " << s1 << '.';
+      throw poprithms::test::error(oss.str());
+    }
+    if (g != full) {
+      std::ostringstream oss;
+      oss << "With seed " << seed << ", the Graphs differ after opening "
+          << id << " with the incremental schedule update, and with full "
+          << "recomputation, although the statuses are both " << s0 << '.';
+      throw poprithms::test::error(oss.str());
+    }
+  }
+}
+
+// Backing out an opening restores the schedule, so that the statuses of all
+// later Proposals are the same as if the opening was never attempted.
+void testBackout0(uint64_t nGates, uint32_t seed) {
+
+  Graph g0;
+  Graph g1;
+  const auto gates0 = getGraph(g0, nGates, seed);
+  const auto gates1 = getGraph(g1, nGates, seed);
+  g0.setScheduleUpdate(ScheduleUpdate::IncrementalDebug);
+  g1.setScheduleUpdate(ScheduleUpdate::IncrementalDebug);
+
+  for (uint64_t i = 0; i < gates0.size(); ++i) {
+    const auto r =
+        g0.tryOpeningPartial({gates0[i].opId(), 0}, CheckParallelWriteable::No);
+    g0.backoutOpening({gates0[i].opId(), 0});
+    const auto s0 =
+        g0.tryOpening({gates0[i].opId(), 0}, CheckParallelWriteable::No);
+    const auto s1 =
+        g1.tryOpening({gates1[i].opId(), 0}, CheckParallelWriteable::No);
+    if (s0 != s1 || r.status() != s0) {
+      std::ostringstream oss;
+      oss << "With seed " << seed << ", after the partial opening " << r
+          << " was backed out, the status is " << s0 << " and not " << s1
+          << '.';
+      throw poprithms::test::error(oss.str());
+    }
+  }
+}
+
+void testReorder0() {
+
+  // Opening the AliasGate makes x0 an alias of m0, so the reader r0 of x0
+  // must be scheduled before the modifier of m0. r0 is created after the
+  // modifier, so the schedule must change.
+  Graph g;
+  g.setScheduleUpdate(ScheduleUpdate::Incremental);
+  const auto x0 = Tensor::variable(g, {3});
+  const auto m0 = x0.closedAliasGate();
+  m0.modify();
+  const auto r0 = Tensor::concat({x0, x0}, 0);
+  (void)r0;
+
+  if (g.tryOpening({m0, 0}, CheckParallelWriteable::No) !=
+      OpeningStatus::Valid) {
+    throw poprithms::test::error("Expected the opening of m0 to be valid");
+  }
+  const auto &stats = g.scheduleUpdateStats();
+  assertStat(stats.nFull, 1, "nFull", g);
+  assertStat(stats.nIncremental + stats.nUnchanged, 1, "nOpenings", g);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{500};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  testReorder0();
+  for (uint32_t seed = 0; seed < 5; ++seed) {
+    testIncremental(n, seed);
+  }
+  for (uint32_t seed = 0; seed < 10; ++seed) {
+    testSameAsFull(60, seed);
+    testBackout0(60, seed);
+  }
+  return 0;
+}
@@ -1,5 +1,6 @@
 // Copyright (c) 2020 Graphcore Ltd. All rights reserved.
 #include <iostream>
+#include <vector>
 
 #include <poprithms/error/error.hpp>
 #include <poprithms/memory/nest/region.hpp>
@@ -67,6 +68,41 @@ void testReduce() {
   }
 }
 
+void testIntersectEmpty0() {
+
+  // Enough Regions that the intersection uses a spatial index, which does
+  // not index the empty Region.
+  const Shape shape{100, 100};
+  std::vector<Region> rows;
+  for (uint64_t i = 0; i < 70; ++i) {
+    rows.push_back(Region::fromBounds(shape, Dimension(0), i, i + 1));
+  }
+  const DisjointRegions many(shape, rows);
+  const DisjointRegions empty(Region::createEmpty(shape));
+
+  for (const auto &inter : {empty.intersect(many), many.intersect(empty)}) {
+    if (!inter.empty()) {
+      throw poprithms::test::error(
+          "The intersection with an empty Region should be empty");
+    }
+  }
+  if (!empty.disjoint(many) || !many.disjoint(empty)) {
+    throw poprithms::test::error(
+        "An empty Region should be disjoint from all Regions");
+  }
+
+  // The intersection with non-empty Regions is unchanged.
+  const DisjointRegions twoRows(
+      Region::fromBounds(shape, Dimension(0), 5, 7));
+  if (many.intersect(twoRows).totalElms() != 200) {
+    throw poprithms::test::error(
+        "Expected 2 rows in the intersection of the rows and rows 5 and 6");
+  }
+}
+
 } // namespace
 
-int main() { testReduce(); }
+int main() {
+  testReduce();
+  testIntersectEmpty0();
+}
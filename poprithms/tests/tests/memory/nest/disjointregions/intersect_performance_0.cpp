@@ -0,0 +1,171 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <testutil/memory/nest/randomregion.hpp>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/nest/region.hpp>
+
+// Compare DisjointRegions::intersect and DisjointRegions::disjoint, which
+// use a spatial index when there are many Regions, to the all-pairs
+// definitions of intersection and disjointedness. The Regions are
+// representative of tensors built from concatenations of slices.
+//
+// Usage: intersect_performance_0 [N n]
+//
+// where n is the number of slices which are concatenated (default 256).
+
+namespace {
+
+using namespace poprithms::memory::nest;
+
+DisjointRegions allPairsIntersect(const DisjointRegions &a,
+                                  const DisjointRegions &b) {
+  std::vector<Region> out;
+  for (const auto &r0 : a.get()) {
+    for (const auto &r1 : b.get()) {
+      const auto r01 = r0.intersect(r1).get();
+      out.insert(out.end(), r01.cbegin(), r01.cend());
+    }
+  }
+  return DisjointRegions(a.shape(), out);
+}
+
+bool allPairsDisjoint(const DisjointRegions &a, const DisjointRegions &b) {
+  for (const auto &r0 : a.get()) {
+    for (const auto &r1 : b.get()) {
+      if (!r0.disjoint(r1)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The same Regions, in the same order.
+bool identical(const DisjointRegions &a, const DisjointRegions &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (uint64_t i = 0; i < a.size(); ++i) {
+    if (!a.at(i).equivalent(b.at(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+void compare(const DisjointRegions &a,
+             const DisjointRegions &b,
+             const std::string &ctxt) {
+
+  auto t0            = std::chrono::high_resolution_clock::now();
+  const auto indexed = a.intersect(b);
+  const auto tIndex  = seconds(t0);
+
+  t0                  = std::chrono::high_resolution_clock::now();
+  const auto expected = allPairsIntersect(a, b);
+  const auto tPairs   = seconds(t0);
+
+  std::cout << ctxt << " : |a|=" << a.size() << " |b|=" << b.size()
+            << " |a.intersect(b)|=" << indexed.size()
+            << ". indexed=" << tIndex << " [s], all-pairs=" << tPairs
+            << " [s]" << std::endl;
+
+  // The indexed intersection visits the intersecting pairs in the same order
+  // as the all-pairs intersection, so the results are identical.
+  if (!identical(indexed, expected)) {
+    std::ostringstream oss;
+    oss << "Indexed intersection differs from the all-pairs intersection, "
+        << "for " << ctxt << ". Expected " << expected << " but observed "
+        << indexed << '.';
+    throw poprithms::test::error(oss.str());
+  }
+
+  if (a.disjoint(b) != allPairsDisjoint(a, b)) {
+    throw poprithms::test::error("Indexed disjoint differs for " + ctxt);
+  }
+}
+
+// The concatenation of the n slices [i*w + shift, i*w + shift + w - 1) of
+// a tensor of shape (n*w, 16).
+DisjointRegions concatOfSlices(int64_t n, int64_t w, int64_t shift) {
+  const Shape shape{n * w, 16};
+  std::vector<Region> regs;
+  for (int64_t i = 0; i < n; ++i) {
+    const int64_t l = std::min(i * w + shift, n * w - 1);
+    const int64_t u = std::min(i * w + w - 1 + shift, n * w);
+    regs.push_back(Region::fromBounds(shape, {l, 0}, {u, 16}));
+  }
+  return DisjointRegions(shape, regs);
+}
+
+// The n slices of width w in dimension 1, each strided by 2 in dimension 0.
+DisjointRegions stridedColumns(int64_t n, int64_t w, int64_t phase) {
+  const Shape shape{32, n * w};
+  std::vector<Region> regs;
+  for (int64_t i = 0; i < n; ++i) {
+    regs.push_back(Region(shape,
+                          {{{{1, 1, phase}}}, {{{w, n * w - w, i * w}}}}));
+  }
+  return DisjointRegions(shape, regs);
+}
+
+void testRandom() {
+  // Random Regions, with few enough Regions that the index is not used, and
+  // many enough that it is.
+  const Shape shape{12, 18};
+  for (uint64_t n : {3, 12}) {
+    for (uint32_t seed = 0; seed < 10; ++seed) {
+      std::vector<DisjointRegions> a;
+      std::vector<DisjointRegions> b;
+      for (uint64_t i = 0; i < n; ++i) {
+        a.push_back(getRandomRegion(shape, 100 * seed + i, 2));
+        b.push_back(getRandomRegion(shape, 100 * seed + n + i, 2));
+      }
+      const auto ua = DisjointRegions::createUnion(a);
+      const auto ub = DisjointRegions::createUnion(b);
+      compare(ua, ub, "random (seed=" + std::to_string(seed) + ")");
+      if (!Region::equivalent(ua.intersect(ub), ub.intersect(ua))) {
+        throw poprithms::test::error("Intersection is not commutative");
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  int64_t n{256};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoi(argv[2]);
+  }
+
+  testRandom();
+
+  compare(concatOfSlices(n, 4, 0),
+          concatOfSlices(n, 4, 2),
+          "concat of shifted slices");
+  compare(concatOfSlices(n, 4, 0),
+          concatOfSlices(n, 4, 0),
+          "concat of identical slices");
+  compare(stridedColumns(n, 3, 0),
+          stridedColumns(n, 3, 1),
+          "disjoint strided columns");
+  compare(stridedColumns(n, 3, 0),
+          DisjointRegions(Region::fromBounds({32, n * 3}, {0, 5}, {32, 40})),
+          "strided columns and a slice");
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <testutil/memory/unwind/fullstate.hpp>
+#include <testutil/memory/unwind/graph.hpp>
+#include <testutil/memory/unwind/op.hpp>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/unwind/sumlike.hpp>
+
+// Compare the layouts obtained by lowering sequentially and in parallel.
+//
+// Usage: lower_parallel_0 [N n]
+//
+// where n is the number of matmuls (default 64).
+
+namespace {
+
+using namespace poprithms;
+using poprithms::memory::unwind::SumAttractions;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+void testMatMuls0(uint64_t n) {
+
+  unwindtoy::Graph g;
+
+  /**
+   * For each i in [0, n):
+   *
+   *   input (lhs_i) ---+
+   *                    +--> matmul --+
+   *   input (rhs_i) ---+             +--> sum
+   *                    |             |
+   *   input (bias_i) --|-------------+
+   *                    |
+   *   input (shared) --+--> slice_i --> matmul
+   *
+   * There are many independent sinks, and one (shared) sink with n paths to
+   * it. The shared input has rows which are sliced for each matmul.
+   * */
+
+  const auto shared = g.input({static_cast<int64_t>(2 * n), 6}, 1.0);
+  unwindtoy::TensorIds inputs{shared};
+  for (uint64_t i = 0; i < n; ++i) {
+    const auto lhs  = g.input({4, 6}, 1.0);
+    const auto rhs  = g.input({6, 3}, 1.0);
+    const auto bias = g.input({1, 3}, 1.0);
+    const auto mm   = g.matmul(lhs, rhs);
+    g.sum({mm, bias}, SumAttractions(10.0));
+    const auto lower = static_cast<int64_t>(2 * i);
+    g.matmul(g.slice(shared, {lower, 0}, {lower + 2, 6}), rhs);
+    inputs.insert(inputs.end(), {lhs, rhs, bias});
+  }
+
+  unwindtoy::FullState sequential(g);
+  auto t0 = std::chrono::high_resolution_clock::now();
+  sequential.lower();
+  const auto tSequential = seconds(t0);
+
+  for (uint64_t nThreads : {1, 2, 4}) {
+    unwindtoy::FullState parallel(g);
+    t0 = std::chrono::high_resolution_clock::now();
+    parallel.lowerParallel(nThreads);
+    const auto tParallel = seconds(t0);
+
+    std::cout << "n=" << n << ", sequential=" << tSequential
+              << " [s], nThreads=" << nThreads << ", parallel=" << tParallel
+              << " [s]" << std::endl;
+
+    for (auto id : inputs) {
+      parallel.mainLayout(id).assertAllEquivalent(sequential.mainLayout(id));
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{64};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  testMatMuls0(n);
+  return 0;
+}
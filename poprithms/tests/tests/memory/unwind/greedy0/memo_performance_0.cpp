@@ -0,0 +1,166 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/nest/memo.hpp>
+#include <poprithms/memory/unwind/graph.hpp>
+#include <poprithms/memory/unwind/solution.hpp>
+
+// Compare the Solutions of unwind Graphs with and without the memoization of
+// Sett and Region operations, and with several threads sharing the cache.
+// The Graphs are of the same form as the group convolution and chains of
+// view changes in the other tests in this directory, with many calls.
+//
+// Usage: memo_performance_0 [N n]
+//
+// where n is the number of calls (default 64).
+
+namespace {
+
+using namespace poprithms::memory::unwind;
+using poprithms::memory::nest::Memo;
+using poprithms::memory::nest::MemoizedOp;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+Graph getGraph(uint64_t nCalls) {
+
+  Graph g;
+
+  const Shape actInShape{10, 8};
+  const Shape weightShape{6, 2};
+  const Shape actOutShape{6, 3};
+  const Shape biasShape{3};
+
+  const auto innerAct  = g.sink(actInShape);
+  const auto actSource = g.source(actInShape);
+  g.insertValuedPair(innerAct, actSource, 10.);
+
+  const auto innerWeight  = g.sink(weightShape);
+  const auto weightSource = g.source(weightShape);
+  g.insertValuedPair(innerWeight, weightSource, 20.);
+
+  const auto innerBias  = g.sink(biasShape);
+  const auto convOp     = g.barrier({innerAct, innerWeight}, {actOutShape});
+  const auto sumLikeOut = g.sumLike({{convOp, 0}, innerBias}, InIndex(0), 5.);
+
+  const int64_t repl     = static_cast<int64_t>(nCalls);
+  const auto outerAct    = g.sink(actInShape.broadcast(repl, 0));
+  const auto outerWeight = g.sink(weightShape.broadcast(repl, 0));
+  const auto outerBias   = g.sink(biasShape.broadcast(repl, 0));
+
+  TensorIds callOuts;
+  for (uint64_t i = 0; i < nCalls; ++i) {
+
+    // The activations are sliced out of a reversed, transposed view of the
+    // outer activations, so that their Regions are strided.
+    const auto actView = g.reshape(
+        g.dimShuffle(g.reshape(outerAct, {repl, 10, 8}), {{0, 2, 1}}),
+        {repl * 8, 10});
+    const auto actSlice = g.reshape(
+        g.slice(g.reverse(actView, Dimensions({0})), i * 8, i * 8 + 8),
+        actInShape);
+
+    const auto weight0 = weightShape.dim_u64(0);
+    auto weightSlice   = g.slice(outerWeight, i * weight0, (i + 1) * weight0);
+
+    const auto bias0 = biasShape.dim_u64(0);
+    auto biasSlice   = g.slice(outerBias, i * bias0, (i + 1) * bias0);
+
+    callOuts.push_back(g.call({actSlice, weightSlice, biasSlice},
+                              {innerAct, innerWeight, innerBias},
+                              {sumLikeOut.out()},
+                              11.)[0]);
+  }
+
+  const auto out = g.concat(callOuts, 1);
+  g.flatten(g.subSample(out, Strides({2, 3})));
+
+  return g;
+}
+
+void assertSame(const Solution &expected,
+                const Solution &observed,
+                const std::string &ctxt) {
+  if (expected.getScore() != observed.getScore() ||
+      expected.barriersToSinks() != observed.barriersToSinks()) {
+    std::ostringstream oss;
+    oss << "The Solution " << ctxt
+        << " differs from the Solution without memoization.";
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{64};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  const auto g = getGraph(n);
+
+  Memo::disable();
+  auto t0 = std::chrono::high_resolution_clock::now();
+  const Solution expected(g);
+  const auto tOff = seconds(t0);
+
+  Memo::clear();
+  Memo::enable();
+  t0 = std::chrono::high_resolution_clock::now();
+  const Solution cold(g);
+  const auto tCold = seconds(t0);
+  assertSame(expected, cold, "with an empty cache");
+
+  t0 = std::chrono::high_resolution_clock::now();
+  const Solution warm(g);
+  const auto tWarm = seconds(t0);
+  assertSame(expected, warm, "with a full cache");
+
+  std::ostringstream stats;
+  Memo::appendStats(stats);
+  Memo::logStats();
+
+  std::cout << "nCalls=" << n << ". without memoization=" << tOff
+            << " [s], empty cache=" << tCold << " [s], full cache=" << tWarm
+            << " [s]. " << stats.str() << std::endl;
+
+  if (Memo::hits(MemoizedOp::Intersect) == 0) {
+    throw poprithms::test::error("Expected intersections to be cached");
+  }
+
+  // Several threads sharing a cache, with a capacity small enough that it is
+  // cleared while they are running.
+  Memo::clear();
+  Memo::setCapacity(64);
+  std::vector<std::unique_ptr<Solution>> solutions(4);
+  std::vector<std::thread> threads;
+  for (uint64_t i = 0; i < solutions.size(); ++i) {
+    threads.emplace_back([&solutions, &g, i]() {
+      solutions[i] = std::make_unique<Solution>(g);
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  for (const auto &s : solutions) {
+    assertSame(expected, *s, "with a shared cache");
+  }
+
+  Memo::disable();
+  Memo::clear();
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/unwind/graph.hpp>
+#include <poprithms/memory/unwind/hosttensorhelper.hpp>
+#include <poprithms/memory/unwind/solution.hpp>
+
+namespace {
+using namespace poprithms::memory::unwind;
+using namespace poprithms;
+
+void assertScore(const Solution &soln,
+                 double expected,
+                 const std::string &ctxt) {
+  if (soln.getScore() != expected) {
+    std::ostringstream oss;
+    oss << "Expected the score " << ctxt << " to be " << expected
+        << ", not " << soln.getScore() << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void greedyIsSuboptimal0() {
+
+  /**
+   *
+   *          +-- slice [0, 6) ...... sourceA (10 per element)
+   *          |
+   *   sink --+-- reverse ........... sourceB (9 per element)
+   *   (10)   |
+   *          +-- reverse ........... sourceB (9 per element)
+   *
+   * Greedy0 sets the layout of the first 6 elements of the sink from
+   * sourceA, which is the most valuable ValuedPair, obtaining 60 points.
+   * The remaining 4 elements obtain 4*9 points from each of the reverses.
+   * This is a total of 60 + 36 + 36 = 132 points.
+   *
+   * Setting the layout of the sink entirely from sourceB obtains 90 points
+   * from each of the reverses, which is a total of 180 points.
+   * */
+
+  Graph g;
+  const auto sink    = g.sink({10});
+  const auto sourceA = g.source({6});
+  const auto sourceB = g.source({10});
+  g.insertValuedPair(g.slice(sink, 0, 6), sourceA, 10.);
+  g.insertValuedPair(g.reverse(sink, Dimensions({0})), sourceB, 9.);
+  g.insertValuedPair(g.reverse(sink, Dimensions({0})), sourceB, 9.);
+
+  const Solution greedy(g);
+  assertScore(greedy, 132., "of Greedy0");
+
+  const Solution refined(g, Algo::Greedy0Refine);
+  assertScore(refined, 180., "of Greedy0Refine");
+
+  // The layout of the sink is the reverse of sourceB.
+  const auto barVals = HostTensorHelper::arangeBarriers(g);
+  HostTensorHelper::get(refined, sink, barVals)
+      .assertAllEquivalent(barVals.at(sourceB).reverse(0));
+
+  if (refined.barriersToSinks().size() != 1 ||
+      refined.barriersToSinks()[0].src() != sourceB) {
+    throw poprithms::test::error(
+        "Expected 1 Path to the sink, from sourceB");
+  }
+
+  // With no iterations, the refinement is just Greedy0.
+  const Solution unrefined(g, Algo::Greedy0Refine, RefinementBudget{0, 10.});
+  assertScore(unrefined, 132., "of Greedy0Refine with no iterations");
+
+  // By default only the number of iterations is limited, so that the
+  // Solution does not depend on the speed of the machine.
+  if (!std::isinf(RefinementBudget().maxSeconds)) {
+    throw poprithms::test::error(
+        "Expected the default RefinementBudget to have no time limit");
+  }
+
+  // With no time, there are no iterations.
+  const Solution timedOut(g, Algo::Greedy0Refine, RefinementBudget{10, 0.});
+  assertScore(timedOut, 132., "of Greedy0Refine with no time");
+}
+
+void greedyIsOptimal0() {
+
+  // A Graph in which Greedy0 obtains the maximum possible score, see
+  // order_matters_0.cpp.
+  Graph g;
+  auto x       = g.sink({4});
+  auto x0      = g.slice(x, 0, 3);
+  auto x1      = g.slice(x, 1, 4);
+  auto source0 = g.source({3});
+  auto source1 = g.source({3});
+  g.insertValuedPair(x0, source0, 10.0);
+  g.insertValuedPair(x1, source1, 20.0);
+
+  const Solution greedy(g);
+  const Solution refined(g, Algo::Greedy0Refine);
+  assertScore(refined, greedy.getScore(), "when Greedy0 is optimal");
+  if (refined.barriersToSinks() != greedy.barriersToSinks()) {
+    throw poprithms::test::error(
+        "Expected the Paths of Greedy0 when it is not improved upon");
+  }
+}
+
+} // namespace
+
+int main() {
+  greedyIsSuboptimal0();
+  greedyIsOptimal0();
+  return 0;
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/memory/unwind/graph.hpp>
+#include <poprithms/memory/unwind/solution.hpp>
+
+// Compare the scores and run times of Algo::Greedy0 and Algo::Greedy0Refine,
+// on Graphs of the same form as those in the greedy0 tests.
+//
+// Usage: refine_performance_0 [N n]
+//
+// where n is the number of calls in the call Graphs (default 16).
+
+namespace {
+
+using namespace poprithms::memory::unwind;
+
+// See order_matters_0.cpp
+Graph orderMatters() {
+  Graph g;
+  auto x0 = g.sink({16, 10});
+  auto x1 = g.dimShuffle(x0, {{1, 0}});
+  auto x2 = g.barrier({x1}, {{5, 8}});
+  auto x3 = g.sink({5, 8});
+  auto x4 = g.reverse(x3, Dimensions({1}));
+  g.sumLike(TensorIds{{x2, 0}, x4}, 0, 100.);
+  g.insertValuedPair(g.source({10, 16}), x1, 1000.);
+  g.insertValuedPair(g.source({5, 8}), x4, 1.);
+  return g;
+}
+
+// See calls_in_series_0.cpp
+Graph callsInSeries(uint64_t nCalls) {
+  Graph g;
+  const auto actInn    = g.sink({1});
+  const auto weightInn = g.sink({1});
+  g.insertValuedPair(g.source({1}), weightInn, 10.);
+  const auto mmOut = g.source({1});
+  g.insertValuedPair(actInn, g.source({1}), 9.);
+  g.insertValuedPair(mmOut, actInn, 9.5);
+  const auto in0 = g.sink({1});
+  g.insertValuedPair(in0, g.source({1}), 1.);
+  TensorId a{g.barrier({in0}, {{1}}), 0};
+  for (uint64_t i = 0; i < nCalls; ++i) {
+    a = g.call({a}, {actInn}, {mmOut}, {1.5}, {2.})[0];
+  }
+  return g;
+}
+
+// See group_conv_with_bias_0.cpp
+Graph groupConvWithBias(uint64_t nCalls) {
+  Graph g;
+  const Shape actInShape{10, 8};
+  const Shape weightShape{5, 2};
+  const Shape actOutShape{5, 3};
+  const Shape biasShape{3};
+  const auto innerAct = g.sink(actInShape);
+  g.insertValuedPair(innerAct, g.source(actInShape), 10.);
+  const auto innerWeight = g.sink(weightShape);
+  g.insertValuedPair(innerWeight, g.source(weightShape), 20.);
+  const auto innerBias  = g.sink(biasShape);
+  const auto conv       = g.barrier({innerAct, innerWeight}, {actOutShape});
+  const auto sumLikeOut = g.sumLike({{conv, 0}, innerBias}, InIndex(0), 5.);
+
+  const int64_t n        = static_cast<int64_t>(nCalls);
+  const auto outerAct    = g.sink(actInShape.broadcast(n, 0));
+  const auto outerWeight = g.sink(weightShape.broadcast(n, 0));
+  const auto outerBias   = g.sink(biasShape.broadcast(n, 0));
+  TensorIds callOuts;
+  for (uint64_t i = 0; i < nCalls; ++i) {
+    const auto act    = g.slice(outerAct, i * 10, (i + 1) * 10);
+    const auto weight = g.slice(outerWeight, i * 5, (i + 1) * 5);
+    const auto bias   = g.slice(outerBias, i * 3, (i + 1) * 3);
+    callOuts.push_back(g.call({act, weight, bias},
+                              {innerAct, innerWeight, innerBias},
+                              {sumLikeOut.out()},
+                              11.)[0]);
+  }
+  g.concat(callOuts, 0);
+  return g;
+}
+
+// Sinks with a valuable target layout for a part of them, and a less
+// valuable target layout for all of them which is used by many consumers.
+// Greedy0 takes the valuable partial layout.
+Graph competingSources(uint64_t nSinks) {
+  Graph g;
+  for (uint64_t i = 0; i < nSinks; ++i) {
+    const auto sink = g.sink({10, 4});
+    g.insertValuedPair(g.slice(sink, {0, 0}, {6, 4}), g.source({6, 4}), 10.);
+    const auto full = g.source({4, 10});
+    for (uint64_t j = 0; j < 3; ++j) {
+      g.insertValuedPair(g.dimShuffle(sink, {{1, 0}}), full, 9.);
+    }
+  }
+  return g;
+}
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{16};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  const std::vector<std::pair<std::string, std::function<Graph()>>> graphs{
+      {"order matters", []() { return orderMatters(); }},
+      {"calls in series", [n]() { return callsInSeries(n); }},
+      {"group conv with bias", [n]() { return groupConvWithBias(n); }},
+      {"competing sources", [n]() { return competingSources(n); }}};
+
+  std::cout << std::setw(22) << "graph" << std::setw(14) << "greedy score"
+            << std::setw(14) << "refine score" << std::setw(14)
+            << "greedy [s]" << std::setw(14) << "refine [s]" << '\n';
+
+  for (const auto &[name, getGraph] : graphs) {
+    const auto g = getGraph();
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const Solution greedy(g, Algo::Greedy0);
+    const auto tGreedy = seconds(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    const Solution refined(
+        g, Algo::Greedy0Refine, RefinementBudget{4 * n, 60.});
+    const auto tRefine = seconds(t0);
+
+    std::cout << std::setw(22) << name << std::setw(14) << greedy.getScore()
+              << std::setw(14) << refined.getScore() << std::setw(14)
+              << tGreedy << std::setw(14) << tRefine << std::endl;
+
+    if (refined.getScore() < greedy.getScore()) {
+      std::ostringstream oss;
+      oss << "The refined score of the Graph '" << name
+          << "' is lower than the greedy score.";
+      throw poprithms::test::error(oss.str());
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,256 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/schedule/connectedcomponents/connectedcomponents.hpp>
+#include <poprithms/schedule/dfs/dfs.hpp>
+#include <poprithms/schedule/scc/scc.hpp>
+#include <poprithms/schedule/transitiveclosure/transitiveclosure.hpp>
+#include <poprithms/schedule/vanilla/csredges.hpp>
+#include <poprithms/schedule/vanilla/pathcount.hpp>
+#include <poprithms/schedule/vanilla/vanilla.hpp>
+
+// Check that the schedule algorithms give the same results with the edges
+// in compressed sparse row format as they do with nested vectors.
+
+namespace {
+
+using namespace poprithms::schedule;
+using vanilla::CsrEdges;
+using vanilla::Edges;
+using vanilla::ErrorIfCycle;
+using vanilla::VerifyEdges;
+
+// A random graph with #N nodes and #E edges. If #dag is true, all edges are
+// from lower to higher nodes, so that the graph has no cycles.
+template <typename TNode>
+Edges<TNode> getRandomEdges(uint64_t N, uint64_t E, bool dag, uint32_t seed) {
+  std::mt19937 rng(seed);
+  Edges<TNode> edges(N);
+  for (uint64_t e = 0; e < E; ++e) {
+    auto a = rng() % N;
+    auto b = rng() % N;
+    if (dag) {
+      if (a == b) {
+        continue;
+      }
+      if (a > b) {
+        std::swap(a, b);
+      }
+    }
+    edges[a].push_back(static_cast<TNode>(b));
+  }
+  return edges;
+}
+
+template <typename T>
+void assertSame(const T &nested,
+                const T &csr,
+                const std::string &algo,
+                uint32_t seed) {
+  if (nested != csr) {
+    std::ostringstream oss;
+    oss << "The result of " << algo << " with CsrEdges is different to "
+        << "the result with nested Edges, for the graph with seed " << seed
+        << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void testConstruction0() {
+
+  Edges<uint64_t> nested{{1, 2}, {}, {0}, {}, {3, 3}};
+  const CsrEdges<uint64_t> csr(nested);
+  if (csr.offsets() != std::vector<uint64_t>{0, 2, 2, 3, 3, 5} ||
+      csr.targets() != std::vector<uint64_t>{1, 2, 0, 3, 3} ||
+      csr.size() != 5 || csr.nEdges() != 5 || !csr[1].empty() ||
+      csr[4].size() != 2) {
+    throw poprithms::test::error("Unexpected CSR of the edges");
+  }
+
+  if (csr.toNested() != nested) {
+    throw poprithms::test::error("Expected toNested to be the inverse");
+  }
+
+  const auto rev = CsrEdges<uint64_t>::reversed(csr);
+  if (rev.toNested() != Edges<uint64_t>{{2}, {0}, {0}, {4, 4}, {}}) {
+    throw poprithms::test::error("Unexpected reverse of the CSR edges");
+  }
+  if (CsrEdges<uint64_t>::reversed(nested) != rev) {
+    throw poprithms::test::error(
+        "Expected the reverses of the nested and CSR edges to be the same");
+  }
+
+  const auto fromOffsets =
+      CsrEdges<uint64_t>::fromOffsets({0, 2, 2, 3, 3, 5}, {1, 2, 0, 3, 3});
+  if (fromOffsets != csr) {
+    throw poprithms::test::error("Expected fromOffsets to give the same CSR");
+  }
+
+  const auto empty = CsrEdges<uint64_t>(Edges<uint64_t>{});
+  if (empty.size() != 0 || empty.nEdges() != 0) {
+    throw poprithms::test::error("Expected the CSR of no edges to be empty");
+  }
+
+  // Invalid offsets: decreasing, not starting at 0, not ending at the
+  // number of targets.
+  for (auto offsets : std::vector<std::vector<uint64_t>>{
+           {0, 2, 1, 3}, {1, 2, 3}, {0, 1, 2}, {}}) {
+    bool caught{false};
+    try {
+      CsrEdges<uint64_t>::fromOffsets(std::move(offsets), {0, 0, 0});
+    } catch (const poprithms::error::error &) {
+      caught = true;
+    }
+    if (!caught) {
+      throw poprithms::test::error("Failed to catch invalid offsets");
+    }
+  }
+}
+
+void testSchedulers0(uint32_t seed) {
+  for (uint64_t E : {0, 20, 100, 400}) {
+    const auto nested = getRandomEdges<uint64_t>(50, E, true, seed);
+    const CsrEdges<uint64_t> csr(nested);
+
+    assertSame(
+        vanilla::getSchedule_u64(nested, ErrorIfCycle::Yes, VerifyEdges::Yes),
+        vanilla::getSchedule_u64(csr, ErrorIfCycle::Yes, VerifyEdges::Yes),
+        "getSchedule_u64",
+        seed);
+
+    const auto nested_i64 = getRandomEdges<int64_t>(50, E, true, seed);
+    const CsrEdges<int64_t> csr_i64(nested_i64);
+    assertSame(vanilla::getSchedule_i64(
+                   nested_i64, ErrorIfCycle::Yes, VerifyEdges::Yes),
+               vanilla::getSchedule_i64(
+                   csr_i64, ErrorIfCycle::Yes, VerifyEdges::Yes),
+               "getSchedule_i64",
+               seed);
+
+    // Priorities on some nodes, and a link between every node and its first
+    // forward edge, when that forward edge is to the next node.
+    vanilla::Priorities<uint64_t, double> priorities{
+        {3, 1.}, {7, -2.}, {11, 4.}};
+    vanilla::Links<uint64_t> links;
+    for (uint64_t i = 0; i < nested.size(); ++i) {
+      if (!nested[i].empty() && nested[i][0] == i + 1 &&
+          (links.empty() || links.back()[1] != i)) {
+        links.push_back({i, i + 1});
+      }
+    }
+
+    using S = vanilla::Scheduler<uint64_t, double>;
+    for (const auto &ls : {vanilla::Links<uint64_t>{}, links}) {
+      assertSame(
+          S::filo(nested, priorities, ls, ErrorIfCycle::No, VerifyEdges::Yes),
+          S::filo(csr, priorities, ls, ErrorIfCycle::No, VerifyEdges::Yes),
+          "filo",
+          seed);
+      assertSame(
+          S::fifo(nested, priorities, ls, ErrorIfCycle::No, VerifyEdges::Yes),
+          S::fifo(csr, priorities, ls, ErrorIfCycle::No, VerifyEdges::Yes),
+          "fifo",
+          seed);
+      assertSame(S::random(nested,
+                           priorities,
+                           ls,
+                           seed,
+                           ErrorIfCycle::No,
+                           VerifyEdges::Yes),
+                 S::random(csr,
+                           priorities,
+                           ls,
+                           seed,
+                           ErrorIfCycle::No,
+                           VerifyEdges::Yes),
+                 "random",
+                 seed);
+    }
+
+    using Q = vanilla::Query<uint64_t>;
+    assertSame(Q::isSchedulable(nested, VerifyEdges::Yes),
+               Q::isSchedulable(csr, VerifyEdges::Yes),
+               "isSchedulable",
+               seed);
+    assertSame(Q::hasUniqueSchedule(nested, VerifyEdges::Yes),
+               Q::hasUniqueSchedule(csr, VerifyEdges::Yes),
+               "hasUniqueSchedule",
+               seed);
+
+    for (auto ct : {vanilla::CountType::Add,
+                    vanilla::CountType::Max,
+                    vanilla::CountType::Min}) {
+      assertSame(vanilla::PathCounter::count(
+                     nested, ct, ErrorIfCycle::Yes, VerifyEdges::Yes),
+                 vanilla::PathCounter::count(
+                     csr, ct, ErrorIfCycle::Yes, VerifyEdges::Yes),
+                 "PathCounter::count",
+                 seed);
+    }
+
+    assertSame(transitiveclosure::TransitiveClosure(nested) ==
+                   transitiveclosure::TransitiveClosure(csr),
+               true,
+               "TransitiveClosure",
+               seed);
+  }
+}
+
+void testCyclic0(uint32_t seed) {
+  for (uint64_t E : {0, 20, 60, 200}) {
+    const auto nested = getRandomEdges<uint64_t>(50, E, false, seed);
+    const CsrEdges<uint64_t> csr(nested);
+
+    assertSame(scc::getStronglyConnectedComponents(nested),
+               scc::getStronglyConnectedComponents(csr),
+               "getStronglyConnectedComponents",
+               seed);
+
+    assertSame(dfs::postOrder(nested),
+               dfs::postOrder(csr),
+               "postOrder",
+               seed);
+
+    using vanilla::Query;
+    assertSame(Query<uint64_t>::isSchedulable(nested, VerifyEdges::Yes),
+               Query<uint64_t>::isSchedulable(csr, VerifyEdges::Yes),
+               "isSchedulable (cyclic)",
+               seed);
+
+    const connectedcomponents::ConnectedComponents ccNested(nested);
+    const connectedcomponents::ConnectedComponents ccCsr(csr);
+    assertSame(ccNested.nComponents(),
+               ccCsr.nComponents(),
+               "nComponents",
+               seed);
+    for (uint64_t i = 0; i < nested.size(); ++i) {
+      assertSame(ccNested.componentId(i),
+                 ccCsr.componentId(i),
+                 "componentId",
+                 seed);
+      assertSame(ccNested.localId(i), ccCsr.localId(i), "localId", seed);
+    }
+    for (uint64_t c = 0; c < ccNested.nComponents(); ++c) {
+      using connectedcomponents::ComponentId;
+      assertSame(ccNested.component(ComponentId(c)),
+                 ccCsr.component(ComponentId(c)),
+                 "component",
+                 seed);
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  testConstruction0();
+  for (uint32_t seed = 1011; seed < 1021; ++seed) {
+    testSchedulers0(seed);
+    testCyclic0(seed);
+  }
+  return 0;
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <malloc.h>
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/schedule/connectedcomponents/connectedcomponents.hpp>
+#include <poprithms/schedule/dfs/dfs.hpp>
+#include <poprithms/schedule/scc/scc.hpp>
+#include <poprithms/schedule/transitiveclosure/transitiveclosure.hpp>
+#include <poprithms/schedule/vanilla/csredges.hpp>
+#include <poprithms/schedule/vanilla/pathcount.hpp>
+#include <poprithms/schedule/vanilla/vanilla.hpp>
+
+// Compare the memory and time taken to construct the edges of a random DAG
+// with nested vectors (Edges) and in compressed sparse row format
+// (CsrEdges), and the time taken by the schedule algorithms with each.
+//
+// Usage: csredges_performance_0 [N n]
+//
+// where n is the number of edges (default 1000000). The graph has n/8 nodes.
+// The TransitiveClosure, which is quadratic in the number of nodes, is
+// measured on a graph with 1/32 of the edges.
+
+namespace {
+
+using namespace poprithms::schedule;
+using vanilla::CsrEdges;
+using vanilla::Edges;
+using vanilla::ErrorIfCycle;
+using vanilla::VerifyEdges;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+// The number of bytes currently allocated on the heap (including large
+// allocations which are mmapped), or 0 if this is not available.
+uint64_t heapBytes() {
+#if defined(__GLIBC__) &&                                                    \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const auto mi = mallinfo2();
+  return mi.uordblks + mi.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+// The edges of a random DAG, as (from, to) pairs, where from < to.
+std::vector<std::pair<uint64_t, uint64_t>> getRandomDag(uint64_t nNodes,
+                                                        uint64_t nEdges) {
+  std::mt19937 rng(1011);
+  std::vector<std::pair<uint64_t, uint64_t>> pairs;
+  pairs.reserve(nEdges);
+  while (pairs.size() < nEdges) {
+    auto a = rng() % nNodes;
+    auto b = rng() % nNodes;
+    if (a != b) {
+      pairs.push_back({std::min(a, b), std::max(a, b)});
+    }
+  }
+  return pairs;
+}
+
+Edges<uint64_t>
+getNested(uint64_t nNodes,
+          const std::vector<std::pair<uint64_t, uint64_t>> &pairs) {
+  Edges<uint64_t> edges(nNodes);
+  for (const auto &[a, b] : pairs) {
+    edges[a].push_back(b);
+  }
+  return edges;
+}
+
+CsrEdges<uint64_t>
+getCsr(uint64_t nNodes,
+       const std::vector<std::pair<uint64_t, uint64_t>> &pairs) {
+  std::vector<uint64_t> offsets(nNodes + 1, 0);
+  for (const auto &p : pairs) {
+    ++offsets[p.first + 1];
+  }
+  for (uint64_t i = 0; i < nNodes; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  std::vector<uint64_t> targets(pairs.size());
+  std::vector<uint64_t> next(offsets.cbegin(), offsets.cend() - 1);
+  for (const auto &[a, b] : pairs) {
+    targets[next[a]++] = b;
+  }
+  return CsrEdges<uint64_t>::fromOffsets(std::move(offsets),
+                                         std::move(targets));
+}
+
+void report(const std::string &what, double tNested, double tCsr) {
+  std::cout << std::setw(34) << what << std::setw(14) << tNested
+            << std::setw(14) << tCsr << std::setw(14)
+            << (tCsr > 0 ? tNested / tCsr : 0.) << std::endl;
+}
+
+template <typename T>
+void assertSame(const T &a, const T &b, const std::string &what) {
+  if (a != b) {
+    throw poprithms::test::error("Different results with CsrEdges for " +
+                                 what);
+  }
+}
+
+// Time #f on the nested and CSR edges, and check that the results agree.
+template <typename F>
+void compare(const std::string &what,
+             const Edges<uint64_t> &nested,
+             const CsrEdges<uint64_t> &csr,
+             F &&f) {
+  auto t0            = std::chrono::high_resolution_clock::now();
+  const auto rNested = f(nested);
+  const auto tNested = seconds(t0);
+
+  t0              = std::chrono::high_resolution_clock::now();
+  const auto rCsr = f(csr);
+  const auto tCsr = seconds(t0);
+
+  report(what + " [s]", tNested, tCsr);
+  assertSame(rNested, rCsr, what);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t nEdges{1000000};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    nEdges = std::stoul(argv[2]);
+  }
+  const uint64_t nNodes = std::max<uint64_t>(2, nEdges / 8);
+  const auto pairs      = getRandomDag(nNodes, nEdges);
+
+  std::cout << "nNodes=" << nNodes << ", nEdges=" << nEdges << "\n\n"
+            << std::setw(34) << "" << std::setw(14) << "nested"
+            << std::setw(14) << "csr" << std::setw(14) << "ratio" << '\n';
+
+  // Construction: the nested edges require nNodes allocations (plus the
+  // reallocations of each vector as it grows), the CSR edges require 2.
+  auto b0           = heapBytes();
+  auto t0           = std::chrono::high_resolution_clock::now();
+  const auto nested = getNested(nNodes, pairs);
+  const auto tNest  = seconds(t0);
+  const auto bNest  = heapBytes() - b0;
+
+  b0              = heapBytes();
+  t0              = std::chrono::high_resolution_clock::now();
+  const auto csr  = getCsr(nNodes, pairs);
+  const auto tCsr = seconds(t0);
+  const auto bCsr = heapBytes() - b0;
+
+  report("construction [s]", tNest, tCsr);
+  report("heap [bytes]", double(bNest), double(bCsr));
+  report("allocations", double(nNodes), 2.);
+
+  assertSame(nested, csr.toNested(), "construction");
+
+  compare("getSchedule_u64", nested, csr, [](const auto &es) {
+    return vanilla::getSchedule_u64(es, ErrorIfCycle::Yes, VerifyEdges::Yes);
+  });
+
+  compare("PathCounter::count (Max)", nested, csr, [](const auto &es) {
+    return vanilla::PathCounter::count(
+        es, vanilla::CountType::Max, ErrorIfCycle::Yes, VerifyEdges::Yes);
+  });
+
+  compare("isSchedulable", nested, csr, [](const auto &es) {
+    return vanilla::Query<uint64_t>::isSchedulable(es, VerifyEdges::Yes);
+  });
+
+  compare("dfs::postOrder", nested, csr, [](const auto &es) {
+    return dfs::postOrder(es);
+  });
+
+  compare("getStronglyConnectedComponents",
+          nested,
+          csr,
+          [](const auto &es) {
+            return scc::getStronglyConnectedComponents(es).size();
+          });
+
+  compare("ConnectedComponents", nested, csr, [](const auto &es) {
+    return connectedcomponents::ConnectedComponents(es).nComponents();
+  });
+
+  const uint64_t nSmall = std::max<uint64_t>(2, nNodes / 32);
+  const auto smallPairs = getRandomDag(nSmall, nEdges / 32);
+  compare("TransitiveClosure (small)",
+          getNested(nSmall, smallPairs),
+          getCsr(nSmall, smallPairs),
+          [](const auto &es) {
+            return transitiveclosure::TransitiveClosure(es);
+          });
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/schedule/vanilla/csredges.hpp>
+#include <poprithms/schedule/vanilla/pathcount.hpp>
+#include <poprithms/schedule/vanilla/vanilla.hpp>
+
+// Check that the frontier based parallel fifo scheduler and path counter
+// give the same results as the sequential ones.
+
+namespace {
+
+using namespace poprithms::schedule::vanilla;
+
+// A DAG with #nLayers layers of #width nodes. Each node has #nOut edges to
+// random nodes in later layers, with some repeated edges.
+Edges<uint64_t> getLayered(uint64_t nLayers,
+                           uint64_t width,
+                           uint64_t nOut,
+                           uint32_t seed) {
+  std::mt19937 rng(seed);
+  const auto N = nLayers * width;
+  Edges<uint64_t> edges(N);
+  for (uint64_t from = 0; from < N - width; ++from) {
+    const auto layerEnd = (from / width + 1) * width;
+    for (uint64_t i = 0; i < nOut; ++i) {
+      // Mostly to the next layer, sometimes further.
+      const auto range = rng() % 4 == 0 ? N - layerEnd : width;
+      edges[from].push_back(layerEnd + rng() % range);
+    }
+    if (from % 7 == 0) {
+      edges[from].push_back(edges[from].back());
+    }
+  }
+  return edges;
+}
+
+void assertSame(const std::vector<uint64_t> &expected,
+                const std::vector<uint64_t> &observed,
+                const std::string &ctxt) {
+  if (expected != observed) {
+    std::ostringstream oss;
+    oss << "Parallel and sequential results differ, " << ctxt << '.';
+    throw poprithms::test::error(oss.str());
+  }
+}
+
+void testSameAsSequential(const Edges<uint64_t> &edges,
+                          const std::string &name) {
+
+  const auto expected = Scheduler<uint64_t, double>::fifo(
+      edges, {}, {}, ErrorIfCycle::Yes, VerifyEdges::Yes);
+
+  const CsrEdges<uint64_t> csr(edges);
+  for (uint64_t nThreads : {0, 1, 2, 3, 8}) {
+    const auto ctxt = name + " with " + std::to_string(nThreads) + " threads";
+    assertSame(expected,
+               getParallelFifoSchedule_u64(
+                   edges, nThreads, ErrorIfCycle::Yes, VerifyEdges::Yes),
+               "schedule of " + ctxt);
+    assertSame(expected,
+               getParallelFifoSchedule_u64(
+                   csr, nThreads, ErrorIfCycle::Yes, VerifyEdges::Yes),
+               "schedule of CSR " + ctxt);
+    for (auto ct : {CountType::Add, CountType::Max, CountType::Min}) {
+      assertSame(
+          PathCounter::count(edges, ct, ErrorIfCycle::Yes, VerifyEdges::Yes),
+          PathCounter::countParallel(
+              edges, ct, nThreads, ErrorIfCycle::Yes, VerifyEdges::Yes),
+          "path counts of " + ctxt);
+    }
+  }
+}
+
+void testWide0() {
+  // Frontiers of 10000 nodes, which are processed on multiple threads.
+  testSameAsSequential(getLayered(6, 10000, 3, 1011), "wide layers");
+  testSameAsSequential(getLayered(3, 20000, 1, 1012), "sparse wide layers");
+}
+
+void testNarrow0() {
+  // Frontiers which are all processed sequentially.
+  testSameAsSequential(getLayered(50, 20, 2, 1013), "narrow layers");
+  testSameAsSequential({{1, 2}, {3}, {4}, {5}, {5}, {}}, "diamond");
+  testSameAsSequential({}, "empty");
+}
+
+void testCycle0() {
+  // 0 -> 1 -> 2 -> 1, and 3.
+  const Edges<uint64_t> edges{{1}, {2}, {1}, {}};
+  const auto expected = Scheduler<uint64_t, double>::fifo(
+      edges, {}, {}, ErrorIfCycle::No, VerifyEdges::Yes);
+  assertSame(expected,
+             getParallelFifoSchedule_u64(
+                 edges, 2, ErrorIfCycle::No, VerifyEdges::Yes),
+             "partial schedule of graph with cycle");
+
+  bool caught{false};
+  try {
+    getParallelFifoSchedule_u64(
+        edges, 2, ErrorIfCycle::Yes, VerifyEdges::Yes);
+  } catch (const poprithms::error::error &) {
+    caught = true;
+  }
+  if (!caught) {
+    throw poprithms::test::error("Failed to catch cycle");
+  }
+}
+
+} // namespace
+
+int main() {
+  testWide0();
+  testNarrow0();
+  testCycle0();
+  return 0;
+}
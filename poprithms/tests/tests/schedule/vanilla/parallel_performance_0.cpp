@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/schedule/vanilla/csredges.hpp>
+#include <poprithms/schedule/vanilla/pathcount.hpp>
+#include <poprithms/schedule/vanilla/vanilla.hpp>
+
+// Measure how the frontier based parallel fifo scheduler and path counter
+// scale with the number of threads, on a very wide DAG.
+//
+// Usage: parallel_performance_0 [N n]
+//
+// where n is the number of nodes (default 1000000). The DAG has 10 layers of
+// n/10 nodes, and each node has 4 edges to nodes in the next layer.
+
+namespace {
+
+using namespace poprithms::schedule::vanilla;
+
+double seconds(std::chrono::high_resolution_clock::time_point t0) {
+  std::chrono::duration<double> d =
+      std::chrono::high_resolution_clock::now() - t0;
+  return d.count();
+}
+
+CsrEdges<uint64_t> getWide(uint64_t n) {
+  std::mt19937 rng(1011);
+  const uint64_t nLayers = 10;
+  const uint64_t width   = std::max<uint64_t>(1, n / nLayers);
+  const uint64_t nOut    = 4;
+  const auto N           = nLayers * width;
+  Edges<uint64_t> edges(N);
+  for (uint64_t from = 0; from < N - width; ++from) {
+    const auto layerEnd = (from / width + 1) * width;
+    for (uint64_t i = 0; i < nOut; ++i) {
+      edges[from].push_back(layerEnd + rng() % width);
+    }
+  }
+  return CsrEdges<uint64_t>(edges);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  uint64_t n{1000000};
+  if (argc == 3 && std::string(argv[1]) == "N") {
+    n = std::stoul(argv[2]);
+  }
+
+  const auto edges = getWide(n);
+  std::cout << "nNodes=" << edges.size() << ", nEdges=" << edges.nEdges()
+            << ", hardware threads=" << std::thread::hardware_concurrency()
+            << "\n\n";
+
+  auto t0        = std::chrono::high_resolution_clock::now();
+  const auto sch = Scheduler<uint64_t, double>::fifo(
+      edges, {}, {}, ErrorIfCycle::Yes, VerifyEdges::Yes);
+  const auto tSch = seconds(t0);
+
+  t0               = std::chrono::high_resolution_clock::now();
+  const auto count = PathCounter::count(
+      edges, CountType::Max, ErrorIfCycle::Yes, VerifyEdges::Yes);
+  const auto tCount = seconds(t0);
+
+  std::cout << std::setw(10) << "threads" << std::setw(16) << "schedule [s]"
+            << std::setw(12) << "speedup" << std::setw(16) << "count [s]"
+            << std::setw(12) << "speedup" << '\n'
+            << std::setw(10) << "seq" << std::setw(16) << tSch
+            << std::setw(12) << 1.0 << std::setw(16) << tCount
+            << std::setw(12) << 1.0 << std::endl;
+
+  for (uint64_t nThreads : {1, 2, 4, 8, 16}) {
+    t0 = std::chrono::high_resolution_clock::now();
+    const auto parSch = getParallelFifoSchedule_u64(
+        edges, nThreads, ErrorIfCycle::Yes, VerifyEdges::Yes);
+    const auto tParSch = seconds(t0);
+
+    t0                  = std::chrono::high_resolution_clock::now();
+    const auto parCount = PathCounter::countParallel(
+        edges, CountType::Max, nThreads, ErrorIfCycle::Yes, VerifyEdges::Yes);
+    const auto tParCount = seconds(t0);
+
+    std::cout << std::setw(10) << nThreads << std::setw(16) << tParSch
+              << std::setw(12) << tSch / tParSch << std::setw(16)
+              << tParCount << std::setw(12) << tCount / tParCount
+              << std::endl;
+
+    if (parSch != sch || parCount != count) {
+      throw poprithms::test::error(
+          "Parallel and sequential results differ with " +
+          std::to_string(nThreads) + " threads");
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poprithms/error/error.hpp>
+#include <poprithms/util/threadpool.hpp>
+
+namespace {
+
+using namespace poprithms;
+
+// Many consecutive jobs on the same pool, each of which covers the range
+// exactly once, and each of which runs on the same threads.
+void testReuse() {
+  util::ThreadPool pool(4);
+  const uint64_t n = 1001;
+  std::vector<std::thread::id> ids(pool.nThreads());
+  for (uint64_t job = 0; job < 200; ++job) {
+    std::vector<uint64_t> counts(n, 0);
+    pool.parallelFor(n, [&](uint64_t t, uint64_t begin, uint64_t end) {
+      for (uint64_t i = begin; i < end; ++i) {
+        ++counts[i];
+      }
+      if (job == 0) {
+        ids[t] = std::this_thread::get_id();
+      } else if (t != 0 && ids[t] != std::this_thread::get_id()) {
+        throw test::error("The threads of a ThreadPool should be reused");
+      }
+    });
+    for (auto c : counts) {
+      if (c != 1) {
+        throw test::error("Every index should be processed exactly once");
+      }
+    }
+  }
+}
+
+// The exception of the lowest thread index is rethrown, and the pool can be
+// used after a job which throws.
+void testThrow() {
+  util::ThreadPool pool(3);
+  bool caught{false};
+  try {
+    pool.forEachThread([](uint64_t t) {
+      if (t != 0) {
+        throw test::error("thrown by " + std::to_string(t));
+      }
+    });
+  } catch (const poprithms::error::error &e) {
+    caught = std::string(e.what()).find("thrown by 1") != std::string::npos;
+  }
+  if (!caught) {
+    throw test::error("The exception of thread 1 should be rethrown");
+  }
+
+  std::atomic<uint64_t> nCalls{0};
+  pool.forEachThread([&nCalls](uint64_t) { ++nCalls; });
+  if (nCalls != 3) {
+    throw test::error("Expected 3 calls after the exception");
+  }
+}
+
+// A call from within a job runs on the calling thread, rather than waiting
+// for the pool (which would never become free).
+void testNested() {
+  util::ThreadPool pool(2);
+  std::atomic<uint64_t> nInner{0};
+  pool.forEachThread([&pool, &nInner](uint64_t) {
+    pool.forEachThread([&nInner](uint64_t) { ++nInner; });
+  });
+  if (nInner != 4) {
+    throw test::error("Expected 2 nested calls on each of 2 threads");
+  }
+}
+
+} // namespace
+
+int main() {
+  testReuse();
+  testThrow();
+  testNested();
+  return 0;
+}
@@ -115,6 +115,12 @@ public:
   OpId unwindOpWithName(const std::vector<std::string> &frags) const;
 
   void lower();
+
+  /**
+   * Lower with paths to different sinks unwound concurrently, on #nThreads
+   * threads.
+   * */
+  void lowerParallel(uint64_t nThreads);
   poprithms::memory::unwind::Graph &uwGraph() { return uwg_; }
   HTensor mainLayout(const TensorId &toyId) const;
   void setMainLayout(const TensorId &toyId, const HTensor &ht);
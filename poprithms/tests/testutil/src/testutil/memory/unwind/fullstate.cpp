@@ -49,6 +49,14 @@ void FullState::lower() {
   poprithms::memory::unwind::Lowerer<HTensor, FullState>::lower(*this);
 }
 
+void FullState::lowerParallel(uint64_t nThreads) {
+  ssp = std::make_unique<ScheduledSolution>(
+      uwg_, Translator(*this, tg_), tg_.getForwardEdgeMap_u64());
+
+  poprithms::memory::unwind::Lowerer<HTensor, FullState>::lowerParallel(
+      *this, nThreads);
+}
+
 HTensor FullState::mainLayout(const TensorId &toyId) const {
   return mainLayouts_.at(toyId);
 }